@@ -43,6 +43,7 @@ public:
   // Only for override, those are never used.
   uint64_t numConnections() const override { return 0; }
   void incNumConnections() override {}
+  Event::Dispatcher& dispatcher() override { return handler_.dispatcher(); }
 
 private:
   Envoy::Network::BalancedConnectionHandler& handler_;
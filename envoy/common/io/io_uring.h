@@ -211,6 +211,17 @@ struct WriteParam {
   int32_t result_;
 };
 
+/**
+ * The socket accepted by the accept request. The receiver takes over the ownership of the
+ * file descriptor by resetting `fd_` to `INVALID_SOCKET`, otherwise the file descriptor will be
+ * closed after the callback returns.
+ */
+struct AcceptedSocketParam {
+  os_fd_t fd_;
+  const sockaddr_storage* remote_addr_;
+  socklen_t remote_addr_len_;
+};
+
 /**
  * Abstract for each socket.
  */
@@ -371,6 +382,13 @@ public:
    */
   virtual const OptRef<WriteParam>& getWriteParam() const PURE;
 
+  /**
+   * Return the socket accepted by the accept request.
+   * @return Only return valid AcceptedSocketParam when the callback is invoked with
+   * `Event::FileReadyType::Read` on an accept socket, otherwise `absl::nullopt` returned.
+   */
+  virtual const OptRef<AcceptedSocketParam>& getAcceptedSocketParam() const PURE;
+
   /**
    * Set the callback when file ready event triggered.
    * @param cb the callback function.
@@ -405,11 +423,22 @@ public:
   virtual IoUringSocket& addClientSocket(os_fd_t fd, Event::FileReadyCb cb,
                                          bool enable_close_event) PURE;
 
+  /**
+   * Add a listening socket to the worker. The new connections are accepted by the io_uring.
+   */
+  virtual IoUringSocket& addAcceptSocket(os_fd_t fd, Event::FileReadyCb cb,
+                                         bool enable_close_event) PURE;
+
   /**
    * Return the current thread's dispatcher.
    */
   virtual Event::Dispatcher& dispatcher() PURE;
 
+  /**
+   * Submit an accept request for a socket.
+   */
+  virtual Request* submitAcceptRequest(IoUringSocket& socket) PURE;
+
   /**
    * Submit a connect request for a socket.
    */
@@ -469,5 +498,31 @@ public:
   virtual void onServerInitialized() PURE;
 };
 
+/**
+ * Abstract factory for IoUringWorker wrappers.
+ */
+class IoUringWorkerFactory {
+public:
+  virtual ~IoUringWorkerFactory() = default;
+
+  /**
+   * Returns the current thread's IoUringWorker. If the thread have not registered a IoUringWorker,
+   * an absl::nullopt will be returned.
+   */
+  virtual OptRef<IoUringWorker> getIoUringWorker() PURE;
+
+  /**
+   * Initializes a IoUringWorkerFactory upon server readiness. The method is used to set the TLS.
+   */
+  virtual void onServerInitialized() PURE;
+
+  /**
+   * Indicates whether the current thread has been registered for a IoUringWorker.
+   */
+  virtual bool currentThreadRegistered() PURE;
+};
+
+using IoUringWorkerFactoryPtr = std::unique_ptr<IoUringWorkerFactory>;
+
 } // namespace Io
 } // namespace Envoy
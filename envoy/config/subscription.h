@@ -81,6 +81,16 @@ public:
    */
   virtual ProtobufTypes::MessagePtr decodeResource(const ProtobufWkt::Any& resource) PURE;
 
+  /**
+   * Decodes a resource into an arena, so that the message and its fields are allocated in the
+   * blocks of the arena rather than one by one.
+   * @param resource some opaque resource (ProtobufWkt::Any).
+   * @param arena supplies the arena which owns the decoded message.
+   * @return Protobuf::Message* decoded protobuf message in the opaque resource, owned by the arena.
+   */
+  virtual Protobuf::Message* decodeResource(const ProtobufWkt::Any& resource,
+                                            Protobuf::Arena& arena) PURE;
+
   /**
    * @param resource some opaque resource (Protobuf::Message).
    * @return std::String the resource name in a Protobuf::Message returned by decodeResource(), e.g.
@@ -3,6 +3,10 @@
 #include "envoy/network/listen_socket.h"
 
 namespace Envoy {
+namespace Event {
+class Dispatcher;
+} // namespace Event
+
 namespace Network {
 
 /**
@@ -33,6 +37,12 @@ public:
    */
   virtual void post(Network::ConnectionSocketPtr&& socket) PURE;
 
+  /**
+   * @return the dispatcher of the worker thread which runs the handler. Balancers may use it to
+   *         observe the worker from the thread which registers the handler.
+   */
+  virtual Event::Dispatcher& dispatcher() PURE;
+
   virtual void onAcceptWorker(Network::ConnectionSocketPtr&& socket,
                               bool hand_off_restored_destination_connections, bool rebalanced) PURE;
 };
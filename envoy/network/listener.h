@@ -7,6 +7,7 @@
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/io_error.h"
 #include "envoy/common/exception.h"
+#include "envoy/common/optref.h"
 #include "envoy/common/resource.h"
 #include "envoy/config/core/v3/base.pb.h"
 #include "envoy/config/listener/v3/udp_listener_config.pb.h"
@@ -34,6 +35,23 @@ class UdpListenerWorkerRouter;
 class ListenSocketFactory;
 using ListenSocketFactoryPtr = std::unique_ptr<ListenSocketFactory>;
 
+/**
+ * The load of the worker which owns a listen socket, by which connections may be steered between
+ * the listen sockets of the workers.
+ */
+class ListenSocketLoad {
+public:
+  virtual ~ListenSocketLoad() = default;
+
+  /**
+   * Adds to the number of connections which the worker has active on the socket. This may be
+   * called on any thread.
+   * @param connections supplies the number of connections which were opened, or if negative,
+   *        closed.
+   */
+  virtual void add(int64_t connections) PURE;
+};
+
 /**
  * ListenSocketFactory is a member of ListenConfig to provide listen socket.
  * Listeners created from the same ListenConfig instance have listening sockets
@@ -52,6 +70,14 @@ public:
    */
   virtual SocketSharedPtr getListenSocket(uint32_t worker_index) PURE;
 
+  /**
+   * @param worker_index supplies the worker index to get the load of the socket for.
+   * @return the load of the socket getListenSocket() returns for the worker, which the listener
+   *         running on the worker keeps up to date, or nullopt if connections aren't steered by
+   *         the load of the workers.
+   */
+  virtual OptRef<ListenSocketLoad> socketLoad(uint32_t worker_index) PURE;
+
   /**
    * @return the type of the socket getListenSocket() returns.
    */
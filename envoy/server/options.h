@@ -205,6 +205,12 @@ public:
    */
   virtual std::chrono::milliseconds fileFlushIntervalMsec() const PURE;
 
+  /**
+   * @return bool whether each thread buffers its writes to access log files separately, and a
+   *         single flush thread flushes all files.
+   */
+  virtual bool fileFlushWorkerBuffers() const PURE;
+
   /**
    * @return const std::string& the server's cluster.
    */
@@ -8,6 +8,7 @@
 #include "envoy/server/options.h"
 #include "envoy/server/proactive_resource_monitor.h"
 #include "envoy/server/resource_monitor.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "source/common/protobuf/protobuf.h"
 
@@ -35,6 +36,12 @@ public:
    */
   virtual Api::Api& api() PURE;
 
+  /**
+   * @return ThreadLocal::SlotAllocator& the thread local storage, by which a monitor may run on
+   *         every thread.
+   */
+  virtual ThreadLocal::SlotAllocator& threadLocal() PURE;
+
   /**
    * @return ProtobufMessage::ValidationVisitor& validation visitor for filter configuration
    *         messages.
@@ -199,6 +199,12 @@ public:
    * downstream TLS handshake, false otherwise.
    */
   virtual bool fullScanCertsOnSNIMismatch() const PURE;
+
+  /**
+   * @return True if the writes of connections are offloaded to kernel TLS once their handshake
+   * completes, false otherwise.
+   */
+  virtual bool kernelTlsOffload() const PURE;
 };
 
 using ServerContextConfigPtr = std::unique_ptr<ServerContextConfig>;
@@ -99,6 +99,16 @@ public:
    */
   virtual void setSinkPredicates(std::unique_ptr<SinkPredicates>&& sink_predicates) PURE;
 
+  /**
+   * Makes the counters allocated from now on shard their values across up to num_shards threads.
+   * Each shard has its own cache line, so threads incrementing the same counter concurrently don't
+   * contend on it, and the shards are summed when the counter is read or latched for a flush. As
+   * each counter then takes a cache line per shard, this is best suited to processes with many
+   * workers and a moderate number of stats. 0 or 1 disables sharding, which is the default.
+   * @param num_shards the number of shards, usually the number of threads incrementing counters.
+   */
+  virtual void setCounterShards(uint32_t num_shards) PURE;
+
   // TODO(jmarantz): create a parallel mechanism to instantiate histograms. At
   // the moment, histograms don't fit the same pattern of counters and gauges
   // as they are not actually created in the context of a stats allocator.
@@ -266,6 +266,12 @@ public:
   virtual void setSinkPredicates(std::unique_ptr<SinkPredicates>&& sink_predicates) PURE;
 
   virtual OptRef<SinkPredicates> sinkPredicates() PURE;
+
+  /**
+   * Shards the counters created from now on across up to num_shards threads, as described by
+   * Allocator::setCounterShards().
+   */
+  virtual void setCounterShards(uint32_t num_shards) PURE;
 };
 
 using StoreRootPtr = std::unique_ptr<StoreRoot>;
@@ -227,6 +227,18 @@ public:
   virtual bool addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
                                   const std::string& version_info) PURE;
 
+  /**
+   * Add or update a cluster via API, like addOrUpdateCluster() above, with the hash of its config
+   * computed ahead of time.
+   *
+   * @param cluster supplies the cluster configuration.
+   * @param version_info supplies the xDS version of the cluster.
+   * @param cluster_hash supplies MessageUtil::hash() of the cluster configuration.
+   * @return true if the action results in an add/update of a cluster.
+   */
+  virtual bool addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
+                                  const std::string& version_info, uint64_t cluster_hash) PURE;
+
   /**
    * Set a callback that will be invoked when all primary clusters have been initialized.
    */
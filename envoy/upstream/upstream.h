@@ -1,8 +1,10 @@
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <iterator>
 #include <list>
 #include <memory>
 #include <string>
@@ -343,6 +345,112 @@ using LocalityWeightsMap =
     absl::node_hash_map<envoy::config::core::v3::Locality, uint32_t, LocalityHash, LocalityEqualTo>;
 using PriorityState = std::vector<std::pair<HostListPtr, LocalityWeightsMap>>;
 
+/**
+ * The hosts of each locality of a HostsPerLocality. It reads like a std::vector<HostVector>, but
+ * holds the hosts of each locality by a shared pointer, so that a HostsPerLocality made from
+ * another one can share the localities that didn't change rather than copy them.
+ */
+class LocalityHostVectors {
+public:
+  class const_iterator {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = HostVector;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const HostVector*;
+    using reference = const HostVector&;
+
+    const_iterator() = default;
+    explicit const_iterator(std::vector<HostVectorConstSharedPtr>::const_iterator it) : it_(it) {}
+
+    reference operator*() const { return **it_; }
+    pointer operator->() const { return it_->get(); }
+    reference operator[](difference_type n) const { return *it_[n]; }
+    const_iterator& operator++() {
+      ++it_;
+      return *this;
+    }
+    const_iterator operator++(int) { return const_iterator(it_++); }
+    const_iterator& operator--() {
+      --it_;
+      return *this;
+    }
+    const_iterator operator--(int) { return const_iterator(it_--); }
+    const_iterator& operator+=(difference_type n) {
+      it_ += n;
+      return *this;
+    }
+    const_iterator& operator-=(difference_type n) {
+      it_ -= n;
+      return *this;
+    }
+    const_iterator operator+(difference_type n) const { return const_iterator(it_ + n); }
+    const_iterator operator-(difference_type n) const { return const_iterator(it_ - n); }
+    difference_type operator-(const const_iterator& other) const { return it_ - other.it_; }
+    bool operator==(const const_iterator& other) const { return it_ == other.it_; }
+    bool operator!=(const const_iterator& other) const { return it_ != other.it_; }
+    bool operator<(const const_iterator& other) const { return it_ < other.it_; }
+
+  private:
+    std::vector<HostVectorConstSharedPtr>::const_iterator it_;
+  };
+  using iterator = const_iterator;
+  using value_type = HostVector;
+  using size_type = size_t;
+  using reference = const HostVector&;
+  using const_reference = const HostVector&;
+
+  LocalityHostVectors() = default;
+  explicit LocalityHostVectors(std::vector<HostVector>&& localities) {
+    localities_.reserve(localities.size());
+    for (HostVector& hosts : localities) {
+      localities_.push_back(std::make_shared<const HostVector>(std::move(hosts)));
+    }
+  }
+  explicit LocalityHostVectors(std::vector<HostVectorConstSharedPtr>&& localities)
+      : localities_(std::move(localities)) {}
+
+  size_t size() const { return localities_.size(); }
+  bool empty() const { return localities_.empty(); }
+  const HostVector& operator[](size_t index) const { return *localities_[index]; }
+  const HostVector& front() const { return *localities_.front(); }
+  const HostVector& back() const { return *localities_.back(); }
+  const_iterator begin() const { return const_iterator(localities_.begin()); }
+  const_iterator end() const { return const_iterator(localities_.end()); }
+
+  /**
+   * @return the shared hosts of the locality at index.
+   */
+  const HostVectorConstSharedPtr& shared(size_t index) const { return localities_[index]; }
+
+  /**
+   * @return a copy of the hosts of each locality.
+   */
+  operator std::vector<HostVector>() const { return std::vector<HostVector>(begin(), end()); }
+
+  friend bool operator==(const LocalityHostVectors& lhs, const LocalityHostVectors& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+  friend bool operator==(const LocalityHostVectors& lhs, const std::vector<HostVector>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+  friend bool operator==(const std::vector<HostVector>& lhs, const LocalityHostVectors& rhs) {
+    return rhs == lhs;
+  }
+  friend bool operator!=(const LocalityHostVectors& lhs, const LocalityHostVectors& rhs) {
+    return !(lhs == rhs);
+  }
+  friend bool operator!=(const LocalityHostVectors& lhs, const std::vector<HostVector>& rhs) {
+    return !(lhs == rhs);
+  }
+  friend bool operator!=(const std::vector<HostVector>& lhs, const LocalityHostVectors& rhs) {
+    return !(rhs == lhs);
+  }
+
+private:
+  std::vector<HostVectorConstSharedPtr> localities_;
+};
+
 /**
  * Bucket hosts by locality.
  */
@@ -357,14 +465,14 @@ public:
   virtual bool hasLocalLocality() const PURE;
 
   /**
-   * @return const std::vector<HostVector>& list of hosts organized per
+   * @return const LocalityHostVectors& list of hosts organized per
    *         locality. The local locality is the first entry if
    *         hasLocalLocality() is true. All hosts within the same entry have the same locality
    *         and all hosts with a given locality are in the same entry. With the exception of
    *         the local locality entry (if present), all entries are sorted by locality with
    *         those considered less by the LocalityLess comparator ordered earlier in the list.
    */
-  virtual const std::vector<HostVector>& get() const PURE;
+  virtual const LocalityHostVectors& get() const PURE;
 
   /**
    * Clone object with multiple filter predicates. Returns a vector of clones, each with host that
@@ -1,5 +1,6 @@
 #include "source/common/access_log/access_log_manager_impl.h"
 
+#include <algorithm>
 #include <string>
 
 #include "envoy/common/exception.h"
@@ -7,6 +8,7 @@
 #include "source/common/common/assert.h"
 #include "source/common/common/fmt.h"
 #include "source/common/common/lock_guard.h"
+#include "source/common/common/thread.h"
 
 #include "absl/container/fixed_array.h"
 
@@ -34,6 +36,16 @@ AccessLogManagerImpl::createAccessLog(const Filesystem::FilePathAndType& file_in
   if (access_logs_.count(file_name)) {
     return access_logs_[file_name];
   }
+  if (file_worker_buffers_ > 0) {
+    if (shared_flush_thread_ == nullptr) {
+      shared_flush_thread_ = std::make_shared<SharedAccessLogFlushThread>(
+          api_.threadFactory(), file_flush_interval_msec_, file_stats_);
+    }
+    access_logs_[file_name] = std::make_shared<AccessLogFileImpl>(
+        std::move(file), lock_, file_stats_, file_flush_interval_msec_, api_.threadFactory(),
+        shared_flush_thread_, file_worker_buffers_);
+    return access_logs_[file_name];
+  }
   access_logs_[file_name] =
       std::make_shared<AccessLogFileImpl>(std::move(file), dispatcher_, lock_, file_stats_,
                                           file_flush_interval_msec_, api_.threadFactory());
@@ -59,6 +71,24 @@ AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatch
   }
 }
 
+AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, Thread::BasicLockable& lock,
+                                     AccessLogFileStats& stats,
+                                     std::chrono::milliseconds flush_interval_msec,
+                                     Thread::ThreadFactory& thread_factory,
+                                     SharedAccessLogFlushThreadSharedPtr shared_flush_thread,
+                                     uint32_t num_worker_buffers)
+    : file_(std::move(file)), file_lock_(lock), thread_factory_(thread_factory),
+      flush_interval_msec_(flush_interval_msec), stats_(stats),
+      worker_buffers_(num_worker_buffers), shared_flush_thread_(std::move(shared_flush_thread)) {
+  ASSERT(num_worker_buffers > 0);
+  auto open_result = open();
+  if (!open_result.return_value_) {
+    throwEnvoyExceptionOrPanic(fmt::format("unable to open file '{}': {}", file_->path(),
+                                           open_result.err_->getErrorDetails()));
+  }
+  shared_flush_thread_->addFile(*this);
+}
+
 Filesystem::FlagSet AccessLogFileImpl::defaultFlags() {
   static constexpr Filesystem::FlagSet default_flags{1 << Filesystem::File::Operation::Write |
                                                      1 << Filesystem::File::Operation::Create |
@@ -75,11 +105,17 @@ Api::IoCallBoolResult AccessLogFileImpl::open() {
 void AccessLogFileImpl::reopen() {
   Thread::LockGuard lock(write_lock_);
   reopen_file_ = true;
-  flush_event_.notifyOne();
+  if (shared_flush_thread_ != nullptr) {
+    shared_flush_thread_->requestFlush();
+  } else {
+    flush_event_.notifyOne();
+  }
 }
 
 AccessLogFileImpl::~AccessLogFileImpl() {
-  {
+  if (shared_flush_thread_ != nullptr) {
+    shared_flush_thread_->removeFile(*this);
+  } else {
     Thread::LockGuard lock(write_lock_);
     flush_thread_exit_ = true;
     flush_event_.notifyOne();
@@ -91,6 +127,7 @@ AccessLogFileImpl::~AccessLogFileImpl() {
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
   if (file_->isOpen()) {
+    moveWorkerBuffers(flush_buffer_);
     if (flush_buffer_.length() > 0) {
       doWrite(flush_buffer_);
     }
@@ -186,6 +223,11 @@ void AccessLogFileImpl::flushThreadFunc() {
 }
 
 void AccessLogFileImpl::flush() {
+  if (!worker_buffers_.empty()) {
+    flushWorkerBuffers();
+    return;
+  }
+
   std::unique_lock<Thread::BasicLockable> flush_buffer_lock;
 
   {
@@ -209,7 +251,82 @@ void AccessLogFileImpl::flush() {
   doWrite(about_to_write_buffer_);
 }
 
+void AccessLogFileImpl::flushWorkerBuffers() {
+  bool reopen_requested;
+  {
+    Thread::LockGuard write_lock(write_lock_);
+    reopen_requested = reopen_file_;
+    reopen_file_ = false;
+  }
+
+  Thread::LockGuard flush_lock(flush_lock_);
+  // A failed reopen is retried with the next flush.
+  reopen_pending_ = reopen_pending_ || reopen_requested;
+  if (reopen_pending_) {
+    if (file_->isOpen()) {
+      const Api::IoCallBoolResult result = file_->close();
+      ASSERT(result.return_value_, fmt::format("unable to close file '{}': {}", file_->path(),
+                                               result.err_->getErrorDetails()));
+    }
+    const Api::IoCallBoolResult open_result = open();
+    if (!open_result.return_value_) {
+      stats_.reopen_failed_.inc();
+    } else {
+      reopen_pending_ = false;
+    }
+  }
+
+  moveWorkerBuffers(about_to_write_buffer_);
+  // doWrite no matter file isOpen, if not, we can drain buffer
+  if (about_to_write_buffer_.length() > 0) {
+    doWrite(about_to_write_buffer_);
+  }
+}
+
+void AccessLogFileImpl::moveWorkerBuffers(Buffer::Instance& buffer) {
+  const uint64_t length = buffer.length();
+  uint64_t writes = 0;
+  for (WorkerBuffer& worker_buffer : worker_buffers_) {
+    Thread::LockGuard lock(worker_buffer.lock_);
+    buffer.move(worker_buffer.buffer_);
+    writes += worker_buffer.writes_;
+    worker_buffer.writes_ = 0;
+  }
+  stats_.write_buffered_.add(writes);
+  stats_.write_total_buffered_.add(buffer.length() - length);
+}
+
+void AccessLogFileImpl::writeToWorkerBuffer(absl::string_view data) {
+  WorkerBuffer& worker_buffer = worker_buffers_[Thread::WorkerIndex::slot(worker_buffers_.size())];
+  bool request_flush = false;
+  {
+    Thread::LockGuard lock(worker_buffer.lock_);
+    const uint64_t length = worker_buffer.buffer_.length();
+    // The flush thread can't keep up with the writes. A single write is still buffered however
+    // large it is, as the buffer is then flushed right away.
+    if (length > 0 && length + data.size() > MAX_WORKER_BUFFER_SIZE) {
+      stats_.write_dropped_.inc();
+      return;
+    }
+    if (length > MIN_FLUSH_SIZE) {
+      stats_.write_backpressured_.inc();
+    }
+    worker_buffer.buffer_.add(data.data(), data.size());
+    worker_buffer.writes_++;
+    request_flush = length <= MIN_FLUSH_SIZE && length + data.size() > MIN_FLUSH_SIZE;
+  }
+
+  if (request_flush) {
+    shared_flush_thread_->requestFlush();
+  }
+}
+
 void AccessLogFileImpl::write(absl::string_view data) {
+  if (!worker_buffers_.empty()) {
+    writeToWorkerBuffer(data);
+    return;
+  }
+
   Thread::LockGuard lock(write_lock_);
 
   if (flush_thread_ == nullptr) {
@@ -229,5 +346,67 @@ void AccessLogFileImpl::createFlushStructures() {
                                                Thread::Options{"AccessLogFlush"});
 }
 
+SharedAccessLogFlushThread::SharedAccessLogFlushThread(Thread::ThreadFactory& thread_factory,
+                                                       std::chrono::milliseconds flush_interval_msec,
+                                                       AccessLogFileStats& stats)
+    : thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec), stats_(stats) {}
+
+SharedAccessLogFlushThread::~SharedAccessLogFlushThread() {
+  {
+    Thread::LockGuard lock(flush_lock_);
+    flush_thread_exit_ = true;
+    flush_event_.notifyOne();
+  }
+
+  if (flush_thread_ != nullptr) {
+    flush_thread_->join();
+  }
+}
+
+void SharedAccessLogFlushThread::addFile(AccessLogFileImpl& file) {
+  Thread::LockGuard lock(files_lock_);
+  files_.push_back(&file);
+  if (flush_thread_ == nullptr) {
+    flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); },
+                                                 Thread::Options{"AccessLogFlush"});
+  }
+}
+
+void SharedAccessLogFlushThread::removeFile(AccessLogFileImpl& file) {
+  Thread::LockGuard lock(files_lock_);
+  files_.erase(std::find(files_.begin(), files_.end(), &file));
+}
+
+void SharedAccessLogFlushThread::requestFlush() {
+  Thread::LockGuard lock(flush_lock_);
+  flush_requested_ = true;
+  flush_event_.notifyOne();
+}
+
+void SharedAccessLogFlushThread::flushThreadFunc() {
+  while (true) {
+    bool flushed_by_timer = false;
+    {
+      Thread::LockGuard lock(flush_lock_);
+      if (!flush_requested_ && !flush_thread_exit_) {
+        flushed_by_timer = flush_event_.waitFor(flush_lock_, flush_interval_msec_) ==
+                           Thread::CondVar::WaitStatus::Timeout;
+      }
+      if (flush_thread_exit_) {
+        return;
+      }
+      flush_requested_ = false;
+    }
+
+    Thread::LockGuard lock(files_lock_);
+    for (AccessLogFileImpl* file : files_) {
+      if (flushed_by_timer) {
+        stats_.flushed_by_timer_.inc();
+      }
+      file->flushWorkerBuffers();
+    }
+  }
+}
+
 } // namespace AccessLog
 } // namespace Envoy
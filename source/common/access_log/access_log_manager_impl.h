@@ -1,6 +1,8 @@
 #pragma once
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/api.h"
@@ -13,6 +15,7 @@
 #include "source/common/common/logger.h"
 #include "source/common/common/thread.h"
 
+#include "absl/base/optimization.h"
 #include "absl/container/node_hash_map.h"
 
 namespace Envoy {
@@ -20,8 +23,10 @@ namespace Envoy {
 #define ACCESS_LOG_FILE_STATS(COUNTER, GAUGE)                                                      \
   COUNTER(flushed_by_timer)                                                                        \
   COUNTER(reopen_failed)                                                                           \
+  COUNTER(write_backpressured)                                                                     \
   COUNTER(write_buffered)                                                                          \
   COUNTER(write_completed)                                                                         \
+  COUNTER(write_dropped)                                                                           \
   COUNTER(write_failed)                                                                            \
   GAUGE(write_total_buffered, Accumulate)
 
@@ -31,15 +36,26 @@ struct AccessLogFileStats {
 
 namespace AccessLog {
 
+class AccessLogFileImpl;
+class SharedAccessLogFlushThread;
+using SharedAccessLogFlushThreadSharedPtr = std::shared_ptr<SharedAccessLogFlushThread>;
+
 class AccessLogManagerImpl : public AccessLogManager, Logger::Loggable<Logger::Id::main> {
 public:
+  /**
+   * @param file_worker_buffers if not 0, the number of buffers each file buffers the writes of
+   *        threads in, rather than in a single buffer, usually one per worker plus one shared by
+   *        the main thread and all other threads. The files are then all flushed by a single flush
+   *        thread.
+   */
   AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec, Api::Api& api,
                        Event::Dispatcher& dispatcher, Thread::BasicLockable& lock,
-                       Stats::Store& stats_store)
+                       Stats::Store& stats_store, uint32_t file_worker_buffers = 0)
       : file_flush_interval_msec_(file_flush_interval_msec), api_(api), dispatcher_(dispatcher),
-        lock_(lock), file_stats_{
-                         ACCESS_LOG_FILE_STATS(POOL_COUNTER_PREFIX(stats_store, "filesystem."),
-                                               POOL_GAUGE_PREFIX(stats_store, "filesystem."))} {}
+        lock_(lock),
+        file_stats_{ACCESS_LOG_FILE_STATS(POOL_COUNTER_PREFIX(stats_store, "filesystem."),
+                                          POOL_GAUGE_PREFIX(stats_store, "filesystem."))},
+        file_worker_buffers_(file_worker_buffers) {}
   ~AccessLogManagerImpl() override;
 
   // AccessLog::AccessLogManager
@@ -52,15 +68,55 @@ private:
   Event::Dispatcher& dispatcher_;
   Thread::BasicLockable& lock_;
   AccessLogFileStats file_stats_;
+  const uint32_t file_worker_buffers_;
+  // Created with the first file when the files have worker buffers.
+  SharedAccessLogFlushThreadSharedPtr shared_flush_thread_;
   absl::node_hash_map<std::string, AccessLogFileSharedPtr> access_logs_;
 };
 
+/**
+ * A flush thread shared by access log files with worker buffers, which flushes them all when any
+ * of them has enough data buffered, or when the flush interval elapses.
+ */
+class SharedAccessLogFlushThread {
+public:
+  SharedAccessLogFlushThread(Thread::ThreadFactory& thread_factory,
+                             std::chrono::milliseconds flush_interval_msec,
+                             AccessLogFileStats& stats);
+  ~SharedAccessLogFlushThread();
+
+  // Files are added once opened, and removed when destroyed, which waits for any flush in progress.
+  void addFile(AccessLogFileImpl& file);
+  void removeFile(AccessLogFileImpl& file);
+
+  /**
+   * Wakes up the flush thread to flush all files.
+   */
+  void requestFlush();
+
+private:
+  void flushThreadFunc();
+
+  Thread::ThreadFactory& thread_factory_;
+  const std::chrono::milliseconds flush_interval_msec_;
+  AccessLogFileStats& stats_;
+
+  // These locks are never held together. files_lock_ is held while the files are flushed.
+  Thread::MutexBasicLockable files_lock_;
+  std::vector<AccessLogFileImpl*> files_ ABSL_GUARDED_BY(files_lock_);
+  Thread::MutexBasicLockable flush_lock_;
+  Thread::CondVar flush_event_;
+  bool flush_requested_ ABSL_GUARDED_BY(flush_lock_){false};
+  bool flush_thread_exit_ ABSL_GUARDED_BY(flush_lock_){false};
+  Thread::ThreadPtr flush_thread_;
+};
+
 /**
  * This is a file implementation geared for writing out access logs. It turn out that in certain
  * cases even if a standard file is opened with O_NONBLOCK, the kernel can still block when writing.
  * This implementation uses a flush thread per file, with the idea there aren't that many
- * files. If this turns out to be a good implementation we can potentially have a single flush
- * thread that flushes all files, but we will start with this.
+ * files. Alternatively, each thread can buffer its writes in a buffer of its own, so that workers
+ * writing to the same file don't contend on a lock, and a single flush thread flushes all files.
  */
 class AccessLogFileImpl : public AccessLogFile {
 public:
@@ -68,6 +124,12 @@ public:
                     Thread::BasicLockable& lock, AccessLogFileStats& stats,
                     std::chrono::milliseconds flush_interval_msec,
                     Thread::ThreadFactory& thread_factory);
+  // Buffers the writes of threads in num_worker_buffers buffers, flushed by shared_flush_thread.
+  AccessLogFileImpl(Filesystem::FilePtr&& file, Thread::BasicLockable& lock,
+                    AccessLogFileStats& stats, std::chrono::milliseconds flush_interval_msec,
+                    Thread::ThreadFactory& thread_factory,
+                    SharedAccessLogFlushThreadSharedPtr shared_flush_thread,
+                    uint32_t num_worker_buffers);
   ~AccessLogFileImpl() override;
 
   // AccessLog::AccessLogFile
@@ -81,7 +143,23 @@ public:
   void reopen() override;
   void flush() override;
 
+  /**
+   * Flushes the worker buffers of the file, reopening it first if requested.
+   */
+  void flushWorkerBuffers();
+
 private:
+  // A buffer of the writes of the threads assigned to it, on its own cache line so that threads
+  // writing to different buffers don't contend.
+  struct ABSL_CACHELINE_ALIGNED WorkerBuffer {
+    Thread::MutexBasicLockable lock_;
+    Buffer::OwnedImpl buffer_ ABSL_GUARDED_BY(lock_);
+    // The writes in buffer_, counted in write_buffered once it is flushed.
+    uint64_t writes_ ABSL_GUARDED_BY(lock_){};
+  };
+
+  void writeToWorkerBuffer(absl::string_view data);
+  void moveWorkerBuffers(Buffer::Instance& buffer);
   void doWrite(Buffer::Instance& buffer);
   void flushThreadFunc();
   Api::IoCallBoolResult open();
@@ -92,13 +170,16 @@ private:
 
   // Minimum size before the flush thread will be told to flush.
   static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
+  // Maximum size of a worker buffer, beyond which writes are dropped.
+  static const uint64_t MAX_WORKER_BUFFER_SIZE = MIN_FLUSH_SIZE * 16;
 
   Filesystem::FilePtr file_;
 
   // These locks are always acquired in the following order if multiple locks are held:
   //    1) write_lock_
   //    2) flush_lock_
-  //    3) file_lock_
+  //    3) the lock_ of a WorkerBuffer
+  //    4) file_lock_
   Thread::BasicLockable& file_lock_;      // This lock is used only by the flush thread when writing
                                           // to disk. This is used to make sure that file blocks do
                                           // not get interleaved by multiple processes writing to
@@ -134,6 +215,12 @@ private:
                                                         // matter if it reached the MIN_FLUSH_SIZE
                                                         // or not.
   AccessLogFileStats& stats_;
+  // The worker buffers, if the file has any, which are used instead of flush_buffer_, and flushed
+  // by the shared flush thread instead of the file's own flush thread and flush_timer_.
+  std::vector<WorkerBuffer> worker_buffers_;
+  const SharedAccessLogFlushThreadSharedPtr shared_flush_thread_;
+  // Set when a reopen of a file with worker buffers is requested, until it succeeds.
+  bool reopen_pending_ ABSL_GUARDED_BY(flush_lock_){false};
 };
 
 } // namespace AccessLog
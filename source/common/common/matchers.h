@@ -137,6 +137,11 @@ public:
 
   const StringMatcherType& matcher() const { return matcher_; }
 
+  /**
+   * @return the compiled regex of a safe_regex matcher, or nullptr for other matchers.
+   */
+  const Regex::CompiledMatcher* regex() const { return regex_.get(); }
+
   /**
    * Helps applications optimize the case where a matcher is a case-sensitive
    * prefix-match.
@@ -1,5 +1,7 @@
 #include "source/common/common/regex.h"
 
+#include <algorithm>
+
 #include "envoy/common/exception.h"
 #include "envoy/extensions/regex_engines/v3/google_re2.pb.h"
 #include "envoy/extensions/regex_engines/v3/google_re2.pb.validate.h"
@@ -61,6 +63,41 @@ CompiledGoogleReMatcher::CompiledGoogleReMatcher(
   }
 }
 
+CompiledGoogleReSet::CompiledGoogleReSet() : set_(re2::RE2::Quiet, re2::RE2::ANCHOR_BOTH) {}
+
+bool CompiledGoogleReSet::add(const CompiledMatcher& matcher) {
+  const auto* google_re_matcher = dynamic_cast<const CompiledGoogleReMatcher*>(&matcher);
+  // The regexes are parsed again with the set's options, which are those of every matcher.
+  if (google_re_matcher == nullptr || set_.Add(google_re_matcher->regex().pattern(), nullptr) < 0) {
+    return false;
+  }
+  size_++;
+  return true;
+}
+
+bool CompiledGoogleReSet::compile() { return set_.Compile(); }
+
+bool CompiledGoogleReSet::findMatches(absl::string_view value, std::vector<int>& matches) const {
+  re2::RE2::Set::ErrorInfo error_info;
+  if (!set_.Match(value, &matches, &error_info)) {
+    matches.clear();
+    return error_info.kind == re2::RE2::Set::kNoError;
+  }
+  std::sort(matches.begin(), matches.end());
+  return true;
+}
+
+absl::optional<bool> CompiledGoogleReSet::matchesAny(absl::string_view value) const {
+  re2::RE2::Set::ErrorInfo error_info;
+  if (set_.Match(value, nullptr, &error_info)) {
+    return true;
+  }
+  if (error_info.kind != re2::RE2::Set::kNoError) {
+    return absl::nullopt;
+  }
+  return false;
+}
+
 CompiledMatcherPtr GoogleReEngine::matcher(const std::string& regex) const {
   return std::make_unique<CompiledGoogleReMatcher>(regex, true);
 }
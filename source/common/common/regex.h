@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <regex>
+#include <vector>
 
 #include "envoy/common/regex.h"
 #include "envoy/registry/registry.h"
@@ -12,7 +13,9 @@
 #include "source/common/singleton/threadsafe_singleton.h"
 #include "source/common/stats/symbol_table.h"
 
+#include "absl/types/optional.h"
 #include "re2/re2.h"
+#include "re2/set.h"
 #include "xds/type/matcher/v3/regex.pb.h"
 
 namespace Envoy {
@@ -37,10 +40,58 @@ public:
     return result;
   }
 
+  const re2::RE2& regex() const { return regex_; }
+
 private:
   const re2::RE2 regex_;
 };
 
+/**
+ * A set of regexes compiled by the Google RE2 engine, which finds all the regexes fully matching a
+ * value in a single pass over it, rather than one pass per regex.
+ */
+class CompiledGoogleReSet {
+public:
+  CompiledGoogleReSet();
+
+  /**
+   * Adds the regex of a matcher to the set. Regexes are identified by the order they are added in.
+   * @param matcher the matcher whose regex to add, before the set is compiled.
+   * @return false if the matcher wasn't compiled by the Google RE2 engine, in which case its regex
+   *         can't be added.
+   */
+  bool add(const CompiledMatcher& matcher);
+
+  /**
+   * Compiles the set once all its regexes were added.
+   * @return false if the set couldn't be compiled, in which case it can't be used.
+   */
+  bool compile();
+
+  /**
+   * Finds the regexes fully matching a value.
+   * @param value the value to match.
+   * @param matches receives the indexes of the matching regexes, in increasing order.
+   * @return false if the set ran out of memory matching the value, in which case any regex may
+   *         match it, and each must be matched on its own.
+   */
+  bool findMatches(absl::string_view value, std::vector<int>& matches) const;
+
+  /**
+   * Finds whether any regex fully matches a value.
+   * @param value the value to match.
+   * @return whether any regex matches the value, or nullopt if the set ran out of memory matching
+   *         it, in which case each regex must be matched on its own.
+   */
+  absl::optional<bool> matchesAny(absl::string_view value) const;
+
+  size_t size() const { return size_; }
+
+private:
+  re2::RE2::Set set_;
+  size_t size_{};
+};
+
 class GoogleReEngine : public Engine {
 public:
   CompiledMatcherPtr matcher(const std::string& regex) const override;
@@ -72,6 +72,9 @@ private:
       main_threads_to_usage_count_ ABSL_GUARDED_BY(mutex_);
 };
 
+// The index of the worker running on the current thread plus one, or 0 if it runs no worker.
+thread_local uint32_t worker_slot = 0;
+
 } // namespace
 
 bool MainThread::isMainThread() { return ThreadIds::get().inMainThread(); }
@@ -82,6 +85,13 @@ MainThread::MainThread() { ThreadIds::get().registerMainThread(); }
 
 MainThread::~MainThread() { ThreadIds::get().releaseMainThread(); }
 
+void WorkerIndex::set(uint32_t index) { worker_slot = index + 1; }
+
+uint32_t WorkerIndex::slot(uint32_t num_slots) {
+  ASSERT(num_slots > 0);
+  return worker_slot % num_slots;
+}
+
 #if TEST_THREAD_SUPPORTED
 bool TestThread::isTestThread() {
   // Keep this implementation consistent with TEST_THREAD_SUPPORTED, defined in thread.h.
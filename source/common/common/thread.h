@@ -235,6 +235,24 @@ public:
   static bool isMainThreadActive();
 };
 
+// The index of the worker whose event loop runs on the current thread. Workers set it when their
+// thread starts, so that state split per thread can give each worker a slot of its own however
+// many other threads there are.
+class WorkerIndex {
+public:
+  /**
+   * Records that the current thread runs the worker with the given index.
+   */
+  static void set(uint32_t index);
+
+  /**
+   * @return the slot of the current thread among num_slots slots. Worker N gets slot N + 1,
+   *         wrapping around if there are fewer slots than workers, and the main thread and all
+   *         other threads share slot 0.
+   */
+  static uint32_t slot(uint32_t num_slots);
+};
+
 #define END_TRY }
 
 #ifdef ENVOY_DISABLE_EXCEPTIONS
@@ -5,6 +5,7 @@
 #include "envoy/service/discovery/v3/discovery.pb.h"
 
 #include "source/common/protobuf/utility.h"
+#include "source/common/runtime/runtime_features.h"
 
 #include "xds/core/v3/collection_entry.pb.h"
 
@@ -24,24 +25,41 @@ repeatedPtrFieldToVector(const Protobuf::RepeatedPtrField<std::string>& xs) {
 
 class DecodedResourceImpl;
 using DecodedResourceImplPtr = std::unique_ptr<DecodedResourceImpl>;
+using ArenaSharedPtr = std::shared_ptr<Protobuf::Arena>;
 
 class DecodedResourceImpl : public DecodedResource {
 public:
+  /**
+   * @return an arena to decode the resources of a config update into, or nullptr if they are
+   *         decoded onto the heap. The resources decoded into an arena keep it alive.
+   */
+  static ArenaSharedPtr createArena() {
+    if (!Runtime::runtimeFeatureEnabled("envoy.reloadable_features.xds_arena_decoding")) {
+      return nullptr;
+    }
+    return std::make_shared<Protobuf::Arena>();
+  }
+
   static DecodedResourceImplPtr fromResource(OpaqueResourceDecoder& resource_decoder,
                                              const ProtobufWkt::Any& resource,
-                                             const std::string& version) {
+                                             const std::string& version,
+                                             const ArenaSharedPtr& arena = nullptr) {
     if (resource.Is<envoy::service::discovery::v3::Resource>()) {
-      envoy::service::discovery::v3::Resource r;
+      envoy::service::discovery::v3::Resource heap_resource;
+      envoy::service::discovery::v3::Resource& r =
+          arena != nullptr
+              ? *Protobuf::Arena::Create<envoy::service::discovery::v3::Resource>(arena.get())
+              : heap_resource;
       MessageUtil::unpackTo(resource, r);
 
       r.set_version(version);
 
-      return std::make_unique<DecodedResourceImpl>(resource_decoder, r);
+      return std::make_unique<DecodedResourceImpl>(resource_decoder, r, arena);
     }
 
     return std::unique_ptr<DecodedResourceImpl>(new DecodedResourceImpl(
         resource_decoder, absl::nullopt, Protobuf::RepeatedPtrField<std::string>(), resource, true,
-        version, absl::nullopt, absl::nullopt));
+        version, absl::nullopt, absl::nullopt, arena));
   }
 
   static DecodedResourceImplPtr
@@ -51,19 +69,21 @@ public:
   }
 
   DecodedResourceImpl(OpaqueResourceDecoder& resource_decoder,
-                      const envoy::service::discovery::v3::Resource& resource)
+                      const envoy::service::discovery::v3::Resource& resource,
+                      const ArenaSharedPtr& arena = nullptr)
       : DecodedResourceImpl(
             resource_decoder, resource.name(), resource.aliases(), resource.resource(),
             resource.has_resource(), resource.version(),
             resource.has_ttl() ? absl::make_optional(std::chrono::milliseconds(
                                      DurationUtil::durationToMilliseconds(resource.ttl())))
                                : absl::nullopt,
-            resource.has_metadata() ? absl::make_optional(resource.metadata()) : absl::nullopt) {}
+            resource.has_metadata() ? absl::make_optional(resource.metadata()) : absl::nullopt,
+            arena) {}
   DecodedResourceImpl(OpaqueResourceDecoder& resource_decoder,
                       const xds::core::v3::CollectionEntry::InlineEntry& inline_entry)
       : DecodedResourceImpl(resource_decoder, inline_entry.name(),
                             Protobuf::RepeatedPtrField<std::string>(), inline_entry.resource(),
-                            true, inline_entry.version(), absl::nullopt, absl::nullopt) {}
+                            true, inline_entry.version(), absl::nullopt, absl::nullopt, nullptr) {}
   DecodedResourceImpl(ProtobufTypes::MessagePtr resource, const std::string& name,
                       const std::vector<std::string>& aliases, const std::string& version)
       : resource_(std::move(resource)), has_resource_(true), name_(name), aliases_(aliases),
@@ -85,13 +105,24 @@ private:
                       const Protobuf::RepeatedPtrField<std::string>& aliases,
                       const ProtobufWkt::Any& resource, bool has_resource,
                       const std::string& version, absl::optional<std::chrono::milliseconds> ttl,
-                      const absl::optional<envoy::config::core::v3::Metadata>& metadata)
-      : resource_(resource_decoder.decodeResource(resource)), has_resource_(has_resource),
+                      const absl::optional<envoy::config::core::v3::Metadata>& metadata,
+                      const ArenaSharedPtr& arena)
+      : resource_(decodeResource(resource_decoder, resource, arena)), has_resource_(has_resource),
         name_(name ? *name : resource_decoder.resourceName(*resource_)),
         aliases_(repeatedPtrFieldToVector(aliases)), version_(version), ttl_(ttl),
         metadata_(metadata) {}
 
-  const ProtobufTypes::MessagePtr resource_;
+  static std::shared_ptr<const Protobuf::Message>
+  decodeResource(OpaqueResourceDecoder& resource_decoder, const ProtobufWkt::Any& resource,
+                 const ArenaSharedPtr& arena) {
+    if (arena == nullptr) {
+      return resource_decoder.decodeResource(resource);
+    }
+    // The resource shares the ownership of its arena.
+    return {arena, resource_decoder.decodeResource(resource, *arena)};
+  }
+
+  const std::shared_ptr<const Protobuf::Message> resource_;
   const bool has_resource_;
   const std::string name_;
   const std::vector<std::string> aliases_;
@@ -109,8 +140,9 @@ struct DecodedResourcesWrapper {
   DecodedResourcesWrapper(OpaqueResourceDecoder& resource_decoder,
                           const Protobuf::RepeatedPtrField<ProtobufWkt::Any>& resources,
                           const std::string& version) {
+    const ArenaSharedPtr arena = DecodedResourceImpl::createArena();
     for (const auto& resource : resources) {
-      pushBack((DecodedResourceImpl::fromResource(resource_decoder, resource, version)));
+      pushBack((DecodedResourceImpl::fromResource(resource_decoder, resource, version, arena)));
     }
   }
 
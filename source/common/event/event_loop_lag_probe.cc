@@ -0,0 +1,64 @@
+#include "source/common/event/event_loop_lag_probe.h"
+
+#include <algorithm>
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Event {
+
+namespace {
+
+int64_t nanoseconds(MonotonicTime time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+EventLoopLagProbeSharedPtr EventLoopLagProbe::acquire(Dispatcher& dispatcher,
+                                                      std::chrono::milliseconds interval) {
+  // A dispatcher only runs on one thread, so the probes of the thread's dispatchers are all that
+  // need to be looked up. Released probes are left behind until the next acquisition rather than
+  // removed by the probe, which may outlive the map when destroyed at thread exit.
+  static thread_local absl::flat_hash_map<const Dispatcher*, std::weak_ptr<EventLoopLagProbe>>
+      probes;
+  absl::erase_if(probes, [](const auto& entry) { return entry.second.expired(); });
+
+  std::weak_ptr<EventLoopLagProbe>& entry = probes[&dispatcher];
+  EventLoopLagProbeSharedPtr probe = entry.lock();
+  if (probe == nullptr) {
+    probe = std::make_shared<EventLoopLagProbe>(dispatcher, interval);
+    entry = probe;
+  } else {
+    // The next probe is scheduled at the shorter interval.
+    probe->interval_ = std::min(probe->interval_, interval);
+  }
+  return probe;
+}
+
+EventLoopLagProbe::EventLoopLagProbe(Dispatcher& dispatcher, std::chrono::milliseconds interval)
+    : time_source_(dispatcher.timeSource()), interval_(interval),
+      timer_(dispatcher.createTimer([this]() { onProbe(); })) {
+  schedule(time_source_.monotonicTime());
+}
+
+std::chrono::nanoseconds EventLoopLagProbe::lag(MonotonicTime now) const {
+  return std::chrono::nanoseconds(std::max(lag_.load(std::memory_order_relaxed),
+                                           nanoseconds(now) -
+                                               deadline_.load(std::memory_order_relaxed)));
+}
+
+void EventLoopLagProbe::schedule(MonotonicTime now) {
+  deadline_.store(nanoseconds(now + interval_), std::memory_order_relaxed);
+  timer_->enableTimer(interval_);
+}
+
+void EventLoopLagProbe::onProbe() {
+  const MonotonicTime now = time_source_.monotonicTime();
+  lag_.store(std::max<int64_t>(0, nanoseconds(now) - deadline_.load(std::memory_order_relaxed)),
+             std::memory_order_relaxed);
+  schedule(now);
+}
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+
+namespace Envoy {
+namespace Event {
+
+class EventLoopLagProbe;
+using EventLoopLagProbeSharedPtr = std::shared_ptr<EventLoopLagProbe>;
+
+/**
+ * Measures the lag of a dispatcher's event loop as how late a periodic timer on it fires. There is
+ * at most one probe per dispatcher, which is shared by all users of the dispatcher's lag. The probe
+ * is acquired and released on the dispatcher's thread, but its lag may be read from any thread.
+ */
+class EventLoopLagProbe {
+public:
+  /**
+   * @param dispatcher supplies the dispatcher whose event loop to probe, which must be running on
+   *        the calling thread.
+   * @param interval supplies how often to probe the event loop. A probe which is already shared
+   *        probes at the shortest interval that it was acquired with.
+   * @return the probe of the dispatcher.
+   */
+  static EventLoopLagProbeSharedPtr acquire(Dispatcher& dispatcher,
+                                            std::chrono::milliseconds interval);
+
+  /**
+   * @param now supplies the current monotonic time.
+   * @return how late the last probe ran. While the next probe is overdue, the lag is at least how
+   *         long it has been overdue, so that an event loop stuck in a long callback is noticed
+   *         before it returns.
+   */
+  std::chrono::nanoseconds lag(MonotonicTime now) const;
+
+  EventLoopLagProbe(Dispatcher& dispatcher, std::chrono::milliseconds interval);
+
+private:
+  void schedule(MonotonicTime now);
+  void onProbe();
+
+  TimeSource& time_source_;
+  // Only accessed on the dispatcher's thread.
+  std::chrono::milliseconds interval_;
+  TimerPtr timer_;
+  // The last measured lag and when the next probe is due, in nanoseconds of monotonic time.
+  std::atomic<int64_t> lag_{};
+  std::atomic<int64_t> deadline_{};
+};
+
+} // namespace Event
+} // namespace Envoy
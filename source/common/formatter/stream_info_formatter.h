@@ -221,6 +221,9 @@ public:
     return str_;
   }
 
+  // The string literal, which formatters can write into their output ahead of time.
+  const std::string& value() const { return str_.string_value(); }
+
 private:
   ProtobufWkt::Value str_;
 };
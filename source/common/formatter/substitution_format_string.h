@@ -12,6 +12,7 @@
 #include "source/common/formatter/substitution_formatter.h"
 #include "source/common/protobuf/message_validator_impl.h"
 #include "source/common/protobuf/protobuf.h"
+#include "source/common/runtime/runtime_features.h"
 #include "source/server/generic_factory_context.h"
 
 namespace Envoy {
@@ -52,7 +53,7 @@ public:
       return std::make_unique<FormatterBaseImpl<FormatterContext>>(
           config.text_format(), config.omit_empty_values(), commands);
     case envoy::config::core::v3::SubstitutionFormatString::FormatCase::kJsonFormat:
-      return std::make_unique<JsonFormatterBaseImpl<FormatterContext>>(
+      return createJsonFormatter<FormatterContext>(
           config.json_format(), true, config.omit_empty_values(),
           config.has_json_format_options() ? config.json_format_options().sort_properties() : false,
           commands);
@@ -74,9 +75,16 @@ public:
   template <class FormatterContext = HttpFormatterContext>
   static FormatterBasePtr<FormatterContext>
   createJsonFormatter(const ProtobufWkt::Struct& struct_format, bool preserve_types,
-                      bool omit_empty_values, bool sort_properties) {
+                      bool omit_empty_values, bool sort_properties,
+                      const CommandParsersBase<FormatterContext>& commands = {}) {
+    // The compiled formatter always sorts properties, and can't omit empty values.
+    if (!omit_empty_values && Runtime::runtimeFeatureEnabled(
+                                  "envoy.reloadable_features.compiled_json_access_log_formatter")) {
+      return std::make_unique<CompiledJsonFormatterBaseImpl<FormatterContext>>(
+          struct_format, preserve_types, commands);
+    }
     return std::make_unique<JsonFormatterBaseImpl<FormatterContext>>(
-        struct_format, preserve_types, omit_empty_values, sort_properties);
+        struct_format, preserve_types, omit_empty_values, sort_properties, commands);
   }
 };
 
@@ -1,5 +1,9 @@
 #include "source/common/formatter/substitution_formatter.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
 namespace Envoy {
 namespace Formatter {
 
@@ -54,5 +58,113 @@ const std::regex& SubstitutionFormatParser::commandWithArgsRegex() {
   // clang-format on
 }
 
+std::vector<std::pair<absl::string_view, const ProtobufWkt::Value*>>
+JsonFormatterUtils::sortedFields(const ProtobufWkt::Struct& value) {
+  std::vector<std::pair<absl::string_view, const ProtobufWkt::Value*>> fields;
+  fields.reserve(value.fields().size());
+  for (const auto& [key, field] : value.fields()) {
+    fields.emplace_back(key, &field);
+  }
+  std::sort(fields.begin(), fields.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+  return fields;
+}
+
+void JsonFormatterUtils::appendString(absl::string_view str, std::string& output) {
+  output.push_back('"');
+  appendSanitized(str, output);
+  output.push_back('"');
+}
+
+void JsonFormatterUtils::appendSanitized(absl::string_view str, std::string& output) {
+  // Json::sanitize() can't be used as it asserts it runs on the main thread, and only the
+  // characters JSON requires escaping are escaped here, so that non-ASCII UTF-8 is copied as is.
+  size_t start = 0;
+  for (size_t i = 0; i < str.size(); i++) {
+    const char c = str[i];
+    if (c != '"' && c != '\\' && static_cast<uint8_t>(c) >= 0x20) {
+      continue;
+    }
+    output.append(str.data() + start, i - start);
+    start = i + 1;
+    switch (c) {
+    case '"':
+      output.append("\\\"");
+      break;
+    case '\\':
+      output.append("\\\\");
+      break;
+    case '\b':
+      output.append("\\b");
+      break;
+    case '\f':
+      output.append("\\f");
+      break;
+    case '\n':
+      output.append("\\n");
+      break;
+    case '\r':
+      output.append("\\r");
+      break;
+    case '\t':
+      output.append("\\t");
+      break;
+    default:
+      fmt::format_to(std::back_inserter(output), "\\u{:04x}", static_cast<uint8_t>(c));
+    }
+  }
+  output.append(str.data() + start, str.size() - start);
+}
+
+void JsonFormatterUtils::appendNumber(double number, std::string& output) {
+  if (!std::isfinite(number)) {
+    output.append("null");
+    return;
+  }
+  fmt::format_to(std::back_inserter(output), "{}", number);
+}
+
+void JsonFormatterUtils::appendValue(const ProtobufWkt::Value& value, std::string& output) {
+  switch (value.kind_case()) {
+  case ProtobufWkt::Value::kStringValue:
+    appendString(value.string_value(), output);
+    break;
+  case ProtobufWkt::Value::kNumberValue:
+    appendNumber(value.number_value(), output);
+    break;
+  case ProtobufWkt::Value::kBoolValue:
+    output.append(value.bool_value() ? "true" : "false");
+    break;
+  case ProtobufWkt::Value::kStructValue: {
+    const auto fields = sortedFields(value.struct_value());
+    output.push_back('{');
+    for (size_t i = 0; i < fields.size(); i++) {
+      if (i > 0) {
+        output.push_back(',');
+      }
+      appendString(fields[i].first, output);
+      output.push_back(':');
+      appendValue(*fields[i].second, output);
+    }
+    output.push_back('}');
+    break;
+  }
+  case ProtobufWkt::Value::kListValue:
+    output.push_back('[');
+    for (int i = 0; i < value.list_value().values_size(); i++) {
+      if (i > 0) {
+        output.push_back(',');
+      }
+      appendValue(value.list_value().values(i), output);
+    }
+    output.push_back(']');
+    break;
+  case ProtobufWkt::Value::kNullValue:
+  case ProtobufWkt::Value::KIND_NOT_SET:
+    output.append("null");
+    break;
+  }
+}
+
 } // namespace Formatter
 } // namespace Envoy
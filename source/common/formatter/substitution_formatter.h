@@ -4,6 +4,7 @@
 #include <functional>
 #include <list>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "envoy/common/time.h"
@@ -142,12 +143,14 @@ public:
       : empty_value_string_(omit_empty_values ? absl::string_view{}
                                               : DefaultUnspecifiedValueStringView) {
     providers_ = SubstitutionFormatParser::parse<FormatterContext>(format);
+    compile();
   }
   CommonFormatterBaseImpl(const std::string& format, bool omit_empty_values,
                           const CommandParsers& command_parsers)
       : empty_value_string_(omit_empty_values ? absl::string_view{}
                                               : DefaultUnspecifiedValueStringView) {
     providers_ = SubstitutionFormatParser::parse<FormatterContext>(format, command_parsers);
+    compile();
   }
 
   // FormatterBase
@@ -156,17 +159,43 @@ public:
     std::string log_line;
     log_line.reserve(256);
 
-    for (const auto& provider : providers_) {
-      const auto bit = provider->formatWithContext(context, stream_info);
-      log_line += bit.value_or(empty_value_string_);
+    for (const Segment& segment : segments_) {
+      log_line.append(segment.literal_);
+      const auto bit = segment.provider_->formatWithContext(context, stream_info);
+      log_line.append(bit.has_value() ? *bit : empty_value_string_);
     }
+    log_line.append(trailing_literal_);
 
     return log_line;
   }
 
 private:
+  // A provider with the literal text preceding it in the format.
+  struct Segment {
+    std::string literal_;
+    const FormatterProviderBase<FormatterContext>* provider_;
+  };
+
+  // Literals are merged with each other and written ahead of the provider following them,
+  // instead of being copied out of a provider of their own for each formatted line.
+  void compile() {
+    std::string literal;
+    for (const auto& provider : providers_) {
+      const auto* plain_string =
+          dynamic_cast<const CommonPlainStringFormatterBase<FormatterContext>*>(provider.get());
+      if (plain_string != nullptr) {
+        literal.append(plain_string->value());
+        continue;
+      }
+      segments_.push_back({std::exchange(literal, {}), provider.get()});
+    }
+    trailing_literal_ = std::move(literal);
+  }
+
   const std::string empty_value_string_;
   std::vector<FormatterProviderBasePtr<FormatterContext>> providers_;
+  std::vector<Segment> segments_;
+  std::string trailing_literal_;
 };
 
 template <class FormatterContext>
@@ -422,12 +451,195 @@ public:
   using CommonJsonFormatterBaseImpl<FormatterContext>::CommonJsonFormatterBaseImpl;
 };
 
+/**
+ * Utilities for writing JSON directly into a log line.
+ */
+class JsonFormatterUtils {
+public:
+  /**
+   * @return the fields of a struct, in the order of their keys.
+   */
+  static std::vector<std::pair<absl::string_view, const ProtobufWkt::Value*>>
+  sortedFields(const ProtobufWkt::Struct& value);
+
+  /**
+   * Appends a string as a quoted JSON string.
+   * @param str the string to append.
+   * @param output the string to append to.
+   */
+  static void appendString(absl::string_view str, std::string& output);
+
+  /**
+   * Appends a string within a quoted JSON string, escaping the characters JSON requires escaping.
+   */
+  static void appendSanitized(absl::string_view str, std::string& output);
+
+  /**
+   * Appends a number as a JSON number, or null if it isn't finite.
+   */
+  static void appendNumber(double number, std::string& output);
+
+  /**
+   * Appends a value as JSON. Struct fields are appended in the order of their keys.
+   */
+  static void appendValue(const ProtobufWkt::Value& value, std::string& output);
+};
+
+/**
+ * JSON formatter which compiles its format into the JSON text between the values to format,
+ * written into the log line along with the values without building a Struct first. Properties
+ * are always written in the order of their keys. Empty values can't be omitted, as which
+ * properties are written would then only be known once the values are formatted.
+ */
+template <class FormatterContext>
+class CompiledJsonFormatterBaseImpl : public FormatterBase<FormatterContext> {
+public:
+  using CommandParsers = std::vector<CommandParserBasePtr<FormatterContext>>;
+
+  CompiledJsonFormatterBaseImpl(const ProtobufWkt::Struct& format_mapping, bool preserve_types,
+                                const CommandParsers& commands = {})
+      : preserve_types_(preserve_types) {
+    std::string literal;
+    compileStruct(format_mapping, commands, literal);
+    literal.push_back('\n');
+    trailing_literal_ = std::move(literal);
+  }
+
+  // FormatterBase
+  std::string formatWithContext(const FormatterContext& context,
+                                const StreamInfo::StreamInfo& stream_info) const override {
+    std::string log_line;
+    log_line.reserve(256);
+
+    for (const Segment& segment : segments_) {
+      log_line.append(segment.literal_);
+      if (segment.in_string_) {
+        const auto bit = segment.provider_->formatWithContext(context, stream_info);
+        JsonFormatterUtils::appendSanitized(
+            bit.has_value() ? absl::string_view(*bit) : DefaultUnspecifiedValueStringView,
+            log_line);
+      } else if (preserve_types_) {
+        JsonFormatterUtils::appendValue(
+            segment.provider_->formatValueWithContext(context, stream_info), log_line);
+      } else {
+        const auto bit = segment.provider_->formatWithContext(context, stream_info);
+        JsonFormatterUtils::appendString(
+            bit.has_value() ? absl::string_view(*bit) : DefaultUnspecifiedValueStringView,
+            log_line);
+      }
+    }
+    log_line.append(trailing_literal_);
+
+    return log_line;
+  }
+
+private:
+  // A provider with the JSON text preceding it.
+  struct Segment {
+    std::string literal_;
+    const FormatterProviderBase<FormatterContext>* provider_;
+    // Whether the provider formats part of a string, as one of several providers of a value.
+    bool in_string_;
+  };
+
+  void addSegment(FormatterProviderBasePtr<FormatterContext> provider, bool in_string,
+                  std::string& literal) {
+    segments_.push_back({std::exchange(literal, {}), provider.get(), in_string});
+    providers_.push_back(std::move(provider));
+  }
+
+  void compileStruct(const ProtobufWkt::Struct& format, const CommandParsers& commands,
+                     std::string& literal) {
+    const auto fields = JsonFormatterUtils::sortedFields(format);
+    literal.push_back('{');
+    for (size_t i = 0; i < fields.size(); i++) {
+      if (i > 0) {
+        literal.push_back(',');
+      }
+      JsonFormatterUtils::appendString(fields[i].first, literal);
+      literal.push_back(':');
+      compileValue(*fields[i].second, commands, literal);
+    }
+    literal.push_back('}');
+  }
+
+  void compileList(const ProtobufWkt::ListValue& format, const CommandParsers& commands,
+                   std::string& literal) {
+    literal.push_back('[');
+    for (int i = 0; i < format.values_size(); i++) {
+      if (i > 0) {
+        literal.push_back(',');
+      }
+      compileValue(format.values(i), commands, literal);
+    }
+    literal.push_back(']');
+  }
+
+  void compileValue(const ProtobufWkt::Value& format, const CommandParsers& commands,
+                    std::string& literal) {
+    switch (format.kind_case()) {
+    case ProtobufWkt::Value::kStringValue:
+      compileString(format.string_value(), commands, literal);
+      break;
+    case ProtobufWkt::Value::kStructValue:
+      compileStruct(format.struct_value(), commands, literal);
+      break;
+    case ProtobufWkt::Value::kListValue:
+      compileList(format.list_value(), commands, literal);
+      break;
+    case ProtobufWkt::Value::kNumberValue:
+      if (preserve_types_) {
+        JsonFormatterUtils::appendNumber(format.number_value(), literal);
+      } else {
+        JsonFormatterUtils::appendString(absl::StrFormat("%g", format.number_value()), literal);
+      }
+      break;
+    default:
+      throwEnvoyExceptionOrPanic(
+          "Only string values, nested structs, list values and number values are "
+          "supported in structured access log format.");
+    }
+  }
+
+  void compileString(const std::string& format, const CommandParsers& commands,
+                     std::string& literal) {
+    auto providers = SubstitutionFormatParser::parse<FormatterContext>(format, commands);
+    const auto as_plain_string = [](const FormatterProviderBasePtr<FormatterContext>& provider) {
+      return dynamic_cast<const CommonPlainStringFormatterBase<FormatterContext>*>(provider.get());
+    };
+
+    if (providers.size() == 1 && as_plain_string(providers.front()) == nullptr) {
+      // A single provider formats the whole value, with its type if types are preserved.
+      addSegment(std::move(providers.front()), false, literal);
+      return;
+    }
+
+    // Multiple providers force string output.
+    literal.push_back('"');
+    for (auto& provider : providers) {
+      const auto* plain_string = as_plain_string(provider);
+      if (plain_string != nullptr) {
+        JsonFormatterUtils::appendSanitized(plain_string->value(), literal);
+      } else {
+        addSegment(std::move(provider), true, literal);
+      }
+    }
+    literal.push_back('"');
+  }
+
+  const bool preserve_types_;
+  std::vector<FormatterProviderBasePtr<FormatterContext>> providers_;
+  std::vector<Segment> segments_;
+  std::string trailing_literal_;
+};
+
 using StructFormatter = StructFormatterBase<HttpFormatterContext>;
 using StructFormatterPtr = std::unique_ptr<StructFormatter>;
 
 // Aliases for backwards compatibility.
 using FormatterImpl = FormatterBaseImpl<HttpFormatterContext>;
 using JsonFormatterImpl = JsonFormatterBaseImpl<HttpFormatterContext>;
+using CompiledJsonFormatterImpl = CompiledJsonFormatterBaseImpl<HttpFormatterContext>;
 
 } // namespace Formatter
 } // namespace Envoy
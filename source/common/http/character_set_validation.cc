@@ -0,0 +1,128 @@
+#include "source/common/http/character_set_validation.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ENVOY_CHAR_TABLE_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace Envoy {
+namespace Http {
+
+#ifdef ENVOY_CHAR_TABLE_SCANNER_X86
+namespace {
+
+// The vectorized scans start at position i of value, and return the position of the first
+// character not in the table, or the position of the remaining characters too few to be tested at
+// once.
+
+__attribute__((target("ssse3"))) size_t
+findFirstNotInTableSsse3(const std::array<uint8_t, 16>& ascii_nibbles, bool all_extended_chars,
+                         absl::string_view value, size_t i) {
+  const __m128i nibbles = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ascii_nibbles.data()));
+  // Maps a high nibble to its bit in nibbles, or to 0 for extended ASCII characters.
+  const __m128i high_nibble_bits =
+      _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i low_nibble_mask = _mm_set1_epi8(0x0f);
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= value.size(); i += 16) {
+    const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(value.data() + i));
+    const __m128i low_nibbles = _mm_and_si128(chars, low_nibble_mask);
+    const __m128i high_nibbles = _mm_and_si128(_mm_srli_epi16(chars, 4), low_nibble_mask);
+    const __m128i in_table = _mm_and_si128(_mm_shuffle_epi8(nibbles, low_nibbles),
+                                           _mm_shuffle_epi8(high_nibble_bits, high_nibbles));
+    __m128i not_in_table = _mm_cmpeq_epi8(in_table, zero);
+    if (all_extended_chars) {
+      not_in_table = _mm_andnot_si128(_mm_cmplt_epi8(chars, zero), not_in_table);
+    }
+    const uint32_t mask = _mm_movemask_epi8(not_in_table);
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return i;
+}
+
+__attribute__((target("avx2"))) size_t
+findFirstNotInTableAvx2(const std::array<uint8_t, 16>& ascii_nibbles, bool all_extended_chars,
+                        absl::string_view value) {
+  // Shuffles look up each 128 bit lane separately, so both lanes hold the lookup tables.
+  const __m256i nibbles = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(ascii_nibbles.data())));
+  const __m256i high_nibble_bits =
+      _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64,
+                       -128, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m256i low_nibble_mask = _mm256_set1_epi8(0x0f);
+  const __m256i zero = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 32 <= value.size(); i += 32) {
+    const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(value.data() + i));
+    const __m256i low_nibbles = _mm256_and_si256(chars, low_nibble_mask);
+    const __m256i high_nibbles = _mm256_and_si256(_mm256_srli_epi16(chars, 4), low_nibble_mask);
+    const __m256i in_table = _mm256_and_si256(_mm256_shuffle_epi8(nibbles, low_nibbles),
+                                              _mm256_shuffle_epi8(high_nibble_bits, high_nibbles));
+    __m256i not_in_table = _mm256_cmpeq_epi8(in_table, zero);
+    if (all_extended_chars) {
+      not_in_table = _mm256_andnot_si256(_mm256_cmpgt_epi8(zero, chars), not_in_table);
+    }
+    const uint32_t mask = _mm256_movemask_epi8(not_in_table);
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  // AVX2 CPUs also support SSSE3, with which a remaining 16 characters can still be tested at once.
+  // The upper halves of the registers must be cleared before running SSE instructions, which is
+  // otherwise slow, and compilers don't always do so before tail calls.
+  _mm256_zeroupper();
+  return findFirstNotInTableSsse3(ascii_nibbles, all_extended_chars, value, i);
+}
+
+enum class CpuSupport { None, Ssse3, Avx2 };
+
+CpuSupport cpuSupport() {
+  static const CpuSupport support = []() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      return CpuSupport::Avx2;
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+      return CpuSupport::Ssse3;
+    }
+    return CpuSupport::None;
+  }();
+  return support;
+}
+
+} // namespace
+#endif
+
+size_t CharTableScanner::findFirstNotInTable(absl::string_view value) const {
+  size_t start = 0;
+#ifdef ENVOY_CHAR_TABLE_SCANNER_X86
+  // Short strings aren't worth setting up the vector registers for.
+  if (vectorizable_ && value.size() >= 16) {
+    switch (cpuSupport()) {
+    case CpuSupport::Avx2:
+      start = findFirstNotInTableAvx2(ascii_nibbles_, all_extended_chars_, value);
+      break;
+    case CpuSupport::Ssse3:
+      start = findFirstNotInTableSsse3(ascii_nibbles_, all_extended_chars_, value, 0);
+      break;
+    case CpuSupport::None:
+      break;
+    }
+  }
+#endif
+  return findFirstNotInTableScalar(value, start);
+}
+
+size_t CharTableScanner::findFirstNotInTableScalar(absl::string_view value, size_t start) const {
+  for (size_t i = start; i < value.size(); ++i) {
+    if (!testCharInTable(table_, value[i])) {
+      return i;
+    }
+  }
+  return value.size();
+}
+
+} // namespace Http
+} // namespace Envoy
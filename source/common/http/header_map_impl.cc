@@ -1,5 +1,7 @@
 #include "source/common/http/header_map_impl.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -54,6 +56,39 @@ template <> bool HeaderMapImpl::HeaderList::isPseudoHeader(const LowerCaseString
   return key.get().c_str()[0] == ':';
 }
 
+HeaderMapImpl::HeaderNodePool::~HeaderNodePool() {
+  for (void* chunk : chunks_) {
+    ::operator delete(chunk);
+  }
+}
+
+void* HeaderMapImpl::HeaderNodePool::allocate(size_t size) {
+  if (free_nodes_ != nullptr) {
+    ASSERT(size <= node_size_);
+    FreeNode* node = free_nodes_;
+    free_nodes_ = node->next_;
+    return node;
+  }
+  if (chunk_next_ == chunk_end_) {
+    // Keep the nodes aligned as operator new would.
+    node_size_ = (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+    chunk_next_ = static_cast<char*>(::operator new(node_size_ * next_chunk_nodes_));
+    chunk_end_ = chunk_next_ + node_size_ * next_chunk_nodes_;
+    chunks_.push_back(chunk_next_);
+    next_chunk_nodes_ = std::min(next_chunk_nodes_ * 2, MaxChunkNodes);
+  }
+  ASSERT(size <= node_size_);
+  void* node = chunk_next_;
+  chunk_next_ += node_size_;
+  return node;
+}
+
+void HeaderMapImpl::HeaderNodePool::deallocate(void* node) {
+  FreeNode* free_node = static_cast<FreeNode*>(node);
+  free_node->next_ = free_nodes_;
+  free_nodes_ = free_node;
+}
+
 bool HeaderMapImpl::HeaderList::maybeMakeMap() {
   if (lazy_map_.empty()) {
     if (headers_.size() < kMinHeadersForLazyMap) {
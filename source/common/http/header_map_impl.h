@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -15,6 +16,8 @@
 #include "source/common/http/headers.h"
 #include "source/common/runtime/runtime_features.h"
 
+#include "absl/container/inlined_vector.h"
+
 namespace Envoy {
 namespace Http {
 
@@ -112,6 +115,79 @@ public:
   StatefulHeaderKeyFormatterOptRef formatter() { return makeOptRefFromPtr(formatter_.get()); }
 
 protected:
+  /**
+   * Allocates the nodes of a HeaderList from chunks of memory owned by the list, reusing the nodes
+   * of removed headers. A header map thus allocates memory for its headers a few times rather than
+   * once per header, and frees it all at once when destroyed. The chunks grow geometrically so
+   * that maps with few headers, such as trailers, stay small.
+   */
+  class HeaderNodePool : NonCopyable {
+  public:
+    HeaderNodePool() = default;
+    ~HeaderNodePool();
+
+    // All the nodes allocated from a pool have the same size.
+    void* allocate(size_t size);
+    void deallocate(void* node);
+
+  private:
+    static constexpr uint32_t InitialChunkNodes = 4;
+    static constexpr uint32_t MaxChunkNodes = 64;
+
+    struct FreeNode {
+      FreeNode* next_;
+    };
+
+    FreeNode* free_nodes_{};
+    char* chunk_next_{};
+    char* chunk_end_{};
+    size_t node_size_{};
+    uint32_t next_chunk_nodes_{InitialChunkNodes};
+    absl::InlinedVector<void*, 4> chunks_;
+  };
+
+  /**
+   * Standard allocator for the nodes of a HeaderList, backed by its HeaderNodePool.
+   */
+  template <class T> class HeaderNodeAllocator {
+  public:
+    using value_type = T;
+
+    explicit HeaderNodeAllocator(HeaderNodePool& pool) : pool_(&pool) {}
+    template <class U>
+    HeaderNodeAllocator(const HeaderNodeAllocator<U>& other) : pool_(other.pool_) {}
+
+    T* allocate(size_t n) {
+      static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned header list node");
+      if (n != 1) {
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+      }
+      return static_cast<T*>(pool_->allocate(sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) {
+      if (n != 1) {
+        ::operator delete(p);
+        return;
+      }
+      pool_->deallocate(p);
+    }
+
+    template <class U> bool operator==(const HeaderNodeAllocator<U>& other) const {
+      return pool_ == other.pool_;
+    }
+    template <class U> bool operator!=(const HeaderNodeAllocator<U>& other) const {
+      return pool_ != other.pool_;
+    }
+
+  private:
+    template <class U> friend class HeaderNodeAllocator;
+
+    HeaderNodePool* pool_;
+  };
+
+  struct HeaderEntryImpl;
+  using HeaderEntryList = std::list<HeaderEntryImpl, HeaderNodeAllocator<HeaderEntryImpl>>;
+
   struct HeaderEntryImpl : public HeaderEntry, NonCopyable {
     HeaderEntryImpl(const LowerCaseString& key);
     HeaderEntryImpl(const LowerCaseString& key, HeaderString&& value);
@@ -127,9 +203,9 @@ protected:
 
     HeaderString key_;
     HeaderString value_;
-    std::list<HeaderEntryImpl>::iterator entry_;
+    HeaderEntryList::iterator entry_;
   };
-  using HeaderNode = std::list<HeaderEntryImpl>::iterator;
+  using HeaderNode = HeaderEntryList::iterator;
 
   /**
    * This is the static lookup table that is used to determine whether a header is one of the O(1)
@@ -202,7 +278,9 @@ protected:
     using HeaderNodeVector = absl::InlinedVector<HeaderNode, 1>;
     using HeaderLazyMap = absl::flat_hash_map<absl::string_view, HeaderNodeVector>;
 
-    HeaderList() : pseudo_headers_end_(headers_.end()) {}
+    HeaderList()
+        : headers_(HeaderNodeAllocator<HeaderEntryImpl>(pool_)),
+          pseudo_headers_end_(headers_.end()) {}
 
     template <class Key> bool isPseudoHeader(const Key& key) {
       return !key.getStringView().empty() && key.getStringView()[0] == ':';
@@ -292,12 +370,12 @@ protected:
      */
     size_t remove(absl::string_view key);
 
-    std::list<HeaderEntryImpl>::iterator begin() { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::iterator end() { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_iterator begin() const { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::const_iterator end() const { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rend() const { return headers_.rend(); }
+    HeaderEntryList::iterator begin() { return headers_.begin(); }
+    HeaderEntryList::iterator end() { return headers_.end(); }
+    HeaderEntryList::const_iterator begin() const { return headers_.begin(); }
+    HeaderEntryList::const_iterator end() const { return headers_.end(); }
+    HeaderEntryList::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
+    HeaderEntryList::const_reverse_iterator rend() const { return headers_.rend(); }
     HeaderLazyMap::iterator mapFind(absl::string_view key) { return lazy_map_.find(key); }
     HeaderLazyMap::iterator mapEnd() { return lazy_map_.end(); }
     size_t size() const { return headers_.size(); }
@@ -309,7 +387,9 @@ protected:
     }
 
   private:
-    std::list<HeaderEntryImpl> headers_;
+    // The pool must outlive the list whose nodes it holds.
+    HeaderNodePool pool_;
+    HeaderEntryList headers_;
     HeaderNode pseudo_headers_end_;
     HeaderLazyMap lazy_map_;
   };
@@ -1,8 +1,12 @@
 #include "source/common/io/io_uring_worker_impl.h"
 
+#include "source/common/api/os_sys_calls_impl.h"
+
 namespace Envoy {
 namespace Io {
 
+AcceptRequest::AcceptRequest(IoUringSocket& socket) : Request(RequestType::Accept, socket) {}
+
 ReadRequest::ReadRequest(IoUringSocket& socket, uint32_t size)
     : Request(RequestType::Read, socket), buf_(std::make_unique<uint8_t[]>(size)),
       iov_(std::make_unique<struct iovec>()) {
@@ -123,6 +127,15 @@ IoUringSocket& IoUringWorkerImpl::addClientSocket(os_fd_t fd, Event::FileReadyCb
   return addSocket(std::move(socket));
 }
 
+IoUringSocket& IoUringWorkerImpl::addAcceptSocket(os_fd_t fd, Event::FileReadyCb cb,
+                                                  bool enable_close_event) {
+  ENVOY_LOG(trace, "add accept socket, fd = {}", fd);
+  std::unique_ptr<IoUringAcceptSocket> socket =
+      std::make_unique<IoUringAcceptSocket>(fd, *this, std::move(cb), enable_close_event);
+  socket->enableRead();
+  return addSocket(std::move(socket));
+}
+
 Event::Dispatcher& IoUringWorkerImpl::dispatcher() { return dispatcher_; }
 
 IoUringSocketEntry& IoUringWorkerImpl::addSocket(IoUringSocketEntryPtr&& socket) {
@@ -130,6 +143,26 @@ IoUringSocketEntry& IoUringWorkerImpl::addSocket(IoUringSocketEntryPtr&& socket)
   return *sockets_.back();
 }
 
+Request* IoUringWorkerImpl::submitAcceptRequest(IoUringSocket& socket) {
+  AcceptRequest* req = new AcceptRequest(socket);
+
+  ENVOY_LOG(trace, "submit accept request, fd = {}, accept req = {}", socket.fd(), fmt::ptr(req));
+
+  auto res =
+      io_uring_->prepareAccept(socket.fd(), reinterpret_cast<struct sockaddr*>(&req->remote_addr_),
+                               &req->remote_addr_len_, req);
+  if (res == IoUringResult::Failed) {
+    // TODO(rojkov): handle `EBUSY` in case the completion queue is never reaped.
+    submit();
+    res = io_uring_->prepareAccept(socket.fd(),
+                                   reinterpret_cast<struct sockaddr*>(&req->remote_addr_),
+                                   &req->remote_addr_len_, req);
+    RELEASE_ASSERT(res == IoUringResult::Ok, "unable to prepare accept");
+  }
+  submit();
+  return req;
+}
+
 Request*
 IoUringWorkerImpl::submitConnectRequest(IoUringSocket& socket,
                                         const Network::Address::InstanceConstSharedPtr& address) {
@@ -674,5 +707,149 @@ void IoUringClientSocket::onConnect(Request* req, int32_t result, bool injected)
   parent_.injectCompletion(*this, Request::RequestType::Write, result);
 }
 
+IoUringAcceptSocket::IoUringAcceptSocket(os_fd_t fd, IoUringWorkerImpl& parent,
+                                         Event::FileReadyCb cb, bool enable_close_event)
+    : IoUringSocketEntry(fd, parent, std::move(cb), enable_close_event) {}
+
+IoUringAcceptSocket::~IoUringAcceptSocket() {
+  // Nobody is going to take over the accepted sockets which have not been delivered.
+  for (auto& pending_socket : pending_sockets_) {
+    Api::OsSysCallsSingleton::get().close(pending_socket.fd_);
+  }
+}
+
+void IoUringAcceptSocket::close(bool keep_fd_open, IoUringSocketOnClosedCb cb) {
+  ENVOY_LOG(trace, "close the accept socket, fd = {}, status = {}", fd_, status_);
+
+  IoUringSocketEntry::close(keep_fd_open, cb);
+  keep_fd_open_ = keep_fd_open;
+
+  // Delay close until the accept request is drained.
+  if (accept_req_ == nullptr) {
+    closeInternal();
+    return;
+  }
+
+  if (cancel_req_ == nullptr) {
+    ENVOY_LOG(trace, "cancel the accept request, fd = {}", fd_);
+    cancel_req_ = parent_.submitCancelRequest(*this, accept_req_);
+  }
+}
+
+void IoUringAcceptSocket::enableRead() {
+  IoUringSocketEntry::enableRead();
+  ENVOY_LOG(trace, "enable accept, fd = {}", fd_);
+
+  // Continue delivering the sockets accepted when the socket was read disabled.
+  if (!pending_sockets_.empty()) {
+    injectCompletion(Request::RequestType::Accept);
+  }
+
+  submitAcceptRequest();
+}
+
+void IoUringAcceptSocket::disableRead() {
+  // The in flight accept request isn't cancelled, the accepted socket will be kept until the
+  // socket is read enabled again.
+  IoUringSocketEntry::disableRead();
+}
+
+void IoUringAcceptSocket::onAccept(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onAccept(req, result, injected);
+
+  ENVOY_LOG(trace, "onAccept with result {}, fd = {}, injected = {}, status_ = {}", result, fd_,
+            injected, status_);
+  if (injected) {
+    if (status_ == ReadEnabled) {
+      deliverAcceptedSockets();
+    }
+    return;
+  }
+
+  accept_req_ = nullptr;
+  if (status_ == Closed) {
+    if (result >= 0) {
+      Api::OsSysCallsSingleton::get().close(result);
+    }
+    if (cancel_req_ == nullptr) {
+      closeInternal();
+    }
+    return;
+  }
+
+  if (result >= 0) {
+    AcceptRequest* accept_req = static_cast<AcceptRequest*>(req);
+    pending_sockets_.push_back(
+        {result, accept_req->remote_addr_, accept_req->remote_addr_len_});
+  } else if (result != -ECANCELED) {
+    ENVOY_LOG(debug, "accept request failed, fd = {}, result = {}", fd_, result);
+  }
+
+  if (status_ == ReadEnabled) {
+    deliverAcceptedSockets();
+  }
+
+  // The socket may be read disabled or closed during the handler callback, check it again here.
+  if (status_ == ReadEnabled) {
+    submitAcceptRequest();
+  }
+}
+
+void IoUringAcceptSocket::onClose(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onClose(req, result, injected);
+  ASSERT(!injected);
+  cleanup();
+}
+
+void IoUringAcceptSocket::onCancel(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onCancel(req, result, injected);
+  ASSERT(!injected);
+  cancel_req_ = nullptr;
+  if (status_ == Closed && accept_req_ == nullptr) {
+    closeInternal();
+  }
+}
+
+void IoUringAcceptSocket::closeInternal() {
+  if (keep_fd_open_) {
+    if (on_closed_cb_) {
+      Buffer::OwnedImpl empty_buffer;
+      on_closed_cb_(empty_buffer);
+    }
+    cleanup();
+    return;
+  }
+  if (close_req_ == nullptr) {
+    close_req_ = parent_.submitCloseRequest(*this);
+  }
+}
+
+void IoUringAcceptSocket::submitAcceptRequest() {
+  if (accept_req_ == nullptr) {
+    accept_req_ = parent_.submitAcceptRequest(*this);
+  }
+}
+
+void IoUringAcceptSocket::deliverAcceptedSockets() {
+  while (status_ == ReadEnabled && !pending_sockets_.empty()) {
+    PendingAcceptedSocket pending_socket = pending_sockets_.front();
+    pending_sockets_.pop_front();
+
+    AcceptedSocketParam param{pending_socket.fd_, &pending_socket.remote_addr_,
+                              pending_socket.remote_addr_len_};
+    accepted_socket_param_ = param;
+    ENVOY_LOG(trace, "calling event callback for accepted socket, fd = {}, accepted fd = {}", fd_,
+              param.fd_);
+    cb_(Event::FileReadyType::Read);
+    accepted_socket_param_ = absl::nullopt;
+
+    // The handler didn't take over the accepted socket, close it to avoid leaking.
+    if (SOCKET_VALID(param.fd_)) {
+      ENVOY_LOG(trace, "accepted socket isn't taken over, close it, fd = {}", param.fd_);
+      Api::OsSysCallsSingleton::get().close(param.fd_);
+    }
+  }
+}
+
 } // namespace Io
 } // namespace Envoy
@@ -10,6 +10,14 @@
 namespace Envoy {
 namespace Io {
 
+class AcceptRequest : public Request {
+public:
+  AcceptRequest(IoUringSocket& socket);
+
+  sockaddr_storage remote_addr_{};
+  socklen_t remote_addr_len_{sizeof(remote_addr_)};
+};
+
 class ReadRequest : public Request {
 public:
   ReadRequest(IoUringSocket& socket, uint32_t size);
@@ -44,7 +52,10 @@ public:
                                  bool enable_close_event) override;
   IoUringSocket& addClientSocket(os_fd_t fd, Event::FileReadyCb cb,
                                  bool enable_close_event) override;
+  IoUringSocket& addAcceptSocket(os_fd_t fd, Event::FileReadyCb cb,
+                                 bool enable_close_event) override;
 
+  Request* submitAcceptRequest(IoUringSocket& socket) override;
   Request* submitConnectRequest(IoUringSocket& socket,
                                 const Network::Address::InstanceConstSharedPtr& address) override;
   Request* submitReadRequest(IoUringSocket& socket) override;
@@ -149,6 +160,9 @@ public:
 
   const OptRef<ReadParam>& getReadParam() const override { return read_param_; }
   const OptRef<WriteParam>& getWriteParam() const override { return write_param_; }
+  const OptRef<AcceptedSocketParam>& getAcceptedSocketParam() const override {
+    return accepted_socket_param_;
+  }
 
   void setFileReadyCb(Event::FileReadyCb cb) override { cb_ = std::move(cb); }
 
@@ -176,6 +190,8 @@ protected:
   OptRef<ReadParam> read_param_;
   // This object stores the data get from write request.
   OptRef<WriteParam> write_param_;
+  // This object stores the socket get from accept request.
+  OptRef<AcceptedSocketParam> accepted_socket_param_;
 
   Event::FileReadyCb cb_;
 };
@@ -258,5 +274,48 @@ public:
   void onConnect(Request* req, int32_t result, bool injected) override;
 };
 
+class IoUringAcceptSocket : public IoUringSocketEntry {
+public:
+  IoUringAcceptSocket(os_fd_t fd, IoUringWorkerImpl& parent, Event::FileReadyCb cb,
+                      bool enable_close_event);
+  ~IoUringAcceptSocket() override;
+
+  // IoUringSocket
+  void close(bool keep_fd_open, IoUringSocketOnClosedCb cb = nullptr) override;
+  void enableRead() override;
+  void disableRead() override;
+  void write(Buffer::Instance&) override { PANIC("not implemented"); }
+  uint64_t write(const Buffer::RawSlice*, uint64_t) override { PANIC("not implemented"); }
+  void shutdown(int) override { PANIC("not implemented"); }
+  void onAccept(Request* req, int32_t result, bool injected) override;
+  void onClose(Request* req, int32_t result, bool injected) override;
+  void onCancel(Request* req, int32_t result, bool injected) override;
+
+private:
+  struct PendingAcceptedSocket {
+    os_fd_t fd_;
+    sockaddr_storage remote_addr_;
+    socklen_t remote_addr_len_;
+  };
+
+  void closeInternal();
+  void submitAcceptRequest();
+  // Deliver the accepted sockets to the handler one by one as long as the socket is read enabled.
+  void deliverAcceptedSockets();
+
+  // Only one accept request is in flight at a time, the next one is submitted once the
+  // previous one is completed.
+  Request* accept_req_{nullptr};
+  // This is used for tracking the accept's cancel request.
+  Request* cancel_req_{nullptr};
+  // This is used for tracking the close request.
+  Request* close_req_{nullptr};
+  // Whether keep the fd open when close the IoUringSocket.
+  bool keep_fd_open_{false};
+  // The sockets which have been accepted but not delivered to the handler yet, since the socket
+  // may be read disabled when the accept request is done.
+  std::list<PendingAcceptedSocket> pending_sockets_;
+};
+
 } // namespace Io
 } // namespace Envoy
@@ -18,13 +18,14 @@ ActiveTcpListener::ActiveTcpListener(Network::TcpConnectionHandler& parent,
                                      Network::SocketSharedPtr&& socket,
                                      Network::Address::InstanceConstSharedPtr& listen_address,
                                      Network::ConnectionBalancer& connection_balancer,
+                                     OptRef<Network::ListenSocketLoad> socket_load,
                                      ThreadLocalOverloadStateOptRef overload_state)
     : OwnedActiveStreamListenerBase(
           parent, parent.dispatcher(),
           parent.createListener(std::move(socket), *this, runtime, random, config, overload_state),
           config),
       tcp_conn_handler_(parent), connection_balancer_(connection_balancer),
-      listen_address_(listen_address) {
+      socket_load_(socket_load), listen_address_(listen_address) {
   connection_balancer_.registerHandler(*this);
 }
 
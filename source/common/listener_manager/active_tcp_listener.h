@@ -31,6 +31,7 @@ public:
                     Network::SocketSharedPtr&& socket,
                     Network::Address::InstanceConstSharedPtr& listen_address,
                     Network::ConnectionBalancer& connection_balancer,
+                    OptRef<Network::ListenSocketLoad> socket_load,
                     ThreadLocalOverloadStateOptRef overload_state);
   ActiveTcpListener(Network::TcpConnectionHandler& parent, Network::ListenerPtr&& listener,
                     Network::Address::InstanceConstSharedPtr& listen_address,
@@ -48,6 +49,9 @@ public:
     ASSERT(num_listener_connections_ > 0);
     --num_listener_connections_;
     config_->openConnections().dec();
+    if (socket_load_.has_value()) {
+      socket_load_->add(-1);
+    }
   }
 
   // Network::TcpListenerCallbacks
@@ -71,8 +75,12 @@ public:
   void incNumConnections() override {
     ++num_listener_connections_;
     config_->openConnections().inc();
+    if (socket_load_.has_value()) {
+      socket_load_->add(1);
+    }
   }
   void post(Network::ConnectionSocketPtr&& socket) override;
+  Event::Dispatcher& dispatcher() override { return OwnedActiveStreamListenerBase::dispatcher(); }
   void onAcceptWorker(Network::ConnectionSocketPtr&& socket,
                       bool hand_off_restored_destination_connections, bool rebalanced) override;
 
@@ -92,6 +100,9 @@ public:
   std::atomic<uint64_t> num_listener_connections_{};
 
   Network::ConnectionBalancer& connection_balancer_;
+  // The load of the listen socket, which the connections of the listener count towards when
+  // connections are steered between the listen sockets of the workers.
+  OptRef<Network::ListenSocketLoad> socket_load_;
   // This is the address this listener is listening on. It's used to get the correct listener
   // when rebalancing. The accepted socket can't be used to get the listening address, since
   // the accepted socket's remote address can be another address than the listening address.
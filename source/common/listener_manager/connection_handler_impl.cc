@@ -81,12 +81,13 @@ void ConnectionHandlerImpl::addListener(absl::optional<uint64_t> overridden_list
     for (auto& socket_factory : config.listenSocketFactories()) {
       auto address = socket_factory->localAddress();
       // worker_index_ doesn't have a value on the main thread for the admin server.
+      const uint32_t worker_index = worker_index_.has_value() ? *worker_index_ : 0;
       details->addActiveListener(
           config, address, listener_reject_fraction_, disable_listeners_,
           std::make_unique<ActiveTcpListener>(
-              *this, config, runtime, random,
-              socket_factory->getListenSocket(worker_index_.has_value() ? *worker_index_ : 0),
+              *this, config, runtime, random, socket_factory->getListenSocket(worker_index),
               address, config.connectionBalancer(*address),
+              socket_factory->socketLoad(worker_index),
               overload_manager_ ? makeOptRef(overload_manager_->getThreadLocalOverloadState())
                                 : absl::nullopt),
           overload_manager_);
@@ -17,6 +17,7 @@
 #include "source/common/access_log/access_log_impl.h"
 #include "source/common/api/os_sys_calls_impl.h"
 #include "source/common/common/assert.h"
+#include "source/common/common/utility.h"
 #include "source/common/config/utility.h"
 #include "source/common/listener_manager/active_raw_udp_listener_config.h"
 #include "source/common/listener_manager/filter_chain_manager_impl.h"
@@ -77,7 +78,8 @@ ListenSocketFactoryImpl::ListenSocketFactoryImpl(
     Network::Socket::Type socket_type, const Network::Socket::OptionsSharedPtr& options,
     const std::string& listener_name, uint32_t tcp_backlog_size,
     ListenerComponentFactory::BindType bind_type,
-    const Network::SocketCreationOptions& creation_options, uint32_t num_sockets)
+    const Network::SocketCreationOptions& creation_options, uint32_t num_sockets,
+    bool reuse_port_load_balancing)
     : factory_(factory), local_address_(address), socket_type_(socket_type), options_(options),
       listener_name_(listener_name), tcp_backlog_size_(tcp_backlog_size), bind_type_(bind_type),
       socket_creation_options_(creation_options) {
@@ -117,6 +119,19 @@ ListenSocketFactoryImpl::ListenSocketFactoryImpl(
     }
   }
   ASSERT(sockets_.size() == num_sockets);
+
+  // The program is attached once the sockets listen, which is when they join the group.
+  if (reuse_port_load_balancing && bind_type_ == ListenerComponentFactory::BindType::ReusePort &&
+      socket_type_ == Network::Socket::Type::Stream && num_sockets > 1 &&
+      sockets_[0] != nullptr) {
+    auto steering_or_error = Network::ReusePortSteering::create(num_sockets);
+    if (steering_or_error.ok()) {
+      steering_ = std::move(steering_or_error.value());
+    } else {
+      ENVOY_LOG(warn, "listener {}: cannot steer connections by load, using hashing instead: {}",
+                listener_name_, steering_or_error.status().message());
+    }
+  }
 }
 
 ListenSocketFactoryImpl::ListenSocketFactoryImpl(const ListenSocketFactoryImpl& factory_to_clone)
@@ -125,7 +140,8 @@ ListenSocketFactoryImpl::ListenSocketFactoryImpl(const ListenSocketFactoryImpl&
       listener_name_(factory_to_clone.listener_name_),
       tcp_backlog_size_(factory_to_clone.tcp_backlog_size_),
       bind_type_(factory_to_clone.bind_type_),
-      socket_creation_options_(factory_to_clone.socket_creation_options_) {
+      socket_creation_options_(factory_to_clone.socket_creation_options_),
+      steering_(factory_to_clone.steering_) {
   for (auto& socket : factory_to_clone.sockets_) {
     // In the cloning case we always duplicate() the socket. This makes sure that during listener
     // update/drain we don't lose any incoming connections when using reuse_port. Specifically on
@@ -180,6 +196,13 @@ Network::SocketSharedPtr ListenSocketFactoryImpl::getListenSocket(uint32_t worke
   return sockets_[worker_index];
 }
 
+OptRef<Network::ListenSocketLoad> ListenSocketFactoryImpl::socketLoad(uint32_t worker_index) {
+  if (steering_ == nullptr) {
+    return {};
+  }
+  return steering_->load(worker_index);
+}
+
 void ListenSocketFactoryImpl::doFinalPreWorkerInit() {
   if (bind_type_ == ListenerComponentFactory::BindType::NoBind ||
       socket_type_ != Network::Socket::Type::Stream) {
@@ -213,6 +236,23 @@ void ListenSocketFactoryImpl::doFinalPreWorkerInit() {
     listen_and_apply_options(*iterator, tcp_backlog_size_);
   }
 #endif
+
+  if (steering_ != nullptr) {
+    // The sockets are added by the index of their worker, so a clone sharing the steering adds its
+    // duplicates of the same sockets again, which leaves the program's choices unchanged.
+    Api::SysCallIntResult result{0, 0};
+    for (uint32_t i = 0; i < sockets_.size() && result.return_value_ == 0; i++) {
+      result = steering_->addSocket(i, *sockets_[i]);
+    }
+    if (result.return_value_ == 0) {
+      result = steering_->attach(*sockets_[0]);
+    }
+    if (result.return_value_ != 0) {
+      ENVOY_LOG(warn, "listener {}: cannot steer connections by load, using hashing instead: {}",
+                listener_name_, errorDetails(result.errno_));
+      steering_.reset();
+    }
+  }
 }
 
 namespace {
@@ -251,6 +291,7 @@ ListenerImpl::ListenerImpl(const envoy::config::listener::v3::Listener& config,
                        ? Network::Socket::Type::Stream
                        : Network::Utility::protobufAddressSocketType(config.address())),
       bind_to_port_(shouldBindToPort(config)), mptcp_enabled_(config.enable_mptcp()),
+      reuse_port_load_balancing_(config.enable_reuse_port_load_balancing()),
       hand_off_restored_destination_connections_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, use_original_dst, false)),
       per_connection_buffer_limit_bytes_(
@@ -385,6 +426,7 @@ ListenerImpl::ListenerImpl(ListenerImpl& origin,
                            uint64_t hash)
     : parent_(parent), addresses_(origin.addresses_), socket_type_(origin.socket_type_),
       bind_to_port_(shouldBindToPort(config)), mptcp_enabled_(config.enable_mptcp()),
+      reuse_port_load_balancing_(config.enable_reuse_port_load_balancing()),
       hand_off_restored_destination_connections_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, use_original_dst, false)),
       per_connection_buffer_limit_bytes_(
@@ -474,6 +516,11 @@ void ListenerImpl::validateConfig() {
           name_));
     }
   }
+  if (reuse_port_load_balancing_ && socket_type_ != Network::Socket::Type::Stream) {
+    throw EnvoyException(fmt::format(
+        "listener {}: enable_reuse_port_load_balancing can only be used with TCP listeners",
+        name_));
+  }
 }
 
 void ListenerImpl::buildAccessLog(const envoy::config::listener::v3::Listener& config) {
@@ -492,8 +539,9 @@ void ListenerImpl::buildInternalListener(const envoy::config::listener::v3::List
                                        name_));
     }
     if ((config.has_connection_balance_config() &&
-         config.connection_balance_config().has_exact_balance()) ||
-        config.enable_mptcp() ||
+         (config.connection_balance_config().has_exact_balance() ||
+          config.connection_balance_config().has_least_connections_balance())) ||
+        config.enable_mptcp() || config.enable_reuse_port_load_balancing() ||
         config.has_enable_reuse_port() // internal listener doesn't use physical l4 port.
         || (config.has_freebind() && config.freebind().value()) || config.has_tcp_backlog_size() ||
         config.has_tcp_fast_open_queue_length() ||
@@ -751,6 +799,20 @@ void ListenerImpl::buildConnectionBalancer(const envoy::config::listener::v3::Li
         connection_balancers_.emplace(address.asString(),
                                       std::make_shared<Network::ExactConnectionBalancerImpl>());
         break;
+      case envoy::config::listener::v3::Listener_ConnectionBalanceConfig::
+          kLeastConnectionsBalance: {
+        const auto& least_connections_balance =
+            config.connection_balance_config().least_connections_balance();
+        connection_balancers_.emplace(
+            address.asString(),
+            std::make_shared<Network::LeastConnectionsConnectionBalancerImpl>(
+                std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(
+                    least_connections_balance, event_loop_lag_probe_interval, 100)),
+                std::chrono::milliseconds(
+                    PROTOBUF_GET_MS_OR_DEFAULT(least_connections_balance, max_event_loop_lag, 50)),
+                least_connections_balance.imbalance_tolerance()));
+        break;
+      }
       case envoy::config::listener::v3::Listener_ConnectionBalanceConfig::kExtendBalance: {
         const std::string connection_balance_library_type{TypeUtil::typeUrlToDescriptorFullName(
             config.connection_balance_config().extend_balance().typed_config().type_url())};
@@ -1120,7 +1182,9 @@ bool ListenerMessageUtil::socketOptionsEqual(const envoy::config::listener::v3::
       (PROTOBUF_GET_WRAPPED_OR_DEFAULT(lhs, freebind, false) !=
        PROTOBUF_GET_WRAPPED_OR_DEFAULT(rhs, freebind, false)) ||
       (PROTOBUF_GET_WRAPPED_OR_DEFAULT(lhs, tcp_fast_open_queue_length, 0) !=
-       PROTOBUF_GET_WRAPPED_OR_DEFAULT(rhs, tcp_fast_open_queue_length, 0))) {
+       PROTOBUF_GET_WRAPPED_OR_DEFAULT(rhs, tcp_fast_open_queue_length, 0)) ||
+      // The steering program is owned by the sockets' factory, so changing it takes new sockets.
+      (lhs.enable_reuse_port_load_balancing() != rhs.enable_reuse_port_load_balancing())) {
     return false;
   }
 
@@ -22,6 +22,7 @@
 #include "source/common/init/target_impl.h"
 #include "source/common/listener_manager/filter_chain_manager_impl.h"
 #include "source/common/listener_manager/listener_info_impl.h"
+#include "source/common/network/reuse_port_steering.h"
 #include "source/common/quic/quic_stat_names.h"
 #include "source/server/factory_context_impl.h"
 #include "source/server/transport_socket_config_impl.h"
@@ -70,7 +71,7 @@ public:
                           const std::string& listener_name, uint32_t tcp_backlog_size,
                           ListenerComponentFactory::BindType bind_type,
                           const Network::SocketCreationOptions& creation_options,
-                          uint32_t num_sockets);
+                          uint32_t num_sockets, bool reuse_port_load_balancing);
 
   // Network::ListenSocketFactory
   Network::Socket::Type socketType() const override { return socket_type_; }
@@ -78,6 +79,7 @@ public:
     return local_address_;
   }
   Network::SocketSharedPtr getListenSocket(uint32_t worker_index) override;
+  OptRef<Network::ListenSocketLoad> socketLoad(uint32_t worker_index) override;
   Network::ListenSocketFactoryPtr clone() const override {
     return absl::WrapUnique(new ListenSocketFactoryImpl(*this));
   }
@@ -114,6 +116,9 @@ private:
   // TODO(mattklein123): If a listener does not bind, it still has a socket. This is confusing
   // and not needed and can be cleaned up.
   std::vector<Network::SocketSharedPtr> sockets_;
+  // Steers the connections to the reuse_port sockets by the load of their workers, if enabled and
+  // supported. It is shared with the clones, which duplicate the same sockets.
+  Network::ReusePortSteeringSharedPtr steering_;
 };
 
 // TODO(mattklein123): Consider getting rid of pre-worker start and post-worker start code by
@@ -277,6 +282,7 @@ public:
   }
   bool bindToPort() const override { return bind_to_port_; }
   bool mptcpEnabled() { return mptcp_enabled_; }
+  bool reusePortLoadBalancing() const { return reuse_port_load_balancing_; }
   bool handOffRestoredDestinationConnections() const override {
     return hand_off_restored_destination_connections_;
   }
@@ -419,6 +425,7 @@ private:
   std::vector<Network::ListenSocketFactoryPtr> socket_factories_;
   const bool bind_to_port_;
   const bool mptcp_enabled_;
+  const bool reuse_port_load_balancing_;
   const bool hand_off_restored_destination_connections_;
   const uint32_t per_connection_buffer_limit_bytes_;
   const uint64_t listener_tag_;
@@ -1173,7 +1173,7 @@ void ListenerManagerImpl::createListenSocketFactory(ListenerImpl& listener) {
       listener.addSocketFactory(std::make_unique<ListenSocketFactoryImpl>(
           *factory_, listener.addresses()[i], socket_type, listener.listenSocketOptions(i),
           listener.name(), listener.tcpBacklogSize(), bind_type, creation_options,
-          server_.options().concurrency()));
+          server_.options().concurrency(), listener.reusePortLoadBalancing()));
     }
   }
   END_TRY
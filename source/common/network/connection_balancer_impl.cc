@@ -1,5 +1,8 @@
 #include "source/common/network/connection_balancer_impl.h"
 
+#include <algorithm>
+#include <thread>
+
 namespace Envoy {
 namespace Network {
 
@@ -34,5 +37,124 @@ ExactConnectionBalancerImpl::pickTargetHandler(BalancedConnectionHandler&) {
   return *min_connection_handler;
 }
 
+LeastConnectionsConnectionBalancerImpl::LeastConnectionsConnectionBalancerImpl(
+    std::chrono::milliseconds lag_probe_interval, std::chrono::milliseconds max_event_loop_lag,
+    uint32_t imbalance_tolerance)
+    : lag_probe_interval_(lag_probe_interval), max_event_loop_lag_(max_event_loop_lag),
+      imbalance_tolerance_(imbalance_tolerance) {
+  snapshots_.push_back(std::make_unique<const Workers>());
+  registered_ = snapshots_.back().get();
+}
+
+void LeastConnectionsConnectionBalancerImpl::registerHandler(BalancedConnectionHandler& handler) {
+  auto worker = std::make_unique<Worker>(handler);
+  if (lag_probe_interval_.count() > 0) {
+    // Handlers are registered on their worker's thread, where the probe must be acquired.
+    Event::Dispatcher& dispatcher = handler.dispatcher();
+    worker->time_source_ = &dispatcher.timeSource();
+    worker->lag_probe_ = Event::EventLoopLagProbe::acquire(dispatcher, lag_probe_interval_);
+  }
+
+  absl::MutexLock lock(&lock_);
+  auto workers = std::make_unique<Workers>(*registered_.load());
+  workers->push_back(worker.get());
+  workers_.push_back(std::move(worker));
+  registered_ = workers.get();
+  snapshots_.push_back(std::move(workers));
+}
+
+void LeastConnectionsConnectionBalancerImpl::unregisterHandler(BalancedConnectionHandler& handler) {
+  absl::MutexLock lock(&lock_);
+  const Workers& previous = *registered_.load();
+  auto workers = std::make_unique<Workers>();
+  Worker* unregistered = nullptr;
+  for (Worker* worker : previous) {
+    if (&worker->handler_ == &handler) {
+      unregistered = worker;
+    } else {
+      workers->push_back(worker);
+    }
+  }
+  ASSERT(workers->size() + 1 == previous.size());
+  registered_ = workers.get();
+  snapshots_.push_back(std::move(workers));
+
+  // Wait out the picks which may have seen the handler, after which the handler may be destroyed.
+  // Picks which start from now on recheck the registered handlers and don't see it.
+  for (Worker* worker : previous) {
+    while (worker->picking_.load() != 0) {
+      std::this_thread::yield();
+    }
+  }
+  // Handlers are unregistered on their worker's thread too, where the probe must be released.
+  unregistered->lag_probe_.reset();
+}
+
+BalancedConnectionHandler& LeastConnectionsConnectionBalancerImpl::pickTargetHandler(
+    BalancedConnectionHandler& current_handler) {
+  while (true) {
+    const Workers* workers = registered_.load();
+    auto current_worker = std::find_if(workers->begin(), workers->end(), [&](const Worker* worker) {
+      return &worker->handler_ == &current_handler;
+    });
+    if (current_worker == workers->end()) {
+      current_handler.incNumConnections();
+      return current_handler;
+    }
+
+    (*current_worker)->picking_.fetch_add(1);
+    if (registered_.load() != workers) {
+      // A handler was registered or unregistered in the meantime, which may not wait for this.
+      (*current_worker)->picking_.fetch_sub(1);
+      continue;
+    }
+    BalancedConnectionHandler& target = pick(*workers, **current_worker);
+    target.incNumConnections();
+    (*current_worker)->picking_.fetch_sub(1);
+    return target;
+  }
+}
+
+BalancedConnectionHandler&
+LeastConnectionsConnectionBalancerImpl::pick(const Workers& workers, Worker& current_worker) {
+  const MonotonicTime now = current_worker.time_source_ != nullptr
+                                ? current_worker.time_source_->monotonicTime()
+                                : MonotonicTime();
+  // The least loaded of all workers, and of those whose event loop keeps up, if any does.
+  Worker* least = nullptr;
+  uint64_t least_connections = 0;
+  Worker* least_responsive = nullptr;
+  uint64_t least_responsive_connections = 0;
+  uint64_t current_connections = 0;
+  bool current_responsive = false;
+  for (Worker* worker : workers) {
+    const uint64_t connections = worker->handler_.numConnections();
+    if (least == nullptr || connections < least_connections) {
+      least = worker;
+      least_connections = connections;
+    }
+    const bool responsive = worker->eventLoopLag(now) <= max_event_loop_lag_;
+    if (responsive && (least_responsive == nullptr || connections < least_responsive_connections)) {
+      least_responsive = worker;
+      least_responsive_connections = connections;
+    }
+    if (worker == &current_worker) {
+      current_connections = connections;
+      current_responsive = responsive;
+    }
+  }
+  if (least_responsive != nullptr) {
+    least = least_responsive;
+    least_connections = least_responsive_connections;
+  } else {
+    current_responsive = true;
+  }
+
+  if (current_responsive && current_connections <= least_connections + imbalance_tolerance_) {
+    return current_worker.handler_;
+  }
+  return least->handler_;
+}
+
 } // namespace Network
 } // namespace Envoy
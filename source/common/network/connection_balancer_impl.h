@@ -1,10 +1,17 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
 #include "envoy/config/listener/v3/listener.pb.h"
+#include "envoy/event/dispatcher.h"
 #include "envoy/network/connection_balancer.h"
 #include "envoy/registry/registry.h"
 #include "envoy/server/filter_config.h"
 
+#include "source/common/event/event_loop_lag_probe.h"
 #include "source/common/protobuf/protobuf.h"
 
 #include "absl/synchronization/mutex.h"
@@ -44,6 +51,68 @@ private:
   std::vector<BalancedConnectionHandler*> handlers_ ABSL_GUARDED_BY(lock_);
 };
 
+/**
+ * Implementation of connection balancer that sends connections to the handler with the fewest
+ * active connections, passing over handlers whose worker's event loop lags behind, without
+ * taking a lock. Each handler's worker measures how late its event loop runs a periodic timer and
+ * publishes it in an atomic, which along with the handlers' atomic connection counts is all that
+ * a pick reads. Connections stay on the handler which accepted them as long as it has at most
+ * imbalance_tolerance more connections than the least loaded handler. Like the exact balancer,
+ * counts may be off by connections which close in parallel, and as several workers may pick at
+ * once, by the connections they are picking.
+ */
+class LeastConnectionsConnectionBalancerImpl : public ConnectionBalancer {
+public:
+  /**
+   * @param lag_probe_interval supplies how often each worker measures its event loop lag, or 0
+   *        to not take the lag into account.
+   * @param max_event_loop_lag supplies the lag beyond which a worker is passed over, unless all
+   *        of them lag as much.
+   * @param imbalance_tolerance supplies how many more connections than the least loaded handler
+   *        the accepting handler may have and still keep a connection.
+   */
+  LeastConnectionsConnectionBalancerImpl(std::chrono::milliseconds lag_probe_interval,
+                                         std::chrono::milliseconds max_event_loop_lag,
+                                         uint32_t imbalance_tolerance);
+
+  // ConnectionBalancer
+  void registerHandler(BalancedConnectionHandler& handler) override;
+  void unregisterHandler(BalancedConnectionHandler& handler) override;
+  BalancedConnectionHandler& pickTargetHandler(BalancedConnectionHandler& current_handler) override;
+
+private:
+  struct Worker {
+    explicit Worker(BalancedConnectionHandler& handler) : handler_(handler) {}
+
+    // The event loop lag of the worker, or 0 if it isn't probed.
+    std::chrono::nanoseconds eventLoopLag(MonotonicTime now) const {
+      return lag_probe_ != nullptr ? lag_probe_->lag(now) : std::chrono::nanoseconds(0);
+    }
+
+    BalancedConnectionHandler& handler_;
+    TimeSource* time_source_{};
+    // Set before the worker is published and released once no pick can see it, on the worker's
+    // thread.
+    Event::EventLoopLagProbeSharedPtr lag_probe_;
+    // The number of picks in progress on the worker, which unregisterHandler() waits out.
+    std::atomic<uint32_t> picking_{};
+  };
+  using Workers = std::vector<Worker*>;
+
+  BalancedConnectionHandler& pick(const Workers& workers, Worker& current_worker);
+
+  const std::chrono::milliseconds lag_probe_interval_;
+  const std::chrono::nanoseconds max_event_loop_lag_;
+  const uint64_t imbalance_tolerance_;
+  absl::Mutex lock_;
+  // Workers and snapshots of the registered workers are kept until the balancer is destroyed, as
+  // a pick may still be looking at a snapshot which was replaced. There are as many as there are
+  // handler registrations, which are bounded by the number of workers and listener updates.
+  std::vector<std::unique_ptr<Worker>> workers_ ABSL_GUARDED_BY(lock_);
+  std::vector<std::unique_ptr<const Workers>> snapshots_ ABSL_GUARDED_BY(lock_);
+  std::atomic<const Workers*> registered_;
+};
+
 /**
  * A NOP connection balancer implementation that always continues execution after incrementing
  * the handler's connection count.
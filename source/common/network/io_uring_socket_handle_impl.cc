@@ -0,0 +1,376 @@
+#include "source/common/network/io_uring_socket_handle_impl.h"
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/exception.h"
+#include "envoy/event/dispatcher.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/utility.h"
+#include "source/common/network/address_impl.h"
+#include "source/common/network/io_socket_error_impl.h"
+
+namespace Envoy {
+namespace Network {
+
+IoUringSocketHandleImpl::IoUringSocketHandleImpl(Io::IoUringWorkerFactory& io_uring_worker_factory,
+                                                 os_fd_t fd, bool socket_v6only,
+                                                 absl::optional<int> domain, bool is_server_socket)
+    : IoSocketHandleBaseImpl(fd, socket_v6only, domain),
+      io_uring_worker_factory_(io_uring_worker_factory),
+      io_uring_socket_type_(is_server_socket ? IoUringSocketType::Server
+                                             : IoUringSocketType::Unknown) {
+  ENVOY_LOG(trace, "construct io uring socket handle, fd = {}, type = {}", fd_,
+            ioUringSocketTypeStr());
+}
+
+IoUringSocketHandleImpl::~IoUringSocketHandleImpl() {
+  // The io_uring worker may have been wiped out with the TLS slot by this moment, in that case
+  // leave the fd to the posix system call in the base class.
+  if (SOCKET_VALID(fd_) && io_uring_socket_.has_value() &&
+      io_uring_worker_factory_.currentThreadRegistered()) {
+    IoUringSocketHandleImpl::close();
+  }
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::close() {
+  ENVOY_LOG(trace, "close, fd = {}, type = {}", fd_, ioUringSocketTypeStr());
+  ASSERT(SOCKET_VALID(fd_));
+
+  if (!io_uring_socket_.has_value()) {
+    // The socket hasn't been added to an io_uring worker yet.
+    const int rc = Api::OsSysCallsSingleton::get().close(fd_).return_value_;
+    SET_SOCKET_INVALID(fd_);
+    return {static_cast<unsigned long>(rc), Api::IoError::none()};
+  }
+
+  // The io_uring socket closes the fd asynchronously once the in flight requests are drained.
+  io_uring_socket_->close(false);
+  io_uring_socket_.reset();
+  SET_SOCKET_INVALID(fd_);
+  return Api::ioCallUint64ResultNoError();
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::readv(uint64_t max_length,
+                                                       Buffer::RawSlice* slices,
+                                                       uint64_t num_slice) {
+  ENVOY_LOG(trace, "readv, fd = {}, type = {}", fd_, ioUringSocketTypeStr());
+  ASSERT(io_uring_socket_.has_value());
+
+  auto result = checkReadResult();
+  if (result.has_value()) {
+    return std::move(*result);
+  }
+
+  Buffer::Instance& buf = io_uring_socket_->getReadParam()->buf_;
+  uint64_t bytes_read = 0;
+  for (uint64_t i = 0; i < num_slice && bytes_read < max_length && buf.length() > 0; i++) {
+    const uint64_t length =
+        std::min({static_cast<uint64_t>(slices[i].len_), max_length - bytes_read, buf.length()});
+    buf.copyOut(0, length, slices[i].mem_);
+    buf.drain(length);
+    bytes_read += length;
+  }
+  return {bytes_read, Api::IoError::none()};
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::read(Buffer::Instance& buffer,
+                                                      absl::optional<uint64_t> max_length_opt) {
+  ENVOY_LOG(trace, "read, fd = {}, type = {}", fd_, ioUringSocketTypeStr());
+  const uint64_t max_length = max_length_opt.value_or(UINT64_MAX);
+  if (max_length == 0) {
+    return Api::ioCallUint64ResultNoError();
+  }
+  ASSERT(io_uring_socket_.has_value());
+
+  auto result = checkReadResult();
+  if (result.has_value()) {
+    return std::move(*result);
+  }
+
+  // Move the slices read by the io_uring worker directly, no copy is needed here.
+  Buffer::Instance& buf = io_uring_socket_->getReadParam()->buf_;
+  const uint64_t bytes_read = std::min(max_length, buf.length());
+  buffer.move(buf, bytes_read);
+  return {bytes_read, Api::IoError::none()};
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::writev(const Buffer::RawSlice* slices,
+                                                        uint64_t num_slice) {
+  ENVOY_LOG(trace, "writev, fd = {}, type = {}", fd_, ioUringSocketTypeStr());
+  ASSERT(io_uring_socket_.has_value());
+
+  auto result = checkWriteResult();
+  if (result.has_value()) {
+    return std::move(*result);
+  }
+
+  const uint64_t bytes_written = io_uring_socket_->write(slices, num_slice);
+  return {bytes_written, Api::IoError::none()};
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::write(Buffer::Instance& buffer) {
+  ENVOY_LOG(trace, "write {}, fd = {}, type = {}", buffer.length(), fd_, ioUringSocketTypeStr());
+  ASSERT(io_uring_socket_.has_value());
+
+  auto result = checkWriteResult();
+  if (result.has_value()) {
+    return std::move(*result);
+  }
+
+  const uint64_t buffer_size = buffer.length();
+  io_uring_socket_->write(buffer);
+  return {buffer_size, Api::IoError::none()};
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::sendmsg(const Buffer::RawSlice*, uint64_t, int,
+                                                         const Address::Ip*,
+                                                         const Address::Instance&) {
+  ENVOY_LOG(trace, "sendmsg, fd = {}, type = {}", fd_, ioUringSocketTypeStr());
+  PANIC("not implemented");
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::recvmsg(Buffer::RawSlice*, const uint64_t,
+                                                         uint32_t, RecvMsgOutput&) {
+  ENVOY_LOG(trace, "recvmsg, fd = {}, type = {}", fd_, ioUringSocketTypeStr());
+  PANIC("not implemented");
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::recvmmsg(RawSliceArrays&, uint32_t,
+                                                          RecvMsgOutput&) {
+  ENVOY_LOG(trace, "recvmmsg, fd = {}, type = {}", fd_, ioUringSocketTypeStr());
+  PANIC("not implemented");
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::recv(void* buffer, size_t length, int flags) {
+  ENVOY_LOG(trace, "recv, fd = {}, type = {}", fd_, ioUringSocketTypeStr());
+  ASSERT(io_uring_socket_.has_value());
+
+  auto result = checkReadResult();
+  if (result.has_value()) {
+    return std::move(*result);
+  }
+
+  // The listener filters peek the data through `MSG_PEEK`, the data is kept in the io_uring
+  // socket's read buffer until it is read by the connection.
+  Buffer::Instance& buf = io_uring_socket_->getReadParam()->buf_;
+  const uint64_t bytes_read = std::min(static_cast<uint64_t>(length), buf.length());
+  buf.copyOut(0, bytes_read, buffer);
+  if ((flags & MSG_PEEK) == 0) {
+    buf.drain(bytes_read);
+  }
+  return {bytes_read, Api::IoError::none()};
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::bind(Address::InstanceConstSharedPtr address) {
+  ENVOY_LOG(trace, "bind {}, fd = {}, type = {}", address->asString(), fd_,
+            ioUringSocketTypeStr());
+  return Api::OsSysCallsSingleton::get().bind(fd_, address->sockAddr(), address->sockAddrLen());
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::listen(int backlog) {
+  ENVOY_LOG(trace, "listen, fd = {}, type = {}", fd_, ioUringSocketTypeStr());
+  ASSERT(io_uring_socket_type_ == IoUringSocketType::Unknown ||
+         io_uring_socket_type_ == IoUringSocketType::Accept);
+  io_uring_socket_type_ = IoUringSocketType::Accept;
+  return Api::OsSysCallsSingleton::get().listen(fd_, backlog);
+}
+
+IoHandlePtr IoUringSocketHandleImpl::accept(struct sockaddr* addr, socklen_t* addrlen) {
+  ENVOY_LOG(trace, "accept, fd = {}, type = {}", fd_, ioUringSocketTypeStr());
+  ASSERT(io_uring_socket_type_ == IoUringSocketType::Accept);
+  ASSERT(io_uring_socket_.has_value());
+
+  // The socket is only available during the read event callback. Returning nullptr tells the
+  // listener there is nothing more to accept for now.
+  const OptRef<Io::AcceptedSocketParam>& accepted_socket_param =
+      io_uring_socket_->getAcceptedSocketParam();
+  if (!accepted_socket_param.has_value() || !SOCKET_VALID(accepted_socket_param->fd_)) {
+    return nullptr;
+  }
+
+  const os_fd_t fd = accepted_socket_param->fd_;
+  // Take over the ownership of the accepted fd.
+  SET_SOCKET_INVALID(accepted_socket_param->fd_);
+  if (addr != nullptr && addrlen != nullptr) {
+    const socklen_t length = std::min(*addrlen, accepted_socket_param->remote_addr_len_);
+    memcpy(addr, accepted_socket_param->remote_addr_, length); // NOLINT(safe-memcpy)
+    *addrlen = accepted_socket_param->remote_addr_len_;
+  }
+
+  return std::make_unique<IoUringSocketHandleImpl>(io_uring_worker_factory_, fd, socket_v6only_,
+                                                   domain_, true);
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::connect(Address::InstanceConstSharedPtr address) {
+  ENVOY_LOG(trace, "connect, fd = {}, type = {}", fd_, ioUringSocketTypeStr());
+  ASSERT(io_uring_socket_type_ == IoUringSocketType::Unknown ||
+         io_uring_socket_type_ == IoUringSocketType::Client);
+  io_uring_socket_type_ = IoUringSocketType::Client;
+
+  if (!io_uring_socket_.has_value()) {
+    // The file event isn't initialized yet, connect through the posix system call.
+    return Api::OsSysCallsSingleton::get().connect(fd_, address->sockAddr(),
+                                                   address->sockAddrLen());
+  }
+
+  // The connect result will be delivered as a write event.
+  io_uring_socket_->connect(address);
+  return {-1, SOCKET_ERROR_IN_PROGRESS};
+}
+
+IoHandlePtr IoUringSocketHandleImpl::duplicate() {
+  ENVOY_LOG(trace, "duplicate, fd = {}, type = {}", fd_, ioUringSocketTypeStr());
+  auto result = Api::OsSysCallsSingleton::get().duplicate(fd_);
+  RELEASE_ASSERT(result.return_value_ != -1,
+                 fmt::format("duplicate failed for '{}': ({}) {}", fd_, result.errno_,
+                             errorDetails(result.errno_)));
+  auto io_handle = std::make_unique<IoUringSocketHandleImpl>(
+      io_uring_worker_factory_, result.return_value_, socket_v6only_, domain_,
+      io_uring_socket_type_ == IoUringSocketType::Server);
+  io_handle->io_uring_socket_type_ = io_uring_socket_type_;
+  return io_handle;
+}
+
+void IoUringSocketHandleImpl::initializeFileEvent(Event::Dispatcher& dispatcher,
+                                                  Event::FileReadyCb cb, Event::FileTriggerType,
+                                                  uint32_t events) {
+  ENVOY_LOG(trace, "initialize file event, fd = {}, type = {}, has socket = {}", fd_,
+            ioUringSocketTypeStr(), io_uring_socket_.has_value());
+
+  // The io_uring socket has already been created. It usually happens after a `resetFileEvents()`,
+  // e.g. the listener filters are done with the socket and the connection takes it over.
+  if (io_uring_socket_.has_value()) {
+    // Moving an io_uring socket between threads isn't supported. The connection balancer hands
+    // over the accepted socket before the file event is initialized.
+    ASSERT(&io_uring_socket_->getIoUringWorker().dispatcher() == &dispatcher);
+    io_uring_socket_->setFileReadyCb(std::move(cb));
+    enableFileEvents(events);
+    return;
+  }
+
+  OptRef<Io::IoUringWorker> io_uring_worker = io_uring_worker_factory_.getIoUringWorker();
+  RELEASE_ASSERT(io_uring_worker.has_value(), "io_uring worker isn't initialized on this thread");
+  ASSERT(&io_uring_worker->dispatcher() == &dispatcher);
+
+  switch (io_uring_socket_type_) {
+  case IoUringSocketType::Accept:
+    io_uring_socket_ = io_uring_worker->addAcceptSocket(fd_, std::move(cb), false);
+    break;
+  case IoUringSocketType::Server:
+    io_uring_socket_ = io_uring_worker->addServerSocket(fd_, std::move(cb),
+                                                        events & Event::FileReadyType::Closed);
+    break;
+  case IoUringSocketType::Unknown:
+  case IoUringSocketType::Client:
+    io_uring_socket_type_ = IoUringSocketType::Client;
+    io_uring_socket_ = io_uring_worker->addClientSocket(fd_, std::move(cb),
+                                                        events & Event::FileReadyType::Closed);
+    break;
+  }
+
+  // The server and accept sockets are read enabled once they are added to the worker.
+  if (io_uring_socket_type_ != IoUringSocketType::Client && !(events & Event::FileReadyType::Read)) {
+    io_uring_socket_->disableRead();
+  }
+}
+
+void IoUringSocketHandleImpl::activateFileEvents(uint32_t events) {
+  ENVOY_LOG(trace, "activate file events {}, fd = {}, type = {}", events, fd_,
+            ioUringSocketTypeStr());
+  ASSERT(io_uring_socket_.has_value());
+
+  if (events & Event::FileReadyType::Read) {
+    io_uring_socket_->injectCompletion(io_uring_socket_type_ == IoUringSocketType::Accept
+                                           ? Io::Request::RequestType::Accept
+                                           : Io::Request::RequestType::Read);
+  }
+  if (events & Event::FileReadyType::Write) {
+    io_uring_socket_->injectCompletion(Io::Request::RequestType::Write);
+  }
+}
+
+void IoUringSocketHandleImpl::enableFileEvents(uint32_t events) {
+  ENVOY_LOG(trace, "enable file events {}, fd = {}, type = {}", events, fd_,
+            ioUringSocketTypeStr());
+  ASSERT(io_uring_socket_.has_value());
+
+  if (events & Event::FileReadyType::Read) {
+    io_uring_socket_->enableRead();
+  } else {
+    io_uring_socket_->disableRead();
+  }
+  io_uring_socket_->enableCloseEvent(events & Event::FileReadyType::Closed);
+}
+
+void IoUringSocketHandleImpl::resetFileEvents() {
+  ENVOY_LOG(trace, "reset file events, fd = {}, type = {}", fd_, ioUringSocketTypeStr());
+  if (!io_uring_socket_.has_value()) {
+    return;
+  }
+
+  // The io_uring socket keeps the data which has been read until the file event is initialized
+  // again.
+  io_uring_socket_->disableRead();
+  io_uring_socket_->enableCloseEvent(false);
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::shutdown(int how) {
+  ENVOY_LOG(trace, "shutdown {}, fd = {}, type = {}", how, fd_, ioUringSocketTypeStr());
+  ASSERT(io_uring_socket_.has_value());
+  io_uring_socket_->shutdown(how);
+  return Api::SysCallIntResult{0, 0};
+}
+
+absl::optional<Api::IoCallUint64Result> IoUringSocketHandleImpl::checkReadResult() const {
+  const OptRef<Io::ReadParam>& read_param = io_uring_socket_->getReadParam();
+  // The read data is only available during the read event callback.
+  if (!read_param.has_value()) {
+    return Api::IoCallUint64Result(0, IoSocketError::getIoSocketEagainError());
+  }
+
+  if (read_param->result_ < 0) {
+    ASSERT(read_param->buf_.length() == 0);
+    return Api::IoCallUint64Result(0, read_param->result_ == -SOCKET_ERROR_AGAIN
+                                          ? IoSocketError::getIoSocketEagainError()
+                                          : IoSocketError::create(-read_param->result_));
+  }
+
+  // A zero result means the remote is closed.
+  if (read_param->result_ == 0) {
+    ASSERT(read_param->buf_.length() == 0);
+    return Api::ioCallUint64ResultNoError();
+  }
+
+  // All the data has been consumed during this callback.
+  if (read_param->buf_.length() == 0) {
+    return Api::IoCallUint64Result(0, IoSocketError::getIoSocketEagainError());
+  }
+
+  return absl::nullopt;
+}
+
+absl::optional<Api::IoCallUint64Result> IoUringSocketHandleImpl::checkWriteResult() const {
+  const OptRef<Io::WriteParam>& write_param = io_uring_socket_->getWriteParam();
+  if (write_param.has_value() && write_param->result_ < 0) {
+    return Api::IoCallUint64Result(0, IoSocketError::create(-write_param->result_));
+  }
+  return absl::nullopt;
+}
+
+std::string IoUringSocketHandleImpl::ioUringSocketTypeStr() const {
+  switch (io_uring_socket_type_) {
+  case IoUringSocketType::Unknown:
+    return "unknown";
+  case IoUringSocketType::Accept:
+    return "accept";
+  case IoUringSocketType::Server:
+    return "server";
+  case IoUringSocketType::Client:
+    return "client";
+  }
+  PANIC_DUE_TO_CORRUPT_ENUM;
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "envoy/api/io_error.h"
+#include "envoy/api/os_sys_calls.h"
+#include "envoy/common/io/io_uring.h"
+#include "envoy/common/platform.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/network/io_handle.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/network/io_socket_error_impl.h"
+#include "source/common/network/io_socket_handle_base_impl.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * The type of the io_uring socket. The type is decided by how the socket is used, since the
+ * socket is created before knowing whether it is going to listen or connect.
+ */
+enum class IoUringSocketType {
+  Unknown,
+  Accept,
+  Server,
+  Client,
+};
+
+/**
+ * IoHandle derivative for sockets which routes accept, connect, read and write through the
+ * current thread's io_uring worker.
+ */
+class IoUringSocketHandleImpl : public IoSocketHandleBaseImpl {
+public:
+  IoUringSocketHandleImpl(Io::IoUringWorkerFactory& io_uring_worker_factory,
+                          os_fd_t fd = INVALID_SOCKET, bool socket_v6only = false,
+                          absl::optional<int> domain = absl::nullopt,
+                          bool is_server_socket = false);
+  ~IoUringSocketHandleImpl() override;
+
+  Api::IoCallUint64Result close() override;
+  Api::IoCallUint64Result readv(uint64_t max_length, Buffer::RawSlice* slices,
+                                uint64_t num_slice) override;
+  Api::IoCallUint64Result read(Buffer::Instance& buffer,
+                               absl::optional<uint64_t> max_length_opt) override;
+  Api::IoCallUint64Result writev(const Buffer::RawSlice* slices, uint64_t num_slice) override;
+  Api::IoCallUint64Result write(Buffer::Instance& buffer) override;
+  Api::IoCallUint64Result sendmsg(const Buffer::RawSlice* slices, uint64_t num_slice, int flags,
+                                  const Address::Ip* self_ip,
+                                  const Address::Instance& peer_address) override;
+  Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
+                                  uint32_t self_port, RecvMsgOutput& output) override;
+  Api::IoCallUint64Result recvmmsg(RawSliceArrays& slices, uint32_t self_port,
+                                   RecvMsgOutput& output) override;
+  Api::IoCallUint64Result recv(void* buffer, size_t length, int flags) override;
+  Api::SysCallIntResult bind(Address::InstanceConstSharedPtr address) override;
+  Api::SysCallIntResult listen(int backlog) override;
+  IoHandlePtr accept(struct sockaddr* addr, socklen_t* addrlen) override;
+  Api::SysCallIntResult connect(Address::InstanceConstSharedPtr address) override;
+  IoHandlePtr duplicate() override;
+  void initializeFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                           Event::FileTriggerType trigger, uint32_t events) override;
+  void activateFileEvents(uint32_t events) override;
+  void enableFileEvents(uint32_t events) override;
+  void resetFileEvents() override;
+  Api::SysCallIntResult shutdown(int how) override;
+
+  IoUringSocketType ioUringSocketType() const { return io_uring_socket_type_; }
+
+private:
+  // Returns the result when the pending read data can't be consumed, e.g. there is no data or
+  // there is an error.
+  absl::optional<Api::IoCallUint64Result> checkReadResult() const;
+  // Returns the error of the last write request if there is one.
+  absl::optional<Api::IoCallUint64Result> checkWriteResult() const;
+  std::string ioUringSocketTypeStr() const;
+
+  Io::IoUringWorkerFactory& io_uring_worker_factory_;
+  IoUringSocketType io_uring_socket_type_;
+  OptRef<Io::IoUringSocket> io_uring_socket_{absl::nullopt};
+};
+
+} // namespace Network
+} // namespace Envoy
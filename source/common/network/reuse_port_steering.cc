@@ -0,0 +1,258 @@
+#include "source/common/network/reuse_port_steering.h"
+
+#include <cstring>
+
+#include "envoy/common/platform.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/utility.h"
+
+#include "absl/strings/str_cat.h"
+
+#if defined(__linux__)
+#include <linux/bpf.h>
+#include <sys/mman.h>
+
+#include "source/common/api/os_sys_calls_impl_linux.h"
+
+// These are missing from older headers, but the kernel may still support them.
+#ifndef SO_ATTACH_REUSEPORT_EBPF
+#define SO_ATTACH_REUSEPORT_EBPF 52
+#endif
+#ifndef BPF_F_MMAPABLE
+#define BPF_F_MMAPABLE (1U << 10)
+#endif
+#endif
+
+namespace Envoy {
+namespace Network {
+
+#if defined(__linux__)
+
+namespace {
+
+// The registers of the eBPF calling convention which the program uses.
+constexpr uint8_t R0 = 0;
+constexpr uint8_t R1 = 1;
+constexpr uint8_t R2 = 2;
+constexpr uint8_t R3 = 3;
+constexpr uint8_t R4 = 4;
+constexpr uint8_t R6 = 6;
+constexpr uint8_t R7 = 7;
+constexpr uint8_t R8 = 8;
+constexpr uint8_t R9 = 9;
+constexpr uint8_t R10 = 10;
+
+static_assert(ReusePortSteering::CountStride == 1 << 6, "the program shifts by the stride");
+constexpr int32_t CountStrideShift = 6;
+
+bpf_insn instruction(uint8_t code, uint8_t dst, uint8_t src, int16_t off, int32_t imm) {
+  bpf_insn insn;
+  memset(&insn, 0, sizeof(insn));
+  insn.code = code;
+  insn.dst_reg = dst;
+  insn.src_reg = src;
+  insn.off = off;
+  insn.imm = imm;
+  return insn;
+}
+
+int bpf(int command, bpf_attr& attr, int& error) {
+  const Api::SysCallIntResult result =
+      Api::LinuxOsSysCallsSingleton::get().bpf(command, &attr, sizeof(attr));
+  error = result.errno_;
+  return result.return_value_;
+}
+
+std::vector<bpf_insn> steeringProgram(int counts_fd, int sockets_fd, uint32_t num_sockets) {
+  const int32_t n = num_sockets;
+  std::vector<bpf_insn> program = {
+      // Keep the context for selecting the socket.
+      instruction(BPF_ALU64 | BPF_MOV | BPF_X, R9, R1, 0, 0),
+      // Look up the counts, which are the only value of the map.
+      instruction(BPF_ST | BPF_MEM | BPF_W, R10, 0, -4, 0),
+      instruction(BPF_LD | BPF_DW | BPF_IMM, R1, BPF_PSEUDO_MAP_FD, 0, counts_fd),
+      instruction(0, 0, 0, 0, 0),
+      instruction(BPF_ALU64 | BPF_MOV | BPF_X, R2, R10, 0, 0),
+      instruction(BPF_ALU64 | BPF_ADD | BPF_K, R2, 0, 0, -4),
+      instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_map_lookup_elem),
+      instruction(BPF_JMP | BPF_JEQ | BPF_K, R0, 0, 0 /* pass */, 0),
+      instruction(BPF_ALU64 | BPF_MOV | BPF_X, R6, R0, 0, 0),
+      // Pick two workers with the halves of a random number, scaled to the number of workers.
+      instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_get_prandom_u32),
+      instruction(BPF_ALU64 | BPF_MOV | BPF_X, R7, R0, 0, 0),
+      instruction(BPF_ALU64 | BPF_AND | BPF_K, R7, 0, 0, 0xffff),
+      instruction(BPF_ALU64 | BPF_MUL | BPF_K, R7, 0, 0, n),
+      instruction(BPF_ALU64 | BPF_RSH | BPF_K, R7, 0, 0, 16),
+      instruction(BPF_ALU64 | BPF_MOV | BPF_X, R8, R0, 0, 0),
+      instruction(BPF_ALU64 | BPF_RSH | BPF_K, R8, 0, 0, 16),
+      instruction(BPF_ALU64 | BPF_AND | BPF_K, R8, 0, 0, 0xffff),
+      instruction(BPF_ALU64 | BPF_MUL | BPF_K, R8, 0, 0, n),
+      instruction(BPF_ALU64 | BPF_RSH | BPF_K, R8, 0, 0, 16),
+      // These never jump, but tell the verifier that the counts are within the map value.
+      instruction(BPF_JMP | BPF_JGE | BPF_K, R7, 0, 0 /* pass */, n),
+      instruction(BPF_JMP | BPF_JGE | BPF_K, R8, 0, 0 /* pass */, n),
+      // Load the counts of the two workers and keep the index of the one with the fewer.
+      instruction(BPF_ALU64 | BPF_MOV | BPF_X, R1, R6, 0, 0),
+      instruction(BPF_ALU64 | BPF_MOV | BPF_X, R2, R7, 0, 0),
+      instruction(BPF_ALU64 | BPF_LSH | BPF_K, R2, 0, 0, CountStrideShift),
+      instruction(BPF_ALU64 | BPF_ADD | BPF_X, R1, R2, 0, 0),
+      instruction(BPF_LDX | BPF_MEM | BPF_W, R2, R1, 0, 0),
+      instruction(BPF_ALU64 | BPF_MOV | BPF_X, R1, R6, 0, 0),
+      instruction(BPF_ALU64 | BPF_MOV | BPF_X, R3, R8, 0, 0),
+      instruction(BPF_ALU64 | BPF_LSH | BPF_K, R3, 0, 0, CountStrideShift),
+      instruction(BPF_ALU64 | BPF_ADD | BPF_X, R1, R3, 0, 0),
+      instruction(BPF_LDX | BPF_MEM | BPF_W, R3, R1, 0, 0),
+      instruction(BPF_JMP | BPF_JLE | BPF_X, R2, R3, 1, 0),
+      instruction(BPF_ALU64 | BPF_MOV | BPF_X, R7, R8, 0, 0),
+      // Select the socket of the worker. If it isn't in the array, no socket is selected.
+      instruction(BPF_STX | BPF_MEM | BPF_W, R10, R7, -8, 0),
+      instruction(BPF_ALU64 | BPF_MOV | BPF_X, R1, R9, 0, 0),
+      instruction(BPF_LD | BPF_DW | BPF_IMM, R2, BPF_PSEUDO_MAP_FD, 0, sockets_fd),
+      instruction(0, 0, 0, 0, 0),
+      instruction(BPF_ALU64 | BPF_MOV | BPF_X, R3, R10, 0, 0),
+      instruction(BPF_ALU64 | BPF_ADD | BPF_K, R3, 0, 0, -8),
+      instruction(BPF_ALU64 | BPF_MOV | BPF_K, R4, 0, 0, 0),
+      instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_sk_select_reuseport),
+      // Passing without selecting a socket makes the kernel fall back to the hash of the
+      // connection.
+      instruction(BPF_ALU | BPF_MOV | BPF_K, R0, 0, 0, SK_PASS),
+      instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+  };
+  const int16_t pass = program.size() - 2;
+  for (int16_t i : {7, 19, 20}) {
+    program[i].off = pass - i - 1;
+  }
+  return program;
+}
+
+int createMap(bpf_map_type type, uint32_t key_size, uint32_t value_size, uint32_t max_entries,
+              uint32_t flags, int& error) {
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.map_type = type;
+  attr.key_size = key_size;
+  attr.value_size = value_size;
+  attr.max_entries = max_entries;
+  attr.map_flags = flags;
+  return bpf(BPF_MAP_CREATE, attr, error);
+}
+
+} // namespace
+
+absl::StatusOr<ReusePortSteeringSharedPtr> ReusePortSteering::create(uint32_t num_sockets) {
+  ASSERT(num_sockets > 0 && num_sockets <= 0xffff);
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+
+  int error;
+  const uint32_t counts_value_size = CountStride * num_sockets;
+  const int counts_fd = createMap(BPF_MAP_TYPE_ARRAY, sizeof(uint32_t), counts_value_size, 1,
+                                  BPF_F_MMAPABLE, error);
+  if (counts_fd < 0) {
+    return absl::UnavailableError(absl::StrCat("cannot create BPF map: ", errorDetails(error)));
+  }
+  const int sockets_fd = createMap(BPF_MAP_TYPE_REUSEPORT_SOCKARRAY, sizeof(uint32_t),
+                                   sizeof(uint64_t), num_sockets, 0, error);
+  if (sockets_fd < 0) {
+    os_sys_calls.close(counts_fd);
+    return absl::UnavailableError(
+        absl::StrCat("cannot create BPF socket array: ", errorDetails(error)));
+  }
+
+  const size_t page_size = ::sysconf(_SC_PAGESIZE);
+  const size_t counts_size = (counts_value_size + page_size - 1) / page_size * page_size;
+  const Api::SysCallPtrResult counts = os_sys_calls.mmap(
+      nullptr, counts_size, PROT_READ | PROT_WRITE, MAP_SHARED, counts_fd, 0);
+  if (counts.return_value_ == MAP_FAILED) {
+    os_sys_calls.close(sockets_fd);
+    os_sys_calls.close(counts_fd);
+    return absl::UnavailableError(
+        absl::StrCat("cannot map BPF map: ", errorDetails(counts.errno_)));
+  }
+
+  const std::vector<bpf_insn> program = steeringProgram(counts_fd, sockets_fd, num_sockets);
+  static constexpr char License[] = "Apache-2.0";
+  bpf_attr program_attr;
+  memset(&program_attr, 0, sizeof(program_attr));
+  program_attr.prog_type = BPF_PROG_TYPE_SK_REUSEPORT;
+  program_attr.insns = reinterpret_cast<uintptr_t>(program.data());
+  program_attr.insn_cnt = program.size();
+  program_attr.license = reinterpret_cast<uintptr_t>(License);
+  const int program_fd = bpf(BPF_PROG_LOAD, program_attr, error);
+  if (program_fd < 0) {
+    os_sys_calls.munmap(counts.return_value_, counts_size);
+    os_sys_calls.close(sockets_fd);
+    os_sys_calls.close(counts_fd);
+    return absl::UnavailableError(
+        absl::StrCat("cannot load BPF program: ", errorDetails(error)));
+  }
+
+  return ReusePortSteeringSharedPtr(new ReusePortSteering(
+      counts_fd, sockets_fd, program_fd, counts.return_value_, counts_size, num_sockets));
+}
+
+ReusePortSteering::ReusePortSteering(int counts_fd, int sockets_fd, int program_fd, void* counts,
+                                     size_t counts_size, uint32_t num_sockets)
+    : counts_fd_(counts_fd), sockets_fd_(sockets_fd), program_fd_(program_fd), counts_(counts),
+      counts_size_(counts_size) {
+  loads_.reserve(num_sockets);
+  for (uint32_t i = 0; i < num_sockets; i++) {
+    loads_.emplace_back(
+        reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(counts_) + i * CountStride));
+  }
+}
+
+ReusePortSteering::~ReusePortSteering() {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  os_sys_calls.munmap(counts_, counts_size_);
+  os_sys_calls.close(program_fd_);
+  os_sys_calls.close(sockets_fd_);
+  os_sys_calls.close(counts_fd_);
+}
+
+Api::SysCallIntResult ReusePortSteering::addSocket(uint32_t index, Socket& socket) const {
+  ASSERT(index < loads_.size());
+  const uint64_t fd = socket.ioHandle().fdDoNotUse();
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.map_fd = sockets_fd_;
+  attr.key = reinterpret_cast<uintptr_t>(&index);
+  attr.value = reinterpret_cast<uintptr_t>(&fd);
+  attr.flags = BPF_ANY;
+  int error;
+  const int rc = bpf(BPF_MAP_UPDATE_ELEM, attr, error);
+  return {rc, error};
+}
+
+Api::SysCallIntResult ReusePortSteering::attach(Socket& socket) const {
+  return socket.setSocketOption(SOL_SOCKET, SO_ATTACH_REUSEPORT_EBPF, &program_fd_,
+                                sizeof(program_fd_));
+}
+
+uint32_t ReusePortSteering::connections(uint32_t index) const {
+  return __atomic_load_n(
+      reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(counts_) + index * CountStride),
+      __ATOMIC_RELAXED);
+}
+
+#else
+
+absl::StatusOr<ReusePortSteeringSharedPtr> ReusePortSteering::create(uint32_t) {
+  return absl::UnimplementedError("steering connections by load is only supported on Linux");
+}
+
+ReusePortSteering::~ReusePortSteering() = default;
+
+Api::SysCallIntResult ReusePortSteering::addSocket(uint32_t, Socket&) const {
+  PANIC("not implemented");
+}
+
+Api::SysCallIntResult ReusePortSteering::attach(Socket&) const { PANIC("not implemented"); }
+
+uint32_t ReusePortSteering::connections(uint32_t) const { PANIC("not implemented"); }
+
+#endif
+
+} // namespace Network
+} // namespace Envoy
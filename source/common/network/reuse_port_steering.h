@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/api/os_sys_calls_common.h"
+#include "envoy/network/listen_socket.h"
+#include "envoy/network/listener.h"
+
+#include "absl/status/statusor.h"
+
+namespace Envoy {
+namespace Network {
+
+class ReusePortSteering;
+using ReusePortSteeringSharedPtr = std::shared_ptr<ReusePortSteering>;
+
+/**
+ * Steers the connections to the SO_REUSEPORT group of the listen sockets of the workers by the
+ * number of connections which the workers have active, rather than by the hash of the
+ * connections' addresses. An eBPF program attached to the group picks two of the sockets at
+ * random and sends each connection to the one whose worker has fewer connections. Picking the
+ * less loaded of two sockets rather than the least loaded of all of them keeps bursts of
+ * connections from all going to the same socket before its worker has accepted them. The counts
+ * are kept in a memory mapped BPF array, which the workers update without system calls.
+ *
+ * The program selects a socket from a BPF socket array by the index of its worker, so it doesn't
+ * depend on the order in which the sockets joined the group, which changes as sockets are closed
+ * and listeners are updated. A connection for which the selected socket isn't in the array is
+ * sent by the hash of its addresses instead. This is only supported on Linux.
+ */
+class ReusePortSteering {
+public:
+  /**
+   * @param num_sockets supplies the number of sockets in the group.
+   * @return the steering, or an error if the kernel doesn't support it or the process isn't
+   *         allowed to load BPF programs.
+   */
+  static absl::StatusOr<ReusePortSteeringSharedPtr> create(uint32_t num_sockets);
+
+  ~ReusePortSteering();
+
+  /**
+   * Adds the socket of a worker to the sockets which the program selects from.
+   * @param index supplies the index of the worker.
+   * @param socket supplies the socket, which must be listening.
+   */
+  Api::SysCallIntResult addSocket(uint32_t index, Socket& socket) const;
+
+  /**
+   * Attaches the program to the group of a socket, which must be listening.
+   */
+  Api::SysCallIntResult attach(Socket& socket) const;
+
+  /**
+   * @return the load of the socket of the given index.
+   */
+  ListenSocketLoad& load(uint32_t index) { return loads_[index]; }
+
+  /**
+   * @return the number of connections which the worker of the socket of the given index has
+   *         active, as the program sees it.
+   */
+  uint32_t connections(uint32_t index) const;
+
+  // The counts are a cache line apart, so that workers don't contend for the lines of others.
+  static constexpr uint32_t CountStride = 64;
+
+private:
+  class Load : public ListenSocketLoad {
+  public:
+    explicit Load(uint32_t* count) : count_(count) {}
+
+    // Network::ListenSocketLoad
+    void add(int64_t connections) override {
+      __atomic_fetch_add(count_, static_cast<uint32_t>(connections), __ATOMIC_RELAXED);
+    }
+
+  private:
+    uint32_t* const count_;
+  };
+
+  ReusePortSteering(int counts_fd, int sockets_fd, int program_fd, void* counts,
+                    size_t counts_size, uint32_t num_sockets);
+
+  const int counts_fd_;
+  const int sockets_fd_;
+  const int program_fd_;
+  void* const counts_;
+  const size_t counts_size_;
+  std::vector<Load> loads_;
+};
+
+} // namespace Network
+} // namespace Envoy
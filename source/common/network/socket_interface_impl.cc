@@ -9,6 +9,13 @@
 #include "source/common/network/address_impl.h"
 #include "source/common/network/io_socket_handle_impl.h"
 #include "source/common/network/win32_socket_handle_impl.h"
+#include "source/common/protobuf/utility.h"
+
+#ifdef __linux__
+#include "source/common/io/io_uring_impl.h"
+#include "source/common/io/io_uring_worker_factory_impl.h"
+#include "source/common/network/io_uring_socket_handle_impl.h"
+#endif
 
 namespace Envoy {
 namespace Network {
@@ -26,6 +33,31 @@ IoHandlePtr SocketInterfaceImpl::makeSocket(int socket_fd, bool socket_v6only,
   return makePlatformSpecificSocket(socket_fd, socket_v6only, domain);
 }
 
+IoHandlePtr SocketInterfaceImpl::makeIoUringSocket(int socket_fd, bool socket_v6only,
+                                                   Socket::Type socket_type,
+                                                   absl::optional<int> domain) const {
+#ifdef __linux__
+  // The io_uring socket handle only supports stream sockets.
+  if (socket_type != Socket::Type::Stream) {
+    return nullptr;
+  }
+  std::shared_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory =
+      io_uring_worker_factory_.lock();
+  if (io_uring_worker_factory == nullptr || !io_uring_worker_factory->currentThreadRegistered() ||
+      !io_uring_worker_factory->getIoUringWorker().has_value()) {
+    return nullptr;
+  }
+  return std::make_unique<IoUringSocketHandleImpl>(*io_uring_worker_factory, socket_fd,
+                                                   socket_v6only, domain);
+#else
+  UNREFERENCED_PARAMETER(socket_fd);
+  UNREFERENCED_PARAMETER(socket_v6only);
+  UNREFERENCED_PARAMETER(socket_type);
+  UNREFERENCED_PARAMETER(domain);
+  return nullptr;
+#endif
+}
+
 IoHandlePtr SocketInterfaceImpl::socket(Socket::Type socket_type, Address::Type addr_type,
                                         Address::IpVersion version, bool socket_v6only,
                                         const SocketCreationOptions& options) const {
@@ -70,7 +102,11 @@ IoHandlePtr SocketInterfaceImpl::socket(Socket::Type socket_type, Address::Type
       Api::OsSysCallsSingleton::get().socket(domain, flags, protocol);
   RELEASE_ASSERT(SOCKET_VALID(result.return_value_),
                  fmt::format("socket(2) failed, got error: {}", errorDetails(result.errno_)));
-  IoHandlePtr io_handle = makeSocket(result.return_value_, socket_v6only, domain);
+  IoHandlePtr io_handle =
+      makeIoUringSocket(result.return_value_, socket_v6only, socket_type, domain);
+  if (io_handle == nullptr) {
+    io_handle = makeSocket(result.return_value_, socket_v6only, domain);
+  }
 
 #if defined(__APPLE__) || defined(WIN32)
   // Cannot set SOCK_NONBLOCK as a ::socket flag.
@@ -116,8 +152,32 @@ bool SocketInterfaceImpl::ipFamilySupported(int domain) {
 }
 
 Server::BootstrapExtensionPtr
-SocketInterfaceImpl::createBootstrapExtension(const Protobuf::Message&,
-                                              Server::Configuration::ServerFactoryContext&) {
+SocketInterfaceImpl::createBootstrapExtension(const Protobuf::Message& config,
+                                              Server::Configuration::ServerFactoryContext& context) {
+#ifdef __linux__
+  const auto& message = MessageUtil::downcastAndValidate<
+      const envoy::extensions::network::socket_interface::v3::DefaultSocketInterface&>(
+      config, context.messageValidationVisitor());
+  if (message.has_io_uring_options()) {
+    if (Io::isIoUringSupported()) {
+      const auto& options = message.io_uring_options();
+      std::shared_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory =
+          std::make_shared<Io::IoUringWorkerFactoryImpl>(
+              PROTOBUF_GET_WRAPPED_OR_DEFAULT(options, io_uring_size, 1000),
+              options.enable_submission_queue_polling(),
+              PROTOBUF_GET_WRAPPED_OR_DEFAULT(options, read_buffer_size, 8192),
+              PROTOBUF_GET_WRAPPED_OR_DEFAULT(options, write_timeout_ms, 1000),
+              context.threadLocal());
+      io_uring_worker_factory_ = io_uring_worker_factory;
+      return std::make_unique<SocketInterfaceExtension>(*this, io_uring_worker_factory);
+    }
+    ENVOY_LOG_MISC(warn, "io_uring is not supported by the kernel, fall back to the default "
+                         "socket API");
+  }
+#else
+  UNREFERENCED_PARAMETER(config);
+  UNREFERENCED_PARAMETER(context);
+#endif
   return std::make_unique<SocketInterfaceExtension>(*this);
 }
 
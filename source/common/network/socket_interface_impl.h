@@ -1,5 +1,6 @@
 #pragma once
 
+#include "envoy/common/io/io_uring.h"
 #include "envoy/network/socket.h"
 
 #include "source/common/network/socket_interface.h"
@@ -32,6 +33,15 @@ public:
 protected:
   virtual IoHandlePtr makeSocket(int socket_fd, bool socket_v6only,
                                  absl::optional<int> domain) const;
+
+private:
+  // Returns an io_uring socket handle if the io_uring is enabled and the current thread is running
+  // an io_uring worker, otherwise nullptr.
+  IoHandlePtr makeIoUringSocket(int socket_fd, bool socket_v6only, Socket::Type socket_type,
+                                absl::optional<int> domain) const;
+
+  // The io_uring worker factory is owned by the bootstrap extension.
+  std::weak_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory_;
 };
 
 DECLARE_FACTORY(SocketInterfaceImpl);
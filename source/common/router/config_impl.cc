@@ -51,6 +51,7 @@
 #include "source/extensions/path/match/uri_template/uri_template_match.h"
 #include "source/extensions/path/rewrite/uri_template/uri_template_rewrite.h"
 
+#include "absl/strings/ascii.h"
 #include "absl/strings/match.h"
 
 namespace Envoy {
@@ -812,6 +813,23 @@ bool RouteEntryImplBase::matchRoute(const Http::RequestHeaderMap& headers,
   return matches;
 }
 
+bool RouteEntryImplBase::matchesOnPathOnly() const {
+  switch (matchType()) {
+  case PathMatchType::Prefix:
+  case PathMatchType::Exact:
+  case PathMatchType::PathSeparatedPrefix:
+    break;
+  default:
+    return false;
+  }
+  // A path without letters matches the same paths whether or not it is case sensitive.
+  const std::string& path = matcher();
+  return (case_sensitive_ || std::none_of(path.begin(), path.end(), absl::ascii_isalpha)) &&
+         runtime_ == nullptr && !match_grpc_ && config_headers_.empty() &&
+         config_query_parameters_.empty() && tls_context_match_criteria_ == nullptr &&
+         dynamic_metadata_.empty();
+}
+
 const std::string& RouteEntryImplBase::clusterName() const { return cluster_name_; }
 
 void RouteEntryImplBase::finalizeRequestHeaders(Http::RequestHeaderMap& headers,
@@ -1814,9 +1832,80 @@ VirtualHostImpl::VirtualHostImpl(
       routes_.emplace_back(createAndValidateRoute(route, shared_virtual_host_, factory_context,
                                                   validator, validation_clusters));
     }
+    compileRouteRuns();
+  }
+}
+
+namespace {
+
+RoutePathTrie::MatchType routePathTrieMatchType(PathMatchType type) {
+  switch (type) {
+  case PathMatchType::Prefix:
+    return RoutePathTrie::MatchType::Prefix;
+  case PathMatchType::Exact:
+    return RoutePathTrie::MatchType::Exact;
+  case PathMatchType::PathSeparatedPrefix:
+    return RoutePathTrie::MatchType::PathSeparatedPrefix;
+  default:
+    PANIC("unexpected path match type");
   }
 }
 
+} // namespace
+
+void VirtualHostImpl::compileRouteRuns() {
+  // Runs of routes matching requests on their path alone are compiled into tries, and runs of
+  // routes matching paths with Google RE2 regexes into regex sets, which keep the routes' order.
+  // The routes in between them are evaluated one at a time.
+  std::vector<RouteRun> runs;
+  size_t linear_begin = 0;
+  size_t begin = 0;
+  const auto add_run = [&](RouteRun&& run) {
+    if (linear_begin < run.begin_) {
+      runs.push_back({linear_begin, run.begin_, nullptr, nullptr});
+    }
+    linear_begin = begin = run.end_;
+    runs.push_back(std::move(run));
+  };
+
+  while (begin < routes_.size()) {
+    size_t end = begin;
+    while (end < routes_.size() && routes_[end]->matchesOnPathOnly()) {
+      end++;
+    }
+    if (end - begin >= MinRoutesPerTrie) {
+      auto trie = std::make_unique<RoutePathTrie>();
+      for (size_t i = begin; i < end; i++) {
+        trie->add(routes_[i]->matcher(), routePathTrieMatchType(routes_[i]->matchType()),
+                  i - begin);
+      }
+      add_run({begin, end, std::move(trie), nullptr});
+      continue;
+    }
+
+    if (end == begin) {
+      auto regex_set = std::make_unique<Regex::CompiledGoogleReSet>();
+      while (end < routes_.size() && routes_[end]->pathRegex() != nullptr &&
+             regex_set->add(*routes_[end]->pathRegex())) {
+        end++;
+      }
+      if (end - begin >= MinRoutesPerRegexSet && regex_set->compile()) {
+        add_run({begin, end, nullptr, std::move(regex_set)});
+        continue;
+      }
+    }
+    begin = std::max(end, begin + 1);
+  }
+
+  if (runs.empty()) {
+    return;
+  }
+  if (linear_begin < routes_.size()) {
+    runs.push_back({linear_begin, routes_.size(), nullptr, nullptr});
+  }
+  route_runs_ = std::move(runs);
+}
+
 const std::shared_ptr<const SslRedirectRoute> VirtualHostImpl::SSL_REDIRECT_ROUTE{
     new SslRedirectRoute()};
 
@@ -1834,22 +1923,78 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromRoutes(
       continue;
     }
 
-    if (cb == nullptr) {
-      return route_entry;
+    absl::optional<RouteConstSharedPtr> result =
+        onRouteMatched(cb, std::move(route_entry), std::next(route) == routes.end());
+    if (result.has_value()) {
+      return std::move(result.value());
     }
+  }
 
-    RouteEvalStatus eval_status = (std::next(route) == routes.end())
-                                      ? RouteEvalStatus::NoMoreRoutes
-                                      : RouteEvalStatus::HasMoreRoutes;
-    RouteMatchStatus match_status = cb(route_entry, eval_status);
-    if (match_status == RouteMatchStatus::Accept) {
-      return route_entry;
+  ENVOY_LOG(debug, "route was resolved but final route list did not match incoming request");
+  return nullptr;
+}
+
+RouteConstSharedPtr VirtualHostImpl::getRouteFromRouteRuns(
+    const RouteCallback& cb, const Http::RequestHeaderMap& headers,
+    const StreamInfo::StreamInfo& stream_info, uint64_t random_value) const {
+  // The path as the routes in the tries match it.
+  absl::string_view path = Http::PathUtil::removeQueryAndFragment(headers.getPathValue());
+  if (shared_virtual_host_->globalRouteConfig().ignorePathParametersInPathMatching()) {
+    path = path.substr(0, path.find(';'));
+  }
+
+  const auto evaluate = [&](size_t index) -> absl::optional<RouteConstSharedPtr> {
+    const RouteEntryImplBaseConstSharedPtr& route = routes_[index];
+    if (!headers.Path() && !route->supportsPathlessHeaders()) {
+      return absl::nullopt;
     }
-    if (match_status == RouteMatchStatus::Continue &&
-        eval_status == RouteEvalStatus::NoMoreRoutes) {
-      ENVOY_LOG(debug,
-                "return null when route match status is Continue but there is no more routes");
-      return nullptr;
+    // Routes found in a trie or a regex set are still evaluated, which checks their other match
+    // criteria and picks their cluster.
+    RouteConstSharedPtr route_entry = route->matches(headers, stream_info, random_value);
+    if (route_entry == nullptr) {
+      return absl::nullopt;
+    }
+    return onRouteMatched(cb, std::move(route_entry), index + 1 == routes_.size());
+  };
+
+  RoutePathTrie::Matches trie_matches;
+  std::vector<int> regex_matches;
+  for (const RouteRun& run : route_runs_) {
+    if (run.trie_ != nullptr || run.regex_set_ != nullptr) {
+      // Routes matching paths don't match requests without one.
+      if (!headers.Path()) {
+        continue;
+      }
+
+      if (run.trie_ != nullptr) {
+        trie_matches.clear();
+        run.trie_->findMatches(path, trie_matches);
+        for (const uint32_t i : trie_matches) {
+          absl::optional<RouteConstSharedPtr> result = evaluate(run.begin_ + i);
+          if (result.has_value()) {
+            return std::move(result.value());
+          }
+        }
+        continue;
+      }
+
+      if (run.regex_set_->findMatches(path, regex_matches)) {
+        for (const int i : regex_matches) {
+          absl::optional<RouteConstSharedPtr> result = evaluate(run.begin_ + i);
+          if (result.has_value()) {
+            return std::move(result.value());
+          }
+        }
+        continue;
+      }
+      // The regex set ran out of memory, and the routes are evaluated one at a time instead.
+    }
+
+    for (size_t index = run.begin_; index < run.end_; index++) {
+      absl::optional<RouteConstSharedPtr> result = evaluate(index);
+      if (result.has_value()) {
+        return std::move(result.value());
+      }
     }
   }
 
@@ -1857,6 +2002,26 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromRoutes(
   return nullptr;
 }
 
+absl::optional<RouteConstSharedPtr>
+VirtualHostImpl::onRouteMatched(const RouteCallback& cb, RouteConstSharedPtr&& route_entry,
+                                bool last_route) const {
+  if (cb == nullptr) {
+    return std::move(route_entry);
+  }
+
+  RouteEvalStatus eval_status =
+      last_route ? RouteEvalStatus::NoMoreRoutes : RouteEvalStatus::HasMoreRoutes;
+  RouteMatchStatus match_status = cb(route_entry, eval_status);
+  if (match_status == RouteMatchStatus::Accept) {
+    return std::move(route_entry);
+  }
+  if (match_status == RouteMatchStatus::Continue && eval_status == RouteEvalStatus::NoMoreRoutes) {
+    ENVOY_LOG(debug, "return null when route match status is Continue but there is no more routes");
+    return RouteConstSharedPtr();
+  }
+  return absl::nullopt;
+}
+
 RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb,
                                                          const Http::RequestHeaderMap& headers,
                                                          const StreamInfo::StreamInfo& stream_info,
@@ -1906,29 +2071,30 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb
   }
 
   // Check for a route that matches the request.
+  if (!route_runs_.empty()) {
+    return getRouteFromRouteRuns(cb, headers, stream_info, random_value);
+  }
   return getRouteFromRoutes(cb, headers, stream_info, random_value, routes_);
 }
 
-const VirtualHostImpl* RouteMatcher::findWildcardVirtualHost(
-    absl::string_view host, const RouteMatcher::WildcardVirtualHosts& wildcard_virtual_hosts,
-    RouteMatcher::SubstringFunction substring_function) const {
+const VirtualHostImpl*
+RouteMatcher::findWildcardVirtualHost(absl::string_view host,
+                                      const WildcardDomainTrie& wildcard_domains) const {
   // We do a longest wildcard match against the host that's passed in
   // (e.g. "foo-bar.baz.com" should match "*-bar.baz.com" before matching "*.baz.com" for suffix
-  // wildcards). This is done by scanning the length => wildcards map looking for every wildcard
-  // whose size is < length.
-  for (const auto& iter : wildcard_virtual_hosts) {
-    const uint32_t wildcard_length = iter.first;
-    const auto& wildcard_map = iter.second;
-    // >= because *.foo.com shouldn't match .foo.com.
-    if (wildcard_length >= host.size()) {
-      continue;
-    }
-    const auto match = wildcard_map.find(substring_function(host, wildcard_length));
-    if (match != wildcard_map.end()) {
-      return match->second.get();
-    }
+  // wildcards). The trie finds it in a single walk of the host.
+  const absl::optional<uint32_t> index = wildcard_domains.findLongestMatch(host);
+  return index.has_value() ? wildcard_virtual_hosts_[index.value()].get() : nullptr;
+}
+
+bool RouteMatcher::addWildcardVirtualHost(WildcardDomainTrie& wildcard_domains,
+                                          absl::string_view domain,
+                                          const VirtualHostSharedPtr& virtual_host) {
+  // The domains of a virtual host are added one after the other, and share its index.
+  if (wildcard_virtual_hosts_.empty() || wildcard_virtual_hosts_.back() != virtual_host) {
+    wildcard_virtual_hosts_.push_back(virtual_host);
   }
-  return nullptr;
+  return wildcard_domains.add(domain, wildcard_virtual_hosts_.size() - 1);
 }
 
 RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& route_config,
@@ -1957,13 +2123,12 @@ RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& r
         }
         default_virtual_host_ = virtual_host;
       } else if (!domain.empty() && '*' == domain[0]) {
-        duplicate_found = !wildcard_virtual_host_suffixes_[domain.size() - 1]
-                               .emplace(domain.substr(1), virtual_host)
-                               .second;
+        duplicate_found = !addWildcardVirtualHost(wildcard_virtual_host_suffixes_,
+                                                  domain.substr(1), virtual_host);
       } else if (!domain.empty() && '*' == domain[domain.size() - 1]) {
-        duplicate_found = !wildcard_virtual_host_prefixes_[domain.size() - 1]
-                               .emplace(domain.substr(0, domain.size() - 1), virtual_host)
-                               .second;
+        duplicate_found =
+            !addWildcardVirtualHost(wildcard_virtual_host_prefixes_,
+                                    domain.substr(0, domain.size() - 1), virtual_host);
       } else {
         duplicate_found = !virtual_hosts_.emplace(domain, virtual_host).second;
       }
@@ -2007,17 +2172,13 @@ const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::RequestHeaderMa
     return iter->second.get();
   }
   if (!wildcard_virtual_host_suffixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_suffixes_,
-        [](absl::string_view h, int l) -> absl::string_view { return h.substr(h.size() - l); });
+    const VirtualHostImpl* vhost = findWildcardVirtualHost(host, wildcard_virtual_host_suffixes_);
     if (vhost != nullptr) {
       return vhost;
     }
   }
   if (!wildcard_virtual_host_prefixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_prefixes_,
-        [](absl::string_view h, int l) -> absl::string_view { return h.substr(0, l); });
+    const VirtualHostImpl* vhost = findWildcardVirtualHost(host, wildcard_virtual_host_prefixes_);
     if (vhost != nullptr) {
       return vhost;
     }
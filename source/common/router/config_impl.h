@@ -24,6 +24,7 @@
 
 #include "source/common/common/matchers.h"
 #include "source/common/common/packed_struct.h"
+#include "source/common/common/regex.h"
 #include "source/common/config/metadata.h"
 #include "source/common/http/hash_policy.h"
 #include "source/common/http/header_utility.h"
@@ -31,8 +32,10 @@
 #include "source/common/router/config_utility.h"
 #include "source/common/router/header_parser.h"
 #include "source/common/router/metadatamatchcriteria_impl.h"
+#include "source/common/router/route_path_trie.h"
 #include "source/common/router/router_ratelimit.h"
 #include "source/common/router/tls_context_match_criteria_impl.h"
+#include "source/common/router/wildcard_domain_trie.h"
 #include "source/common/stats/symbol_table.h"
 
 #include "absl/container/node_hash_map.h"
@@ -380,6 +383,36 @@ public:
 private:
   enum class SslRequirements : uint8_t { None, ExternalOnly, All };
 
+  // A run of consecutive routes in routes_. The routes of a run with a trie all match requests on
+  // their path alone, and are found in the trie by their index in the run. The routes of a run
+  // with a regex set all match paths with a regex, and only those whose regex matches the path,
+  // found in the set by their index in the run, are evaluated. The routes of other runs are
+  // evaluated one at a time.
+  struct RouteRun {
+    size_t begin_;
+    size_t end_;
+    std::unique_ptr<const RoutePathTrie> trie_;
+    std::unique_ptr<const Regex::CompiledGoogleReSet> regex_set_;
+  };
+
+  // Runs of fewer routes matching requests on their path alone, or with a regex, are evaluated one
+  // at a time.
+  static constexpr size_t MinRoutesPerTrie = 8;
+  static constexpr size_t MinRoutesPerRegexSet = 4;
+
+  void compileRouteRuns();
+
+  RouteConstSharedPtr getRouteFromRouteRuns(const RouteCallback& cb,
+                                            const Http::RequestHeaderMap& headers,
+                                            const StreamInfo::StreamInfo& stream_info,
+                                            uint64_t random_value) const;
+
+  // Returns the route to use once route_entry was matched, or nullopt to keep evaluating the
+  // remaining routes.
+  absl::optional<RouteConstSharedPtr> onRouteMatched(const RouteCallback& cb,
+                                                     RouteConstSharedPtr&& route_entry,
+                                                     bool last_route) const;
+
   static const std::shared_ptr<const SslRedirectRoute> SSL_REDIRECT_ROUTE;
 
   CommonVirtualHostSharedPtr shared_virtual_host_;
@@ -387,6 +420,8 @@ private:
   SslRequirements ssl_requirements_;
 
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  // Empty unless some routes were compiled into tries.
+  std::vector<RouteRun> route_runs_;
   Matcher::MatchTreeSharedPtr<Http::HttpMatchingData> matcher_;
 };
 
@@ -632,6 +667,11 @@ public:
 
   bool matchRoute(const Http::RequestHeaderMap& headers, const StreamInfo::StreamInfo& stream_info,
                   uint64_t random_value) const;
+  // Whether the route matches requests on their path alone, with its prefix, path or path
+  // separated prefix, in which case it can be found in a RoutePathTrie.
+  bool matchesOnPathOnly() const;
+  // The regex that the paths of requests matched by the route must match, if any.
+  virtual const Regex::CompiledMatcher* pathRegex() const { return nullptr; }
   void validateClusters(const Upstream::ClusterManager::ClusterInfoMaps& cluster_info_maps) const;
 
   // Router::RouteEntry
@@ -1348,6 +1388,11 @@ public:
   absl::optional<std::string>
   currentUrlPathAfterRewrite(const Http::RequestHeaderMap& headers) const override;
 
+  // RouteEntryImplBase
+  const Regex::CompiledMatcher* pathRegex() const override {
+    return path_matcher_->matcher().regex();
+  }
+
 private:
   const Matchers::PathMatcherConstSharedPtr path_matcher_;
 };
@@ -1488,27 +1533,18 @@ public:
   const VirtualHostImpl* findVirtualHost(const Http::RequestHeaderMap& headers) const;
 
 private:
-  using WildcardVirtualHosts =
-      std::map<int64_t, absl::node_hash_map<std::string, VirtualHostSharedPtr>, std::greater<>>;
-  using SubstringFunction = std::function<absl::string_view(absl::string_view, int)>;
   const VirtualHostImpl* findWildcardVirtualHost(absl::string_view host,
-                                                 const WildcardVirtualHosts& wildcard_virtual_hosts,
-                                                 SubstringFunction substring_function) const;
+                                                 const WildcardDomainTrie& wildcard_domains) const;
+  bool addWildcardVirtualHost(WildcardDomainTrie& wildcard_domains, absl::string_view domain,
+                              const VirtualHostSharedPtr& virtual_host);
   bool ignorePortInHostMatching() const { return ignore_port_in_host_matching_; }
 
   Stats::ScopeSharedPtr vhost_scope_;
   absl::node_hash_map<std::string, VirtualHostSharedPtr> virtual_hosts_;
-  // std::greater as a minor optimization to iterate from more to less specific
-  //
-  // A note on using an unordered_map versus a vector of (string, VirtualHostSharedPtr) pairs:
-  //
-  // Based on local benchmarks, each vector entry costs around 20ns for recall and (string)
-  // comparison with a fixed cost of about 25ns. For unordered_map, the empty map costs about 65ns
-  // and climbs to about 110ns once there are any entries.
-  //
-  // The break-even is 4 entries.
-  WildcardVirtualHosts wildcard_virtual_host_suffixes_;
-  WildcardVirtualHosts wildcard_virtual_host_prefixes_;
+  // The virtual hosts of the wildcard domains, which the tries identify by their index.
+  std::vector<VirtualHostSharedPtr> wildcard_virtual_hosts_;
+  WildcardDomainTrie wildcard_virtual_host_suffixes_{WildcardDomainTrie::MatchType::Suffix};
+  WildcardDomainTrie wildcard_virtual_host_prefixes_{WildcardDomainTrie::MatchType::Prefix};
 
   VirtualHostSharedPtr default_virtual_host_;
   const bool ignore_port_in_host_matching_{false};
@@ -0,0 +1,86 @@
+#include "source/common/router/route_path_trie.h"
+
+#include <algorithm>
+
+#include "absl/strings/match.h"
+
+namespace Envoy {
+namespace Router {
+
+namespace {
+
+// Returns the child whose label starts with c, if any, or else where such a child would go.
+template <class Children> auto findChild(Children& children, char c) {
+  return std::lower_bound(children.begin(), children.end(), c,
+                          [](const auto& child, char first) { return child->label_[0] < first; });
+}
+
+} // namespace
+
+void RoutePathTrie::add(absl::string_view path, MatchType type, uint32_t index) {
+  Node* node = &root_;
+  while (!path.empty()) {
+    auto child = findChild(node->children_, path[0]);
+    if (child == node->children_.end() || (*child)->label_[0] != path[0]) {
+      auto leaf = std::make_unique<Node>();
+      leaf->label_ = std::string(path);
+      node = node->children_.insert(child, std::move(leaf))->get();
+      break;
+    }
+
+    const std::string& label = (*child)->label_;
+    const size_t common =
+        std::mismatch(label.begin(), label.end(), path.begin(), path.end()).first - label.begin();
+    if (common < label.size()) {
+      // The path diverges from the child's label, which is split where it does.
+      auto middle = std::make_unique<Node>();
+      middle->label_ = label.substr(0, common);
+      (*child)->label_.erase(0, common);
+      middle->children_.push_back(std::move(*child));
+      *child = std::move(middle);
+    }
+    node = child->get();
+    path.remove_prefix(common);
+  }
+  node->routes_.push_back({index, type});
+}
+
+void RoutePathTrie::findMatches(absl::string_view path, Matches& matches) const {
+  const Node* node = &root_;
+  size_t matched = 0;
+  while (true) {
+    const bool at_end = matched == path.size();
+    for (const Route& route : node->routes_) {
+      switch (route.type_) {
+      case MatchType::Prefix:
+        matches.push_back(route.index_);
+        break;
+      case MatchType::Exact:
+        if (at_end) {
+          matches.push_back(route.index_);
+        }
+        break;
+      case MatchType::PathSeparatedPrefix:
+        if (at_end || path[matched] == '/') {
+          matches.push_back(route.index_);
+        }
+        break;
+      }
+    }
+    if (at_end) {
+      break;
+    }
+
+    const auto child = findChild(node->children_, path[matched]);
+    if (child == node->children_.end() || (*child)->label_[0] != path[matched] ||
+        !absl::StartsWith(path.substr(matched), (*child)->label_)) {
+      break;
+    }
+    matched += (*child)->label_.size();
+    node = child->get();
+  }
+  std::sort(matches.begin(), matches.end());
+}
+
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Radix tree of the paths matched by a run of routes, used to find the routes matching a request
+ * path in a single walk of the path instead of testing the routes one at a time. Routes are
+ * identified by their index in the run, so that the caller can keep evaluating them in order.
+ */
+class RoutePathTrie {
+public:
+  enum class MatchType : uint8_t {
+    // The path starts with the route's path.
+    Prefix,
+    // The path is the route's path.
+    Exact,
+    // The path is the route's path, or starts with it followed by a '/'.
+    PathSeparatedPrefix,
+  };
+
+  using Matches = absl::InlinedVector<uint32_t, 8>;
+
+  /**
+   * Adds a route to the trie.
+   * @param path the path matched by the route.
+   * @param type how the route matches paths.
+   * @param index the index identifying the route.
+   */
+  void add(absl::string_view path, MatchType type, uint32_t index);
+
+  /**
+   * Finds the routes matching a path.
+   * @param path the path to match, without its query and fragment.
+   * @param matches receives the indexes of the matching routes, in increasing order.
+   */
+  void findMatches(absl::string_view path, Matches& matches) const;
+
+private:
+  struct Route {
+    uint32_t index_;
+    MatchType type_;
+  };
+
+  struct Node {
+    // The part of the path between the parent node and this one.
+    std::string label_;
+    // Sorted by the first character of their labels, which is unique among the children.
+    std::vector<std::unique_ptr<Node>> children_;
+    // The routes whose path ends at this node.
+    std::vector<Route> routes_;
+  };
+
+  Node root_;
+};
+
+} // namespace Router
+} // namespace Envoy
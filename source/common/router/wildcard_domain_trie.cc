@@ -0,0 +1,87 @@
+#include "source/common/router/wildcard_domain_trie.h"
+
+#include <algorithm>
+
+namespace Envoy {
+namespace Router {
+
+namespace {
+
+// Returns the child whose label starts with c, if any, or else where such a child would go.
+template <class Children> auto findChild(Children& children, char c) {
+  return std::lower_bound(children.begin(), children.end(), c,
+                          [](const auto& child, char first) { return child->label_[0] < first; });
+}
+
+} // namespace
+
+bool WildcardDomainTrie::add(absl::string_view domain, uint32_t index) {
+  std::string key(domain);
+  if (type_ == MatchType::Suffix) {
+    std::reverse(key.begin(), key.end());
+  }
+
+  Node* node = &root_;
+  absl::string_view remaining = key;
+  while (!remaining.empty()) {
+    auto child = findChild(node->children_, remaining[0]);
+    if (child == node->children_.end() || (*child)->label_[0] != remaining[0]) {
+      auto leaf = std::make_unique<Node>();
+      leaf->label_ = std::string(remaining);
+      node = node->children_.insert(child, std::move(leaf))->get();
+      break;
+    }
+
+    const std::string& label = (*child)->label_;
+    const size_t common =
+        std::mismatch(label.begin(), label.end(), remaining.begin(), remaining.end()).first -
+        label.begin();
+    if (common < label.size()) {
+      // The domain diverges from the child's label, which is split where it does.
+      auto middle = std::make_unique<Node>();
+      middle->label_ = label.substr(0, common);
+      (*child)->label_.erase(0, common);
+      middle->children_.push_back(std::move(*child));
+      *child = std::move(middle);
+    }
+    node = child->get();
+    remaining.remove_prefix(common);
+  }
+
+  if (node->index_.has_value()) {
+    return false;
+  }
+  node->index_ = index;
+  return true;
+}
+
+absl::optional<uint32_t> WildcardDomainTrie::findLongestMatch(absl::string_view host) const {
+  const Node* node = &root_;
+  size_t matched = 0;
+  absl::optional<uint32_t> longest;
+  while (matched < host.size()) {
+    const auto child = findChild(node->children_, charAt(host, matched));
+    if (child == node->children_.end() || (*child)->label_[0] != charAt(host, matched)) {
+      break;
+    }
+    const std::string& label = (*child)->label_;
+    // The wildcard must match at least one character, which deeper domains leave none for either.
+    if (matched + label.size() >= host.size()) {
+      break;
+    }
+    for (size_t i = 1; i < label.size(); i++) {
+      if (label[i] != charAt(host, matched + i)) {
+        return longest;
+      }
+    }
+    matched += label.size();
+    node = child->get();
+    if (node->index_.has_value()) {
+      longest = node->index_;
+    }
+  }
+  return longest;
+}
+
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Radix tree of the wildcard domains of virtual hosts, used to find the longest wildcard domain
+ * matching a host in a single walk of the host instead of one lookup per wildcard length. Suffix
+ * wildcard domains are stored from their last character to their first, so that the hosts they
+ * match are walked from the end. Domains are identified by an index chosen by the caller.
+ */
+class WildcardDomainTrie {
+public:
+  enum class MatchType : uint8_t {
+    // The host ends with the domain, e.g. "*.foo.com" matches "bar.foo.com".
+    Suffix,
+    // The host starts with the domain, e.g. "foo.*" matches "foo.com".
+    Prefix,
+  };
+
+  explicit WildcardDomainTrie(MatchType type) : type_(type) {}
+
+  /**
+   * Adds a wildcard domain to the trie.
+   * @param domain the domain without its wildcard, e.g. ".foo.com" for "*.foo.com".
+   * @param index the index identifying the domain.
+   * @return false if the domain was already added, in which case its index is unchanged.
+   */
+  bool add(absl::string_view domain, uint32_t index);
+
+  /**
+   * Finds the longest domain matching a host, which the wildcard must match at least one character
+   * of, e.g. "*.foo.com" doesn't match ".foo.com".
+   * @param host the lower case host to match.
+   * @return the index of the longest matching domain, if any.
+   */
+  absl::optional<uint32_t> findLongestMatch(absl::string_view host) const;
+
+  bool empty() const { return root_.children_.empty(); }
+
+private:
+  struct Node {
+    // The characters of the domains between the parent node and this one, in walk order.
+    std::string label_;
+    // Sorted by the first character of their labels, which is unique among the children.
+    std::vector<std::unique_ptr<Node>> children_;
+    // The index of the domain ending at this node, if any.
+    absl::optional<uint32_t> index_;
+  };
+
+  // The character of a host at a position in walk order.
+  char charAt(absl::string_view host, size_t position) const {
+    return type_ == MatchType::Suffix ? host[host.size() - 1 - position] : host[position];
+  }
+
+  const MatchType type_;
+  Node root_;
+};
+
+} // namespace Router
+} // namespace Envoy
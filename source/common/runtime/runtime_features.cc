@@ -133,8 +133,13 @@ FALSE_RUNTIME_GUARD(envoy_restart_features_use_eds_cache_for_ads);
 FALSE_RUNTIME_GUARD(envoy_reloadable_features_enable_universal_header_validator);
 // TODO(pksohn): enable after fixing https://github.com/envoyproxy/envoy/issues/29930
 FALSE_RUNTIME_GUARD(envoy_reloadable_features_quic_defer_logging_to_ack_listener);
+// Flip to true once the compiled JSON access log formatter, whose escaping and number
+// formatting differ slightly from the protobuf JSON printer, has been verified in prod.
+FALSE_RUNTIME_GUARD(envoy_reloadable_features_compiled_json_access_log_formatter);
 // TODO(#31276): flip this to true after some test time.
 FALSE_RUNTIME_GUARD(envoy_restart_features_use_fast_protobuf_hash);
+// Flip to true once decoding xDS resources into arenas has been verified in prod.
+FALSE_RUNTIME_GUARD(envoy_reloadable_features_xds_arena_decoding);
 
 // Block of non-boolean flags. Use of int flags is deprecated. Do not add more.
 ABSL_FLAG(uint64_t, re2_max_program_size_error_level, 100, ""); // NOLINT
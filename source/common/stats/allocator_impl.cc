@@ -16,6 +16,7 @@
 #include "source/common/stats/stat_merger.h"
 #include "source/common/stats/symbol_table.h"
 
+#include "absl/base/optimization.h"
 #include "absl/container/flat_hash_set.h"
 
 namespace Envoy {
@@ -166,6 +167,61 @@ private:
   std::atomic<uint64_t> pending_increment_{0};
 };
 
+// A counter whose value is split into cache line sized shards, one per worker and one for the main
+// and other threads, so that concurrent increments from several workers don't contend on the
+// counter's cache line. Reads and latches sum the shards.
+class ShardedCounterImpl : public StatsSharedImpl<Counter> {
+public:
+  ShardedCounterImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
+                     const StatNameTagVector& stat_name_tags, uint32_t num_shards)
+      : StatsSharedImpl(name, alloc, tag_extracted_name, stat_name_tags), shards_(num_shards) {}
+
+  void removeFromSetLockHeld() ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc_.mutex_) override {
+    const size_t count = alloc_.counters_.erase(statName());
+    ASSERT(count == 1);
+    alloc_.sinked_counters_.erase(this);
+  }
+
+  // Stats::Counter
+  void add(uint64_t amount) override {
+    Shard& shard = shards_[Thread::WorkerIndex::slot(shards_.size())];
+    shard.value_.fetch_add(amount, std::memory_order_relaxed);
+    shard.pending_increment_.fetch_add(amount, std::memory_order_relaxed);
+    // Only write the flags once, as every write would take the cache line the shards avoid sharing.
+    if ((flags_.load(std::memory_order_relaxed) & Flags::Used) == 0) {
+      flags_ |= Flags::Used;
+    }
+  }
+  void inc() override { add(1); }
+  uint64_t latch() override {
+    uint64_t pending_increment = 0;
+    for (Shard& shard : shards_) {
+      pending_increment += shard.pending_increment_.exchange(0);
+    }
+    return pending_increment;
+  }
+  void reset() override {
+    for (Shard& shard : shards_) {
+      shard.value_ = 0;
+    }
+  }
+  uint64_t value() const override {
+    uint64_t value = 0;
+    for (const Shard& shard : shards_) {
+      value += shard.value_.load(std::memory_order_relaxed);
+    }
+    return value;
+  }
+
+private:
+  struct ABSL_CACHELINE_ALIGNED Shard {
+    std::atomic<uint64_t> value_{0};
+    std::atomic<uint64_t> pending_increment_{0};
+  };
+
+  std::vector<Shard> shards_;
+};
+
 class GaugeImpl : public StatsSharedImpl<Gauge> {
 public:
   GaugeImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
@@ -366,9 +422,15 @@ bool AllocatorImpl::isMutexLockedForTest() {
 
 Counter* AllocatorImpl::makeCounterInternal(StatName name, StatName tag_extracted_name,
                                             const StatNameTagVector& stat_name_tags) {
+  const uint32_t counter_shards = counter_shards_;
+  if (counter_shards > 1) {
+    return new ShardedCounterImpl(name, *this, tag_extracted_name, stat_name_tags, counter_shards);
+  }
   return new CounterImpl(name, *this, tag_extracted_name, stat_name_tags);
 }
 
+void AllocatorImpl::setCounterShards(uint32_t num_shards) { counter_shards_ = num_shards; }
+
 void AllocatorImpl::forEachCounter(SizeFn f_size, StatFn<Counter> f_stat) const {
   Thread::LockGuard lock(mutex_);
   if (f_size != nullptr) {
@@ -206,6 +206,7 @@ public:
 
   void setSinkPredicates(std::unique_ptr<SinkPredicates>&& sink_predicates) override;
   OptRef<SinkPredicates> sinkPredicates() override { return sink_predicates_; }
+  void setCounterShards(uint32_t num_shards) override { alloc_.setCounterShards(num_shards); }
 
   /**
    * @return a thread synchronizer object used for controlling thread behavior in tests.
@@ -1,12 +1,16 @@
 #include "source/common/upstream/cds_api_helper.h"
 
+#include <algorithm>
+
 #include "envoy/common/exception.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/config/cluster/v3/cluster.pb.validate.h"
 #include "envoy/config/endpoint/v3/endpoint.pb.h"
 #include "envoy/config/grpc_mux.h"
 
 #include "source/common/common/fmt.h"
 #include "source/common/config/resource_name.h"
+#include "source/common/protobuf/utility.h"
 #include "source/common/runtime/runtime_features.h"
 
 #include "absl/container/flat_hash_set.h"
@@ -14,6 +18,76 @@
 namespace Envoy {
 namespace Upstream {
 
+ClusterPreparationPool::ClusterPreparationPool(Thread::ThreadFactory& thread_factory,
+                                               uint32_t num_threads) {
+  const Thread::Options options{"cds_prepare"};
+  threads_.reserve(num_threads);
+  for (uint32_t i = 0; i < num_threads; i++) {
+    threads_.push_back(thread_factory.createThread([this]() { worker(); }, options));
+  }
+}
+
+ClusterPreparationPool::~ClusterPreparationPool() {
+  {
+    absl::MutexLock lock(&mutex_);
+    terminate_ = true;
+  }
+  for (const Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+}
+
+void ClusterPreparationPool::run(size_t size, size_t min_range_size, const Task& task) {
+  const size_t num_ranges = std::min(threads_.size(), size / min_range_size);
+  if (num_ranges <= 1) {
+    task(0, size);
+    return;
+  }
+
+  absl::MutexLock lock(&mutex_);
+  ASSERT(task_ == nullptr);
+  task_ = &task;
+  for (size_t i = 0; i < num_ranges; i++) {
+    ranges_.emplace_back(size * i / num_ranges, size * (i + 1) / num_ranges);
+  }
+  running_ranges_ = num_ranges;
+  const auto done = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) { return running_ranges_ == 0; };
+  mutex_.Await(absl::Condition(&done));
+  task_ = nullptr;
+}
+
+void ClusterPreparationPool::worker() {
+  while (true) {
+    const auto condition = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+      return !ranges_.empty() || terminate_;
+    };
+    const Task* task;
+    std::pair<size_t, size_t> range;
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(&condition));
+      if (terminate_) {
+        return;
+      }
+      task = task_;
+      range = ranges_.front();
+      ranges_.pop_front();
+    }
+    (*task)(range.first, range.second);
+    absl::MutexLock lock(&mutex_);
+    --running_ranges_;
+  }
+}
+
+CdsApiHelper::CdsApiHelper(ClusterManager& cm, std::string name,
+                           Thread::ThreadFactory& thread_factory, uint32_t preparation_threads)
+    : cm_(cm), name_(std::move(name)) {
+  if (preparation_threads > 0) {
+    preparation_pool_ =
+        std::make_unique<ClusterPreparationPool>(thread_factory, preparation_threads);
+  }
+}
+
 std::vector<std::string>
 CdsApiHelper::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& added_resources,
                              const Protobuf::RepeatedPtrField<std::string>& removed_resources,
@@ -31,12 +105,26 @@ CdsApiHelper::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& adde
   ENVOY_LOG(info, "{}: add {} cluster(s), remove {} cluster(s)", name_, added_resources.size(),
             removed_resources.size());
 
+  const std::vector<PreparedCluster> prepared_clusters = prepareClusters(added_resources);
   std::vector<std::string> exception_msgs;
+  // Like a resource failing to decode, an invalid cluster rejects the whole update.
+  for (size_t i = 0; i < prepared_clusters.size(); i++) {
+    if (!prepared_clusters[i].validation_error_.empty()) {
+      exception_msgs.push_back(fmt::format("{}: Proto constraint validation failed ({})",
+                                           added_resources[i].get().name(),
+                                           prepared_clusters[i].validation_error_));
+    }
+  }
+  if (!exception_msgs.empty()) {
+    return exception_msgs;
+  }
+
   absl::flat_hash_set<std::string> cluster_names(added_resources.size());
   bool any_applied = false;
   uint32_t added_or_updated = 0;
   uint32_t skipped = 0;
-  for (const auto& resource : added_resources) {
+  for (size_t i = 0; i < added_resources.size(); i++) {
+    const Config::DecodedResourceRef& resource = added_resources[i];
     envoy::config::cluster::v3::Cluster cluster;
     TRY_ASSERT_MAIN_THREAD {
       cluster = dynamic_cast<const envoy::config::cluster::v3::Cluster&>(resource.get().resource());
@@ -46,7 +134,12 @@ CdsApiHelper::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& adde
             fmt::format("{}: duplicate cluster {} found", cluster.name(), cluster.name()));
         continue;
       }
-      if (cm_.addOrUpdateCluster(cluster, resource.get().version())) {
+      const bool applied =
+          prepared_clusters.empty()
+              ? cm_.addOrUpdateCluster(cluster, resource.get().version())
+              : cm_.addOrUpdateCluster(cluster, resource.get().version(),
+                                       prepared_clusters[i].hash_);
+      if (applied) {
         any_applied = true;
         ENVOY_LOG(debug, "{}: add/update cluster '{}'", name_, cluster.name());
         ++added_or_updated;
@@ -76,5 +169,28 @@ CdsApiHelper::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& adde
   return exception_msgs;
 }
 
+std::vector<CdsApiHelper::PreparedCluster>
+CdsApiHelper::prepareClusters(const std::vector<Config::DecodedResourceRef>& resources) {
+  if (preparation_pool_ == nullptr) {
+    return {};
+  }
+
+  // Preparing only reads the decoded resources, so each thread prepares its own range of them.
+  std::vector<PreparedCluster> prepared(resources.size());
+  preparation_pool_->run(
+      resources.size(), MinClustersPerPreparationThread,
+      [&resources, &prepared](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+          const auto& cluster = dynamic_cast<const envoy::config::cluster::v3::Cluster&>(
+              resources[i].get().resource());
+          if (Validate(cluster, &prepared[i].validation_error_)) {
+            prepared[i].hash_ = MessageUtil::hash(cluster);
+          }
+        }
+      });
+  ENVOY_LOG(debug, "{}: prepared {} cluster(s)", name_, resources.size());
+  return prepared;
+}
+
 } // namespace Upstream
 } // namespace Envoy
@@ -1,17 +1,54 @@
 #pragma once
 
+#include <deque>
+#include <functional>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "envoy/config/subscription.h"
+#include "envoy/thread/thread.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "source/common/common/logger.h"
 #include "source/common/protobuf/protobuf.h"
 
+#include "absl/synchronization/mutex.h"
+
 namespace Envoy {
 namespace Upstream {
 
+/**
+ * A fixed set of threads which prepare the clusters of CDS updates in parallel. The threads are
+ * started with the pool and wait for the next update until the pool is destroyed.
+ */
+class ClusterPreparationPool {
+public:
+  using Task = std::function<void(size_t begin, size_t end)>;
+
+  ClusterPreparationPool(Thread::ThreadFactory& thread_factory, uint32_t num_threads);
+  ~ClusterPreparationPool() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  /**
+   * Runs a task over the range [0, size), split into contiguous ranges of at least min_range_size
+   * which are run on the threads of the pool. If the range isn't large enough to split, the task is
+   * run on the calling thread instead. Returns once the task has been run over the whole range.
+   * The task must not throw.
+   */
+  void run(size_t size, size_t min_range_size, const Task& task) ABSL_LOCKS_EXCLUDED(mutex_);
+
+private:
+  void worker() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  std::vector<Thread::ThreadPtr> threads_;
+  absl::Mutex mutex_;
+  const Task* task_ ABSL_GUARDED_BY(mutex_){};
+  std::deque<std::pair<size_t, size_t>> ranges_ ABSL_GUARDED_BY(mutex_);
+  size_t running_ranges_ ABSL_GUARDED_BY(mutex_){};
+  bool terminate_ ABSL_GUARDED_BY(mutex_){};
+};
+
 /**
  * A named helper class for handling a successful cluster configuration update from Subscription. A
  * name is used mostly for logging to differentiate between different users of the helper class.
@@ -19,6 +56,15 @@ namespace Upstream {
 class CdsApiHelper : Logger::Loggable<Logger::Id::upstream> {
 public:
   CdsApiHelper(ClusterManager& cm, std::string name) : cm_(cm), name_(std::move(name)) {}
+  /**
+   * @param thread_factory supplies the factory of the threads which prepare the clusters of large
+   *        updates in parallel.
+   * @param preparation_threads supplies the number of threads preparing the clusters of updates.
+   *        If it isn't 0, the resources of updates must have been decoded without checking their
+   *        proto constraints, which are checked as the clusters are prepared.
+   */
+  CdsApiHelper(ClusterManager& cm, std::string name, Thread::ThreadFactory& thread_factory,
+               uint32_t preparation_threads);
   /**
    * onConfigUpdate handles the addition and removal of clusters by notifying the ClusterManager
    * about the cluster changes. It closely follows the onConfigUpdate API from
@@ -35,9 +81,29 @@ public:
                  const std::string& system_version_info);
   const std::string versionInfo() const { return system_version_info_; }
 
+  // The fewest clusters each preparation thread is given of an update.
+  static constexpr size_t MinClustersPerPreparationThread = 100;
+
 private:
+  // A cluster of an update, as prepared by the preparation threads.
+  struct PreparedCluster {
+    // The error of checking the proto constraints of the cluster, or empty if it is valid.
+    std::string validation_error_;
+    uint64_t hash_{};
+  };
+
+  /**
+   * Checks the proto constraints of the clusters of an update and hashes them, in parallel if the
+   * update is large enough.
+   * @return the prepared clusters, in order, or an empty vector if there are no preparation
+   *         threads and the clusters are checked and hashed as they are added or updated.
+   */
+  std::vector<PreparedCluster>
+  prepareClusters(const std::vector<Config::DecodedResourceRef>& resources);
+
   ClusterManager& cm_;
   const std::string name_;
+  std::unique_ptr<ClusterPreparationPool> preparation_pool_;
   std::string system_version_info_;
 };
 
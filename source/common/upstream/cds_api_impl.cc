@@ -2,27 +2,77 @@
 
 #include "source/common/common/assert.h"
 #include "source/common/grpc/common.h"
+#include "source/common/protobuf/utility.h"
 
 #include "absl/strings/str_join.h"
 
 namespace Envoy {
 namespace Upstream {
 
+namespace {
+
+// Decodes clusters without checking their proto constraints, which the helper checks on its
+// preparation threads. Unknown and deprecated fields are still checked here, as the validation
+// visitor and the runtime it consults are only used on the main thread.
+class UncheckedClusterDecoder : public Config::OpaqueResourceDecoder {
+public:
+  explicit UncheckedClusterDecoder(ProtobufMessage::ValidationVisitor& validation_visitor)
+      : validation_visitor_(validation_visitor) {}
+
+  // Config::OpaqueResourceDecoder
+  ProtobufTypes::MessagePtr decodeResource(const ProtobufWkt::Any& resource) override {
+    auto cluster = std::make_unique<envoy::config::cluster::v3::Cluster>();
+    decode(resource, *cluster);
+    return cluster;
+  }
+  Protobuf::Message* decodeResource(const ProtobufWkt::Any& resource,
+                                    Protobuf::Arena& arena) override {
+    auto* cluster = Protobuf::Arena::Create<envoy::config::cluster::v3::Cluster>(&arena);
+    decode(resource, *cluster);
+    return cluster;
+  }
+  std::string resourceName(const Protobuf::Message& resource) override {
+    return dynamic_cast<const envoy::config::cluster::v3::Cluster&>(resource).name();
+  }
+
+private:
+  void decode(const ProtobufWkt::Any& resource, envoy::config::cluster::v3::Cluster& cluster) {
+    if (resource.type_url().empty()) {
+      return;
+    }
+    MessageUtil::anyConvert(resource, cluster);
+    if (!validation_visitor_.skipValidation()) {
+      MessageUtil::checkForUnexpectedFields(cluster, validation_visitor_);
+    }
+  }
+
+  ProtobufMessage::ValidationVisitor& validation_visitor_;
+};
+
+} // namespace
+
 CdsApiPtr CdsApiImpl::create(const envoy::config::core::v3::ConfigSource& cds_config,
                              const xds::core::v3::ResourceLocator* cds_resources_locator,
                              ClusterManager& cm, Stats::Scope& scope,
-                             ProtobufMessage::ValidationVisitor& validation_visitor) {
-  return CdsApiPtr{
-      new CdsApiImpl(cds_config, cds_resources_locator, cm, scope, validation_visitor)};
+                             ProtobufMessage::ValidationVisitor& validation_visitor,
+                             Thread::ThreadFactory& thread_factory,
+                             uint32_t preparation_threads) {
+  return CdsApiPtr{new CdsApiImpl(cds_config, cds_resources_locator, cm, scope, validation_visitor,
+                                  thread_factory, preparation_threads)};
 }
 
 CdsApiImpl::CdsApiImpl(const envoy::config::core::v3::ConfigSource& cds_config,
                        const xds::core::v3::ResourceLocator* cds_resources_locator,
                        ClusterManager& cm, Stats::Scope& scope,
-                       ProtobufMessage::ValidationVisitor& validation_visitor)
+                       ProtobufMessage::ValidationVisitor& validation_visitor,
+                       Thread::ThreadFactory& thread_factory, uint32_t preparation_threads)
     : Envoy::Config::SubscriptionBase<envoy::config::cluster::v3::Cluster>(validation_visitor,
                                                                            "name"),
-      helper_(cm, "cds"), cm_(cm), scope_(scope.createScope("cluster_manager.cds.")) {
+      helper_(cm, "cds", thread_factory, preparation_threads), cm_(cm),
+      scope_(scope.createScope("cluster_manager.cds.")) {
+  if (preparation_threads > 0) {
+    resource_decoder_ = std::make_shared<UncheckedClusterDecoder>(validation_visitor);
+  }
   const auto resource_name = getResourceName();
   if (cds_resources_locator == nullptr) {
     subscription_ = cm_.subscriptionFactory().subscriptionFromConfigSource(
@@ -1,5 +1,6 @@
 #include "source/common/upstream/upstream_impl.h"
 
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <limits>
@@ -57,6 +58,8 @@
 #include "source/extensions/filters/network/http_connection_manager/config.h"
 #include "source/server/transport_socket_config_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/container/node_hash_set.h"
 #include "absl/strings/str_cat.h"
 
@@ -529,38 +532,33 @@ void HostImpl::weight(uint32_t new_weight) { weight_ = std::max(1U, new_weight);
 
 std::vector<HostsPerLocalityConstSharedPtr> HostsPerLocalityImpl::filter(
     const std::vector<std::function<bool(const Host&)>>& predicates) const {
-  // We keep two lists: one for being able to mutate the clone and one for returning to the
-  // caller. Creating them both at the start avoids iterating over the mutable values at the end
-  // to convert them to a const pointer.
-  std::vector<std::shared_ptr<HostsPerLocalityImpl>> mutable_clones;
-  std::vector<HostsPerLocalityConstSharedPtr> filtered_clones;
-
-  mutable_clones.reserve(predicates.size());
-  filtered_clones.reserve(predicates.size());
-  for (size_t i = 0; i < predicates.size(); ++i) {
-    mutable_clones.emplace_back(std::make_shared<HostsPerLocalityImpl>());
-    filtered_clones.emplace_back(mutable_clones.back());
-    mutable_clones.back()->local_ = local_;
+  // The hosts of each locality which match each predicate.
+  std::vector<std::vector<HostVector>> filtered_locality_hosts(predicates.size());
+  for (std::vector<HostVector>& locality_hosts : filtered_locality_hosts) {
+    locality_hosts.reserve(hosts_per_locality_.size());
   }
 
   for (const auto& hosts_locality : hosts_per_locality_) {
-    std::vector<HostVector> current_locality_hosts;
-    current_locality_hosts.resize(predicates.size());
+    for (std::vector<HostVector>& locality_hosts : filtered_locality_hosts) {
+      locality_hosts.emplace_back();
+    }
 
     // Since # of hosts >> # of predicates, we iterate over the hosts in the outer loop.
     for (const auto& host : hosts_locality) {
       for (size_t i = 0; i < predicates.size(); ++i) {
         if (predicates[i](*host)) {
-          current_locality_hosts[i].emplace_back(host);
+          filtered_locality_hosts[i].back().emplace_back(host);
         }
       }
     }
-
-    for (size_t i = 0; i < predicates.size(); ++i) {
-      mutable_clones[i]->hosts_per_locality_.push_back(std::move(current_locality_hosts[i]));
-    }
   }
 
+  std::vector<HostsPerLocalityConstSharedPtr> filtered_clones;
+  filtered_clones.reserve(predicates.size());
+  for (std::vector<HostVector>& locality_hosts : filtered_locality_hosts) {
+    filtered_clones.emplace_back(
+        std::make_shared<HostsPerLocalityImpl>(std::move(locality_hosts), local_));
+  }
   return filtered_clones;
 }
 
@@ -705,6 +703,147 @@ HostSetImpl::partitionHosts(HostVectorConstSharedPtr hosts,
                            std::move(std::get<2>(healthy_degraded_excluded_hosts_per_locality)));
 }
 
+namespace {
+
+using HostPtrSet = absl::flat_hash_set<const Host*>;
+
+// Returns the hosts of old_hosts except removed_hosts, followed by added_hosts, or old_hosts itself
+// when no host left or joined the list. The load balancers don't depend on the order of the hosts
+// in the aggregate lists, only on the order of the hosts per locality, which is preserved.
+template <class HostVectorT>
+std::shared_ptr<const HostVectorT> patchHostList(std::shared_ptr<const HostVectorT> old_hosts,
+                                                 const HostPtrSet& removed_hosts,
+                                                 const HostVector& added_hosts) {
+  if (removed_hosts.empty() && added_hosts.empty()) {
+    return old_hosts;
+  }
+  auto hosts = std::make_shared<HostVectorT>();
+  hosts->get().reserve(old_hosts->get().size() - removed_hosts.size() + added_hosts.size());
+  for (const HostSharedPtr& host : old_hosts->get()) {
+    if (!removed_hosts.contains(host.get())) {
+      hosts->get().push_back(host);
+    }
+  }
+  hosts->get().insert(hosts->get().end(), added_hosts.begin(), added_hosts.end());
+  return hosts;
+}
+
+// Records in removed_hosts and added_hosts the hosts of updated_hosts which left or joined a
+// partition of a locality, given its old and new hosts.
+void diffLocalityPartition(const HostVector& old_hosts, const HostVector& new_hosts,
+                           const HostPtrSet& updated_hosts, HostPtrSet& removed_hosts,
+                           HostVector& added_hosts) {
+  HostPtrSet old_updated_hosts;
+  for (const HostSharedPtr& host : old_hosts) {
+    if (updated_hosts.contains(host.get())) {
+      old_updated_hosts.insert(host.get());
+    }
+  }
+  for (const HostSharedPtr& host : new_hosts) {
+    if (updated_hosts.contains(host.get()) && old_updated_hosts.erase(host.get()) == 0) {
+      added_hosts.push_back(host);
+    }
+  }
+  removed_hosts.insert(old_updated_hosts.begin(), old_updated_hosts.end());
+}
+
+} // namespace
+
+PrioritySet::UpdateHostsParams
+HostSetImpl::repartitionHosts(const HostSet& host_set,
+                              const HostVector& hosts_with_updated_health) {
+  if (hosts_with_updated_health.empty()) {
+    return updateHostsParams(host_set);
+  }
+
+  const LocalityHostVectors& hosts_per_locality = host_set.hostsPerLocality().get();
+  const std::array<HostsPerLocalityConstSharedPtr, 3> old_partitions_per_locality{
+      host_set.healthyHostsPerLocalityPtr(), host_set.degradedHostsPerLocalityPtr(),
+      host_set.excludedHostsPerLocalityPtr()};
+  for (const HostsPerLocalityConstSharedPtr& partition_per_locality :
+       old_partitions_per_locality) {
+    if (partition_per_locality->get().size() != hosts_per_locality.size()) {
+      return partitionHosts(host_set.hostsPtr(), host_set.hostsPerLocalityPtr());
+    }
+  }
+
+  // All hosts of a locality share the same locality, so the first host of each locality indexes
+  // it, and the locality of each updated host is looked up directly.
+  absl::flat_hash_map<std::reference_wrapper<const envoy::config::core::v3::Locality>, size_t,
+                      LocalityHash, LocalityEqualTo>
+      locality_indexes;
+  locality_indexes.reserve(hosts_per_locality.size());
+  for (size_t i = 0; i < hosts_per_locality.size(); ++i) {
+    if (!hosts_per_locality[i].empty()) {
+      locality_indexes.emplace(hosts_per_locality[i].front()->locality(), i);
+    }
+  }
+
+  HostPtrSet updated_hosts;
+  std::vector<bool> locality_updated(hosts_per_locality.size(), false);
+  for (const HostSharedPtr& host : hosts_with_updated_health) {
+    const auto it = locality_indexes.find(host->locality());
+    if (it == locality_indexes.end()) {
+      return partitionHosts(host_set.hostsPtr(), host_set.hostsPerLocalityPtr());
+    }
+    updated_hosts.insert(host.get());
+    locality_updated[it->second] = true;
+  }
+
+  // The localities without updated hosts share their partitions with the current host set. The
+  // others are partitioned again, and the difference with their old partitions gives the hosts to
+  // remove from and add to the aggregate partitions.
+  std::array<std::vector<HostVectorConstSharedPtr>, 3> partitions_per_locality;
+  std::array<HostPtrSet, 3> removed_hosts;
+  std::array<HostVector, 3> added_hosts;
+  for (auto& partition_per_locality : partitions_per_locality) {
+    partition_per_locality.reserve(hosts_per_locality.size());
+  }
+  for (size_t i = 0; i < hosts_per_locality.size(); ++i) {
+    if (!locality_updated[i]) {
+      for (size_t p = 0; p < partitions_per_locality.size(); ++p) {
+        partitions_per_locality[p].push_back(old_partitions_per_locality[p]->get().shared(i));
+      }
+      continue;
+    }
+    auto partitioned_locality = ClusterImplBase::partitionHostList(hosts_per_locality[i]);
+    // Alias the vectors inside the partitions rather than copy them.
+    const std::array<HostVectorConstSharedPtr, 3> new_partitions{
+        HostVectorConstSharedPtr(std::get<0>(partitioned_locality),
+                                 &std::get<0>(partitioned_locality)->get()),
+        HostVectorConstSharedPtr(std::get<1>(partitioned_locality),
+                                 &std::get<1>(partitioned_locality)->get()),
+        HostVectorConstSharedPtr(std::get<2>(partitioned_locality),
+                                 &std::get<2>(partitioned_locality)->get())};
+    for (size_t p = 0; p < partitions_per_locality.size(); ++p) {
+      diffLocalityPartition(old_partitions_per_locality[p]->get()[i], *new_partitions[p],
+                            updated_hosts, removed_hosts[p], added_hosts[p]);
+      partitions_per_locality[p].push_back(new_partitions[p]);
+    }
+  }
+
+  const bool has_local_locality = host_set.hostsPerLocality().hasLocalLocality();
+  std::array<HostsPerLocalityConstSharedPtr, 3> new_partitions_per_locality;
+  for (size_t p = 0; p < partitions_per_locality.size(); ++p) {
+    // A partition which no host left or joined is the same in every locality.
+    if (removed_hosts[p].empty() && added_hosts[p].empty()) {
+      new_partitions_per_locality[p] = old_partitions_per_locality[p];
+      continue;
+    }
+    new_partitions_per_locality[p] = std::make_shared<HostsPerLocalityImpl>(
+        LocalityHostVectors(std::move(partitions_per_locality[p])), has_local_locality);
+  }
+
+  return updateHostsParams(
+      host_set.hostsPtr(), host_set.hostsPerLocalityPtr(),
+      patchHostList(host_set.healthyHostsPtr(), removed_hosts[0], added_hosts[0]),
+      std::move(new_partitions_per_locality[0]),
+      patchHostList(host_set.degradedHostsPtr(), removed_hosts[1], added_hosts[1]),
+      std::move(new_partitions_per_locality[1]),
+      patchHostList(host_set.excludedHostsPtr(), removed_hosts[2], added_hosts[2]),
+      std::move(new_partitions_per_locality[2]));
+}
+
 double HostSetImpl::effectiveLocalityWeight(uint32_t index,
                                             const HostsPerLocality& eligible_hosts_per_locality,
                                             const HostsPerLocality& excluded_hosts_per_locality,
@@ -2120,10 +2259,24 @@ void PriorityStateManager::updateClusterPrioritySet(
   }
 }
 
+void PriorityStateManager::updateClusterPrioritySetInPlace(
+    const uint32_t priority, const HostSet& host_set, const HostVector& hosts_with_updated_health) {
+  if (update_cb_ != nullptr) {
+    update_cb_->updateHosts(priority,
+                            HostSetImpl::repartitionHosts(host_set, hosts_with_updated_health),
+                            host_set.localityWeights(), {}, {}, absl::nullopt, absl::nullopt);
+  } else {
+    parent_.prioritySet().updateHosts(
+        priority, HostSetImpl::repartitionHosts(host_set, hosts_with_updated_health),
+        host_set.localityWeights(), {}, {}, absl::nullopt, absl::nullopt);
+  }
+}
+
 bool BaseDynamicClusterImpl::updateDynamicHostList(
     const HostVector& new_hosts, HostVector& current_priority_hosts,
     HostVector& hosts_added_to_current_priority, HostVector& hosts_removed_from_current_priority,
-    const HostMap& all_hosts, const absl::flat_hash_set<std::string>& all_new_hosts) {
+    const HostMap& all_hosts, const absl::flat_hash_set<std::string>& all_new_hosts,
+    HostVector* hosts_with_updated_health) {
   uint64_t max_host_weight = 1;
 
   // Did hosts change?
@@ -2210,7 +2363,12 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(
         hosts_changed = true;
       }
 
-      hosts_changed |= updateEdsHealthFlag(*host, *existing_host->second);
+      if (updateEdsHealthFlag(*host, *existing_host->second)) {
+        hosts_changed = true;
+        if (hosts_with_updated_health != nullptr) {
+          hosts_with_updated_health->push_back(existing_host->second);
+        }
+      }
 
       // Did metadata change?
       bool metadata_changed = true;
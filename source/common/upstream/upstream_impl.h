@@ -501,12 +501,17 @@ public:
   // 4. All non-local HostVector buckets must be sorted in ascending order by the LocalityLess
   // comparator
   HostsPerLocalityImpl(std::vector<HostVector>&& locality_hosts, bool has_local_locality)
+      : HostsPerLocalityImpl(LocalityHostVectors(std::move(locality_hosts)), has_local_locality) {}
+
+  // Multiple localities constructor, which shares the hosts of each locality. The same ordering
+  // constraints apply.
+  HostsPerLocalityImpl(LocalityHostVectors&& locality_hosts, bool has_local_locality)
       : local_(has_local_locality), hosts_per_locality_(std::move(locality_hosts)) {
     ASSERT(!has_local_locality || !hosts_per_locality_.empty());
   }
 
   bool hasLocalLocality() const override { return local_; }
-  const std::vector<HostVector>& get() const override { return hosts_per_locality_; }
+  const LocalityHostVectors& get() const override { return hosts_per_locality_; }
   std::vector<HostsPerLocalityConstSharedPtr>
   filter(const std::vector<std::function<bool(const Host&)>>& predicate) const override;
 
@@ -520,7 +525,7 @@ private:
   // Does an entry exist for the local locality?
   bool local_{};
   // The first entry is for local hosts in the local locality.
-  std::vector<HostVector> hosts_per_locality_;
+  LocalityHostVectors hosts_per_locality_;
 };
 
 /**
@@ -597,6 +602,12 @@ public:
   static PrioritySet::UpdateHostsParams updateHostsParams(const HostSet& host_set);
   static PrioritySet::UpdateHostsParams
   partitionHosts(HostVectorConstSharedPtr hosts, HostsPerLocalityConstSharedPtr hosts_per_locality);
+  // Partitions the hosts of host_set again after the health of hosts_with_updated_health, which
+  // all belong to host_set, changed in place. The hosts and hosts per locality of host_set are
+  // reused, and so are the partitions of the localities that none of these hosts are in. The
+  // aggregate partitions are only patched for the hosts that left or joined them.
+  static PrioritySet::UpdateHostsParams
+  repartitionHosts(const HostSet& host_set, const HostVector& hosts_with_updated_health);
 
   void updateHosts(PrioritySet::UpdateHostsParams&& update_hosts_params,
                    LocalityWeightsConstSharedPtr locality_weights, const HostVector& hosts_added,
@@ -1331,6 +1342,13 @@ public:
                            absl::optional<bool> weighted_priority_health = absl::nullopt,
                            absl::optional<uint32_t> overprovisioning_factor = absl::nullopt);
 
+  // Updates a priority whose hosts are the same as in host_set, only the health, weight or metadata
+  // of some of them changed in place. Unlike updateClusterPrioritySet(), this doesn't group the
+  // hosts by locality again: the localities and locality weights of host_set are kept, and only
+  // the localities of hosts_with_updated_health are partitioned again.
+  void updateClusterPrioritySetInPlace(const uint32_t priority, const HostSet& host_set,
+                                       const HostVector& hosts_with_updated_health);
+
   // Returns the saved priority state.
   PriorityState& priorityState() { return priority_state_; }
 
@@ -1362,13 +1380,16 @@ protected:
    * priority.
    * @param all_hosts all known hosts prior to this host update across all priorities.
    * @param all_new_hosts addresses of all hosts in the new configuration across all priorities.
+   * @param hosts_with_updated_health if not null, will be populated with the existing hosts whose
+   * health changed with the new configuration.
    * @return whether the hosts for the priority changed.
    */
   bool updateDynamicHostList(const HostVector& new_hosts, HostVector& current_priority_hosts,
                              HostVector& hosts_added_to_current_priority,
                              HostVector& hosts_removed_from_current_priority,
                              const HostMap& all_hosts,
-                             const absl::flat_hash_set<std::string>& all_new_hosts);
+                             const absl::flat_hash_set<std::string>& all_new_hosts,
+                             HostVector* hosts_with_updated_health = nullptr);
 };
 
 /**
@@ -0,0 +1,170 @@
+#include "source/extensions/access_loggers/binary/binary_access_log_impl.h"
+
+#include <chrono>
+
+#include "envoy/event/dispatcher.h"
+
+#include "source/common/http/utility.h"
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Binary {
+
+namespace {
+
+using BinaryAccessLogConfig = envoy::extensions::access_loggers::binary::v3::BinaryAccessLog;
+
+// 64MiB.
+constexpr uint64_t DefaultSegmentSize = 64 * 1024 * 1024;
+
+absl::optional<absl::string_view> headerValue(const Http::HeaderEntry* entry) {
+  if (entry == nullptr) {
+    return absl::nullopt;
+  }
+  return entry->value().getStringView();
+}
+
+absl::optional<uint64_t> microseconds(absl::optional<std::chrono::nanoseconds> duration) {
+  if (!duration.has_value()) {
+    return absl::nullopt;
+  }
+  return std::chrono::duration_cast<std::chrono::microseconds>(*duration).count();
+}
+
+} // namespace
+
+BinaryAccessLog::ThreadLocalWriter::ThreadLocalWriter(Api::OsSysCalls& os_sys_calls,
+                                                      TimeSource& time_source,
+                                                      BinaryAccessLogStats stats,
+                                                      std::string path_prefix, std::string header,
+                                                      uint64_t segment_size, uint32_t max_segments)
+    : writer_(os_sys_calls, time_source, stats, std::move(path_prefix), std::move(header),
+              segment_size, max_segments) {}
+
+BinaryAccessLog::BinaryAccessLog(AccessLog::FilterPtr&& filter,
+                                 const BinaryAccessLogConfig& config,
+                                 ThreadLocal::SlotAllocator& tls, Stats::Scope& scope,
+                                 TimeSource& time_source, Api::OsSysCalls& os_sys_calls)
+    : Common::ImplBase(std::move(filter)),
+      fields_(config.fields().begin(), config.fields().end()), tls_slot_(tls.allocateSlot()) {
+  const BinaryAccessLogStats stats{
+      ALL_BINARY_ACCESS_LOG_STATS(POOL_COUNTER_PREFIX(scope, "access_logs.binary_access_log."))};
+  const uint64_t segment_size =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, segment_size, DefaultSegmentSize);
+  tls_slot_->set([&os_sys_calls, &time_source, stats, path_prefix = config.path_prefix(),
+                  header = SegmentFormat::header(fields_), segment_size,
+                  max_segments = config.max_segments()](Event::Dispatcher& dispatcher) {
+    return std::make_shared<ThreadLocalWriter>(os_sys_calls, time_source, stats,
+                                               absl::StrCat(path_prefix, ".", dispatcher.name()),
+                                               header, segment_size, max_segments);
+  });
+}
+
+void BinaryAccessLog::encodeRecord(const std::vector<Field>& fields,
+                                   const Formatter::HttpFormatterContext& context,
+                                   const StreamInfo::StreamInfo& stream_info,
+                                   std::string& record) {
+  const Http::RequestHeaderMap& request_headers = context.requestHeaders();
+  for (const Field field : fields) {
+    switch (field) {
+    case BinaryAccessLogConfig::START_TIME:
+      SegmentFormat::appendInteger(std::chrono::duration_cast<std::chrono::microseconds>(
+                                       stream_info.startTime().time_since_epoch())
+                                       .count(),
+                                   record);
+      break;
+    case BinaryAccessLogConfig::DURATION:
+      SegmentFormat::appendInteger(microseconds(stream_info.requestComplete()), record);
+      break;
+    case BinaryAccessLogConfig::RESPONSE_CODE:
+      SegmentFormat::appendInteger(stream_info.responseCode(), record);
+      break;
+    case BinaryAccessLogConfig::RESPONSE_FLAGS:
+      SegmentFormat::appendInteger(stream_info.responseFlags(), record);
+      break;
+    case BinaryAccessLogConfig::BYTES_RECEIVED:
+      SegmentFormat::appendInteger(stream_info.bytesReceived(), record);
+      break;
+    case BinaryAccessLogConfig::BYTES_SENT:
+      SegmentFormat::appendInteger(stream_info.bytesSent(), record);
+      break;
+    case BinaryAccessLogConfig::PROTOCOL: {
+      const auto protocol = stream_info.protocol();
+      SegmentFormat::appendString(protocol.has_value()
+                                      ? absl::make_optional<absl::string_view>(
+                                            Http::Utility::getProtocolString(*protocol))
+                                      : absl::nullopt,
+                                  record);
+      break;
+    }
+    case BinaryAccessLogConfig::REQUEST_METHOD:
+      SegmentFormat::appendString(headerValue(request_headers.Method()), record);
+      break;
+    case BinaryAccessLogConfig::REQUEST_PATH:
+      SegmentFormat::appendString(headerValue(request_headers.Path()), record);
+      break;
+    case BinaryAccessLogConfig::AUTHORITY:
+      SegmentFormat::appendString(headerValue(request_headers.Host()), record);
+      break;
+    case BinaryAccessLogConfig::USER_AGENT:
+      SegmentFormat::appendString(headerValue(request_headers.UserAgent()), record);
+      break;
+    case BinaryAccessLogConfig::REQUEST_ID: {
+      const auto provider = stream_info.getStreamIdProvider();
+      SegmentFormat::appendString(provider.has_value() ? provider->toStringView() : absl::nullopt,
+                                  record);
+      break;
+    }
+    case BinaryAccessLogConfig::DOWNSTREAM_REMOTE_ADDRESS: {
+      const auto& address = stream_info.downstreamAddressProvider().remoteAddress();
+      if (address != nullptr) {
+        SegmentFormat::appendString(address->asStringView(), record);
+      } else {
+        SegmentFormat::appendString(absl::nullopt, record);
+      }
+      break;
+    }
+    case BinaryAccessLogConfig::UPSTREAM_HOST: {
+      const auto upstream_info = stream_info.upstreamInfo();
+      if (upstream_info.has_value() && upstream_info->upstreamHost() != nullptr) {
+        SegmentFormat::appendString(upstream_info->upstreamHost()->address()->asStringView(),
+                                    record);
+      } else {
+        SegmentFormat::appendString(absl::nullopt, record);
+      }
+      break;
+    }
+    case BinaryAccessLogConfig::UPSTREAM_CLUSTER: {
+      const auto cluster_info = stream_info.upstreamClusterInfo();
+      if (cluster_info.has_value() && *cluster_info != nullptr) {
+        SegmentFormat::appendString((*cluster_info)->observabilityName(), record);
+      } else {
+        SegmentFormat::appendString(absl::nullopt, record);
+      }
+      break;
+    }
+    case BinaryAccessLogConfig::ROUTE_NAME:
+      SegmentFormat::appendString(stream_info.getRouteName(), record);
+      break;
+    default:
+      PANIC_DUE_TO_CORRUPT_ENUM;
+    }
+  }
+}
+
+void BinaryAccessLog::emitLog(const Formatter::HttpFormatterContext& context,
+                              const StreamInfo::StreamInfo& stream_info) {
+  ThreadLocalWriter& local = tls_slot_->getTyped<ThreadLocalWriter>();
+  local.record_.clear();
+  encodeRecord(fields_, context, stream_info, local.record_);
+  local.writer_.write(local.record_);
+}
+
+} // namespace Binary
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/api/os_sys_calls.h"
+#include "envoy/common/time.h"
+#include "envoy/extensions/access_loggers/binary/v3/binary.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/extensions/access_loggers/binary/segment_format.h"
+#include "source/extensions/access_loggers/binary/segment_writer.h"
+#include "source/extensions/access_loggers/common/access_log_base.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Binary {
+
+/**
+ * Access log Instance that writes records of fixed fields into per-thread segment files.
+ */
+class BinaryAccessLog : public Common::ImplBase {
+public:
+  BinaryAccessLog(AccessLog::FilterPtr&& filter,
+                  const envoy::extensions::access_loggers::binary::v3::BinaryAccessLog& config,
+                  ThreadLocal::SlotAllocator& tls, Stats::Scope& scope, TimeSource& time_source,
+                  Api::OsSysCalls& os_sys_calls);
+
+  /**
+   * Appends the fields of a request to a record.
+   */
+  static void encodeRecord(const std::vector<Field>& fields,
+                           const Formatter::HttpFormatterContext& context,
+                           const StreamInfo::StreamInfo& stream_info, std::string& record);
+
+private:
+  /**
+   * Per-thread segment writer, along with a buffer reused for encoding records.
+   */
+  struct ThreadLocalWriter : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalWriter(Api::OsSysCalls& os_sys_calls, TimeSource& time_source,
+                      BinaryAccessLogStats stats, std::string path_prefix, std::string header,
+                      uint64_t segment_size, uint32_t max_segments);
+
+    SegmentWriter writer_;
+    std::string record_;
+  };
+
+  // Common::ImplBase
+  void emitLog(const Formatter::HttpFormatterContext& context,
+               const StreamInfo::StreamInfo& stream_info) override;
+
+  const std::vector<Field> fields_;
+  const ThreadLocal::SlotPtr tls_slot_;
+};
+
+} // namespace Binary
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,47 @@
+#include "source/extensions/access_loggers/binary/config.h"
+
+#include <memory>
+
+#include "envoy/extensions/access_loggers/binary/v3/binary.pb.h"
+#include "envoy/extensions/access_loggers/binary/v3/binary.pb.validate.h"
+#include "envoy/registry/registry.h"
+#include "envoy/server/filter_config.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/protobuf/protobuf.h"
+#include "source/extensions/access_loggers/binary/binary_access_log_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Binary {
+
+AccessLog::InstanceSharedPtr
+BinaryAccessLogFactory::createAccessLogInstance(const Protobuf::Message& config,
+                                                AccessLog::FilterPtr&& filter,
+                                                Server::Configuration::FactoryContext& context) {
+  const auto& proto_config = MessageUtil::downcastAndValidate<
+      const envoy::extensions::access_loggers::binary::v3::BinaryAccessLog&>(
+      config, context.messageValidationVisitor());
+
+  return std::make_shared<BinaryAccessLog>(
+      std::move(filter), proto_config, context.serverFactoryContext().threadLocal(),
+      context.scope(), context.serverFactoryContext().timeSource(),
+      Api::OsSysCallsSingleton::get());
+}
+
+ProtobufTypes::MessagePtr BinaryAccessLogFactory::createEmptyConfigProto() {
+  return std::make_unique<envoy::extensions::access_loggers::binary::v3::BinaryAccessLog>();
+}
+
+std::string BinaryAccessLogFactory::name() const { return "envoy.access_loggers.binary"; }
+
+/**
+ * Static registration for the binary access log. @see RegisterFactory.
+ */
+REGISTER_FACTORY(BinaryAccessLogFactory, AccessLog::AccessLogInstanceFactory);
+
+} // namespace Binary
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+#include "envoy/access_log/access_log_config.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Binary {
+
+/**
+ * Config registration for the binary access log. @see AccessLogInstanceFactory.
+ */
+class BinaryAccessLogFactory : public AccessLog::AccessLogInstanceFactory {
+public:
+  AccessLog::InstanceSharedPtr
+  createAccessLogInstance(const Protobuf::Message& config, AccessLog::FilterPtr&& filter,
+                          Server::Configuration::FactoryContext& context) override;
+
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override;
+
+  std::string name() const override;
+};
+
+} // namespace Binary
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,162 @@
+#include "source/extensions/access_loggers/binary/segment_format.h"
+
+#include "source/common/common/assert.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Binary {
+
+namespace {
+
+// Reads an unsigned LEB128 varint from the start of input, which is advanced past it.
+bool readVarint(absl::string_view& input, uint64_t& value) {
+  value = 0;
+  for (size_t i = 0; i < input.size() && i < SegmentFormat::MaxVarintSize; i++) {
+    const uint8_t byte = input[i];
+    value |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+    if ((byte & 0x80) == 0) {
+      input.remove_prefix(i + 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+bool SegmentFormat::isInteger(Field field) {
+  using BinaryAccessLog = envoy::extensions::access_loggers::binary::v3::BinaryAccessLog;
+  switch (field) {
+  case BinaryAccessLog::START_TIME:
+  case BinaryAccessLog::DURATION:
+  case BinaryAccessLog::RESPONSE_CODE:
+  case BinaryAccessLog::RESPONSE_FLAGS:
+  case BinaryAccessLog::BYTES_RECEIVED:
+  case BinaryAccessLog::BYTES_SENT:
+    return true;
+  case BinaryAccessLog::PROTOCOL:
+  case BinaryAccessLog::REQUEST_METHOD:
+  case BinaryAccessLog::REQUEST_PATH:
+  case BinaryAccessLog::AUTHORITY:
+  case BinaryAccessLog::USER_AGENT:
+  case BinaryAccessLog::REQUEST_ID:
+  case BinaryAccessLog::DOWNSTREAM_REMOTE_ADDRESS:
+  case BinaryAccessLog::UPSTREAM_HOST:
+  case BinaryAccessLog::UPSTREAM_CLUSTER:
+  case BinaryAccessLog::ROUTE_NAME:
+    return false;
+  default:
+    PANIC_DUE_TO_CORRUPT_ENUM;
+  }
+}
+
+std::string SegmentFormat::header(const std::vector<Field>& fields) {
+  ASSERT(!fields.empty() && fields.size() <= UINT8_MAX);
+  std::string header(Magic);
+  header.push_back(Version);
+  header.push_back(static_cast<char>(fields.size()));
+  for (const Field field : fields) {
+    header.push_back(static_cast<char>(field));
+  }
+  return header;
+}
+
+size_t SegmentFormat::writeVarint(uint64_t value, uint8_t* output) {
+  size_t size = 0;
+  while (value >= 0x80) {
+    output[size++] = static_cast<uint8_t>(value) | 0x80;
+    value >>= 7;
+  }
+  output[size++] = static_cast<uint8_t>(value);
+  return size;
+}
+
+void SegmentFormat::appendInteger(absl::optional<uint64_t> value, std::string& record) {
+  uint8_t varint[MaxVarintSize];
+  // The largest integer can't be told apart from no value, and is written as the one before it.
+  const uint64_t encoded = value.has_value() ? (*value == UINT64_MAX ? *value : *value + 1) : 0;
+  record.append(reinterpret_cast<const char*>(varint), writeVarint(encoded, varint));
+}
+
+void SegmentFormat::appendString(absl::optional<absl::string_view> value, std::string& record) {
+  uint8_t varint[MaxVarintSize];
+  const uint64_t encoded = value.has_value() ? value->size() + 1 : 0;
+  record.append(reinterpret_cast<const char*>(varint), writeVarint(encoded, varint));
+  if (value.has_value()) {
+    record.append(value->data(), value->size());
+  }
+}
+
+absl::StatusOr<SegmentReader> SegmentReader::create(absl::string_view segment) {
+  if (segment.size() < SegmentFormat::Magic.size() + 2 ||
+      segment.substr(0, SegmentFormat::Magic.size()) != SegmentFormat::Magic) {
+    return absl::InvalidArgumentError("not a binary access log segment");
+  }
+  segment.remove_prefix(SegmentFormat::Magic.size());
+  const uint8_t version = segment[0];
+  if (version != SegmentFormat::Version) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("unsupported segment version ", static_cast<int>(version)));
+  }
+  const uint8_t num_fields = segment[1];
+  segment.remove_prefix(2);
+  if (num_fields == 0 || segment.size() < num_fields) {
+    return absl::InvalidArgumentError("truncated segment header");
+  }
+
+  std::vector<Field> fields;
+  fields.reserve(num_fields);
+  for (uint8_t i = 0; i < num_fields; i++) {
+    const uint8_t field = segment[i];
+    if (!envoy::extensions::access_loggers::binary::v3::BinaryAccessLog::Field_IsValid(field)) {
+      return absl::InvalidArgumentError(absl::StrCat("unknown field ", static_cast<int>(field)));
+    }
+    fields.push_back(static_cast<Field>(field));
+  }
+  segment.remove_prefix(num_fields);
+  return SegmentReader(std::move(fields), segment);
+}
+
+absl::StatusOr<bool> SegmentReader::next(std::vector<Value>& values) {
+  uint64_t length;
+  if (remaining_.empty() || !readVarint(remaining_, length) || length == 0) {
+    // The unused end of a segment still being written is zeroed.
+    remaining_ = {};
+    return false;
+  }
+  if (length > remaining_.size()) {
+    return absl::DataLossError("truncated record");
+  }
+  absl::string_view record = remaining_.substr(0, length);
+  remaining_.remove_prefix(length);
+
+  values.clear();
+  for (const Field field : fields_) {
+    uint64_t encoded;
+    if (!readVarint(record, encoded)) {
+      return absl::DataLossError("truncated field");
+    }
+    if (encoded == 0) {
+      values.emplace_back(absl::monostate());
+    } else if (SegmentFormat::isInteger(field)) {
+      values.emplace_back(encoded - 1);
+    } else if (encoded - 1 > record.size()) {
+      return absl::DataLossError("truncated string field");
+    } else {
+      values.emplace_back(record.substr(0, encoded - 1));
+      record.remove_prefix(encoded - 1);
+    }
+  }
+  if (!record.empty()) {
+    return absl::DataLossError("record longer than its fields");
+  }
+  return true;
+}
+
+} // namespace Binary
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
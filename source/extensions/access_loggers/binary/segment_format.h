@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/access_loggers/binary/v3/binary.pb.h"
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/variant.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Binary {
+
+using Field = envoy::extensions::access_loggers::binary::v3::BinaryAccessLog::Field;
+
+/**
+ * The encoding of binary access log segments, as documented in binary.proto.
+ */
+class SegmentFormat {
+public:
+  static constexpr absl::string_view Magic = "ENVOYBAL";
+  static constexpr uint8_t Version = 1;
+  // The longest varint, of the largest 64 bit integer.
+  static constexpr size_t MaxVarintSize = 10;
+
+  /**
+   * @return whether a field is an integer, or else a string.
+   */
+  static bool isInteger(Field field);
+
+  /**
+   * @return the header of segments whose records have the given fields.
+   */
+  static std::string header(const std::vector<Field>& fields);
+
+  /**
+   * Writes an unsigned LEB128 varint.
+   * @param value the value to write.
+   * @param output the buffer to write into, of at least MaxVarintSize bytes.
+   * @return the number of bytes written.
+   */
+  static size_t writeVarint(uint64_t value, uint8_t* output);
+
+  /**
+   * Appends an integer field to a record.
+   */
+  static void appendInteger(absl::optional<uint64_t> value, std::string& record);
+
+  /**
+   * Appends a string field to a record.
+   */
+  static void appendString(absl::optional<absl::string_view> value, std::string& record);
+};
+
+/**
+ * Reads the records of a segment.
+ */
+class SegmentReader {
+public:
+  // A field without a value, an integer or a string.
+  using Value = absl::variant<absl::monostate, uint64_t, absl::string_view>;
+
+  /**
+   * Reads the header of a segment.
+   * @param segment the contents of the segment, which must outlive the reader.
+   * @return the reader of the records of the segment, or an error if its header is invalid.
+   */
+  static absl::StatusOr<SegmentReader> create(absl::string_view segment);
+
+  const std::vector<Field>& fields() const { return fields_; }
+
+  /**
+   * Reads the next record of the segment.
+   * @param values supplies the values of the fields of the record, valid as long as the segment.
+   * @return false once there are no more records, or an error if the record is invalid.
+   */
+  absl::StatusOr<bool> next(std::vector<Value>& values);
+
+private:
+  SegmentReader(std::vector<Field>&& fields, absl::string_view records)
+      : fields_(std::move(fields)), remaining_(records) {}
+
+  std::vector<Field> fields_;
+  absl::string_view remaining_;
+};
+
+} // namespace Binary
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
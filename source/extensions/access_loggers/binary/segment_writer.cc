@@ -0,0 +1,130 @@
+#include "source/extensions/access_loggers/binary/segment_writer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <chrono>
+#include <cstring>
+
+#include "source/common/common/utility.h"
+#include "source/extensions/access_loggers/binary/segment_format.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Binary {
+
+SegmentWriter::SegmentWriter(Api::OsSysCalls& os_sys_calls, TimeSource& time_source,
+                             BinaryAccessLogStats stats, std::string path_prefix,
+                             std::string header, uint64_t segment_size, uint32_t max_segments)
+    : os_sys_calls_(os_sys_calls), time_source_(time_source), stats_(stats),
+      path_prefix_(std::move(path_prefix)), header_(std::move(header)),
+      segment_size_(segment_size), max_segments_(max_segments) {
+  ASSERT(header_.size() < segment_size_);
+}
+
+SegmentWriter::~SegmentWriter() {
+  if (segment_ != nullptr) {
+    closeSegment();
+  }
+}
+
+void SegmentWriter::write(absl::string_view record) {
+  uint8_t length[SegmentFormat::MaxVarintSize];
+  const size_t length_size = SegmentFormat::writeVarint(record.size(), length);
+  const uint64_t size = length_size + record.size();
+  if (size > segment_size_ - header_.size()) {
+    stats_.logs_dropped_.inc();
+    return;
+  }
+  if (segment_ != nullptr && size > segment_size_ - offset_) {
+    closeSegment();
+  }
+  if (segment_ == nullptr && !openSegment()) {
+    stats_.logs_dropped_.inc();
+    return;
+  }
+
+  memcpy(segment_ + offset_, length, length_size);
+  memcpy(segment_ + offset_ + length_size, record.data(), record.size());
+  offset_ += size;
+  stats_.logs_written_.inc();
+}
+
+bool SegmentWriter::openSegment() {
+  if (time_source_.monotonicTime() < next_open_time_) {
+    return false;
+  }
+
+  // Segments left behind by an earlier process with the same path prefix are skipped, not reused.
+  std::string path;
+  Api::SysCallIntResult result;
+  do {
+    path = absl::StrCat(path_prefix_, ".", next_sequence_++, ".bal");
+    result = os_sys_calls_.open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC,
+                                S_IRUSR | S_IWUSR | S_IRGRP);
+  } while (result.return_value_ == -1 && result.errno_ == EEXIST);
+  if (result.return_value_ == -1) {
+    return segmentFailed("open", path, result.errno_);
+  }
+  const int fd = result.return_value_;
+
+  result = os_sys_calls_.ftruncate(fd, segment_size_);
+  if (result.return_value_ == -1) {
+    os_sys_calls_.close(fd);
+    os_sys_calls_.unlink(path.c_str());
+    return segmentFailed("ftruncate", path, result.errno_);
+  }
+  const Api::SysCallPtrResult mapped =
+      os_sys_calls_.mmap(nullptr, segment_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapped.return_value_ == MAP_FAILED) {
+    os_sys_calls_.close(fd);
+    os_sys_calls_.unlink(path.c_str());
+    return segmentFailed("mmap", path, mapped.errno_);
+  }
+
+  fd_ = fd;
+  segment_ = static_cast<uint8_t*>(mapped.return_value_);
+  memcpy(segment_, header_.data(), header_.size());
+  offset_ = header_.size();
+  stats_.segments_created_.inc();
+
+  segment_paths_.push_back(std::move(path));
+  if (max_segments_ > 0 && segment_paths_.size() > max_segments_) {
+    os_sys_calls_.unlink(segment_paths_.front().c_str());
+    segment_paths_.pop_front();
+  }
+  return true;
+}
+
+void SegmentWriter::closeSegment() {
+  os_sys_calls_.munmap(segment_, segment_size_);
+  // The unused end of the segment is cut off, so that closed segments take only what they hold.
+  const Api::SysCallIntResult result = os_sys_calls_.ftruncate(fd_, offset_);
+  if (result.return_value_ == -1) {
+    stats_.segment_errors_.inc();
+    ENVOY_LOG_EVERY_POW_2(warn, "failed to truncate binary access log segment {}: {}",
+                          segment_paths_.back(), errorDetails(result.errno_));
+  }
+  os_sys_calls_.close(fd_);
+  fd_ = -1;
+  segment_ = nullptr;
+  offset_ = 0;
+}
+
+bool SegmentWriter::segmentFailed(absl::string_view operation, const std::string& path,
+                                  int error) {
+  stats_.segment_errors_.inc();
+  next_open_time_ = time_source_.monotonicTime() + std::chrono::seconds(1);
+  ENVOY_LOG_EVERY_POW_2(warn, "failed to {} binary access log segment {}: {}", operation, path,
+                        errorDetails(error));
+  return false;
+}
+
+} // namespace Binary
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
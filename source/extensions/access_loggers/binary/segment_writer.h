@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+
+#include "envoy/api/os_sys_calls.h"
+#include "envoy/common/time.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/common/logger.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Binary {
+
+/**
+ * All binary access log stats. @see stats_macros.h
+ */
+#define ALL_BINARY_ACCESS_LOG_STATS(COUNTER)                                                       \
+  COUNTER(logs_dropped)                                                                            \
+  COUNTER(logs_written)                                                                            \
+  COUNTER(segment_errors)                                                                          \
+  COUNTER(segments_created)
+
+/**
+ * Struct definition for all binary access log stats. @see stats_macros.h
+ */
+struct BinaryAccessLogStats {
+  ALL_BINARY_ACCESS_LOG_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * Writes the records of a single thread into memory-mapped segment files, named
+ * <path_prefix>.<sequence>.bal. Not thread safe.
+ */
+class SegmentWriter : Logger::Loggable<Logger::Id::file> {
+public:
+  /**
+   * @param path_prefix the path prefix of the segments.
+   * @param header the header written at the start of each segment.
+   * @param segment_size the size of each segment while it is written.
+   * @param max_segments the number of segments to keep, or zero to keep them all.
+   */
+  SegmentWriter(Api::OsSysCalls& os_sys_calls, TimeSource& time_source,
+                BinaryAccessLogStats stats, std::string path_prefix, std::string header,
+                uint64_t segment_size, uint32_t max_segments);
+  ~SegmentWriter();
+
+  /**
+   * Writes a record, starting a new segment if it doesn't fit into the current one.
+   * @param record the encoded fields of the record, without its length.
+   */
+  void write(absl::string_view record);
+
+private:
+  bool openSegment();
+  void closeSegment();
+  bool segmentFailed(absl::string_view operation, const std::string& path, int error);
+
+  Api::OsSysCalls& os_sys_calls_;
+  TimeSource& time_source_;
+  BinaryAccessLogStats stats_;
+  const std::string path_prefix_;
+  const std::string header_;
+  const uint64_t segment_size_;
+  const uint32_t max_segments_;
+  int fd_{-1};
+  uint8_t* segment_{};
+  uint64_t offset_{};
+  uint64_t next_sequence_{};
+  // The segments written so far, oldest first, as long as they are kept.
+  std::deque<std::string> segment_paths_;
+  // Opening segments is retried at most once a second after it fails.
+  MonotonicTime next_open_time_;
+};
+
+} // namespace Binary
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <deque>
 #include <memory>
 
+#include "envoy/common/time.h"
 #include "envoy/config/core/v3/config_source.pb.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/grpc/async_client_manager.h"
@@ -81,6 +85,13 @@ public:
   virtual bool isConnected() PURE;
   virtual bool log(const LogRequest& request) PURE;
 
+  /**
+   * @param flush_interval supplies the interval of flushes to the service.
+   * @return whether requests are sent faster than the service takes them in, judging by signals
+   *         other than log() failing.
+   */
+  virtual bool isCongested(std::chrono::milliseconds) { return false; }
+
 protected:
   GrpcAccessLogClient(const Grpc::RawAsyncClientSharedPtr& client,
                       const Protobuf::MethodDescriptor& service_method,
@@ -114,27 +125,65 @@ class UnaryGrpcAccessLogClient : public GrpcAccessLogClient<LogRequest, LogRespo
 public:
   UnaryGrpcAccessLogClient(const Grpc::RawAsyncClientSharedPtr& client,
                            const Protobuf::MethodDescriptor& service_method,
-                           OptRef<const envoy::config::core::v3::RetryPolicy> retry_policy)
-      : GrpcAccessLogClient<LogRequest, LogResponse>(client, service_method, retry_policy) {}
+                           OptRef<const envoy::config::core::v3::RetryPolicy> retry_policy,
+                           TimeSource& time_source)
+      : GrpcAccessLogClient<LogRequest, LogResponse>(client, service_method, retry_policy),
+        time_source_(time_source) {}
 
   bool isConnected() override { return false; }
 
   bool log(const LogRequest& request) override {
+    // Requests which never complete, such as those without a timeout to a service which hangs,
+    // stop being tracked once too many newer ones are outstanding.
+    if (send_times_.size() >= MaxTrackedRequests) {
+      send_times_.pop_front();
+    }
+    // Recorded ahead of sending, as the request may complete inline.
+    send_times_.push_back(time_source_.monotonicTime());
     GrpcAccessLogClient<LogRequest, LogResponse>::client_->send(
         GrpcAccessLogClient<LogRequest, LogResponse>::service_method_, request, request_cb_,
         Tracing::NullSpan::instance(), GrpcAccessLogClient<LogRequest, LogResponse>::opts_);
     return true;
   }
 
+  bool isCongested(std::chrono::milliseconds flush_interval) override {
+    return send_times_.size() > 1 || (smoothed_rtt_.has_value() && *smoothed_rtt_ > flush_interval);
+  }
+
   struct RequestCallbacks : public Grpc::AsyncRequestCallbacks<LogResponse> {
+    RequestCallbacks(UnaryGrpcAccessLogClient& parent) : parent_(parent) {}
+
     // Grpc::AsyncRequestCallbacks
-    void onSuccess(Grpc::ResponsePtr<LogResponse>&&, Tracing::Span&) override {}
+    void onSuccess(Grpc::ResponsePtr<LogResponse>&&, Tracing::Span&) override {
+      parent_.onRequestComplete();
+    }
     void onCreateInitialMetadata(Http::RequestHeaderMap&) override {}
-    void onFailure(Grpc::Status::GrpcStatus, const std::string&, Tracing::Span&) override {}
+    void onFailure(Grpc::Status::GrpcStatus, const std::string&, Tracing::Span&) override {
+      parent_.onRequestComplete();
+    }
+
+    UnaryGrpcAccessLogClient& parent_;
   };
 
+  static constexpr size_t MaxTrackedRequests = 64;
+
 private:
-  RequestCallbacks request_cb_;
+  // Requests are assumed to complete in the order they are sent, so each completion is timed from
+  // the oldest outstanding request.
+  void onRequestComplete() {
+    if (send_times_.empty()) {
+      return;
+    }
+    const auto rtt = std::chrono::duration_cast<std::chrono::milliseconds>(
+        time_source_.monotonicTime() - send_times_.front());
+    send_times_.pop_front();
+    smoothed_rtt_ = smoothed_rtt_.has_value() ? (*smoothed_rtt_ * 7 + rtt) / 8 : rtt;
+  }
+
+  TimeSource& time_source_;
+  RequestCallbacks request_cb_{*this};
+  std::deque<MonotonicTime> send_times_;
+  absl::optional<std::chrono::milliseconds> smoothed_rtt_;
 };
 
 template <typename LogRequest, typename LogResponse>
@@ -202,7 +251,8 @@ public:
  */
 #define ALL_GRPC_ACCESS_LOGGER_STATS(COUNTER)                                                      \
   COUNTER(logs_written)                                                                            \
-  COUNTER(logs_dropped)
+  COUNTER(logs_dropped)                                                                            \
+  COUNTER(logs_evicted)
 
 /**
  * Wrapper struct for the access log stats. @see stats_macros.h
@@ -233,13 +283,23 @@ public:
           flush_timer_->enableTimer(buffer_flush_interval_msec_);
         })),
         max_buffer_size_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, buffer_size_bytes, 16384)),
+        adaptive_batching_(config.has_adaptive_batching()),
+        adaptive_max_buffer_size_bytes_(std::max<uint64_t>(
+            PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.adaptive_batching(), max_buffer_size_bytes,
+                                            262144),
+            max_buffer_size_bytes_)),
+        max_pending_bytes_(std::max<uint64_t>(
+            PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.adaptive_batching(), max_pending_bytes, 1048576),
+            max_buffer_size_bytes_)),
+        buffer_size_bytes_(max_buffer_size_bytes_),
         stats_({ALL_GRPC_ACCESS_LOGGER_STATS(POOL_COUNTER_PREFIX(scope, access_log_prefix))}) {
     if (stream) {
       client_ = std::make_unique<Detail::StreamingGrpcAccessLogClient<LogRequest, LogResponse>>(
           client, service_method, GrpcCommon::optionalRetryPolicy(config));
     } else {
       client_ = std::make_unique<Detail::UnaryGrpcAccessLogClient<LogRequest, LogResponse>>(
-          client, service_method, GrpcCommon::optionalRetryPolicy(config));
+          client, service_method, GrpcCommon::optionalRetryPolicy(config),
+          dispatcher.timeSource());
     }
     flush_timer_->enableTimer(buffer_flush_interval_msec_);
   }
@@ -248,20 +308,10 @@ public:
     if (!canLogMore()) {
       return;
     }
-    approximate_message_size_bytes_ += entry.ByteSizeLong();
-    addEntry(std::move(entry));
-    if (approximate_message_size_bytes_ >= max_buffer_size_bytes_) {
-      flush();
-    }
+    addEntrySized(std::move(entry));
   }
 
-  void log(TcpLogProto&& entry) override {
-    approximate_message_size_bytes_ += entry.ByteSizeLong();
-    addEntry(std::move(entry));
-    if (approximate_message_size_bytes_ >= max_buffer_size_bytes_) {
-      flush();
-    }
-  }
+  void log(TcpLogProto&& entry) override { addEntrySized(std::move(entry)); }
 
 protected:
   std::unique_ptr<Detail::GrpcAccessLogClient<LogRequest, LogResponse>> client_;
@@ -272,8 +322,25 @@ private:
   virtual void initMessage() PURE;
   virtual void addEntry(HttpLogProto&& entry) PURE;
   virtual void addEntry(TcpLogProto&& entry) PURE;
+  // Removes the given number of the oldest entries from the message.
+  virtual void removeOldestEntries(size_t count) PURE;
   virtual void clearMessage() { message_.Clear(); }
 
+  template <typename LogProto> void addEntrySized(LogProto&& entry) {
+    const uint64_t entry_size = entry.ByteSizeLong();
+    approximate_message_size_bytes_ += entry_size;
+    addEntry(std::move(entry));
+    if (adaptive_batching_) {
+      entry_sizes_.push_back(entry_size);
+    }
+    if (approximate_message_size_bytes_ >= buffer_size_bytes_) {
+      flush();
+    }
+    if (adaptive_batching_) {
+      evictOldestEntries();
+    }
+  }
+
   void flush() {
     if (isEmpty()) {
       // Nothing to flush.
@@ -284,14 +351,49 @@ private:
       initMessage();
     }
 
-    if (client_->log(message_)) {
+    const bool sent = client_->log(message_);
+    if (sent) {
       // Clear the message regardless of the success.
       approximate_message_size_bytes_ = 0;
+      entry_sizes_.clear();
       clearMessage();
     }
+    if (adaptive_batching_) {
+      // Batches grow while the service is congested, so that it is sent fewer and larger messages,
+      // and shrink back to the configured size otherwise, to keep the latency of logs low.
+      if (!sent || client_->isCongested(buffer_flush_interval_msec_)) {
+        // The buffer never grows past the pending limit, as the oldest entries are evicted there.
+        buffer_size_bytes_ = std::min({std::max<uint64_t>(buffer_size_bytes_ * 2, 1024),
+                                       adaptive_max_buffer_size_bytes_, max_pending_bytes_});
+      } else {
+        buffer_size_bytes_ = std::max(buffer_size_bytes_ / 2, max_buffer_size_bytes_);
+      }
+    }
+  }
+
+  // Drops the oldest entries while the entries buffered for a congested service take more than
+  // max_pending_bytes_, always keeping the newest one.
+  void evictOldestEntries() {
+    size_t evicted = 0;
+    while (approximate_message_size_bytes_ > max_pending_bytes_ &&
+           entry_sizes_.size() - evicted > 1) {
+      approximate_message_size_bytes_ -= entry_sizes_[evicted];
+      evicted++;
+    }
+    if (evicted > 0) {
+      entry_sizes_.erase(entry_sizes_.begin(), entry_sizes_.begin() + evicted);
+      removeOldestEntries(evicted);
+      stats_.logs_dropped_.add(evicted);
+      stats_.logs_evicted_.add(evicted);
+    }
   }
 
   bool canLogMore() {
+    if (adaptive_batching_) {
+      // The oldest entries are evicted instead of dropping new ones.
+      stats_.logs_written_.inc();
+      return true;
+    }
     if (max_buffer_size_bytes_ == 0 || approximate_message_size_bytes_ < max_buffer_size_bytes_) {
       stats_.logs_written_.inc();
       return true;
@@ -308,7 +410,17 @@ private:
   const std::chrono::milliseconds buffer_flush_interval_msec_;
   const Event::TimerPtr flush_timer_;
   const uint64_t max_buffer_size_bytes_;
+  const bool adaptive_batching_;
+  const uint64_t adaptive_max_buffer_size_bytes_;
+  // At least max_buffer_size_bytes_, as evicting entries below the flush threshold would drop them
+  // even while the service is healthy.
+  const uint64_t max_pending_bytes_;
+  // The size at which the buffer is flushed, which only differs from max_buffer_size_bytes_ with
+  // adaptive batching.
+  uint64_t buffer_size_bytes_;
   uint64_t approximate_message_size_bytes_ = 0;
+  // The sizes of the buffered entries, oldest first, with adaptive batching.
+  std::deque<uint64_t> entry_sizes_;
   GrpcAccessLoggerStats stats_;
 };
 
@@ -32,6 +32,15 @@ void GrpcAccessLoggerImpl::addEntry(envoy::data::accesslog::v3::TCPAccessLogEntr
   message_.mutable_tcp_logs()->mutable_log_entry()->Add(std::move(entry));
 }
 
+void GrpcAccessLoggerImpl::removeOldestEntries(size_t count) {
+  // A logger only logs either HTTP or TCP entries.
+  if (message_.has_http_logs()) {
+    message_.mutable_http_logs()->mutable_log_entry()->DeleteSubrange(0, count);
+  } else {
+    message_.mutable_tcp_logs()->mutable_log_entry()->DeleteSubrange(0, count);
+  }
+}
+
 bool GrpcAccessLoggerImpl::isEmpty() {
   return !message_.has_http_logs() && !message_.has_tcp_logs();
 }
@@ -32,6 +32,7 @@ private:
   // Extensions::AccessLoggers::GrpcCommon::GrpcAccessLogger
   void addEntry(envoy::data::accesslog::v3::HTTPAccessLogEntry&& entry) override;
   void addEntry(envoy::data::accesslog::v3::TCPAccessLogEntry&& entry) override;
+  void removeOldestEntries(size_t count) override;
   bool isEmpty() override;
   void initMessage() override;
 
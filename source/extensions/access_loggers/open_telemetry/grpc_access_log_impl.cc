@@ -68,6 +68,10 @@ void GrpcAccessLoggerImpl::addEntry(opentelemetry::proto::logs::v1::LogRecord&&
   root_->mutable_log_records()->Add(std::move(entry));
 }
 
+void GrpcAccessLoggerImpl::removeOldestEntries(size_t count) {
+  root_->mutable_log_records()->DeleteSubrange(0, count);
+}
+
 bool GrpcAccessLoggerImpl::isEmpty() { return root_->log_records().empty(); }
 
 // The message is already initialized in the c'tor, and only the logs are cleared.
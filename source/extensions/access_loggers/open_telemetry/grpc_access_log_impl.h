@@ -51,6 +51,7 @@ private:
   void addEntry(opentelemetry::proto::logs::v1::LogRecord&& entry) override;
   // Non used addEntry method (the above is used for both TCP and HTTP).
   void addEntry(ProtobufWkt::Empty&& entry) override { (void)entry; };
+  void removeOldestEntries(size_t count) override;
   bool isEmpty() override;
   void initMessage() override;
   void clearMessage() override;
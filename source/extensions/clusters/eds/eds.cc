@@ -396,11 +396,14 @@ bool EdsClusterImpl::updateHostsPerLocality(
   // performance implications, since this has the knock on effect that we rebuild the load balancers
   // and locality scheduler. See the comment in BaseDynamicClusterImpl::updateDynamicHostList
   // about this. In the future we may need to do better here.
-  const bool hosts_updated = updateDynamicHostList(new_hosts, *current_hosts_copy, hosts_added,
-                                                   hosts_removed, all_hosts, all_new_hosts);
-  if (hosts_updated || host_set.weightedPriorityHealth() != weighted_priority_health ||
-      host_set.overprovisioningFactor() != overprovisioning_factor ||
-      locality_weights_map != new_locality_weights_map) {
+  HostVector hosts_with_updated_health;
+  const bool hosts_updated =
+      updateDynamicHostList(new_hosts, *current_hosts_copy, hosts_added, hosts_removed, all_hosts,
+                            all_new_hosts, &hosts_with_updated_health);
+  const bool settings_updated = host_set.weightedPriorityHealth() != weighted_priority_health ||
+                                host_set.overprovisioningFactor() != overprovisioning_factor ||
+                                locality_weights_map != new_locality_weights_map;
+  if (hosts_updated || settings_updated) {
     ASSERT(std::all_of(current_hosts_copy->begin(), current_hosts_copy->end(),
                        [&](const auto& host) { return host->priority() == priority; }));
     locality_weights_map = new_locality_weights_map;
@@ -408,6 +411,17 @@ bool EdsClusterImpl::updateHostsPerLocality(
               "EDS hosts or locality weights changed for cluster: {} current hosts {} priority {}",
               info_->name(), host_set.hosts().size(), host_set.priority());
 
+    // Most updates of large clusters only change the health or weight of a few endpoints, which
+    // updateDynamicHostList() has already applied to the existing hosts. The hosts and their
+    // localities are then unchanged, so only the localities of the hosts whose health changed need
+    // to be partitioned again.
+    if (!settings_updated && hosts_added.empty() && hosts_removed.empty() &&
+        *current_hosts_copy == host_set.hosts()) {
+      priority_state_manager.updateClusterPrioritySetInPlace(priority, host_set,
+                                                             hosts_with_updated_health);
+      return true;
+    }
+
     priority_state_manager.updateClusterPrioritySet(
         priority, std::move(current_hosts_copy), hosts_added, hosts_removed, absl::nullopt,
         weighted_priority_health, overprovisioning_factor);
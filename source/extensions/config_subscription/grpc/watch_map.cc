@@ -206,9 +206,10 @@ void WatchMap::onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt::Any>
   }
 
   std::vector<DecodedResourcePtr> decoded_resources;
+  const ArenaSharedPtr arena = DecodedResourceImpl::createArena();
   for (const auto& r : resources) {
-    decoded_resources.emplace_back(
-        DecodedResourceImpl::fromResource((*watches_.begin())->resource_decoder_, r, version_info));
+    decoded_resources.emplace_back(DecodedResourceImpl::fromResource(
+        (*watches_.begin())->resource_decoder_, r, version_info, arena));
   }
 
   onConfigUpdate(decoded_resources, version_info);
@@ -226,6 +227,7 @@ void WatchMap::onConfigUpdate(
   // cares about. Each entry in the map-pair is then a nice little bundle that can be fed directly
   // into the individual onConfigUpdate()s.
   std::vector<DecodedResourcePtr> decoded_resources;
+  const ArenaSharedPtr arena = DecodedResourceImpl::createArena();
   absl::flat_hash_map<Watch*, std::vector<DecodedResourceRef>> per_watch_added;
   for (const auto& r : added_resources) {
     const absl::flat_hash_set<Watch*>& interested_in_r = watchesInterestedIn(r.name());
@@ -235,7 +237,7 @@ void WatchMap::onConfigUpdate(
       continue;
     }
     decoded_resources.emplace_back(
-        new DecodedResourceImpl((*interested_in_r.begin())->resource_decoder_, r));
+        new DecodedResourceImpl((*interested_in_r.begin())->resource_decoder_, r, arena));
     for (const auto& interested_watch : interested_in_r) {
       per_watch_added[interested_watch].emplace_back(*decoded_resources.back());
     }
@@ -49,6 +49,7 @@ void SotwSubscriptionState::handleGoodResponse(
 
   {
     const auto scoped_update = ttl_.scopedTtlUpdate();
+    const ArenaSharedPtr arena = DecodedResourceImpl::createArena();
     for (const auto& any : message.resources()) {
       if (!any.Is<envoy::service::discovery::v3::Resource>() &&
           any.type_url() != message.type_url()) {
@@ -59,7 +60,7 @@ void SotwSubscriptionState::handleGoodResponse(
       }
 
       auto decoded_resource =
-          DecodedResourceImpl::fromResource(*resource_decoder_, any, message.version_info());
+          DecodedResourceImpl::fromResource(*resource_decoder_, any, message.version_info(), arena);
       setResourceTtl(*decoded_resource);
       if (isHeartbeatResource(*decoded_resource, message.version_info())) {
         continue;
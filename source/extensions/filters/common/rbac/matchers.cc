@@ -4,6 +4,7 @@
 #include "envoy/upstream/upstream.h"
 
 #include "source/common/config/utility.h"
+#include "source/common/http/path_utility.h"
 #include "source/extensions/filters/common/rbac/matcher_extension.h"
 
 namespace Envoy {
@@ -112,14 +113,50 @@ bool AndMatcher::matches(const Network::Connection& connection,
 OrMatcher::OrMatcher(const Protobuf::RepeatedPtrField<envoy::config::rbac::v3::Permission>& rules,
                      ProtobufMessage::ValidationVisitor& validation_visitor) {
   for (const auto& rule : rules) {
-    matchers_.push_back(Matcher::create(rule, validation_visitor));
+    if (rule.rule_case() == envoy::config::rbac::v3::Permission::RuleCase::kUrlPath) {
+      addPathMatcher(rule.url_path());
+    } else {
+      matchers_.push_back(Matcher::create(rule, validation_visitor));
+    }
   }
+  compilePathRegexSet();
 }
 
 OrMatcher::OrMatcher(const Protobuf::RepeatedPtrField<envoy::config::rbac::v3::Principal>& ids) {
   for (const auto& id : ids) {
-    matchers_.push_back(Matcher::create(id));
+    if (id.identifier_case() == envoy::config::rbac::v3::Principal::IdentifierCase::kUrlPath) {
+      addPathMatcher(id.url_path());
+    } else {
+      matchers_.push_back(Matcher::create(id));
+    }
+  }
+  compilePathRegexSet();
+}
+
+void OrMatcher::addPathMatcher(const envoy::type::matcher::v3::PathMatcher& path_matcher) {
+  auto matcher = std::make_shared<const PathMatcher>(path_matcher);
+  if (matcher->regex() != nullptr) {
+    path_regex_matchers_.push_back(std::move(matcher));
+  } else {
+    matchers_.push_back(std::move(matcher));
+  }
+}
+
+void OrMatcher::compilePathRegexSet() {
+  if (path_regex_matchers_.size() > 1) {
+    auto regex_set = std::make_unique<Regex::CompiledGoogleReSet>();
+    bool added = true;
+    for (const auto& matcher : path_regex_matchers_) {
+      added = added && regex_set->add(*matcher->regex());
+    }
+    if (added && regex_set->compile()) {
+      path_regex_set_ = std::move(regex_set);
+      return;
+    }
   }
+  // Otherwise the url_path sub-matchers are evaluated one at a time, like the others.
+  matchers_.insert(matchers_.end(), path_regex_matchers_.begin(), path_regex_matchers_.end());
+  path_regex_matchers_.clear();
 }
 
 bool OrMatcher::matches(const Network::Connection& connection,
@@ -131,6 +168,20 @@ bool OrMatcher::matches(const Network::Connection& connection,
     }
   }
 
+  if (path_regex_set_ == nullptr || headers.Path() == nullptr) {
+    return false;
+  }
+  const absl::optional<bool> path_matches = path_regex_set_->matchesAny(
+      Envoy::Http::PathUtil::removeQueryAndFragment(headers.getPathValue()));
+  if (path_matches.has_value()) {
+    return path_matches.value();
+  }
+  // The regex set ran out of memory, and the regexes are matched one at a time instead.
+  for (const auto& matcher : path_regex_matchers_) {
+    if (matcher->matches(connection, headers, info)) {
+      return true;
+    }
+  }
   return false;
 }
 
@@ -11,6 +11,7 @@
 #include "envoy/type/matcher/v3/string.pb.h"
 
 #include "source/common/common/matchers.h"
+#include "source/common/common/regex.h"
 #include "source/common/http/header_utility.h"
 #include "source/common/network/cidr_range.h"
 #include "source/extensions/filters/common/expr/evaluator.h"
@@ -23,6 +24,7 @@ namespace RBAC {
 
 class Matcher;
 using MatcherConstSharedPtr = std::shared_ptr<const Matcher>;
+class PathMatcher;
 
 /**
  *  Matchers describe the rules for matching either a permission action or principal.
@@ -87,7 +89,8 @@ private:
 
 /**
  * A composite matcher where only one sub-matcher must match for this to return true. Evaluation
- * short-circuits on the first match.
+ * short-circuits on the first match. The paths of requests are matched against the regexes of
+ * several url_path sub-matchers at once.
  */
 class OrMatcher : public Matcher {
 public:
@@ -103,7 +106,14 @@ public:
                const StreamInfo::StreamInfo&) const override;
 
 private:
+  // Adds the sub-matcher of a url_path rule, whose regex may be matched with others at once.
+  void addPathMatcher(const envoy::type::matcher::v3::PathMatcher& path_matcher);
+  void compilePathRegexSet();
+
   std::vector<MatcherConstSharedPtr> matchers_;
+  // The url_path sub-matchers with Google RE2 regexes, when there are several, and their regexes.
+  std::vector<std::shared_ptr<const PathMatcher>> path_regex_matchers_;
+  std::unique_ptr<const Regex::CompiledGoogleReSet> path_regex_set_;
 };
 
 class NotMatcher : public Matcher {
@@ -279,6 +289,9 @@ public:
   bool matches(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap& headers,
                const StreamInfo::StreamInfo&) const override;
 
+  // The compiled regex of a safe_regex path matcher, or nullptr for other matchers.
+  const Regex::CompiledMatcher* regex() const { return path_matcher_.matcher().regex(); }
+
 private:
   const Matchers::PathMatcher path_matcher_;
 };
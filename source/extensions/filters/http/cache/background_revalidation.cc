@@ -0,0 +1,228 @@
+#include "source/extensions/filters/http/cache/background_revalidation.h"
+
+#include "envoy/http/codes.h"
+
+#include "source/common/common/enum_to_int.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/http/headers.h"
+#include "source/common/http/message_impl.h"
+#include "source/common/http/utility.h"
+#include "source/extensions/filters/http/cache/cache_custom_headers.h"
+#include "source/extensions/filters/http/cache/cacheability_utils.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+bool BackgroundRevalidation::start(CacheFilterSharedStateSharedPtr shared_state,
+                                   std::shared_ptr<HttpCache> cache, TimeSource& time_source,
+                                   const Http::RequestHeaderMap& request_headers,
+                                   const Http::ResponseHeaderMap& cached_headers,
+                                   Http::StreamDecoderFilterCallbacks& decoder_callbacks) {
+  Router::RouteConstSharedPtr route = decoder_callbacks.route();
+  const Router::RouteEntry* route_entry = route != nullptr ? route->routeEntry() : nullptr;
+  if (route_entry == nullptr) {
+    ENVOY_STREAM_LOG(debug, "BackgroundRevalidation: request has no route to revalidate on",
+                     decoder_callbacks);
+    return false;
+  }
+  Upstream::ThreadLocalCluster* cluster =
+      shared_state->clusterManager().getThreadLocalCluster(route_entry->clusterName());
+  if (cluster == nullptr) {
+    ENVOY_STREAM_LOG(debug, "BackgroundRevalidation: unknown cluster {}", decoder_callbacks,
+                     route_entry->clusterName());
+    return false;
+  }
+  const VaryAllowList& vary_allow_list = shared_state->varyAllowList();
+  Key key = LookupRequest(request_headers, time_source.systemTime(), vary_allow_list).key();
+  if (!shared_state->tryStartRevalidation(key)) {
+    // The stale response is already being revalidated, so it can be served as is.
+    return true;
+  }
+  LookupContextPtr update_context = cache->makeDetachedLookupContext(
+      LookupRequest(request_headers, time_source.systemTime(), vary_allow_list));
+  if (update_context == nullptr) {
+    ENVOY_STREAM_LOG(debug, "BackgroundRevalidation: cache doesn't support detached lookups",
+                     decoder_callbacks);
+    shared_state->finishRevalidation(key);
+    return false;
+  }
+  shared_state->stats().background_revalidation_started_.inc();
+  std::unique_ptr<BackgroundRevalidation> revalidation(new BackgroundRevalidation(
+      std::move(shared_state), std::move(cache), time_source, decoder_callbacks.dispatcher(),
+      std::move(key), request_headers, cached_headers, std::move(update_context)));
+  BackgroundRevalidation& ref = *revalidation;
+  ref.self_ownership_ = std::move(revalidation);
+  ref.send(*cluster, *route_entry, request_headers, cached_headers);
+  return true;
+}
+
+BackgroundRevalidation::BackgroundRevalidation(CacheFilterSharedStateSharedPtr shared_state,
+                                               std::shared_ptr<HttpCache> cache,
+                                               TimeSource& time_source,
+                                               Event::Dispatcher& dispatcher, Key key,
+                                               const Http::RequestHeaderMap& request_headers,
+                                               const Http::ResponseHeaderMap& cached_headers,
+                                               LookupContextPtr update_context)
+    : shared_state_(std::move(shared_state)), cache_(std::move(cache)), time_source_(time_source),
+      dispatcher_(dispatcher), key_(std::move(key)),
+      cached_status_(Http::Utility::getResponseStatus(cached_headers)),
+      cached_etag_(cached_headers.getInlineValue(CacheCustomHeaders::etag())),
+      update_context_(std::move(update_context)) {
+  // The lookup requests refer to the allow list, which the shared state keeps alive.
+  LookupContextPtr insert_lookup_context = cache_->makeDetachedLookupContext(LookupRequest(
+      request_headers, time_source_.systemTime(), shared_state_->varyAllowList()));
+  if (insert_lookup_context != nullptr) {
+    // The insert context owns the lookup context it is made from.
+    insert_context_ = cache_->makeDetachedInsertContext(std::move(insert_lookup_context));
+  }
+}
+
+BackgroundRevalidation::~BackgroundRevalidation() {
+  if (request_ != nullptr) {
+    request_->cancel();
+  }
+  if (insert_context_ != nullptr) {
+    insert_context_->onDestroy();
+  }
+  if (update_context_ != nullptr) {
+    update_context_->onDestroy();
+  }
+  if (!finished_) {
+    shared_state_->finishRevalidation(key_);
+  }
+}
+
+void BackgroundRevalidation::send(Upstream::ThreadLocalCluster& cluster,
+                                  const Router::RouteEntry& route_entry,
+                                  const Http::RequestHeaderMap& request_headers,
+                                  const Http::ResponseHeaderMap& cached_headers) {
+  auto headers = Http::createHeaderMap<Http::RequestHeaderMapImpl>(request_headers);
+  // The whole response is revalidated, whichever part of it the client asked for.
+  headers->remove(Http::Headers::get().Range);
+  headers->remove(Http::CustomHeaders::get().IfRange);
+  CacheHeadersUtils::setValidationHeaders(cached_headers, *headers);
+
+  Http::AsyncClient::RequestOptions options;
+  if (route_entry.timeout().count() > 0) {
+    options.setTimeout(route_entry.timeout());
+  }
+  // The async client may call onFailure inline, in which case this revalidation has already been
+  // scheduled for deletion, but is still alive.
+  Http::AsyncClient::Request* request = cluster.httpAsyncClient().send(
+      std::make_unique<Http::RequestMessageImpl>(std::move(headers)), *this, options);
+  if (!finished_) {
+    request_ = request;
+  }
+}
+
+void BackgroundRevalidation::onSuccess(const Http::AsyncClient::Request&,
+                                       Http::ResponseMessagePtr&& response) {
+  request_ = nullptr;
+  response_ = std::move(response);
+  const Http::ResponseHeaderMap& headers = response_->headers();
+  if (Http::Utility::getResponseStatus(headers) == enumToInt(Http::Code::NotModified)) {
+    updateHeaders();
+    return;
+  }
+  if (insert_context_ != nullptr &&
+      CacheabilityUtils::isCacheableResponse(headers, shared_state_->varyAllowList())) {
+    insertHeaders();
+    return;
+  }
+  ENVOY_LOG(debug, "BackgroundRevalidation: upstream responded with an uncacheable {}",
+            headers.getStatusValue());
+  finish(stats().background_revalidation_failed_);
+}
+
+void BackgroundRevalidation::onFailure(const Http::AsyncClient::Request&,
+                                       Http::AsyncClient::FailureReason) {
+  request_ = nullptr;
+  ENVOY_LOG(debug, "BackgroundRevalidation: upstream request failed");
+  finish(stats().background_revalidation_failed_);
+}
+
+void BackgroundRevalidation::updateHeaders() {
+  Http::ResponseHeaderMap& headers = response_->headers();
+  // According to: https://httpwg.org/specs/rfc7234.html#freshening.responses, a 304 with a
+  // different strong validator is for another response, which mustn't be freshened.
+  const absl::string_view etag = headers.getInlineValue(CacheCustomHeaders::etag());
+  if (!etag.empty() && etag != cached_etag_) {
+    finish(stats().background_revalidation_failed_);
+    return;
+  }
+  // The 304 only carries the headers to update; the cached response keeps its own status.
+  headers.setStatus(cached_status_);
+  headers.removeContentLength();
+  const ResponseMetadata metadata = {time_source_.systemTime()};
+  cache_->updateHeaders(*update_context_, headers, metadata,
+                        onDispatcher([this](bool updated) {
+                          finish(updated ? stats().background_revalidation_not_modified_
+                                         : stats().background_revalidation_failed_);
+                        }));
+}
+
+void BackgroundRevalidation::insertHeaders() {
+  const bool end_stream = response_->body().length() == 0 && response_->trailers() == nullptr;
+  const ResponseMetadata metadata = {time_source_.systemTime()};
+  insert_context_->insertHeaders(
+      response_->headers(), metadata,
+      onDispatcher([this, end_stream](bool ready) {
+        if (!ready) {
+          finish(stats().background_revalidation_failed_);
+        } else if (end_stream) {
+          finish(stats().background_revalidation_replaced_);
+        } else if (response_->body().length() > 0) {
+          insertBody();
+        } else {
+          insertTrailers();
+        }
+      }),
+      end_stream);
+}
+
+void BackgroundRevalidation::insertBody() {
+  const bool end_stream = response_->trailers() == nullptr;
+  insert_context_->insertBody(
+      response_->body(),
+      onDispatcher([this, end_stream](bool ready) {
+        if (!ready) {
+          finish(stats().background_revalidation_failed_);
+        } else if (end_stream) {
+          finish(stats().background_revalidation_replaced_);
+        } else {
+          insertTrailers();
+        }
+      }),
+      end_stream);
+}
+
+void BackgroundRevalidation::insertTrailers() {
+  insert_context_->insertTrailers(*response_->trailers(), onDispatcher([this](bool inserted) {
+                                    finish(inserted ? stats().background_revalidation_replaced_
+                                                    : stats().background_revalidation_failed_);
+                                  }));
+}
+
+InsertCallback BackgroundRevalidation::onDispatcher(std::function<void(bool)> cb) {
+  // Caches may call back on any thread. The revalidation stays alive until a callback finishes it,
+  // so the posted callback can refer to it.
+  return [&dispatcher = dispatcher_, cb = std::move(cb)](bool result) {
+    dispatcher.post([cb, result]() { cb(result); });
+  };
+}
+
+void BackgroundRevalidation::finish(Stats::Counter& result) {
+  ASSERT(!finished_);
+  finished_ = true;
+  result.inc();
+  // Later stale hits may revalidate the entry again.
+  shared_state_->finishRevalidation(key_);
+  dispatcher_.deferredDelete(std::move(self_ownership_));
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/async_client.h"
+#include "envoy/http/filter.h"
+#include "envoy/router/router.h"
+#include "envoy/upstream/thread_local_cluster.h"
+
+#include "source/common/common/logger.h"
+#include "source/extensions/filters/http/cache/cache_filter_shared_state.h"
+#include "source/extensions/filters/http/cache/cache_headers_utils.h"
+#include "source/extensions/filters/http/cache/http_cache.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * Revalidates a stale cached response in the background while the stale response is served, as
+ * allowed by its stale-while-revalidate directive: https://httpwg.org/specs/rfc5861.html
+ *
+ * Sends a conditional request for the cached response to the request's upstream cluster through
+ * the cluster's async client. A 304 response freshens the cached headers; a new cacheable response
+ * replaces the cached one. The revalidation owns itself until the upstream request and any
+ * resulting cache write complete, since it outlives the request that started it. It therefore
+ * only uses the cache's detached contexts and its own async client callbacks, never the filter
+ * callbacks of the request. At most one revalidation of an entry is in flight per filter config.
+ */
+class BackgroundRevalidation : public Http::AsyncClient::Callbacks,
+                               public Event::DeferredDeletable,
+                               public Logger::Loggable<Logger::Id::cache_filter> {
+public:
+  // Starts revalidating cached_headers, the stale response found for request_headers. Returns
+  // false if the response can't be revalidated in the background, because the request isn't
+  // routed to a cluster or the cache doesn't support detached lookups, in which case the caller
+  // should validate it before serving it. Returns true without starting another revalidation if
+  // the entry is already being revalidated. The decoder callbacks are only used during the call.
+  static bool start(CacheFilterSharedStateSharedPtr shared_state, std::shared_ptr<HttpCache> cache,
+                    TimeSource& time_source, const Http::RequestHeaderMap& request_headers,
+                    const Http::ResponseHeaderMap& cached_headers,
+                    Http::StreamDecoderFilterCallbacks& decoder_callbacks);
+
+  ~BackgroundRevalidation() override;
+
+  // Http::AsyncClient::Callbacks
+  void onSuccess(const Http::AsyncClient::Request& request,
+                 Http::ResponseMessagePtr&& response) override;
+  void onFailure(const Http::AsyncClient::Request& request,
+                 Http::AsyncClient::FailureReason reason) override;
+  void onBeforeFinalizeUpstreamSpan(Tracing::Span&, const Http::ResponseHeaderMap*) override {}
+
+private:
+  BackgroundRevalidation(CacheFilterSharedStateSharedPtr shared_state,
+                         std::shared_ptr<HttpCache> cache, TimeSource& time_source,
+                         Event::Dispatcher& dispatcher, Key key,
+                         const Http::RequestHeaderMap& request_headers,
+                         const Http::ResponseHeaderMap& cached_headers,
+                         LookupContextPtr update_context);
+
+  void send(Upstream::ThreadLocalCluster& cluster, const Router::RouteEntry& route_entry,
+            const Http::RequestHeaderMap& request_headers,
+            const Http::ResponseHeaderMap& cached_headers);
+
+  // Freshens the cached headers with a 304 response.
+  void updateHeaders();
+
+  // Replace the cached response with a new one, one part at a time.
+  void insertHeaders();
+  void insertBody();
+  void insertTrailers();
+
+  // Wraps an insert callback so that it runs on this revalidation's dispatcher.
+  InsertCallback onDispatcher(std::function<void(bool)> cb);
+
+  // Ends the revalidation and schedules its deletion.
+  void finish(Stats::Counter& result);
+
+  CacheFilterStats& stats() { return shared_state_->stats(); }
+
+  const CacheFilterSharedStateSharedPtr shared_state_;
+  const std::shared_ptr<HttpCache> cache_;
+  TimeSource& time_source_;
+  Event::Dispatcher& dispatcher_;
+  const Key key_;
+  // The status and etag of the cached response, needed to freshen it with a 304 response.
+  const uint64_t cached_status_;
+  const std::string cached_etag_;
+  // Used to freshen the cached headers if the response is still valid.
+  LookupContextPtr update_context_;
+  // Used to replace the cached response if it has changed.
+  InsertContextPtr insert_context_;
+  Http::AsyncClient::Request* request_ = nullptr;
+  Http::ResponseMessagePtr response_;
+  bool finished_ = false;
+  std::unique_ptr<BackgroundRevalidation> self_ownership_;
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -15,6 +15,8 @@ absl::string_view cacheEntryStatusString(CacheEntryStatus s) {
     return "Unusable";
   case CacheEntryStatus::RequiresValidation:
     return "RequiresValidation";
+  case CacheEntryStatus::StaleWhileRevalidate:
+    return "StaleWhileRevalidate";
   case CacheEntryStatus::FoundNotModified:
     return "FoundNotModified";
   case CacheEntryStatus::LookupError:
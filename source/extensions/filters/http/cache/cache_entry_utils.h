@@ -33,6 +33,9 @@ enum class CacheEntryStatus {
   Unusable,
   // This entry is stale, but appropriate for validating
   RequiresValidation,
+  // This entry is stale, but may be served while it is validated in the background, according
+  // to its stale-while-revalidate directive.
+  StaleWhileRevalidate,
   // This entry is fresh, and an appropriate basis for a 304 Not Modified
   // response.
   FoundNotModified,
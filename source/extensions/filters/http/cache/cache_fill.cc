@@ -0,0 +1,163 @@
+#include "source/extensions/filters/http/cache/cache_fill.h"
+
+#include "source/common/http/header_map_impl.h"
+
+#include "absl/strings/numbers.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+CacheFill::CacheFill(std::weak_ptr<CacheFillManager> manager, Key key, uint64_t max_buffer_bytes)
+    : manager_(std::move(manager)), key_(std::move(key)), max_buffer_bytes_(max_buffer_bytes) {}
+
+void CacheFill::onHeaders(const Http::ResponseHeaderMap& headers, bool end_stream) {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (failed_) {
+      return;
+    }
+    ASSERT(headers_ == nullptr);
+    uint64_t content_length;
+    // A response which announces a body too large to buffer fails before any waiter serves it.
+    if (end_stream || !absl::SimpleAtoi(headers.getContentLengthValue(), &content_length) ||
+        content_length <= max_buffer_bytes_) {
+      headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(headers);
+      end_stream_ = end_stream;
+      notifySubscribers();
+      return;
+    }
+    fail();
+  }
+  unregister();
+}
+
+void CacheFill::onBody(const Buffer::Instance& data, bool end_stream) {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (failed_) {
+      return;
+    }
+    ASSERT(headers_ != nullptr && !end_stream_);
+    if (body_.length() + data.length() <= max_buffer_bytes_) {
+      body_.add(data);
+      end_stream_ = end_stream;
+      notifySubscribers();
+      return;
+    }
+    fail();
+  }
+  unregister();
+}
+
+void CacheFill::onTrailers(const Http::ResponseTrailerMap& trailers) {
+  absl::MutexLock lock(&mutex_);
+  if (failed_) {
+    return;
+  }
+  ASSERT(headers_ != nullptr && !end_stream_);
+  trailers_ = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(trailers);
+  end_stream_ = true;
+  notifySubscribers();
+}
+
+void CacheFill::onInsertComplete() { unregister(); }
+
+void CacheFill::abort() {
+  {
+    absl::MutexLock lock(&mutex_);
+    fail();
+  }
+  unregister();
+}
+
+void CacheFill::fail() {
+  if (end_stream_ || failed_) {
+    return;
+  }
+  failed_ = true;
+  headers_.reset();
+  body_.drain(body_.length());
+  notifySubscribers();
+}
+
+void CacheFill::subscribe(Event::Dispatcher& dispatcher, std::function<void()> on_update) {
+  absl::MutexLock lock(&mutex_);
+  dispatcher.post(on_update);
+  subscribers_.push_back(Subscriber{dispatcher, std::move(on_update)});
+}
+
+CacheFillUpdate CacheFill::read(bool headers_read, uint64_t body_offset) {
+  CacheFillUpdate update;
+  absl::MutexLock lock(&mutex_);
+  if (failed_) {
+    update.failed_ = true;
+    return update;
+  }
+  if (headers_ == nullptr) {
+    return update;
+  }
+  if (!headers_read) {
+    update.headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*headers_);
+  }
+  ASSERT(body_offset <= body_.length());
+  // Copy only the unread part of the body, slice by slice.
+  uint64_t skip = body_offset;
+  for (const Buffer::RawSlice& slice : body_.getRawSlices()) {
+    if (skip >= slice.len_) {
+      skip -= slice.len_;
+      continue;
+    }
+    update.body_.add(static_cast<const char*>(slice.mem_) + skip, slice.len_ - skip);
+    skip = 0;
+  }
+  if (end_stream_) {
+    if (trailers_ != nullptr) {
+      update.trailers_ = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*trailers_);
+    }
+    update.end_stream_ = true;
+  }
+  return update;
+}
+
+void CacheFill::notifySubscribers() {
+  for (const Subscriber& subscriber : subscribers_) {
+    subscriber.dispatcher_.post(subscriber.on_update_);
+  }
+}
+
+void CacheFill::unregister() {
+  if (std::shared_ptr<CacheFillManager> manager = manager_.lock()) {
+    // The manager may hold the last reference to this fill.
+    CacheFillSharedPtr self = shared_from_this();
+    manager->remove(*this);
+  }
+}
+
+std::pair<CacheFillSharedPtr, bool> CacheFillManager::acquire(const Key& key) {
+  absl::MutexLock lock(&mutex_);
+  auto it = fills_.find(key);
+  if (it != fills_.end()) {
+    return {it->second, false};
+  }
+  auto fill = std::make_shared<CacheFill>(weak_from_this(), key, max_buffer_bytes_);
+  fills_.emplace(key, fill);
+  return {std::move(fill), true};
+}
+
+void CacheFillManager::remove(const CacheFill& fill) {
+  CacheFillSharedPtr removed;
+  absl::MutexLock lock(&mutex_);
+  auto it = fills_.find(fill.key());
+  if (it != fills_.end() && it->second.get() == &fill) {
+    // Release the fill after the lock, in case this was the last reference to it.
+    removed = std::move(it->second);
+    fills_.erase(it);
+  }
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
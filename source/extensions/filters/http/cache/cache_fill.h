@@ -0,0 +1,138 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/header_map.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/cache/key.pb.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+class CacheFillManager;
+
+// What a reader of a CacheFill hasn't seen yet. @see CacheFill::read.
+struct CacheFillUpdate {
+  // The response headers, if the reader hadn't read them yet and they have arrived.
+  Http::ResponseHeaderMapPtr headers_;
+  // The body bytes that arrived after the reader's body offset.
+  Buffer::OwnedImpl body_;
+  // The response trailers, if they have arrived.
+  Http::ResponseTrailerMapPtr trailers_;
+  // True if this update contains the end of the response.
+  bool end_stream_ = false;
+  // True if the fill will never complete, e.g. because the response turned out not to be
+  // cacheable or too large to buffer, the insert was aborted by the cache, or the leading request
+  // was cancelled.
+  bool failed_ = false;
+};
+
+/**
+ * The response being inserted into the cache by the first of a group of concurrent cache misses
+ * for the same key (the "leader"). Later misses for the key (the "waiters") subscribe to the fill
+ * and stream the response from it rather than sending their own requests upstream.
+ *
+ * The leader's CacheInsertQueue writes to the fill on the leader's worker thread; waiters may be on
+ * any worker thread, so the fill is guarded by a mutex, and waiters are notified by posting to
+ * their own dispatcher.
+ *
+ * Waiters may join until the insert completes, so the fill buffers the whole body. A response
+ * body larger than max_buffer_bytes fails the fill, and waiters which haven't started serving the
+ * response go upstream on their own instead.
+ */
+class CacheFill : public std::enable_shared_from_this<CacheFill> {
+public:
+  CacheFill(std::weak_ptr<CacheFillManager> manager, Key key, uint64_t max_buffer_bytes);
+
+  // Producer side, called by the leader. Writes after the fill failed are ignored.
+  void onHeaders(const Http::ResponseHeaderMap& headers, bool end_stream);
+  void onBody(const Buffer::Instance& data, bool end_stream);
+  void onTrailers(const Http::ResponseTrailerMap& trailers);
+  // Called once the cache has finished inserting the response, so that later lookups for the key
+  // are served by the cache rather than by the fill.
+  void onInsertComplete();
+  // Called when the leader won't complete the fill. Waiters which haven't started serving the
+  // response should go upstream on their own; a complete fill is only unregistered.
+  void abort();
+
+  // Consumer side. on_update is posted to dispatcher whenever the fill changes, and once
+  // immediately so that a subscriber joining late catches up.
+  void subscribe(Event::Dispatcher& dispatcher, std::function<void()> on_update);
+  // Returns everything a reader which has already seen the headers (if headers_read) and
+  // body_offset bytes of body hasn't seen yet.
+  CacheFillUpdate read(bool headers_read, uint64_t body_offset);
+
+  const Key& key() const { return key_; }
+
+private:
+  struct Subscriber {
+    Event::Dispatcher& dispatcher_;
+    std::function<void()> on_update_;
+  };
+
+  void notifySubscribers() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Fails the fill if it is incomplete, and releases what it buffered.
+  void fail() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void unregister();
+
+  const std::weak_ptr<CacheFillManager> manager_;
+  const Key key_;
+  const uint64_t max_buffer_bytes_;
+  absl::Mutex mutex_;
+  Http::ResponseHeaderMapPtr headers_ ABSL_GUARDED_BY(mutex_);
+  Buffer::OwnedImpl body_ ABSL_GUARDED_BY(mutex_);
+  Http::ResponseTrailerMapPtr trailers_ ABSL_GUARDED_BY(mutex_);
+  bool end_stream_ ABSL_GUARDED_BY(mutex_) = false;
+  bool failed_ ABSL_GUARDED_BY(mutex_) = false;
+  std::vector<Subscriber> subscribers_ ABSL_GUARDED_BY(mutex_);
+};
+
+using CacheFillSharedPtr = std::shared_ptr<CacheFill>;
+
+/**
+ * The per-key fill locks of one cache filter config, shared by all of its workers. The first
+ * cache miss for a key creates the key's CacheFill and leads it; misses for the same key while the
+ * fill is registered wait on it instead.
+ */
+class CacheFillManager : public std::enable_shared_from_this<CacheFillManager> {
+public:
+  // @param max_buffer_bytes the largest response body that a fill buffers for its waiters.
+  explicit CacheFillManager(uint64_t max_buffer_bytes) : max_buffer_bytes_(max_buffer_bytes) {}
+
+  // Returns the fill for key, and true if the caller created it and so leads the fill.
+  std::pair<CacheFillSharedPtr, bool> acquire(const Key& key);
+
+  // Removes fill from the manager, if it is still the registered fill for its key.
+  void remove(const CacheFill& fill);
+
+  size_t size() {
+    absl::MutexLock lock(&mutex_);
+    return fills_.size();
+  }
+
+private:
+  const uint64_t max_buffer_bytes_;
+  absl::Mutex mutex_;
+  absl::flat_hash_map<Key, CacheFillSharedPtr, MessageUtil, MessageUtil>
+      fills_ ABSL_GUARDED_BY(mutex_);
+};
+
+using CacheFillManagerSharedPtr = std::shared_ptr<CacheFillManager>;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -5,10 +5,13 @@
 #include "source/common/common/enum_to_int.h"
 #include "source/common/http/headers.h"
 #include "source/common/http/utility.h"
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/cache/background_revalidation.h"
 #include "source/extensions/filters/http/cache/cache_custom_headers.h"
 #include "source/extensions/filters/http/cache/cache_entry_utils.h"
 #include "source/extensions/filters/http/cache/cache_filter_logging_info.h"
 #include "source/extensions/filters/http/cache/cacheability_utils.h"
+#include "source/extensions/filters/http/cache/range_utils.h"
 
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
@@ -23,6 +26,18 @@ namespace {
 inline bool isResponseNotModified(const Http::ResponseHeaderMap& response_headers) {
   return Http::Utility::getResponseStatus(response_headers) == enumToInt(Http::Code::NotModified);
 }
+
+// According to: https://httpwg.org/specs/rfc5861.html#stale-if-error, these are the errors that
+// a stale response may be served in place of.
+inline bool isServerError(const Http::ResponseHeaderMap& response_headers) {
+  const uint64_t status = Http::Utility::getResponseStatus(response_headers);
+  return status == enumToInt(Http::Code::InternalServerError) ||
+         status == enumToInt(Http::Code::BadGateway) ||
+         status == enumToInt(Http::Code::ServiceUnavailable) ||
+         status == enumToInt(Http::Code::GatewayTimeout);
+}
+
+constexpr uint64_t DefaultFillMaxWaitMs = 5000;
 } // namespace
 
 struct CacheResponseCodeDetailValues {
@@ -32,16 +47,27 @@ struct CacheResponseCodeDetailValues {
 using CacheResponseCodeDetails = ConstSingleton<CacheResponseCodeDetailValues>;
 
 CacheFilter::CacheFilter(const envoy::extensions::filters::http::cache::v3::CacheConfig& config,
-                         const std::string&, Stats::Scope&, TimeSource& time_source,
+                         CacheFilterSharedStateSharedPtr shared_state, TimeSource& time_source,
                          std::shared_ptr<HttpCache> http_cache)
-    : time_source_(time_source), cache_(http_cache),
-      vary_allow_list_(config.allowed_vary_headers()) {}
+    : shared_state_(std::move(shared_state)), time_source_(time_source), cache_(http_cache),
+      vary_allow_list_(config.allowed_vary_headers()),
+      serve_stale_while_revalidate_(config.serve_stale_while_revalidate()),
+      fill_max_wait_(PROTOBUF_GET_MS_OR_DEFAULT(config.request_coalescing(), max_wait,
+                                                DefaultFillMaxWaitMs)) {}
 
 void CacheFilter::onDestroy() {
   filter_state_ = FilterState::Destroyed;
   if (lookup_ != nullptr) {
     lookup_->onDestroy();
   }
+  if (fill_timer_ != nullptr) {
+    fill_timer_->disableTimer();
+  }
+  if (fill_ != nullptr && fill_leader_) {
+    // The response never reached the insert queue, so the waiters have to go upstream.
+    fill_->abort();
+  }
+  releaseFill();
   if (insert_queue_ != nullptr) {
     // The filter can complete and be destroyed while there is still data being
     // written to the cache. In this case the filter hands ownership of the
@@ -91,6 +117,10 @@ Http::FilterHeadersStatus CacheFilter::decodeHeaders(Http::RequestHeaderMap& hea
   LookupRequest lookup_request(headers, time_source_.systemTime(), vary_allow_list_);
   request_allows_inserts_ = !lookup_request.requestCacheControl().no_store_;
   is_head_request_ = headers.getMethodValue() == Http::Headers::get().MethodValues.Head;
+  if (shared_state_->fillManager() != nullptr && request_allows_inserts_ && !is_head_request_ &&
+      !RangeUtils::getRangeHeader(headers).has_value()) {
+    fill_key_ = lookup_request.key();
+  }
   lookup_ = cache_->makeLookupContext(std::move(lookup_request), *decoder_callbacks_);
 
   ASSERT(lookup_);
@@ -109,6 +139,14 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
     return Http::FilterHeadersStatus::Continue;
   }
 
+  if (filter_state_ == FilterState::WaitingForFill) {
+    // A local reply was sent while waiting for the response of a coalesced request.
+    fill_timer_->disableTimer();
+    releaseFill();
+    filter_state_ = FilterState::NotServingFromCache;
+    return Http::FilterHeadersStatus::Continue;
+  }
+
   // If lookup_ is null, the request wasn't cacheable, so the response isn't either.
   if (!lookup_) {
     return Http::FilterHeadersStatus::Continue;
@@ -126,6 +164,17 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
     return Http::FilterHeadersStatus::Continue;
   }
 
+  if (filter_state_ == FilterState::ValidatingCachedResponse &&
+      lookup_result_->serve_stale_if_error_ && isServerError(headers)) {
+    serveStaleOnError(headers);
+    // Stop the encoding stream until the cached response is fetched & added to the encoding stream.
+    if (is_head_request_) {
+      return Http::FilterHeadersStatus::Continue;
+    } else {
+      return Http::FilterHeadersStatus::StopIteration;
+    }
+  }
+
   if (filter_state_ == FilterState::ValidatingCachedResponse && isResponseNotModified(headers)) {
     processSuccessfulValidation(headers);
     // Stop the encoding stream until the cached response is fetched & added to the encoding stream.
@@ -154,6 +203,11 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
                                                insert_queue_ = nullptr;
                                                insert_status_ = InsertStatus::InsertAbortedByCache;
                                              });
+      if (fill_leader_ && !VaryHeaderUtils::hasVary(headers)) {
+        // Requests coalesced behind this one stream the response from the insert queue. A varied
+        // response may not be the right one for them, so they go upstream instead.
+        insert_queue_->setFill(std::move(fill_));
+      }
       // Add metadata associated with the cached response. Right now this is only response_time;
       const ResponseMetadata metadata = {time_source_.systemTime()};
       insert_queue_->insertHeaders(headers, metadata, end_stream);
@@ -166,6 +220,12 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
   } else {
     insert_status_ = InsertStatus::NoInsertResponseNotCacheable;
   }
+  if (fill_ != nullptr) {
+    // The response isn't going to be inserted, so there is nothing for coalesced requests to wait
+    // for.
+    fill_->abort();
+    fill_.reset();
+  }
   filter_state_ = FilterState::NotServingFromCache;
   return Http::FilterHeadersStatus::Continue;
 }
@@ -176,6 +236,14 @@ Http::FilterDataStatus CacheFilter::encodeData(Buffer::Instance& data, bool end_
     // cached response was found and is being added to the encoding stream -- ignore it.
     return Http::FilterDataStatus::Continue;
   }
+  if (served_stale_on_error_) {
+    // The upstream's error response body is replaced by the cached body. Once the cached response
+    // has been added to the encoding stream, the (empty) data only carries the end of the stream.
+    data.drain(data.length());
+    return filter_state_ == FilterState::EncodeServingFromCache
+               ? Http::FilterDataStatus::StopIterationAndBuffer
+               : Http::FilterDataStatus::Continue;
+  }
   if (filter_state_ == FilterState::EncodeServingFromCache) {
     // Stop the encoding stream until the cached response is fetched & added to the encoding stream.
     return Http::FilterDataStatus::StopIterationAndBuffer;
@@ -224,10 +292,9 @@ CacheFilter::resolveLookupStatus(absl::optional<CacheEntryStatus> cache_entry_st
       return LookupStatus::CacheMiss;
     case CacheEntryStatus::RequiresValidation: {
       // The CacheFilter sent the response upstream for validation; check the
-      // filter state to see whether and how the upstream responded. The
-      // filter currently won't send the stale entry if it can't reach the
-      // upstream or if the upstream responds with a 5xx, so don't include
-      // special handling for those cases.
+      // filter state to see whether and how the upstream responded. A stale
+      // entry served because the upstream responded with a 5xx is reported by
+      // lookupStatus, as the filter state doesn't distinguish it.
       switch (filter_state) {
       case FilterState::ValidatingCachedResponse:
         return LookupStatus::RequestIncomplete;
@@ -240,6 +307,8 @@ CacheFilter::resolveLookupStatus(absl::optional<CacheEntryStatus> cache_entry_st
         return LookupStatus::StaleHitWithFailedValidation;
       case FilterState::Initial:
         ABSL_FALLTHROUGH_INTENDED;
+      case FilterState::WaitingForFill:
+        ABSL_FALLTHROUGH_INTENDED;
       case FilterState::DecodeServingFromCache:
         ABSL_FALLTHROUGH_INTENDED;
       case FilterState::Destroyed:
@@ -249,6 +318,8 @@ CacheFilter::resolveLookupStatus(absl::optional<CacheEntryStatus> cache_entry_st
       }
       return LookupStatus::Unknown;
     }
+    case CacheEntryStatus::StaleWhileRevalidate:
+      return LookupStatus::StaleHitWhileRevalidating;
     case CacheEntryStatus::FoundNotModified:
       // TODO(capoferro): Report this as a FoundNotModified when we handle
       // those.
@@ -272,6 +343,8 @@ CacheFilter::resolveLookupStatus(absl::optional<CacheEntryStatus> cache_entry_st
   // GCOV_EXCL_START
   case FilterState::ValidatingCachedResponse:
     ABSL_FALLTHROUGH_INTENDED;
+  case FilterState::WaitingForFill:
+    ABSL_FALLTHROUGH_INTENDED;
   case FilterState::DecodeServingFromCache:
     ABSL_FALLTHROUGH_INTENDED;
   case FilterState::EncodeServingFromCache:
@@ -306,10 +379,11 @@ void CacheFilter::getHeaders(Http::RequestHeaderMap& request_headers) {
     dispatcher.post(
         [self, &request_headers, status = result.cache_entry_status_,
          headers = std::move(result.headers_), range_details = std::move(result.range_details_),
-         content_length = result.content_length_, has_trailers = result.has_trailers_]() mutable {
+         content_length = result.content_length_, has_trailers = result.has_trailers_,
+         serve_stale_if_error = result.serve_stale_if_error_]() mutable {
           if (CacheFilterSharedPtr cache_filter = self.lock()) {
             cache_filter->onHeaders(LookupResult{status, std::move(headers), content_length,
-                                                 range_details, has_trailers},
+                                                 range_details, has_trailers, serve_stale_if_error},
                                     request_headers);
           }
         });
@@ -387,6 +461,9 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
     // and the cache entry will be injected in the response body.
     handleCacheHitWithValidation(request_headers);
     return;
+  case CacheEntryStatus::StaleWhileRevalidate:
+    handleStaleWhileRevalidate(request_headers);
+    return;
   case CacheEntryStatus::Ok:
     if (lookup_result_->range_details_.has_value()) {
       handleCacheHitWithRangeRequest();
@@ -395,6 +472,9 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
     handleCacheHit();
     return;
   case CacheEntryStatus::Unusable:
+    if (fill_key_.has_value() && waitForFill()) {
+      return;
+    }
     decoder_callbacks_->continueDecoding();
     return;
   case CacheEntryStatus::LookupError:
@@ -465,6 +545,120 @@ void CacheFilter::onTrailers(Http::ResponseTrailerMapPtr&& trailers) {
   finalizeEncodingCachedResponse();
 }
 
+bool CacheFilter::waitForFill() {
+  auto [fill, leader] = shared_state_->fillManager()->acquire(fill_key_.value());
+  fill_key_.reset();
+  fill_ = std::move(fill);
+  if (leader) {
+    fill_leader_ = true;
+    return false;
+  }
+  ENVOY_STREAM_LOG(debug, "CacheFilter::waitForFill coalescing request", *decoder_callbacks_);
+  filter_state_ = FilterState::WaitingForFill;
+  // The timer is owned by the filter and disabled in onDestroy, so it can capture this.
+  fill_timer_ = decoder_callbacks_->dispatcher().createTimer([this]() {
+    ENVOY_STREAM_LOG(debug, "CacheFilter::waitForFill timed out", *decoder_callbacks_);
+    stopWaitingForFill();
+  });
+  fill_timer_->enableTimer(fill_max_wait_);
+  // The fill may be updated from any worker thread, so it posts the update to this filter's
+  // dispatcher; as with the cache callbacks, a weak_ptr guards against the filter being destroyed
+  // before the posted callback runs.
+  CacheFilterWeakPtr self = weak_from_this();
+  fill_->subscribe(decoder_callbacks_->dispatcher(), [self]() {
+    if (CacheFilterSharedPtr cache_filter = self.lock()) {
+      cache_filter->onFillUpdated();
+    }
+  });
+  decoder_callbacks_->addDownstreamWatermarkCallbacks(*this);
+  fill_watermark_callbacks_added_ = true;
+  return true;
+}
+
+void CacheFilter::stopWaitingForFill() {
+  ASSERT(filter_state_ == FilterState::WaitingForFill);
+  fill_timer_->disableTimer();
+  releaseFill();
+  filter_state_ = FilterState::Initial;
+  decoder_callbacks_->continueDecoding();
+}
+
+void CacheFilter::releaseFill() {
+  fill_.reset();
+  if (fill_watermark_callbacks_added_) {
+    decoder_callbacks_->removeDownstreamWatermarkCallbacks(*this);
+    fill_watermark_callbacks_added_ = false;
+  }
+}
+
+void CacheFilter::onAboveWriteBufferHighWatermark() { fill_high_watermark_count_++; }
+
+void CacheFilter::onBelowWriteBufferLowWatermark() {
+  ASSERT(fill_high_watermark_count_ > 0);
+  if (--fill_high_watermark_count_ == 0 && fill_headers_served_) {
+    // Serve the body that arrived while the downstream was backed up.
+    onFillUpdated();
+  }
+}
+
+void CacheFilter::onFillUpdated() {
+  if (fill_ == nullptr || filter_state_ == FilterState::Destroyed) {
+    // Stale notification: the request stopped waiting, or already served the whole response.
+    return;
+  }
+  if (fill_headers_served_ && fill_high_watermark_count_ > 0) {
+    // The rest of the response is read once the downstream drains below its low watermark.
+    return;
+  }
+  CacheFillUpdate update = fill_->read(fill_headers_served_, fill_body_offset_);
+  if (update.failed_) {
+    if (!fill_headers_served_) {
+      stopWaitingForFill();
+    } else {
+      // Part of the response was already sent downstream and the rest will never arrive.
+      releaseFill();
+      decoder_callbacks_->resetStream();
+    }
+    return;
+  }
+  if (update.headers_ != nullptr) {
+    fill_timer_->disableTimer();
+    fill_headers_served_ = true;
+    filter_state_ = FilterState::DecodeServingFromCache;
+    insert_status_ = InsertStatus::NoInsertCacheHit;
+    // The response is served by the cache filter, so this request counts as a cache hit.
+    lookup_result_->cache_entry_status_ = CacheEntryStatus::Ok;
+    decoder_callbacks_->streamInfo().setResponseFlag(
+        StreamInfo::ResponseFlag::ResponseFromCacheFilter);
+    decoder_callbacks_->streamInfo().setResponseCodeDetails(
+        CacheResponseCodeDetails::get().ResponseFromCacheFilter);
+    const bool end_stream =
+        update.end_stream_ && update.body_.length() == 0 && update.trailers_ == nullptr;
+    decoder_callbacks_->encodeHeaders(std::move(update.headers_), end_stream,
+                                      CacheResponseCodeDetails::get().ResponseFromCacheFilter);
+    if (end_stream) {
+      releaseFill();
+      finalizeEncodingCachedResponse();
+      return;
+    }
+  }
+  if (!fill_headers_served_ || filter_state_ == FilterState::Destroyed) {
+    return;
+  }
+  const bool body_end_stream = update.end_stream_ && update.trailers_ == nullptr;
+  if (update.body_.length() > 0 || body_end_stream) {
+    fill_body_offset_ += update.body_.length();
+    decoder_callbacks_->encodeData(update.body_, body_end_stream);
+  }
+  if (update.trailers_ != nullptr && filter_state_ != FilterState::Destroyed) {
+    decoder_callbacks_->encodeTrailers(std::move(update.trailers_));
+  }
+  if (update.end_stream_) {
+    releaseFill();
+    finalizeEncodingCachedResponse();
+  }
+}
+
 void CacheFilter::handleCacheHit() {
   filter_state_ = FilterState::DecodeServingFromCache;
   insert_status_ = InsertStatus::NoInsertCacheHit;
@@ -527,6 +721,23 @@ void CacheFilter::handleCacheHitWithValidation(Envoy::Http::RequestHeaderMap& re
   decoder_callbacks_->continueDecoding();
 }
 
+void CacheFilter::handleStaleWhileRevalidate(Http::RequestHeaderMap& request_headers) {
+  // Start the revalidation before serving, which consumes the cached headers.
+  if (!serve_stale_while_revalidate_ ||
+      !BackgroundRevalidation::start(shared_state_, cache_, time_source_, request_headers,
+                                     *lookup_result_->headers_, *decoder_callbacks_)) {
+    lookup_result_->cache_entry_status_ = CacheEntryStatus::RequiresValidation;
+    handleCacheHitWithValidation(request_headers);
+    return;
+  }
+  shared_state_->stats().stale_while_revalidate_served_.inc();
+  if (lookup_result_->range_details_.has_value()) {
+    handleCacheHitWithRangeRequest();
+    return;
+  }
+  handleCacheHit();
+}
+
 void CacheFilter::processSuccessfulValidation(Http::ResponseHeaderMap& response_headers) {
   ASSERT(lookup_result_, "CacheFilter trying to validate a non-existent lookup result");
   ASSERT(
@@ -577,6 +788,25 @@ void CacheFilter::processSuccessfulValidation(Http::ResponseHeaderMap& response_
   encodeCachedResponse();
 }
 
+void CacheFilter::serveStaleOnError(Http::ResponseHeaderMap& response_headers) {
+  ASSERT(lookup_result_, "CacheFilter trying to serve a non-existent lookup result");
+  ASSERT(filter_state_ == FilterState::ValidatingCachedResponse,
+         "serveStaleOnError must only be called when a cached response is being validated");
+  ENVOY_STREAM_LOG(debug, "CacheFilter::serveStaleOnError upstream responded with {}",
+                   *encoder_callbacks_, response_headers.getStatusValue());
+  shared_state_->stats().stale_if_error_served_.inc();
+  served_stale_on_error_ = true;
+  filter_state_ = FilterState::EncodeServingFromCache;
+  insert_status_ = InsertStatus::NoInsertCacheHit;
+
+  // Replace the error response headers with the cached ones, which keep their Age header as the
+  // response is served stale.
+  response_headers.clear();
+  Http::HeaderMapImpl::copyFrom(response_headers, *lookup_result_->headers_);
+
+  encodeCachedResponse();
+}
+
 // TODO(yosrym93): Write a test that exercises this when SimpleHttpCache implements updateHeaders
 bool CacheFilter::shouldUpdateCachedEntry(const Http::ResponseHeaderMap& response_headers) const {
   ASSERT(isResponseNotModified(response_headers),
@@ -605,26 +835,7 @@ void CacheFilter::injectValidationHeaders(Http::RequestHeaderMap& request_header
          "injectValidationHeaders precondition unsatisfied: the "
          "CacheFilter is not validating a cache lookup result");
 
-  const Http::HeaderEntry* etag_header =
-      lookup_result_->headers_->getInline(CacheCustomHeaders::etag());
-  const Http::HeaderEntry* last_modified_header =
-      lookup_result_->headers_->getInline(CacheCustomHeaders::lastModified());
-
-  if (etag_header) {
-    absl::string_view etag = etag_header->value().getStringView();
-    request_headers.setInline(CacheCustomHeaders::ifNoneMatch(), etag);
-  }
-  if (DateUtil::timePointValid(CacheHeadersUtils::httpTime(last_modified_header))) {
-    // Valid Last-Modified header exists.
-    absl::string_view last_modified = last_modified_header->value().getStringView();
-    request_headers.setInline(CacheCustomHeaders::ifModifiedSince(), last_modified);
-  } else {
-    // Either Last-Modified is missing or invalid, fallback to Date.
-    // A correct behaviour according to:
-    // https://httpwg.org/specs/rfc7232.html#header.if-modified-since
-    absl::string_view date = lookup_result_->headers_->getDateValue();
-    request_headers.setInline(CacheCustomHeaders::ifModifiedSince(), date);
-  }
+  CacheHeadersUtils::setValidationHeaders(*lookup_result_->headers_, request_headers);
 }
 
 void CacheFilter::encodeCachedResponse() {
@@ -680,6 +891,10 @@ LookupStatus CacheFilter::lookupStatus() const {
     return LookupStatus::RequestIncomplete;
   }
 
+  if (served_stale_on_error_) {
+    return LookupStatus::StaleHitOnError;
+  }
+
   if (lookup_result_ != nullptr) {
     return resolveLookupStatus(lookup_result_->cache_entry_status_, filter_state_);
   } else {
@@ -8,7 +8,9 @@
 #include "envoy/extensions/filters/http/cache/v3/cache.pb.h"
 
 #include "source/common/common/logger.h"
+#include "source/extensions/filters/http/cache/cache_fill.h"
 #include "source/extensions/filters/http/cache/cache_filter_logging_info.h"
+#include "source/extensions/filters/http/cache/cache_filter_shared_state.h"
 #include "source/extensions/filters/http/cache/cache_headers_utils.h"
 #include "source/extensions/filters/http/cache/cache_insert_queue.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
@@ -25,10 +27,15 @@ enum class FilterState {
   // Cache lookup found a cached response that requires validation.
   ValidatingCachedResponse,
 
+  // Cache lookup found no response, and another request for the same key is already filling the
+  // cache; waiting for its response to start arriving.
+  WaitingForFill,
+
   // Cache lookup found a fresh cached response and it is being added to the encoding stream.
   DecodeServingFromCache,
 
-  // A cached response was successfully validated and it is being added to the encoding stream
+  // A cached response was successfully validated, or validating it failed but it may be served
+  // stale, and it is being added to the encoding stream
   EncodeServingFromCache,
 
   // The cached response was successfully added to the encoding stream (either during decoding or
@@ -50,11 +57,12 @@ enum class FilterState {
  * A filter that caches responses and attempts to satisfy requests from cache.
  */
 class CacheFilter : public Http::PassThroughFilter,
+                    public Http::DownstreamWatermarkCallbacks,
                     public Logger::Loggable<Logger::Id::cache_filter>,
                     public std::enable_shared_from_this<CacheFilter> {
 public:
   CacheFilter(const envoy::extensions::filters::http::cache::v3::CacheConfig& config,
-              const std::string& stats_prefix, Stats::Scope& scope, TimeSource& time_source,
+              CacheFilterSharedStateSharedPtr shared_state, TimeSource& time_source,
               std::shared_ptr<HttpCache> http_cache);
   // Http::StreamFilterBase
   void onDestroy() override;
@@ -67,6 +75,9 @@ public:
                                           bool end_stream) override;
   Http::FilterDataStatus encodeData(Buffer::Instance& buffer, bool end_stream) override;
   Http::FilterTrailersStatus encodeTrailers(Http::ResponseTrailerMap& trailers) override;
+  // Http::DownstreamWatermarkCallbacks
+  void onAboveWriteBufferHighWatermark() override;
+  void onBelowWriteBufferLowWatermark() override;
 
   static LookupStatus resolveLookupStatus(absl::optional<CacheEntryStatus> cache_entry_status,
                                           FilterState filter_state);
@@ -82,6 +93,21 @@ private:
   void onBody(Buffer::InstancePtr&& body);
   void onTrailers(Http::ResponseTrailerMapPtr&& trailers);
 
+  // Precondition: the cache lookup found no usable response and the request can be coalesced.
+  // Joins or creates the fill for the request's key. Returns true if another request leads the
+  // fill, in which case this request waits for its response instead of going upstream.
+  bool waitForFill();
+
+  // Called on the filter's thread whenever the fill this request waits on changes; serves
+  // whatever part of the response hasn't been served yet.
+  void onFillUpdated();
+
+  // Stops waiting on the fill and sends the request upstream on its own.
+  void stopWaitingForFill();
+
+  // Stops reading the fill this request waits on.
+  void releaseFill();
+
   // Set required state in the CacheFilter for handling a cache hit.
   void handleCacheHit();
 
@@ -93,11 +119,21 @@ private:
   // validation is required.
   void handleCacheHitWithValidation(Envoy::Http::RequestHeaderMap& request_headers);
 
+  // Serves a stale cache hit as a fresh one, and revalidates it in the background. Validates it
+  // before serving it instead if background revalidation is disabled or unavailable.
+  void handleStaleWhileRevalidate(Http::RequestHeaderMap& request_headers);
+
   // Precondition: lookup_result_ points to a cache lookup result that requires validation.
   //               filter_state_ is ValidatingCachedResponse.
   // Serves a validated cached response after updating it with a 304 response.
   void processSuccessfulValidation(Http::ResponseHeaderMap& response_headers);
 
+  // Precondition: lookup_result_ points to a cache lookup result that requires validation, and
+  //               may be served stale if validating it fails.
+  //               filter_state_ is ValidatingCachedResponse.
+  // Serves the stale cached response in place of the upstream's error response.
+  void serveStaleOnError(Http::ResponseHeaderMap& response_headers);
+
   // Precondition: lookup_result_ points to a cache lookup result that requires validation.
   //               filter_state_ is ValidatingCachedResponse.
   // Checks if a cached entry should be updated with a 304 response.
@@ -131,6 +167,7 @@ private:
   // CacheFilter::onDestroy, allowing the insert queue to outlive the filter
   // while the necessary cache write operations complete.
   std::unique_ptr<CacheInsertQueue> insert_queue_;
+  const CacheFilterSharedStateSharedPtr shared_state_;
   TimeSource& time_source_;
   std::shared_ptr<HttpCache> cache_;
   LookupContextPtr lookup_;
@@ -147,6 +184,24 @@ private:
   // Stores the allow list rules that decide if a header can be varied upon.
   VaryAllowList vary_allow_list_;
 
+  const bool serve_stale_while_revalidate_;
+  const std::chrono::milliseconds fill_max_wait_;
+  // The key to coalesce this request on if the lookup misses; unset if the request can't be
+  // coalesced.
+  absl::optional<Key> fill_key_;
+  // The fill this request leads (if fill_leader_) or waits on.
+  CacheFillSharedPtr fill_;
+  bool fill_leader_ = false;
+  // Fails over to sending the request upstream if the fill's response doesn't start in time.
+  Event::TimerPtr fill_timer_;
+  // How much of the fill's response this request has served.
+  bool fill_headers_served_ = false;
+  uint64_t fill_body_offset_ = 0;
+  // The fill's body is only served while the downstream connection is below its high watermark,
+  // so that it isn't buffered a second time by a slow downstream.
+  bool fill_watermark_callbacks_added_ = false;
+  uint32_t fill_high_watermark_count_ = 0;
+
   // True if the response has trailers.
   // TODO(toddmgreer): cache trailers.
   bool response_has_trailers_ = false;
@@ -158,6 +213,8 @@ private:
   FilterState filter_state_ = FilterState::Initial;
 
   bool is_head_request_ = false;
+  // True if the upstream's error response was replaced with the stale cached response.
+  bool served_stale_on_error_ = false;
   // The status of the insert operation or header update, or decision not to insert or update.
   // If it's too early to determine the final status, this is empty.
   absl::optional<InsertStatus> insert_status_;
@@ -19,6 +19,10 @@ absl::string_view lookupStatusToString(LookupStatus status) {
     return "StaleHitWithSuccessfulValidation";
   case LookupStatus::StaleHitWithFailedValidation:
     return "StaleHitWithFailedValidation";
+  case LookupStatus::StaleHitWhileRevalidating:
+    return "StaleHitWhileRevalidating";
+  case LookupStatus::StaleHitOnError:
+    return "StaleHitOnError";
   case LookupStatus::NotModifiedHit:
     return "NotModifiedHit";
   case LookupStatus::RequestNotCacheable:
@@ -24,8 +24,16 @@ enum class LookupStatus {
   // The CacheFilter found a stale response, and sent a validation request to
   // the upstream; the upstream responded with anything other than a 304 Not
   // Modified. The CacheFilter forwards 5xx responses from the
-  // upstream in this case, instead of sending the stale cache entry.
+  // upstream in this case, instead of sending the stale cache entry, unless
+  // the entry allows stale-if-error.
   StaleHitWithFailedValidation,
+  // The CacheFilter found a stale response that allows stale-while-revalidate,
+  // served it, and sent a validation request to the upstream in the background.
+  StaleHitWhileRevalidating,
+  // The CacheFilter found a stale response that allows stale-if-error, sent a
+  // validation request to the upstream, and served the stale response because
+  // the upstream responded with a 5xx.
+  StaleHitOnError,
   // The CacheFilter found a response in cache and served a 304 Not Modified.
   NotModifiedHit,
   // The request wasn't cacheable, and the CacheFilter didn't try to look it up
@@ -0,0 +1,29 @@
+#include "source/extensions/filters/http/cache/cache_filter_shared_state.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+CacheFilterSharedState::CacheFilterSharedState(
+    const envoy::extensions::filters::http::cache::v3::CacheConfig& config,
+    const std::string& stats_prefix, Stats::Scope& scope, Upstream::ClusterManager& cluster_manager,
+    CacheFillManagerSharedPtr fill_manager)
+    : stats_{ALL_CACHE_FILTER_STATS(POOL_COUNTER_PREFIX(scope, stats_prefix + "cache."))},
+      cluster_manager_(cluster_manager), vary_allow_list_(config.allowed_vary_headers()),
+      fill_manager_(std::move(fill_manager)) {}
+
+bool CacheFilterSharedState::tryStartRevalidation(const Key& key) {
+  absl::MutexLock lock(&mutex_);
+  return revalidating_.insert(key).second;
+}
+
+void CacheFilterSharedState::finishRevalidation(const Key& key) {
+  absl::MutexLock lock(&mutex_);
+  revalidating_.erase(key);
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/filters/http/cache/v3/cache.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/upstream/cluster_manager.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/cache/cache_fill.h"
+#include "source/extensions/filters/http/cache/cache_headers_utils.h"
+#include "source/extensions/filters/http/cache/key.pb.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * All cache filter stats. @see stats_macros.h
+ */
+#define ALL_CACHE_FILTER_STATS(COUNTER)                                                            \
+  COUNTER(stale_while_revalidate_served)                                                           \
+  COUNTER(stale_if_error_served)                                                                   \
+  COUNTER(background_revalidation_started)                                                         \
+  COUNTER(background_revalidation_not_modified)                                                    \
+  COUNTER(background_revalidation_replaced)                                                        \
+  COUNTER(background_revalidation_failed)
+
+/**
+ * Struct definition for all cache filter stats. @see stats_macros.h
+ */
+struct CacheFilterStats {
+  ALL_CACHE_FILTER_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * The state shared by all the filters created from one cache filter config, on every worker.
+ */
+class CacheFilterSharedState {
+public:
+  CacheFilterSharedState(const envoy::extensions::filters::http::cache::v3::CacheConfig& config,
+                         const std::string& stats_prefix, Stats::Scope& scope,
+                         Upstream::ClusterManager& cluster_manager,
+                         CacheFillManagerSharedPtr fill_manager);
+
+  CacheFilterStats& stats() { return stats_; }
+  Upstream::ClusterManager& clusterManager() { return cluster_manager_; }
+
+  // The config's allow list, for lookups that may outlive the filter which starts them.
+  const VaryAllowList& varyAllowList() const { return vary_allow_list_; }
+
+  // Set when request coalescing is enabled.
+  const CacheFillManagerSharedPtr& fillManager() const { return fill_manager_; }
+
+  // Marks the entry for key as being revalidated in the background. Returns false if it already
+  // was, in which case the caller shouldn't revalidate it again.
+  bool tryStartRevalidation(const Key& key);
+  void finishRevalidation(const Key& key);
+
+private:
+  CacheFilterStats stats_;
+  Upstream::ClusterManager& cluster_manager_;
+  const VaryAllowList vary_allow_list_;
+  const CacheFillManagerSharedPtr fill_manager_;
+  absl::Mutex mutex_;
+  absl::flat_hash_set<Key, MessageUtil, MessageUtil> revalidating_ ABSL_GUARDED_BY(mutex_);
+};
+
+using CacheFilterSharedStateSharedPtr = std::shared_ptr<CacheFilterSharedState>;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -7,6 +7,7 @@
 
 #include "envoy/http/header_map.h"
 
+#include "source/common/common/utility.h"
 #include "source/common/http/header_map_impl.h"
 #include "source/common/http/header_utility.h"
 #include "source/extensions/filters/http/cache/cache_custom_headers.h"
@@ -109,6 +110,10 @@ ResponseCacheControl::ResponseCacheControl(absl::string_view cache_control_heade
       max_age_ = parseDuration(argument);
     } else if (!max_age_.has_value() && directive == "max-age") {
       max_age_ = parseDuration(argument);
+    } else if (directive == "stale-while-revalidate") {
+      stale_while_revalidate_ = parseDuration(argument);
+    } else if (directive == "stale-if-error") {
+      stale_if_error_ = parseDuration(argument);
     }
   }
 }
@@ -123,7 +128,9 @@ bool operator==(const RequestCacheControl& lhs, const RequestCacheControl& rhs)
 bool operator==(const ResponseCacheControl& lhs, const ResponseCacheControl& rhs) {
   return (lhs.must_validate_ == rhs.must_validate_) && (lhs.no_store_ == rhs.no_store_) &&
          (lhs.no_transform_ == rhs.no_transform_) && (lhs.no_stale_ == rhs.no_stale_) &&
-         (lhs.is_public_ == rhs.is_public_) && (lhs.max_age_ == rhs.max_age_);
+         (lhs.is_public_ == rhs.is_public_) && (lhs.max_age_ == rhs.max_age_) &&
+         (lhs.stale_while_revalidate_ == rhs.stale_while_revalidate_) &&
+         (lhs.stale_if_error_ == rhs.stale_if_error_);
 }
 
 std::ostream& operator<<(std::ostream& os, const RequestCacheControl& request_cache_control) {
@@ -179,6 +186,15 @@ std::ostream& operator<<(std::ostream& os, const ResponseCacheControl& response_
     fields.push_back(
         absl::StrCat("max-age=", std::to_string(response_cache_control.max_age_->count())));
   }
+  if (response_cache_control.stale_while_revalidate_.has_value()) {
+    fields.push_back(absl::StrCat(
+        "stale-while-revalidate=",
+        std::to_string(response_cache_control.stale_while_revalidate_->count())));
+  }
+  if (response_cache_control.stale_if_error_.has_value()) {
+    fields.push_back(absl::StrCat("stale-if-error=",
+                                  std::to_string(response_cache_control.stale_if_error_->count())));
+  }
 
   return os << "{" << absl::StrJoin(fields, ", ") << "}";
 }
@@ -232,6 +248,29 @@ Seconds CacheHeadersUtils::calculateAge(const Http::ResponseHeaderMap& response_
   return std::chrono::duration_cast<Seconds>(current_age);
 }
 
+void CacheHeadersUtils::setValidationHeaders(const Http::ResponseHeaderMap& cached_headers,
+                                             Http::RequestHeaderMap& request_headers) {
+  const Http::HeaderEntry* etag_header = cached_headers.getInline(CacheCustomHeaders::etag());
+  const Http::HeaderEntry* last_modified_header =
+      cached_headers.getInline(CacheCustomHeaders::lastModified());
+
+  if (etag_header) {
+    absl::string_view etag = etag_header->value().getStringView();
+    request_headers.setInline(CacheCustomHeaders::ifNoneMatch(), etag);
+  }
+  if (DateUtil::timePointValid(httpTime(last_modified_header))) {
+    // Valid Last-Modified header exists.
+    absl::string_view last_modified = last_modified_header->value().getStringView();
+    request_headers.setInline(CacheCustomHeaders::ifModifiedSince(), last_modified);
+  } else {
+    // Either Last-Modified is missing or invalid, fallback to Date.
+    // A correct behaviour according to:
+    // https://httpwg.org/specs/rfc7232.html#header.if-modified-since
+    absl::string_view date = cached_headers.getDateValue();
+    request_headers.setInline(CacheCustomHeaders::ifModifiedSince(), date);
+  }
+}
+
 absl::optional<uint64_t> CacheHeadersUtils::readAndRemoveLeadingDigits(absl::string_view& str) {
   uint64_t val = 0;
   uint32_t bytes_consumed = 0;
@@ -91,6 +91,14 @@ struct ResponseCacheControl {
   // max_age is set if to 's-maxage' if present, if not it is set to 'max-age' if present.
   // Indicates the maximum time after which this response will be considered stale
   OptionalDuration max_age_;
+
+  // For how long after it becomes stale this response may be served while it is revalidated in
+  // the background, according to: https://httpwg.org/specs/rfc5861.html#stale-while-revalidate
+  OptionalDuration stale_while_revalidate_;
+
+  // For how long after it becomes stale this response may be served if revalidating it fails
+  // with an error, according to: https://httpwg.org/specs/rfc5861.html#stale-if-error
+  OptionalDuration stale_if_error_;
 };
 
 bool operator==(const RequestCacheControl& lhs, const RequestCacheControl& rhs);
@@ -107,6 +115,11 @@ SystemTime httpTime(const Http::HeaderEntry* header_entry);
 Seconds calculateAge(const Http::ResponseHeaderMap& response_headers, SystemTime response_time,
                      SystemTime now);
 
+// Adds the conditional headers needed to validate the cached response with cached_headers to
+// request_headers, according to: https://httpwg.org/specs/rfc7234.html#validation.sent
+void setValidationHeaders(const Http::ResponseHeaderMap& cached_headers,
+                          Http::RequestHeaderMap& request_headers);
+
 /**
  * Read a leading positive decimal integer value and advance "*str" past the
  * digits read. If overflow occurs, or no digits exist, return
@@ -77,6 +77,9 @@ CacheInsertQueue::CacheInsertQueue(std::shared_ptr<HttpCache> cache,
 void CacheInsertQueue::insertHeaders(const Http::ResponseHeaderMap& response_headers,
                                      const ResponseMetadata& metadata, bool end_stream) {
   end_stream_queued_ = end_stream;
+  if (fill_ != nullptr) {
+    fill_->onHeaders(response_headers, end_stream);
+  }
   // While zero isn't technically true for the size of headers, headers are
   // typically excluded from the stream buffer limit.
   insert_context_->insertHeaders(
@@ -90,6 +93,9 @@ void CacheInsertQueue::insertBody(const Buffer::Instance& fragment, bool end_str
   if (end_stream) {
     end_stream_queued_ = true;
   }
+  if (fill_ != nullptr) {
+    fill_->onBody(fragment, end_stream);
+  }
   if (fragment_in_flight_) {
     size_t sz = fragment.length();
     queue_size_bytes_ += sz;
@@ -113,6 +119,9 @@ void CacheInsertQueue::insertBody(const Buffer::Instance& fragment, bool end_str
 
 void CacheInsertQueue::insertTrailers(const Http::ResponseTrailerMap& trailers) {
   end_stream_queued_ = true;
+  if (fill_ != nullptr) {
+    fill_->onTrailers(trailers);
+  }
   if (fragment_in_flight_) {
     fragments_.push_back(std::make_unique<CacheInsertFragmentTrailers>(trailers));
   } else {
@@ -163,6 +172,11 @@ void CacheInsertQueue::onFragmentComplete(bool cache_success, bool end_stream, s
     if (end_stream) {
       ASSERT(fragments_.empty(), "ending a stream with the queue not empty is a bug");
       ASSERT(!watermarked_, "being over the high watermark when the queue is empty makes no sense");
+      if (fill_ != nullptr) {
+        // The cache has the whole response now, so new lookups no longer need the fill.
+        fill_->onInsertComplete();
+        fill_.reset();
+      }
       self_ownership_.reset();
       return;
     }
@@ -196,6 +210,10 @@ void CacheInsertQueue::setSelfOwned(std::unique_ptr<CacheInsertQueue> self) {
     // If the queue can't be completed we can abort early but we need to wait for
     // any callback-in-flight to complete before destroying the queue.
     aborting_ = true;
+    if (fill_ != nullptr) {
+      fill_->abort();
+      fill_.reset();
+    }
   }
   self_ownership_ = std::move(self);
 }
@@ -203,6 +221,10 @@ void CacheInsertQueue::setSelfOwned(std::unique_ptr<CacheInsertQueue> self) {
 CacheInsertQueue::~CacheInsertQueue() {
   ASSERT(!watermarked_, "should not have a watermarked status when the queue is destroyed");
   ASSERT(fragments_.empty(), "queue should be empty by the time the destructor is run");
+  if (fill_ != nullptr) {
+    // The insert was abandoned or aborted by the cache before it completed.
+    fill_->abort();
+  }
   insert_context_->onDestroy();
 }
 
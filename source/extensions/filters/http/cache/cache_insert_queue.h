@@ -3,6 +3,7 @@
 #include <deque>
 #include <functional>
 
+#include "source/extensions/filters/http/cache/cache_fill.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
 
 namespace Envoy {
@@ -42,6 +43,9 @@ public:
   void insertBody(const Buffer::Instance& fragment, bool end_stream);
   void insertTrailers(const Http::ResponseTrailerMap& trailers);
   void setSelfOwned(std::unique_ptr<CacheInsertQueue> self);
+  // Makes the queue also write the response to fill, so that requests coalesced behind this
+  // one can stream it while it is being inserted. Must be called before insertHeaders.
+  void setFill(CacheFillSharedPtr fill) { fill_ = std::move(fill); }
   ~CacheInsertQueue();
 
 private:
@@ -78,6 +82,9 @@ private:
   // while a cache action is still in flight, which can cause the cache to be
   // deleted prematurely.
   std::shared_ptr<HttpCache> cache_;
+  // The fill waiting requests read this response from, if any. It is completed once the cache
+  // has the whole response, and aborted if the insert doesn't complete.
+  CacheFillSharedPtr fill_;
 };
 
 } // namespace Cache
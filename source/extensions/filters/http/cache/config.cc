@@ -7,6 +7,10 @@ namespace Extensions {
 namespace HttpFilters {
 namespace Cache {
 
+namespace {
+constexpr uint64_t DefaultFillMaxBufferBytes = 1024 * 1024;
+} // namespace
+
 Http::FilterFactoryCb CacheFilterFactory::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::http::cache::v3::CacheConfig& config,
     const std::string& stats_prefix, Server::Configuration::FactoryContext& context) {
@@ -26,10 +30,20 @@ Http::FilterFactoryCb CacheFilterFactory::createFilterFactoryFromProtoTyped(
     cache = http_cache_factory->getCache(config, context);
   }
 
-  return [config, stats_prefix, &context,
-          cache](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+  // The fill locks are shared by every worker using this filter config.
+  CacheFillManagerSharedPtr fill_manager;
+  if (cache != nullptr && config.has_request_coalescing()) {
+    fill_manager = std::make_shared<CacheFillManager>(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+        config.request_coalescing(), max_buffer_bytes, DefaultFillMaxBufferBytes));
+  }
+  auto shared_state = std::make_shared<CacheFilterSharedState>(
+      config, stats_prefix, context.scope(), context.serverFactoryContext().clusterManager(),
+      std::move(fill_manager));
+
+  return [config, &context, cache,
+          shared_state](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(std::make_shared<CacheFilter>(
-        config, stats_prefix, context.scope(), context.serverFactoryContext().timeSource(), cache));
+        config, shared_state, context.serverFactoryContext().timeSource(), cache));
   };
 }
 
@@ -77,8 +77,9 @@ void LookupRequest::initializeRequestCacheControl(const Http::RequestHeaderMap&
   }
 }
 
-bool LookupRequest::requiresValidation(const Http::ResponseHeaderMap& response_headers,
-                                       SystemTime::duration response_age) const {
+void LookupRequest::resolveCacheEntryStatus(const Http::ResponseHeaderMap& response_headers,
+                                            SystemTime::duration response_age,
+                                            LookupResult& result) const {
   // TODO(yosrym93): Store parsed response cache-control in cache instead of parsing it on every
   // lookup.
   const absl::string_view cache_control =
@@ -91,7 +92,8 @@ bool LookupRequest::requiresValidation(const Http::ResponseHeaderMap& response_h
       request_max_age_exceeded) {
     // Either the request or response explicitly require validation, or a request max-age
     // requirement is not satisfied.
-    return true;
+    result.cache_entry_status_ = CacheEntryStatus::RequiresValidation;
+    return;
   }
 
   // CacheabilityUtils::isCacheableResponse(..) guarantees that any cached response satisfies this.
@@ -113,16 +115,33 @@ bool LookupRequest::requiresValidation(const Http::ResponseHeaderMap& response_h
     // Response is stale, requires validation if
     // the response does not allow being served stale,
     // or the request max-stale directive does not allow it.
-    const bool allowed_by_max_stale =
-        request_cache_control_.max_stale_.has_value() &&
-        request_cache_control_.max_stale_.value() > response_age - freshness_lifetime;
-    return response_cache_control.no_stale_ || !allowed_by_max_stale;
+    const SystemTime::duration staleness = response_age - freshness_lifetime;
+    const bool allowed_by_max_stale = request_cache_control_.max_stale_.has_value() &&
+                                      request_cache_control_.max_stale_.value() > staleness;
+    if (!response_cache_control.no_stale_ && allowed_by_max_stale) {
+      result.cache_entry_status_ = CacheEntryStatus::Ok;
+      return;
+    }
+    result.cache_entry_status_ = CacheEntryStatus::RequiresValidation;
+    if (response_cache_control.no_stale_) {
+      // must-revalidate and proxy-revalidate also forbid the RFC 5861 extensions.
+      return;
+    }
+    // According to: https://httpwg.org/specs/rfc5861.html, a stale response may still be served
+    // while it is revalidated in the background, or if revalidating it fails.
+    if (response_cache_control.stale_while_revalidate_.has_value() &&
+        response_cache_control.stale_while_revalidate_.value() >= staleness) {
+      result.cache_entry_status_ = CacheEntryStatus::StaleWhileRevalidate;
+    }
+    result.serve_stale_if_error_ = response_cache_control.stale_if_error_.has_value() &&
+                                   response_cache_control.stale_if_error_.value() >= staleness;
   } else {
     // Response is fresh, requires validation only if there is an unsatisfied min-fresh requirement.
     const bool min_fresh_unsatisfied =
         request_cache_control_.min_fresh_.has_value() &&
         request_cache_control_.min_fresh_.value() > freshness_lifetime - response_age;
-    return min_fresh_unsatisfied;
+    result.cache_entry_status_ =
+        min_fresh_unsatisfied ? CacheEntryStatus::RequiresValidation : CacheEntryStatus::Ok;
   }
 }
 
@@ -138,9 +157,7 @@ LookupResult LookupRequest::makeLookupResult(Http::ResponseHeaderMapPtr&& respon
       CacheHeadersUtils::calculateAge(*response_headers, metadata.response_time_, timestamp_);
   response_headers->setInline(CacheCustomHeaders::age(), std::to_string(age.count()));
 
-  result.cache_entry_status_ = requiresValidation(*response_headers, age)
-                                   ? CacheEntryStatus::RequiresValidation
-                                   : CacheEntryStatus::Ok;
+  resolveCacheEntryStatus(*response_headers, age, result);
   result.headers_ = std::move(response_headers);
   result.content_length_ = content_length;
   result.range_details_ = RangeUtils::createRangeDetails(requestHeaders(), content_length);
@@ -50,6 +50,10 @@ struct LookupResult {
   // True if the cached response has trailers.
   bool has_trailers_ = false;
 
+  // True if the cached response requires validation, but may still be served if validating it
+  // fails with a server error, according to: https://httpwg.org/specs/rfc5861.html#stale-if-error
+  bool serve_stale_if_error_ = false;
+
   // Update the content length of the object and its response headers.
   void setContentLength(uint64_t new_length) {
     content_length_ = new_length;
@@ -104,8 +108,10 @@ public:
 
 private:
   void initializeRequestCacheControl(const Http::RequestHeaderMap& request_headers);
-  bool requiresValidation(const Http::ResponseHeaderMap& response_headers,
-                          SystemTime::duration age) const;
+  // Sets result's cache_entry_status_ and serve_stale_if_error_ for a cached response of the given
+  // age.
+  void resolveCacheEntryStatus(const Http::ResponseHeaderMap& response_headers,
+                               SystemTime::duration age, LookupResult& result) const;
 
   Key key_;
   std::vector<RawByteRange> request_range_spec_;
@@ -252,6 +258,16 @@ public:
   virtual InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context,
                                              Http::StreamEncoderFilterCallbacks& callbacks) PURE;
 
+  // Returns a LookupContextPtr for a lookup which isn't made on behalf of a downstream request,
+  // such as the background revalidation of a stale response, and so may outlive any request.
+  // Returns nullptr if the cache needs a request's filter callbacks to look up responses, in which
+  // case such lookups aren't made.
+  virtual LookupContextPtr makeDetachedLookupContext(LookupRequest&&) { return nullptr; }
+
+  // Returns an InsertContextPtr to insert the response of a lookup made by
+  // makeDetachedLookupContext, or nullptr if the response can't be inserted.
+  virtual InsertContextPtr makeDetachedInsertContext(LookupContextPtr&&) { return nullptr; }
+
   // Precondition: lookup_context represents a prior cache lookup that required
   // validation.
   //
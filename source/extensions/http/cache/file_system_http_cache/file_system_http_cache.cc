@@ -116,6 +116,10 @@ FileSystemHttpCache::makeVaryKey(const Key& base, const VaryAllowList& vary_allo
 
 LookupContextPtr FileSystemHttpCache::makeLookupContext(LookupRequest&& lookup,
                                                         Http::StreamDecoderFilterCallbacks&) {
+  return makeDetachedLookupContext(std::move(lookup));
+}
+
+LookupContextPtr FileSystemHttpCache::makeDetachedLookupContext(LookupRequest&& lookup) {
   return std::make_unique<FileLookupContext>(*this, std::move(lookup));
 }
 
@@ -340,6 +344,10 @@ std::string FileSystemHttpCache::generateFilename(const Key& key) const {
 
 InsertContextPtr FileSystemHttpCache::makeInsertContext(LookupContextPtr&& lookup_context,
                                                         Http::StreamEncoderFilterCallbacks&) {
+  return makeDetachedInsertContext(std::move(lookup_context));
+}
+
+InsertContextPtr FileSystemHttpCache::makeDetachedInsertContext(LookupContextPtr&& lookup_context) {
   auto file_lookup_context = std::unique_ptr<FileLookupContext>(
       dynamic_cast<FileLookupContext*>(lookup_context.release()));
   ASSERT(file_lookup_context);
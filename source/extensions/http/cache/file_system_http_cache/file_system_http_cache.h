@@ -50,6 +50,8 @@ public:
                                      Http::StreamDecoderFilterCallbacks& callbacks) override;
   InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context,
                                      Http::StreamEncoderFilterCallbacks& callbacks) override;
+  LookupContextPtr makeDetachedLookupContext(LookupRequest&& lookup) override;
+  InsertContextPtr makeDetachedInsertContext(LookupContextPtr&& lookup_context) override;
   CacheInfo cacheInfo() const override;
   const CacheStats& stats() const;
 
@@ -1,6 +1,6 @@
 #include "source/extensions/http/cache/simple_http_cache/simple_http_cache.h"
 
-#include "envoy/extensions/http/cache/simple_http_cache/v3/config.pb.h"
+#include "envoy/extensions/http/cache/simple_http_cache/v3/config.pb.validate.h"
 #include "envoy/registry/registry.h"
 
 #include "source/common/buffer/buffer_impl.h"
@@ -31,6 +31,16 @@ absl::optional<Key> variedRequestKey(const LookupRequest& request,
   return varied_request_key;
 }
 
+// The number of shards used when the config doesn't set shard_count.
+constexpr uint32_t DefaultShardCount = 16;
+
+// The number of bytes accounted to an entry against the cache's byte budget.
+uint64_t entrySize(const Key& key, const Http::ResponseHeaderMap* response_headers,
+                   absl::string_view body, const Http::ResponseTrailerMap* trailers) {
+  return key.ByteSizeLong() + (response_headers ? response_headers->byteSize() : 0) +
+         body.size() + (trailers ? trailers->byteSize() : 0);
+}
+
 class SimpleLookupContext : public LookupContext {
 public:
   SimpleLookupContext(SimpleHttpCache& cache, LookupRequest&& request)
@@ -137,98 +147,189 @@ private:
 };
 } // namespace
 
+SimpleHttpCache::SimpleHttpCache(const SimpleHttpCacheConfig& config, Stats::Scope& stats_scope)
+    : config_(config),
+      stats_({ALL_SIMPLE_HTTP_CACHE_STATS(POOL_COUNTER_PREFIX(stats_scope, "simple_http_cache."),
+                                          POOL_GAUGE_PREFIX(stats_scope, "simple_http_cache."))}),
+      max_shard_size_bytes_([&config]() -> uint64_t {
+        const uint64_t max_size = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_cache_size_bytes, 0);
+        const uint32_t shard_count =
+            PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, shard_count, DefaultShardCount);
+        return max_size == 0 ? 0 : std::max<uint64_t>(max_size / shard_count, 1);
+      }()) {
+  const uint32_t shard_count =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, shard_count, DefaultShardCount);
+  shards_.reserve(shard_count);
+  for (uint32_t i = 0; i < shard_count; i++) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+SimpleHttpCache::~SimpleHttpCache() {
+  // The size gauges are shared with other caches, so only take away what this cache added.
+  for (auto& shard : shards_) {
+    absl::MutexLock lock(&shard->mutex_);
+    stats_.size_bytes_.sub(shard->size_bytes_);
+    stats_.size_count_.sub(shard->map_.size());
+  }
+}
+
 LookupContextPtr SimpleHttpCache::makeLookupContext(LookupRequest&& request,
                                                     Http::StreamDecoderFilterCallbacks&) {
+  return makeDetachedLookupContext(std::move(request));
+}
+
+LookupContextPtr SimpleHttpCache::makeDetachedLookupContext(LookupRequest&& request) {
   return std::make_unique<SimpleLookupContext>(*this, std::move(request));
 }
 
+SimpleHttpCache::Shard& SimpleHttpCache::shardFor(const Key& key) {
+  if (shards_.size() == 1) {
+    return *shards_[0];
+  }
+  return *shards_[MessageUtil::hash(key) % shards_.size()];
+}
+
+void SimpleHttpCache::removeEntry(Shard& shard, EntryMap::iterator iter) {
+  shard.size_bytes_ -= iter->second.size_bytes_;
+  stats_.size_bytes_.sub(iter->second.size_bytes_);
+  stats_.size_count_.dec();
+  shard.lru_.erase(iter->second.lru_position_);
+  shard.map_.erase(iter);
+}
+
+void SimpleHttpCache::evictForSize(Shard& shard, uint64_t extra_bytes) {
+  if (max_shard_size_bytes_ == 0) {
+    return;
+  }
+  while (!shard.lru_.empty() && shard.size_bytes_ + extra_bytes > max_shard_size_bytes_) {
+    auto iter = shard.map_.find(shard.lru_.back());
+    ASSERT(iter != shard.map_.end());
+    removeEntry(shard, iter);
+    stats_.eviction_.inc();
+  }
+}
+
+SimpleHttpCache::Entry SimpleHttpCache::lookupKey(const Key& key) {
+  Shard& shard = shardFor(key);
+  absl::MutexLock lock(&shard.mutex_);
+  auto iter = shard.map_.find(key);
+  if (iter == shard.map_.end()) {
+    return Entry{};
+  }
+  const Entry& entry = iter->second.entry_;
+  ASSERT(entry.response_headers_);
+  shard.lru_.splice(shard.lru_.begin(), shard.lru_, iter->second.lru_position_);
+
+  Http::ResponseTrailerMapPtr trailers_map;
+  if (entry.trailers_) {
+    trailers_map = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*entry.trailers_);
+  }
+  return Entry{Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*entry.response_headers_),
+               entry.metadata_, entry.body_, std::move(trailers_map)};
+}
+
+bool SimpleHttpCache::insertKey(const Key& key, Entry&& entry) {
+  const uint64_t size_bytes =
+      entrySize(key, entry.response_headers_.get(), entry.body_, entry.trailers_.get());
+  if (max_shard_size_bytes_ != 0 && size_bytes > max_shard_size_bytes_) {
+    stats_.insert_rejected_.inc();
+    return false;
+  }
+  Shard& shard = shardFor(key);
+  absl::MutexLock lock(&shard.mutex_);
+  auto iter = shard.map_.find(key);
+  if (iter != shard.map_.end()) {
+    removeEntry(shard, iter);
+  }
+  evictForSize(shard, size_bytes);
+  shard.lru_.push_front(key);
+  shard.map_.emplace(key, StoredEntry{std::move(entry), size_bytes, shard.lru_.begin()});
+  shard.size_bytes_ += size_bytes;
+  stats_.size_bytes_.add(size_bytes);
+  stats_.size_count_.inc();
+  return true;
+}
+
 void SimpleHttpCache::updateHeaders(const LookupContext& lookup_context,
                                     const Http::ResponseHeaderMap& response_headers,
                                     const ResponseMetadata& metadata,
                                     std::function<void(bool)> on_complete) {
   const auto& simple_lookup_context = static_cast<const SimpleLookupContext&>(lookup_context);
-  const Key& key = simple_lookup_context.request().key();
-  absl::WriterMutexLock lock(&mutex_);
-  auto iter = map_.find(key);
-  if (iter == map_.end() || !iter->second.response_headers_) {
-    on_complete(false);
-    return;
-  }
-  if (VaryHeaderUtils::hasVary(*iter->second.response_headers_)) {
-    absl::optional<Key> varied_key =
-        variedRequestKey(simple_lookup_context.request(), *iter->second.response_headers_);
-    if (!varied_key.has_value()) {
+  Key key = simple_lookup_context.request().key();
+  {
+    // The varied entry may live in a different shard, so find its key first and release the lock
+    // before updating it.
+    Shard& shard = shardFor(key);
+    absl::MutexLock lock(&shard.mutex_);
+    auto iter = shard.map_.find(key);
+    if (iter == shard.map_.end() || !iter->second.entry_.response_headers_) {
       on_complete(false);
       return;
     }
-    iter = map_.find(varied_key.value());
-    if (iter == map_.end() || !iter->second.response_headers_) {
-      on_complete(false);
-      return;
+    if (VaryHeaderUtils::hasVary(*iter->second.entry_.response_headers_)) {
+      absl::optional<Key> varied_key = variedRequestKey(simple_lookup_context.request(),
+                                                        *iter->second.entry_.response_headers_);
+      if (!varied_key.has_value()) {
+        on_complete(false);
+        return;
+      }
+      key = std::move(varied_key.value());
     }
   }
-  Entry& entry = iter->second;
+  Shard& shard = shardFor(key);
+  absl::MutexLock lock(&shard.mutex_);
+  auto iter = shard.map_.find(key);
+  if (iter == shard.map_.end() || !iter->second.entry_.response_headers_) {
+    on_complete(false);
+    return;
+  }
+  StoredEntry& stored = iter->second;
+  Entry& entry = stored.entry_;
 
   applyHeaderUpdate(response_headers, *entry.response_headers_);
   entry.metadata_ = metadata;
+
+  // The update may change the size of the headers; keep the accounting exact, but don't evict
+  // other entries for a refreshed one.
+  const uint64_t size_bytes =
+      entrySize(key, entry.response_headers_.get(), entry.body_, entry.trailers_.get());
+  shard.size_bytes_ = shard.size_bytes_ - stored.size_bytes_ + size_bytes;
+  stats_.size_bytes_.sub(stored.size_bytes_);
+  stats_.size_bytes_.add(size_bytes);
+  stored.size_bytes_ = size_bytes;
+  shard.lru_.splice(shard.lru_.begin(), shard.lru_, stored.lru_position_);
   on_complete(true);
 }
 
 SimpleHttpCache::Entry SimpleHttpCache::lookup(const LookupRequest& request) {
-  absl::ReaderMutexLock lock(&mutex_);
-  auto iter = map_.find(request.key());
-  if (iter == map_.end()) {
-    return Entry{};
+  Entry entry = lookupKey(request.key());
+  if (entry.response_headers_ && VaryHeaderUtils::hasVary(*entry.response_headers_)) {
+    entry = varyLookup(request, entry.response_headers_);
   }
-  ASSERT(iter->second.response_headers_);
-
-  if (VaryHeaderUtils::hasVary(*iter->second.response_headers_)) {
-    return varyLookup(request, iter->second.response_headers_);
+  if (entry.response_headers_) {
+    stats_.cache_hit_.inc();
   } else {
-    Http::ResponseTrailerMapPtr trailers_map;
-    if (iter->second.trailers_) {
-      trailers_map = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*iter->second.trailers_);
-    }
-    return SimpleHttpCache::Entry{
-        Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*iter->second.response_headers_),
-        iter->second.metadata_, iter->second.body_, std::move(trailers_map)};
+    stats_.cache_miss_.inc();
   }
+  return entry;
 }
 
 bool SimpleHttpCache::insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
                              ResponseMetadata&& metadata, std::string&& body,
                              Http::ResponseTrailerMapPtr&& trailers) {
-  absl::WriterMutexLock lock(&mutex_);
-  map_[key] = SimpleHttpCache::Entry{std::move(response_headers), std::move(metadata),
-                                     std::move(body), std::move(trailers)};
-  return true;
+  return insertKey(key, Entry{std::move(response_headers), std::move(metadata), std::move(body),
+                              std::move(trailers)});
 }
 
 SimpleHttpCache::Entry
 SimpleHttpCache::varyLookup(const LookupRequest& request,
                             const Http::ResponseHeaderMapPtr& response_headers) {
-  // This method should be called from lookup, which holds the mutex for reading.
-  mutex_.AssertReaderHeld();
-
   absl::optional<Key> varied_key = variedRequestKey(request, *response_headers);
   if (!varied_key.has_value()) {
     return SimpleHttpCache::Entry{};
   }
-  Key& varied_request_key = varied_key.value();
-
-  auto iter = map_.find(varied_request_key);
-  if (iter == map_.end()) {
-    return SimpleHttpCache::Entry{};
-  }
-  ASSERT(iter->second.response_headers_);
-  Http::ResponseTrailerMapPtr trailers_map;
-  if (iter->second.trailers_) {
-    trailers_map = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*iter->second.trailers_);
-  }
-
-  return SimpleHttpCache::Entry{
-      Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*iter->second.response_headers_),
-      iter->second.metadata_, iter->second.body_, std::move(trailers_map)};
+  return lookupKey(varied_key.value());
 }
 
 bool SimpleHttpCache::varyInsert(const Key& request_key,
@@ -237,8 +338,6 @@ bool SimpleHttpCache::varyInsert(const Key& request_key,
                                  const Http::RequestHeaderMap& request_headers,
                                  const VaryAllowList& vary_allow_list,
                                  Http::ResponseTrailerMapPtr&& trailers) {
-  absl::WriterMutexLock lock(&mutex_);
-
   absl::btree_set<absl::string_view> vary_header_values =
       VaryHeaderUtils::getVaryValues(*response_headers);
   ASSERT(!vary_header_values.empty());
@@ -253,29 +352,33 @@ bool SimpleHttpCache::varyInsert(const Key& request_key,
   }
 
   varied_request_key.add_custom_fields(vary_identifier.value());
-  map_[varied_request_key] = SimpleHttpCache::Entry{
-      std::move(response_headers), std::move(metadata), std::move(body), std::move(trailers)};
-
-  // Add a special entry to flag that this request generates varied responses.
-  auto iter = map_.find(request_key);
-  if (iter == map_.end()) {
-    Envoy::Http::ResponseHeaderMapPtr vary_only_map =
-        Envoy::Http::createHeaderMap<Envoy::Http::ResponseHeaderMapImpl>({});
-    vary_only_map->setCopy(Envoy::Http::CustomHeaders::get().Vary,
-                           absl::StrJoin(vary_header_values, ","));
-    // TODO(cbdm): In a cache that evicts entries, we could maintain a list of the "varykey"s that
-    // we have inserted as the body for this first lookup. This way, we would know which keys we
-    // have inserted for that resource. For the first entry simply use vary_identifier as the
-    // entry_list; for future entries append vary_identifier to existing list.
-    std::string entry_list;
-    map_[request_key] =
-        SimpleHttpCache::Entry{std::move(vary_only_map), {}, std::move(entry_list), {}};
+  // vary_header_values points into response_headers, so build the vary-only headers before the
+  // response headers are moved into the cache.
+  Envoy::Http::ResponseHeaderMapPtr vary_only_map =
+      Envoy::Http::createHeaderMap<Envoy::Http::ResponseHeaderMapImpl>({});
+  vary_only_map->setCopy(Envoy::Http::CustomHeaders::get().Vary,
+                         absl::StrJoin(vary_header_values, ","));
+  if (!insertKey(varied_request_key, Entry{std::move(response_headers), std::move(metadata),
+                                           std::move(body), std::move(trailers)})) {
+    return false;
   }
-  return true;
+
+  // Add a special entry to flag that this request generates varied responses. It is refreshed on
+  // every varied insert so that it doesn't get evicted while its variants are in use.
+  // TODO(cbdm): In a cache that evicts entries, we could maintain a list of the "varykey"s that
+  // we have inserted as the body for this first lookup. This way, we would know which keys we
+  // have inserted for that resource. For the first entry simply use vary_identifier as the
+  // entry_list; for future entries append vary_identifier to existing list.
+  std::string entry_list;
+  return insertKey(request_key, Entry{std::move(vary_only_map), {}, std::move(entry_list), {}});
 }
 
 InsertContextPtr SimpleHttpCache::makeInsertContext(LookupContextPtr&& lookup_context,
                                                     Http::StreamEncoderFilterCallbacks&) {
+  return makeDetachedInsertContext(std::move(lookup_context));
+}
+
+InsertContextPtr SimpleHttpCache::makeDetachedInsertContext(LookupContextPtr&& lookup_context) {
   ASSERT(lookup_context != nullptr);
   return std::make_unique<SimpleInsertContext>(*lookup_context, *this);
 }
@@ -288,6 +391,37 @@ CacheInfo SimpleHttpCache::cacheInfo() const {
   return cache_info;
 }
 
+/**
+ * A singleton that acts as a factory for generating and looking up SimpleHttpCaches.
+ * When given equivalent configs, the singleton returns pointers to the same cache.
+ * When given different configs, the singleton returns different cache instances.
+ */
+class SimpleHttpCacheSingleton : public Singleton::Instance {
+public:
+  std::shared_ptr<SimpleHttpCache> get(const SimpleHttpCacheConfig& config,
+                                       Stats::Scope& stats_scope) {
+    std::shared_ptr<SimpleHttpCache> cache;
+    absl::MutexLock lock(&mu_);
+    auto it = caches_.find(config);
+    if (it != caches_.end()) {
+      cache = it->second.lock();
+    }
+    if (!cache) {
+      cache = std::make_shared<SimpleHttpCache>(config, stats_scope);
+      caches_[config] = cache;
+    }
+    return cache;
+  }
+
+private:
+  absl::Mutex mu_;
+  // We keep weak_ptr here so the caches can be destroyed if the config is updated to stop using
+  // that config of cache.
+  absl::flat_hash_map<SimpleHttpCacheConfig, std::weak_ptr<SimpleHttpCache>, MessageUtil,
+                      MessageUtil>
+      caches_ ABSL_GUARDED_BY(mu_);
+};
+
 SINGLETON_MANAGER_REGISTRATION(simple_http_cache_singleton);
 
 class SimpleHttpCacheFactory : public HttpCacheFactory {
@@ -296,20 +430,21 @@ public:
   std::string name() const override { return std::string(Name); }
   // From TypedFactory
   ProtobufTypes::MessagePtr createEmptyConfigProto() override {
-    return std::make_unique<
-        envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig>();
+    return std::make_unique<SimpleHttpCacheConfig>();
   }
   // From HttpCacheFactory
   std::shared_ptr<HttpCache>
-  getCache(const envoy::extensions::filters::http::cache::v3::CacheConfig&,
+  getCache(const envoy::extensions::filters::http::cache::v3::CacheConfig& filter_config,
            Server::Configuration::FactoryContext& context) override {
-    return context.serverFactoryContext().singletonManager().getTyped<SimpleHttpCache>(
-        SINGLETON_MANAGER_REGISTERED_NAME(simple_http_cache_singleton), &createCache);
-  }
-
-private:
-  static std::shared_ptr<Singleton::Instance> createCache() {
-    return std::make_shared<SimpleHttpCache>();
+    SimpleHttpCacheConfig config;
+    MessageUtil::unpackTo(filter_config.typed_config(), config);
+    MessageUtil::validate(config, context.messageValidationVisitor());
+    std::shared_ptr<SimpleHttpCacheSingleton> caches =
+        context.serverFactoryContext().singletonManager().getTyped<SimpleHttpCacheSingleton>(
+            SINGLETON_MANAGER_REGISTERED_NAME(simple_http_cache_singleton),
+            [] { return std::make_shared<SimpleHttpCacheSingleton>(); }, /* pin = */ true);
+    // The cache may outlive the listener that created it, so its stats live in the server scope.
+    return caches->get(config, context.serverFactoryContext().scope());
   }
 };
 
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <list>
+
+#include "envoy/extensions/http/cache/simple_http_cache/v3/config.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
 #include "source/common/protobuf/utility.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
 
@@ -12,8 +18,34 @@ namespace Extensions {
 namespace HttpFilters {
 namespace Cache {
 
-// Example cache backend that never evicts. Not suitable for production use.
-class SimpleHttpCache : public HttpCache, public Singleton::Instance {
+using SimpleHttpCacheConfig =
+    envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig;
+
+/**
+ * All simple http cache stats. @see stats_macros.h
+ *
+ * size_bytes and size_count are shared by every SimpleHttpCache instance in the process, so they
+ * report the total memory held by all of them.
+ */
+#define ALL_SIMPLE_HTTP_CACHE_STATS(COUNTER, GAUGE)                                                \
+  COUNTER(cache_hit)                                                                               \
+  COUNTER(cache_miss)                                                                              \
+  COUNTER(eviction)                                                                                \
+  COUNTER(insert_rejected)                                                                         \
+  GAUGE(size_bytes, NeverImport)                                                                   \
+  GAUGE(size_count, NeverImport)
+
+/**
+ * Struct definition for all simple http cache stats. @see stats_macros.h
+ */
+struct SimpleHttpCacheStats {
+  ALL_SIMPLE_HTTP_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+// In-memory cache backend. Entries are spread over a number of shards, each with its own lock and
+// LRU list, and the least recently used entries of a shard are evicted when the shard grows past
+// its share of max_cache_size_bytes, which, when set, bounds the memory that the cache uses.
+class SimpleHttpCache : public HttpCache {
 private:
   struct Entry {
     Http::ResponseHeaderMapPtr response_headers_;
@@ -22,6 +54,40 @@ private:
     Http::ResponseTrailerMapPtr trailers_;
   };
 
+  // An entry as stored in a shard, along with its accounted size and its position in the shard's
+  // LRU list.
+  struct StoredEntry {
+    Entry entry_;
+    uint64_t size_bytes_;
+    std::list<Key>::iterator lru_position_;
+  };
+
+  using EntryMap = absl::flat_hash_map<Key, StoredEntry, MessageUtil, MessageUtil>;
+
+  struct Shard {
+    absl::Mutex mutex_;
+    EntryMap map_ ABSL_GUARDED_BY(mutex_);
+    // Most recently used keys are at the front.
+    std::list<Key> lru_ ABSL_GUARDED_BY(mutex_);
+    uint64_t size_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  };
+
+  Shard& shardFor(const Key& key);
+
+  // Returns a copy of the entry stored under key, marking it as most recently used, or an empty
+  // Entry if there is none.
+  Entry lookupKey(const Key& key);
+
+  // Stores entry under key, evicting least recently used entries of the shard as needed to stay
+  // within the shard's byte budget. Returns false if the entry can't fit in the shard at all.
+  bool insertKey(const Key& key, Entry&& entry);
+
+  // Removes the least recently used entries of the shard until extra_bytes more would fit.
+  void evictForSize(Shard& shard, uint64_t extra_bytes) ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
+
+  void removeEntry(Shard& shard, EntryMap::iterator iter)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
+
   // Looks for a response that has been varied. Only called from lookup.
   Entry varyLookup(const LookupRequest& request,
                    const Http::ResponseHeaderMapPtr& response_headers);
@@ -33,11 +99,16 @@ private:
   static const absl::flat_hash_set<Http::LowerCaseString> headersNotToUpdate();
 
 public:
+  SimpleHttpCache(const SimpleHttpCacheConfig& config, Stats::Scope& stats_scope);
+  ~SimpleHttpCache() override;
+
   // HttpCache
   LookupContextPtr makeLookupContext(LookupRequest&& request,
                                      Http::StreamDecoderFilterCallbacks& callbacks) override;
   InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context,
                                      Http::StreamEncoderFilterCallbacks& callbacks) override;
+  LookupContextPtr makeDetachedLookupContext(LookupRequest&& request) override;
+  InsertContextPtr makeDetachedInsertContext(LookupContextPtr&& lookup_context) override;
   void updateHeaders(const LookupContext& lookup_context,
                      const Http::ResponseHeaderMap& response_headers,
                      const ResponseMetadata& metadata,
@@ -55,8 +126,15 @@ public:
                   const Http::RequestHeaderMap& request_headers,
                   const VaryAllowList& vary_allow_list, Http::ResponseTrailerMapPtr&& trailers);
 
-  absl::Mutex mutex_;
-  absl::flat_hash_map<Key, Entry, MessageUtil, MessageUtil> map_ ABSL_GUARDED_BY(mutex_);
+  const SimpleHttpCacheConfig& config() const { return config_; }
+  const SimpleHttpCacheStats& stats() const { return stats_; }
+
+private:
+  const SimpleHttpCacheConfig config_;
+  SimpleHttpCacheStats stats_;
+  // The byte budget of each shard, or 0 if the cache is unbounded.
+  const uint64_t max_shard_size_bytes_;
+  std::vector<std::unique_ptr<Shard>> shards_;
 };
 
 } // namespace Cache
@@ -1,5 +1,6 @@
 #include "source/extensions/http/header_validators/envoy_default/header_validator.h"
 
+#include <algorithm>
 #include <charconv>
 
 #include "envoy/http/header_validator_errors.h"
@@ -193,19 +194,14 @@ HeaderValidator::validateGenericHeaderName(const HeaderString& name) {
 
   const bool reject_header_names_with_underscores =
       config_.headers_with_underscores_action() == HeaderValidatorConfig::REJECT_REQUEST;
-  bool is_valid = true;
-  bool reject_due_to_underscore = false;
-  char c = '\0';
-
-  for (auto iter = key_string_view.begin();
-       iter != key_string_view.end() && is_valid && !reject_due_to_underscore; ++iter) {
-    c = *iter;
-    if (c != '_') {
-      is_valid &= testCharInTable(::Envoy::Http::kGenericHeaderNameCharTable, c);
-    } else {
-      reject_due_to_underscore = reject_header_names_with_underscores;
-    }
-  }
+  const size_t invalid_position =
+      ::Envoy::Http::kGenericHeaderNameCharScanner.findFirstNotInTable(key_string_view);
+  // Underscores are valid header name characters, so whichever of an invalid character or a
+  // rejected underscore comes first decides the result.
+  const bool reject_due_to_underscore =
+      reject_header_names_with_underscores &&
+      key_string_view.substr(0, invalid_position).find('_') != absl::string_view::npos;
+  const bool is_valid = reject_due_to_underscore || invalid_position == key_string_view.size();
 
   if (!is_valid) {
     return {HeaderEntryValidationResult::Action::Reject,
@@ -236,14 +232,7 @@ HeaderValidator::validateGenericHeaderValue(const HeaderString& value) {
   //
   // VCHAR          =  %x21-7E
   //                   ; visible (printing) characters
-  const auto& value_string_view = value.getStringView();
-  bool is_valid = true;
-
-  for (auto iter = value_string_view.begin(); iter != value_string_view.end() && is_valid; ++iter) {
-    is_valid &= testCharInTable(kGenericHeaderValueCharTable, *iter);
-  }
-
-  if (!is_valid) {
+  if (!kGenericHeaderValueCharScanner.allInTable(value.getStringView())) {
     return {HeaderValueValidationResult::Action::Reject,
             UhvResponseCodeDetail::get().InvalidValueCharacters};
   }
@@ -390,13 +379,13 @@ HeaderValidator::validateHostHeaderRegName(absl::string_view host) {
 
 HeaderValidator::HeaderValueValidationResult
 HeaderValidator::validatePathHeaderCharacters(const HeaderString& value) {
-  return validatePathHeaderCharacterSet(value, kPathHeaderCharTable,
-                                        ::Envoy::Http::kUriQueryAndFragmentCharTable);
+  return validatePathHeaderCharacterSet(value, kPathHeaderCharScanner,
+                                        ::Envoy::Http::kUriQueryAndFragmentCharScanner);
 }
 
 HeaderValidator::HeaderValueValidationResult HeaderValidator::validatePathHeaderCharacterSet(
-    const HeaderString& value, const std::array<uint32_t, 8>& allowed_path_chracters,
-    const std::array<uint32_t, 8>& allowed_query_fragment_characters) {
+    const HeaderString& value, const ::Envoy::Http::CharTableScanner& allowed_path_characters,
+    const ::Envoy::Http::CharTableScanner& allowed_query_fragment_characters) {
   static const HeaderValueValidationResult bad_path_result{
       HeaderValueValidationResult::Action::Reject, UhvResponseCodeDetail::get().InvalidUrl};
   const auto& path = value.getStringView();
@@ -404,48 +393,32 @@ HeaderValidator::HeaderValueValidationResult HeaderValidator::validatePathHeader
     return bad_path_result;
   }
 
-  auto iter = path.begin();
-  auto end = path.end();
-
-  // Validate the path component of the URI
-  for (; iter != end; ++iter) {
-    if (*iter == '?' || *iter == '#') {
-      // This is the start of the query or fragment portion of the path which uses a different
-      // character table.
-      break;
-    }
-
-    if (!testCharInTable(allowed_path_chracters, *iter)) {
-      return bad_path_result;
-    }
+  // Validate the path component of the URI, up to the start of the query or fragment portion of
+  // the path which uses a different character table.
+  const size_t path_end = std::min(path.find_first_of("?#"), path.size());
+  if (!allowed_path_characters.allInTable(path.substr(0, path_end))) {
+    return bad_path_result;
   }
 
-  if (iter != end && *iter == '?') {
+  size_t fragment_start = path_end;
+  if (path_end != path.size() && path[path_end] == '?') {
     // Validate the query component of the URI
-    ++iter;
-    for (; iter != end; ++iter) {
-      if (*iter == '#') {
-        break;
-      }
-
-      if (!testCharInTable(allowed_query_fragment_characters, *iter)) {
-        return bad_path_result;
-      }
+    fragment_start = std::min(path.find('#', path_end + 1), path.size());
+    if (!allowed_query_fragment_characters.allInTable(
+            path.substr(path_end + 1, fragment_start - path_end - 1))) {
+      return bad_path_result;
     }
   }
 
-  if (iter != end) {
-    ASSERT(*iter == '#');
+  if (fragment_start != path.size()) {
+    ASSERT(path[fragment_start] == '#');
     if (!config_.strip_fragment_from_path()) {
       return {HeaderValueValidationResult::Action::Reject,
               UhvResponseCodeDetail::get().FragmentInUrlPath};
     }
     // Validate the fragment component of the URI
-    ++iter;
-    for (; iter != end; ++iter) {
-      if (!testCharInTable(allowed_query_fragment_characters, *iter)) {
-        return bad_path_result;
-      }
+    if (!allowed_query_fragment_characters.allInTable(path.substr(fragment_start + 1))) {
+      return bad_path_result;
     }
   }
 
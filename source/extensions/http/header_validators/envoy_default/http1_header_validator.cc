@@ -97,9 +97,14 @@ Http1HeaderValidator::validatePathHeaderWithAdditionalCharacters(
       0b00000000000000000000000000000000,
       0b00000000000000000000000000000000,
   };
+  static constexpr ::Envoy::Http::CharTableScanner kPathHeaderCharScannerWithAdditionalCharacters{
+      kPathHeaderCharTableWithAdditionalCharacters};
+  static constexpr ::Envoy::Http::CharTableScanner
+      kQueryAndFragmentCharScannerWithAdditionalCharacters{
+          kQueryAndFragmentCharTableWithAdditionalCharacters};
   return HeaderValidator::validatePathHeaderCharacterSet(
-      path_header_value, kPathHeaderCharTableWithAdditionalCharacters,
-      kQueryAndFragmentCharTableWithAdditionalCharacters);
+      path_header_value, kPathHeaderCharScannerWithAdditionalCharacters,
+      kQueryAndFragmentCharScannerWithAdditionalCharacters);
 }
 
 HeaderValidator::HeaderEntryValidationResult
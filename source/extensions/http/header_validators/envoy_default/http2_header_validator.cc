@@ -152,9 +152,14 @@ Http2HeaderValidator::validatePathHeaderWithAdditionalCharactersHttp2(
       0b11111111111111111111111111111111,
       0b11111111111111111111111111111111,
   };
+  static constexpr ::Envoy::Http::CharTableScanner kPathHeaderCharScannerWithAdditionalCharacters{
+      kPathHeaderCharTableWithAdditionalCharacters};
+  static constexpr ::Envoy::Http::CharTableScanner
+      kQueryAndFragmentCharScannerWithAdditionalCharacters{
+          kQueryAndFragmentCharTableWithAdditionalCharacters};
   return HeaderValidator::validatePathHeaderCharacterSet(
-      path_header_value, kPathHeaderCharTableWithAdditionalCharacters,
-      kQueryAndFragmentCharTableWithAdditionalCharacters);
+      path_header_value, kPathHeaderCharScannerWithAdditionalCharacters,
+      kQueryAndFragmentCharScannerWithAdditionalCharacters);
 }
 
 HeaderValidator::HeaderValueValidationResult
@@ -200,9 +205,14 @@ Http2HeaderValidator::validatePathHeaderWithAdditionalCharactersHttp3(
       0b00000000000000000000000000000000,
       0b00000000000000000000000000000000,
   };
+  static constexpr ::Envoy::Http::CharTableScanner kPathHeaderCharScannerWithAdditionalCharacters{
+      kPathHeaderCharTableWithAdditionalCharacters};
+  static constexpr ::Envoy::Http::CharTableScanner
+      kQueryAndFragmentCharScannerWithAdditionalCharacters{
+          kQueryAndFragmentCharTableWithAdditionalCharacters};
   return HeaderValidator::validatePathHeaderCharacterSet(
-      path_header_value, kPathHeaderCharTableWithAdditionalCharacters,
-      kQueryAndFragmentCharTableWithAdditionalCharacters);
+      path_header_value, kPathHeaderCharScannerWithAdditionalCharacters,
+      kQueryAndFragmentCharScannerWithAdditionalCharacters);
 }
 
 ValidationResult
@@ -38,19 +38,20 @@ public:
   static MaglevTableSharedPtr
   createMaglevTable(const NormalizedHostWeightVector& normalized_host_weights,
                     double max_normalized_weight, uint64_t table_size,
-                    bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats) {
+                    bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats,
+                    MaglevPermutationCache& permutation_cache) {
 
     MaglevTableSharedPtr maglev_table;
     if (shouldUseCompactTable(normalized_host_weights.size(), table_size)) {
-      maglev_table =
-          std::make_shared<CompactMaglevTable>(normalized_host_weights, max_normalized_weight,
-                                               table_size, use_hostname_for_hashing, stats);
+      maglev_table = std::make_shared<CompactMaglevTable>(
+          normalized_host_weights, max_normalized_weight, table_size, use_hostname_for_hashing,
+          stats, &permutation_cache);
       ENVOY_LOG(debug, "creating compact maglev table given table size {} and number of hosts {}",
                 table_size, normalized_host_weights.size());
     } else {
-      maglev_table =
-          std::make_shared<OriginalMaglevTable>(normalized_host_weights, max_normalized_weight,
-                                                table_size, use_hostname_for_hashing, stats);
+      maglev_table = std::make_shared<OriginalMaglevTable>(
+          normalized_host_weights, max_normalized_weight, table_size, use_hostname_for_hashing,
+          stats, &permutation_cache);
       ENVOY_LOG(debug, "creating original maglev table given table size {} and number of hosts {}",
                 table_size, normalized_host_weights.size());
     }
@@ -69,13 +70,39 @@ LegacyMaglevLbConfig::LegacyMaglevLbConfig(const ClusterProto& cluster) {
 
 TypedMaglevLbConfig::TypedMaglevLbConfig(const MaglevLbProto& lb_config) : lb_config_(lb_config) {}
 
+MaglevPermutationCache::Permutation
+MaglevPermutationCache::computePermutation(absl::string_view key, uint64_t table_size) {
+  return {HashUtil::xxHash64(key) % table_size,
+          (HashUtil::xxHash64(key, 1) % (table_size - 1)) + 1};
+}
+
+MaglevPermutationCache::Permutation MaglevPermutationCache::get(absl::string_view key) {
+  auto it = permutations_.find(key);
+  if (it == permutations_.end()) {
+    it = permutations_.emplace(key, Entry{computePermutation(key, table_size_), build_}).first;
+  } else {
+    it->second.build_ = build_;
+  }
+  return it->second.permutation_;
+}
+
+void MaglevPermutationCache::endBuild(uint64_t retained_builds) {
+  ASSERT(retained_builds > 0);
+  absl::erase_if(permutations_, [oldest = build_ - std::min(build_, retained_builds - 1)](
+                                    const auto& entry) { return entry.second.build_ < oldest; });
+  ++build_;
+}
+
 ThreadAwareLoadBalancerBase::HashingLoadBalancerSharedPtr
 MaglevLoadBalancer::createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
                                        double /* min_normalized_weight */,
                                        double max_normalized_weight) {
   HashingLoadBalancerSharedPtr maglev_lb =
       MaglevFactory::createMaglevTable(normalized_host_weights, max_normalized_weight, table_size_,
-                                       use_hostname_for_hashing_, stats_);
+                                       use_hostname_for_hashing_, stats_, permutation_cache_);
+  // A table is built for each priority on every refresh, so keep the permutations used by the
+  // tables of any priority.
+  permutation_cache_.endBuild(std::max<size_t>(priority_set_.hostSetsPerPriority().size(), 1));
 
   if (hash_balance_factor_ == 0) {
     return maglev_lb;
@@ -87,7 +114,7 @@ MaglevLoadBalancer::createLoadBalancer(const NormalizedHostWeightVector& normali
 
 void MaglevTable::constructMaglevTableInternal(
     const NormalizedHostWeightVector& normalized_host_weights, double max_normalized_weight,
-    bool use_hostname_for_hashing) {
+    bool use_hostname_for_hashing, MaglevPermutationCache* permutation_cache) {
   // We can't do anything sensible with no hosts.
   if (normalized_host_weights.empty()) {
     ENVOY_LOG(debug, "maglev: normalized hosts weights is empty, skipping building table");
@@ -117,9 +144,11 @@ void MaglevTable::constructMaglevTableInternal(
     const auto& host = std::get<1>(sorted_host_weight);
     const auto& weight = std::get<2>(sorted_host_weight);
 
-    table_build_entries.emplace_back(host, HashUtil::xxHash64(key_to_hash) % table_size_,
-                                     (HashUtil::xxHash64(key_to_hash, 1) % (table_size_ - 1)) + 1,
-                                     weight);
+    const MaglevPermutationCache::Permutation permutation =
+        permutation_cache != nullptr
+            ? permutation_cache->get(key_to_hash)
+            : MaglevPermutationCache::computePermutation(key_to_hash, table_size_);
+    table_build_entries.emplace_back(host, permutation.offset_, permutation.skip_, weight);
   }
 
   constructImplementationInternals(table_build_entries, max_normalized_weight);
@@ -157,14 +186,12 @@ void OriginalMaglevTable::constructImplementationInternals(
         continue;
       }
       entry.target_weight_ += max_normalized_weight;
-      uint64_t c = permutation(entry);
-      while (table_[c] != nullptr) {
-        entry.next_++;
-        c = permutation(entry);
+      while (table_[entry.permutation_] != nullptr) {
+        nextPermutation(entry);
       }
 
-      table_[c] = entry.host_;
-      entry.next_++;
+      table_[entry.permutation_] = entry.host_;
+      nextPermutation(entry);
       entry.count_++;
       table_index++;
     }
@@ -173,11 +200,12 @@ void OriginalMaglevTable::constructImplementationInternals(
 CompactMaglevTable::CompactMaglevTable(const NormalizedHostWeightVector& normalized_host_weights,
                                        double max_normalized_weight, uint64_t table_size,
                                        bool use_hostname_for_hashing,
-                                       MaglevLoadBalancerStats& stats)
+                                       MaglevLoadBalancerStats& stats,
+                                       MaglevPermutationCache* permutation_cache)
     : MaglevTable(table_size, stats),
       table_(absl::bit_width(normalized_host_weights.size()), table_size) {
   constructMaglevTableInternal(normalized_host_weights, max_normalized_weight,
-                               use_hostname_for_hashing);
+                               use_hostname_for_hashing, permutation_cache);
 }
 
 void CompactMaglevTable::constructImplementationInternals(
@@ -207,19 +235,15 @@ void CompactMaglevTable::constructImplementationInternals(
         continue;
       }
       entry.target_weight_ += max_normalized_weight;
-      // As we're using the compact implementation, our table size is limited to
-      // 32-bit, hence static_cast here should be safe.
-      uint32_t c = static_cast<uint32_t>(permutation(entry));
-      while (occupied[c]) {
-        entry.next_++;
-        c = static_cast<uint32_t>(permutation(entry));
+      while (occupied[entry.permutation_]) {
+        nextPermutation(entry);
       }
 
       // Record the index of the given host.
-      table_.set(c, i);
-      occupied[c] = true;
+      table_.set(entry.permutation_, i);
+      occupied[entry.permutation_] = true;
 
-      entry.next_++;
+      nextPermutation(entry);
       entry.count_++;
       table_index++;
     }
@@ -282,10 +306,6 @@ HostConstSharedPtr CompactMaglevTable::chooseHost(uint64_t hash, uint32_t attemp
   return host_table_[index];
 }
 
-uint64_t MaglevTable::permutation(const TableBuildEntry& entry) {
-  return (entry.offset_ + (entry.skip_ * entry.next_)) % table_size_;
-}
-
 MaglevLoadBalancer::MaglevLoadBalancer(
     const PrioritySet& priority_set, ClusterLbStats& stats, Stats::Scope& scope,
     Runtime::Loader& runtime, Random::RandomGenerator& random,
@@ -304,7 +324,8 @@ MaglevLoadBalancer::MaglevLoadBalancer(
               ? common_config.consistent_hashing_lb_config().use_hostname_for_hashing()
               : false),
       hash_balance_factor_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
-          common_config.consistent_hashing_lb_config(), hash_balance_factor, 0)) {
+          common_config.consistent_hashing_lb_config(), hash_balance_factor, 0)),
+      permutation_cache_(table_size_) {
   ENVOY_LOG(debug, "maglev table size: {}", table_size_);
   // The table size must be prime number.
   if (!Primes::isPrime(table_size_)) {
@@ -326,7 +347,8 @@ MaglevLoadBalancer::MaglevLoadBalancer(
               ? config.consistent_hashing_lb_config().use_hostname_for_hashing()
               : false),
       hash_balance_factor_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.consistent_hashing_lb_config(),
-                                                           hash_balance_factor, 0)) {
+                                                           hash_balance_factor, 0)),
+      permutation_cache_(table_size_) {
   ENVOY_LOG(debug, "maglev table size: {}", table_size_);
   // The table size must be prime number.
   if (!Primes::isPrime(table_size_)) {
@@ -12,6 +12,8 @@
 #include "source/common/common/bit_array.h"
 #include "source/common/upstream/thread_aware_lb_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -64,6 +66,48 @@ struct MaglevLoadBalancerStats {
 class MaglevTable;
 using MaglevTableSharedPtr = std::shared_ptr<MaglevTable>;
 
+/**
+ * Keeps the offset and skip of each host's permutation of a Maglev table across table builds. Both
+ * only depend on the host's hash key and the table size, so each build only has to hash the keys
+ * of the hosts added since the previous ones. Not thread safe: tables are built on the main thread.
+ */
+class MaglevPermutationCache {
+public:
+  explicit MaglevPermutationCache(uint64_t table_size) : table_size_(table_size) {}
+
+  struct Permutation {
+    uint64_t offset_;
+    uint64_t skip_;
+  };
+
+  static Permutation computePermutation(absl::string_view key, uint64_t table_size);
+
+  /**
+   * @return the permutation of the host with the given hash key, computing it if the key isn't
+   *         cached.
+   */
+  Permutation get(absl::string_view key);
+
+  /**
+   * Ends a table build, evicting the permutations that none of the last retained_builds builds,
+   * including this one, used.
+   */
+  void endBuild(uint64_t retained_builds);
+
+  size_t size() const { return permutations_.size(); }
+
+private:
+  struct Entry {
+    Permutation permutation_;
+    // The build that last used the entry.
+    uint64_t build_;
+  };
+
+  const uint64_t table_size_;
+  uint64_t build_{};
+  absl::flat_hash_map<std::string, Entry> permutations_;
+};
+
 /**
  * This is an implementation of Maglev consistent hashing as described in:
  * https://static.googleusercontent.com/media/research.google.com/en//pubs/archive/44824.pdf
@@ -83,24 +127,33 @@ public:
 protected:
   struct TableBuildEntry {
     TableBuildEntry(const HostConstSharedPtr& host, uint64_t offset, uint64_t skip, double weight)
-        : host_(host), offset_(offset), skip_(skip), weight_(weight) {}
+        : host_(host), skip_(skip), weight_(weight), permutation_(offset) {}
 
     HostConstSharedPtr host_;
-    const uint64_t offset_;
     const uint64_t skip_;
     const double weight_;
     double target_weight_{};
-    uint64_t next_{};
+    // The next table index in the host's permutation, (offset + skip * next) % table_size.
+    uint64_t permutation_;
     uint64_t count_{};
   };
 
-  uint64_t permutation(const TableBuildEntry& entry);
+  // Moves on to the next table index in the entry's permutation. Since both the index and the skip
+  // are smaller than the table size, this needs no division.
+  void nextPermutation(TableBuildEntry& entry) const {
+    entry.permutation_ += entry.skip_;
+    if (entry.permutation_ >= table_size_) {
+      entry.permutation_ -= table_size_;
+    }
+  }
 
   /**
-   * Template method for constructing the Maglev table.
+   * Template method for constructing the Maglev table. Host permutations are taken from
+   * permutation_cache if it is set.
    */
   void constructMaglevTableInternal(const NormalizedHostWeightVector& normalized_host_weights,
-                                    double max_normalized_weight, bool use_hostname_for_hashing);
+                                    double max_normalized_weight, bool use_hostname_for_hashing,
+                                    MaglevPermutationCache* permutation_cache);
 
   const uint64_t table_size_;
   MaglevLoadBalancerStats& stats_;
@@ -127,10 +180,11 @@ class OriginalMaglevTable : public MaglevTable {
 public:
   OriginalMaglevTable(const NormalizedHostWeightVector& normalized_host_weights,
                       double max_normalized_weight, uint64_t table_size,
-                      bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats)
+                      bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats,
+                      MaglevPermutationCache* permutation_cache = nullptr)
       : MaglevTable(table_size, stats) {
     constructMaglevTableInternal(normalized_host_weights, max_normalized_weight,
-                                 use_hostname_for_hashing);
+                                 use_hostname_for_hashing, permutation_cache);
   }
   ~OriginalMaglevTable() override = default;
 
@@ -155,7 +209,8 @@ class CompactMaglevTable : public MaglevTable {
 public:
   CompactMaglevTable(const NormalizedHostWeightVector& normalized_host_weights,
                      double max_normalized_weight, uint64_t table_size,
-                     bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats);
+                     bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats,
+                     MaglevPermutationCache* permutation_cache = nullptr);
   ~CompactMaglevTable() override = default;
 
   // ThreadAwareLoadBalancerBase::HashingLoadBalancer
@@ -190,6 +245,7 @@ public:
 
   const MaglevLoadBalancerStats& stats() const { return stats_; }
   uint64_t tableSize() const { return table_size_; }
+  const MaglevPermutationCache& permutationCache() const { return permutation_cache_; }
 
 private:
   // ThreadAwareLoadBalancerBase
@@ -203,6 +259,7 @@ private:
   const uint64_t table_size_;
   const bool use_hostname_for_hashing_;
   const uint32_t hash_balance_factor_;
+  MaglevPermutationCache permutation_cache_;
 };
 
 } // namespace Upstream
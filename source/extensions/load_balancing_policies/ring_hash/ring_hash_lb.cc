@@ -1,5 +1,6 @@
 #include "source/extensions/load_balancing_policies/ring_hash/ring_hash_lb.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <string>
@@ -11,6 +12,7 @@
 #include "source/common/upstream/load_balancer_impl.h"
 
 #include "absl/container/inlined_vector.h"
+#include "absl/numeric/bits.h"
 #include "absl/strings/string_view.h"
 
 namespace Envoy {
@@ -91,52 +93,36 @@ RingHashLoadBalancerStats RingHashLoadBalancer::generateStats(Stats::Scope& scop
 }
 
 HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h, uint32_t attempt) const {
-  if (ring_.empty()) {
+  if (hashes_.empty()) {
     return nullptr;
   }
 
-  // Ported from https://github.com/RJ/ketama/blob/master/libketama/ketama.c (ketama_get_server)
-  // I've generally kept the variable names to make the code easier to compare.
-  // NOTE: The algorithm depends on using signed integers for lowp, midp, and highp. Do not
-  //       change them!
-  int64_t lowp = 0;
-  int64_t highp = ring_.size();
-  int64_t midp = 0;
-  while (true) {
-    midp = (lowp + highp) / 2;
-
-    if (midp == static_cast<int64_t>(ring_.size())) {
-      midp = 0;
-      break;
-    }
-
-    uint64_t midval = ring_[midp].hash_;
-    uint64_t midval1 = midp == 0 ? 0 : ring_[midp - 1].hash_;
-
-    if (h <= midval && h > midval1) {
-      break;
-    }
-
-    if (midval < h) {
-      lowp = midp + 1;
-    } else {
-      highp = midp - 1;
-    }
-
-    if (lowp > highp) {
-      midp = 0;
-      break;
-    }
-  }
+  uint64_t index = findEntry(h);
 
   // If a retry host predicate is being applied, behave as if this host was not in the ring.
-  // Note that this does not guarantee a different host: e.g., attempt == ring_.size() or
+  // Note that this does not guarantee a different host: e.g., attempt == hashes_.size() or
   // when the offset causes us to select the same host at another location in the ring.
   if (attempt > 0) {
-    midp = (midp + attempt) % ring_.size();
+    index = (index + attempt) % hashes_.size();
   }
 
-  return ring_[midp].host_;
+  return hosts_[host_indexes_[index]];
+}
+
+uint64_t RingHashLoadBalancer::Ring::findEntry(uint64_t h) const {
+  // As in ketama (https://github.com/RJ/ketama/blob/master/libketama/ketama.c, ketama_get_server),
+  // a hash belongs to the first entry with an equal or larger hash.
+  auto begin = hashes_.begin();
+  auto end = hashes_.end();
+  if (!bucket_starts_.empty()) {
+    const uint64_t bucket = h >> bucket_shift_;
+    end = hashes_.begin() + bucket_starts_[bucket + 1];
+    begin = hashes_.begin() + bucket_starts_[bucket];
+  }
+  // If h is larger than all the hashes in its bucket, its entry is the first one of a later bucket,
+  // which is where the search ends.
+  const uint64_t index = std::lower_bound(begin, end, h) - hashes_.begin();
+  return index == hashes_.size() ? 0 : index;
 }
 
 using HashFunction = envoy::config::cluster::v3::Cluster::RingHashLbConfig::HashFunction;
@@ -163,7 +149,9 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
 
   // Reserve memory for the entire ring up front.
   const uint64_t ring_size = std::ceil(scale);
-  ring_.reserve(ring_size);
+  std::vector<std::pair<uint64_t, uint32_t>> ring;
+  ring.reserve(ring_size);
+  hosts_.reserve(normalized_host_weights.size());
 
   // Populate the hash ring by walking through the (host, weight) pairs in
   // normalized_host_weights, and generating (scale * weight) hashes for each host. Since these
@@ -190,6 +178,8 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
   uint64_t max_hashes_per_host = 0;
   for (const auto& entry : normalized_host_weights) {
     const auto& host = entry.first;
+    const uint32_t host_index = hosts_.size();
+    hosts_.push_back(host);
     const absl::string_view key_to_hash = hashKey(host, use_hostname_for_hashing);
     ASSERT(!key_to_hash.empty());
 
@@ -214,7 +204,7 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
               : HashUtil::xxHash64(hash_key);
 
       ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key, hash);
-      ring_.push_back({hash, host});
+      ring.emplace_back(hash, host_index);
       ++i;
       ++current_hashes;
       hash_key_buffer.erase(offset_start, hash_key_buffer.end());
@@ -223,13 +213,33 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
     max_hashes_per_host = std::max(i, max_hashes_per_host);
   }
 
-  std::sort(ring_.begin(), ring_.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
-    return lhs.hash_ < rhs.hash_;
-  });
+  std::sort(ring.begin(), ring.end());
   if (ENVOY_LOG_CHECK_LEVEL(trace)) {
-    for (const auto& entry : ring_) {
-      const absl::string_view key_to_hash = hashKey(entry.host_, use_hostname_for_hashing);
-      ENVOY_LOG(trace, "ring hash: host={} hash={}", key_to_hash, entry.hash_);
+    for (const auto& entry : ring) {
+      const absl::string_view key_to_hash = hashKey(hosts_[entry.second], use_hostname_for_hashing);
+      ENVOY_LOG(trace, "ring hash: host={} hash={}", key_to_hash, entry.first);
+    }
+  }
+
+  hashes_.reserve(ring.size());
+  host_indexes_.reserve(ring.size());
+  for (const auto& entry : ring) {
+    hashes_.push_back(entry.first);
+    host_indexes_.push_back(entry.second);
+  }
+
+  if (hashes_.size() >= MinSizeForBucketIndex) {
+    // Use a power of two number of buckets, so that the bucket of a hash is its top bits.
+    const uint32_t bucket_bits = absl::bit_width(hashes_.size() / EntriesPerBucket);
+    const uint64_t num_buckets = uint64_t(1) << bucket_bits;
+    bucket_shift_ = 64 - bucket_bits;
+    bucket_starts_.resize(num_buckets + 1);
+    uint64_t index = 0;
+    for (uint64_t bucket = 0; bucket <= num_buckets; ++bucket) {
+      while (index < hashes_.size() && (hashes_[index] >> bucket_shift_) < bucket) {
+        ++index;
+      }
+      bucket_starts_[bucket] = index;
     }
   }
 
@@ -89,11 +89,6 @@ public:
 private:
   using HashFunction = envoy::config::cluster::v3::Cluster::RingHashLbConfig::HashFunction;
 
-  struct RingEntry {
-    uint64_t hash_;
-    HostConstSharedPtr host_;
-  };
-
   struct Ring : public HashingLoadBalancer {
     Ring(const NormalizedHostWeightVector& normalized_host_weights, double min_normalized_weight,
          uint64_t min_ring_size, uint64_t max_ring_size, HashFunction hash_function,
@@ -102,7 +97,25 @@ private:
     // ThreadAwareLoadBalancerBase::HashingLoadBalancer
     HostConstSharedPtr chooseHost(uint64_t hash, uint32_t attempt) const override;
 
-    std::vector<RingEntry> ring_;
+    // Returns the index of the ring entry for hash h: the first one with a hash of at least h,
+    // wrapping around to the first entry.
+    uint64_t findEntry(uint64_t h) const;
+
+    // The hashes of the ring entries, sorted. They are kept apart from the hosts so that a search
+    // touches as few cache lines as possible.
+    std::vector<uint64_t> hashes_;
+    // For each ring entry, the index of its host in hosts_.
+    std::vector<uint32_t> host_indexes_;
+    std::vector<HostConstSharedPtr> hosts_;
+
+    // Rings of at least MinSizeForBucketIndex entries are split into buckets of hashes with the
+    // same top bits. The hashes in bucket b are those in [bucket_starts_[b], bucket_starts_[b + 1]),
+    // so a search only has to look at the few hashes of one bucket.
+    static constexpr uint64_t MinSizeForBucketIndex = 1024;
+    // The target number of ring entries per bucket.
+    static constexpr uint64_t EntriesPerBucket = 8;
+    std::vector<uint32_t> bucket_starts_;
+    uint32_t bucket_shift_{};
 
     RingHashLoadBalancerStats& stats_;
   };
@@ -0,0 +1,74 @@
+#include "source/extensions/resource_monitors/event_loop_lag/event_loop_lag_monitor.h"
+
+#include <algorithm>
+
+#include "envoy/extensions/resource_monitors/event_loop_lag/v3/event_loop_lag.pb.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/lock_guard.h"
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopLagMonitor {
+
+void ThreadProbes::add(const Event::EventLoopLagProbe& probe) {
+  Thread::LockGuard lock(mutex_);
+  probes_.insert(&probe);
+}
+
+void ThreadProbes::remove(const Event::EventLoopLagProbe& probe) {
+  Thread::LockGuard lock(mutex_);
+  probes_.erase(&probe);
+}
+
+std::chrono::nanoseconds ThreadProbes::maxLag(MonotonicTime now) {
+  std::chrono::nanoseconds max_lag{0};
+  Thread::LockGuard lock(mutex_);
+  for (const Event::EventLoopLagProbe* probe : probes_) {
+    max_lag = std::max(max_lag, probe->lag(now));
+  }
+  return max_lag;
+}
+
+ThreadProbe::ThreadProbe(Event::Dispatcher& dispatcher, std::chrono::milliseconds interval,
+                         ThreadProbesSharedPtr probes)
+    : probes_(std::move(probes)), probe_(Event::EventLoopLagProbe::acquire(dispatcher, interval)) {
+  probes_->add(*probe_);
+}
+
+ThreadProbe::~ThreadProbe() { probes_->remove(*probe_); }
+
+EventLoopLagMonitor::EventLoopLagMonitor(
+    const envoy::extensions::resource_monitors::event_loop_lag::v3::EventLoopLagConfig& config,
+    ThreadLocal::SlotAllocator& slot_allocator, TimeSource& time_source)
+    : max_lag_(PROTOBUF_GET_MS_REQUIRED(config, max_event_loop_lag)),
+      probe_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, probe_interval, 100)),
+      time_source_(time_source), probes_(std::make_shared<ThreadProbes>()), slot_(slot_allocator) {
+  ASSERT(max_lag_.count() > 0);
+}
+
+void EventLoopLagMonitor::updateResourceUsage(Server::ResourceUpdateCallbacks& callbacks) {
+  if (!probing_) {
+    probing_ = true;
+    slot_.set([interval = probe_interval_, probes = probes_](Event::Dispatcher& dispatcher) {
+      return std::make_shared<ThreadProbe>(dispatcher, interval, probes);
+    });
+  }
+
+  const std::chrono::nanoseconds lag = probes_->maxLag(time_source_.monotonicTime());
+
+  Server::ResourceUsage usage;
+  usage.resource_pressure_ = std::chrono::duration<double>(lag) / max_lag_;
+
+  ENVOY_LOG_MISC(trace, "EventLoopLagMonitor: lag={}ns, max_lag={}ms, pressure={}", lag.count(),
+                 max_lag_.count(), usage.resource_pressure_);
+
+  callbacks.onSuccess(usage);
+}
+
+} // namespace EventLoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
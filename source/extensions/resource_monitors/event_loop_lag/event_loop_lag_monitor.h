@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/extensions/resource_monitors/event_loop_lag/v3/event_loop_lag.pb.h"
+#include "envoy/server/resource_monitor.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/common/common/thread.h"
+#include "source/common/event/event_loop_lag_probe.h"
+
+#include "absl/container/flat_hash_set.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopLagMonitor {
+
+/**
+ * The event loop lag probes of the threads, which the monitor reads.
+ */
+class ThreadProbes {
+public:
+  void add(const Event::EventLoopLagProbe& probe);
+  void remove(const Event::EventLoopLagProbe& probe);
+
+  /**
+   * @return the lag of the most lagging thread.
+   */
+  std::chrono::nanoseconds maxLag(MonotonicTime now);
+
+private:
+  Thread::MutexBasicLockable mutex_;
+  absl::flat_hash_set<const Event::EventLoopLagProbe*> probes_ ABSL_GUARDED_BY(mutex_);
+};
+
+using ThreadProbesSharedPtr = std::shared_ptr<ThreadProbes>;
+
+/**
+ * Holds the event loop lag probe of a thread while the monitor reads it.
+ */
+class ThreadProbe : public ThreadLocal::ThreadLocalObject {
+public:
+  ThreadProbe(Event::Dispatcher& dispatcher, std::chrono::milliseconds interval,
+              ThreadProbesSharedPtr probes);
+  ~ThreadProbe() override;
+
+private:
+  const ThreadProbesSharedPtr probes_;
+  const Event::EventLoopLagProbeSharedPtr probe_;
+};
+
+/**
+ * Event loop lag monitor with a statically configured maximum lag.
+ */
+class EventLoopLagMonitor : public Server::ResourceMonitor {
+public:
+  EventLoopLagMonitor(
+      const envoy::extensions::resource_monitors::event_loop_lag::v3::EventLoopLagConfig& config,
+      ThreadLocal::SlotAllocator& slot_allocator, TimeSource& time_source);
+
+  void updateResourceUsage(Server::ResourceUpdateCallbacks& callbacks) override;
+
+private:
+  const std::chrono::milliseconds max_lag_;
+  const std::chrono::milliseconds probe_interval_;
+  TimeSource& time_source_;
+  const ThreadProbesSharedPtr probes_;
+  ThreadLocal::TypedSlot<ThreadProbe> slot_;
+  // The probes are started with the first update, by when the workers have been registered with
+  // the thread local storage.
+  bool probing_{};
+};
+
+} // namespace EventLoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -29,6 +29,7 @@
 #include "source/common/stats/utility.h"
 #include "source/extensions/transport_sockets/tls/cert_validator/cert_validator.h"
 #include "source/extensions/transport_sockets/tls/cert_validator/factory.h"
+#include "source/extensions/transport_sockets/tls/cert_validator/trusted_ca_cache.h"
 #include "source/extensions/transport_sockets/tls/cert_validator/utility.h"
 #include "source/extensions/transport_sockets/tls/stats.h"
 #include "source/extensions/transport_sockets/tls/utility.h"
@@ -72,16 +73,17 @@ int DefaultCertValidator::initializeSslContexts(std::vector<SSL_CTX*> contexts,
 
   if (config_ != nullptr && !config_->caCert().empty() && !provides_certificates) {
     ca_file_path_ = config_->caCertPath();
-    bssl::UniquePtr<BIO> bio(
-        BIO_new_mem_buf(const_cast<char*>(config_->caCert().data()), config_->caCert().size()));
-    RELEASE_ASSERT(bio != nullptr, "");
-    // Based on BoringSSL's X509_load_cert_crl_file().
-    bssl::UniquePtr<STACK_OF(X509_INFO)> list(
-        PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
-    if (list == nullptr) {
+    bool shared;
+    trusted_ca_ = TrustedCaCache::get().getOrParse(config_->caCert(), shared);
+    if (trusted_ca_ == nullptr) {
       throwEnvoyExceptionOrPanic(
           absl::StrCat("Failed to load trusted CA certificates from ", config_->caCertPath()));
     }
+    if (shared) {
+      stats_.trusted_ca_cache_hit_.inc();
+    } else {
+      stats_.trusted_ca_cache_miss_.inc();
+    }
 
     for (auto& ctx : contexts) {
       X509_STORE* store = SSL_CTX_get_cert_store(ctx);
@@ -89,7 +91,7 @@ int DefaultCertValidator::initializeSslContexts(std::vector<SSL_CTX*> contexts,
         X509_STORE_set_flags(store, X509_V_FLAG_PARTIAL_CHAIN);
       }
       bool has_crl = false;
-      for (const X509_INFO* item : list.get()) {
+      for (const X509_INFO* item : const_cast<STACK_OF(X509_INFO)*>(trusted_ca_.get())) {
         if (item->x509) {
           X509_STORE_add_cert(store, item->x509);
           if (ca_cert_ == nullptr) {
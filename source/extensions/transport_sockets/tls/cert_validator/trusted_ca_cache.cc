@@ -0,0 +1,68 @@
+#include "source/extensions/transport_sockets/tls/cert_validator/trusted_ca_cache.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/macros.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+TrustedCaCache& TrustedCaCache::get() { MUTABLE_CONSTRUCT_ON_FIRST_USE(TrustedCaCache); }
+
+X509InfoListConstSharedPtr TrustedCaCache::getOrParse(absl::string_view pem, bool& shared) {
+  Digest digest;
+  SHA256(reinterpret_cast<const uint8_t*>(pem.data()), pem.size(), digest.data());
+
+  absl::MutexLock lock(&mutex_);
+  auto it = bundles_.find(digest);
+  if (it != bundles_.end()) {
+    if (X509InfoListConstSharedPtr list = it->second.lock(); list != nullptr) {
+      shared = true;
+      return list;
+    }
+  }
+  shared = false;
+
+  bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(const_cast<char*>(pem.data()), pem.size()));
+  RELEASE_ASSERT(bio != nullptr, "");
+  // Based on BoringSSL's X509_load_cert_crl_file().
+  STACK_OF(X509_INFO)* parsed = PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr);
+  if (parsed == nullptr) {
+    return nullptr;
+  }
+  // The bundle is removed from the cache once its last holder releases it. The deleter owns a copy
+  // of the key, as the cache entry may have been replaced by then.
+  X509InfoListConstSharedPtr list(parsed, [this, digest](const STACK_OF(X509_INFO)* list) {
+    release(digest, list);
+  });
+  if (it != bundles_.end()) {
+    it->second = list;
+  } else {
+    bundles_.emplace(digest, list);
+  }
+  return list;
+}
+
+size_t TrustedCaCache::size() {
+  absl::MutexLock lock(&mutex_);
+  return bundles_.size();
+}
+
+void TrustedCaCache::release(const Digest& digest, const STACK_OF(X509_INFO)* list) {
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = bundles_.find(digest);
+    // A holder may have released the bundle after it was parsed again, in which case the entry is
+    // the newer bundle's.
+    if (it != bundles_.end() && it->second.expired()) {
+      bundles_.erase(it);
+    }
+  }
+  sk_X509_INFO_pop_free(const_cast<STACK_OF(X509_INFO)*>(list), X509_INFO_free);
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/pem.h"
+#include "openssl/sha.h"
+#include "openssl/x509.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+using X509InfoListConstSharedPtr = std::shared_ptr<const STACK_OF(X509_INFO)>;
+
+/**
+ * Interns the parsed certificates and CRLs of trusted CA bundles, so that contexts which trust the
+ * same bundle, e.g. the clusters and listeners configured with the system CA bundle, share its
+ * X509 objects rather than each parsing their own copy of it. Bundles are identified by the
+ * SHA-256 digest of their contents and are released once their last holder is destroyed, on any
+ * thread.
+ */
+class TrustedCaCache {
+public:
+  /**
+   * @return the process-wide cache.
+   */
+  static TrustedCaCache& get();
+
+  /**
+   * Parses a PEM bundle of certificates and CRLs, or returns the already parsed one of the same
+   * contents.
+   * @param pem supplies the contents of the bundle.
+   * @param shared is set to whether the bundle was already parsed.
+   * @return the parsed bundle, which must be held for as long as it is used, or nullptr if it
+   *         couldn't be parsed.
+   */
+  X509InfoListConstSharedPtr getOrParse(absl::string_view pem, bool& shared);
+
+  /**
+   * @return the number of bundles which are held.
+   */
+  size_t size();
+
+private:
+  using Digest = std::array<uint8_t, SHA256_DIGEST_LENGTH>;
+
+  void release(const Digest& digest, const STACK_OF(X509_INFO)* list);
+
+  absl::Mutex mutex_;
+  // Keyed by digest rather than by contents, so that the cache doesn't hold another copy of each
+  // bundle, which may be hundreds of kilobytes for a system CA bundle.
+  absl::flat_hash_map<Digest, std::weak_ptr<const STACK_OF(X509_INFO)>>
+      bundles_ ABSL_GUARDED_BY(mutex_);
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -411,7 +411,8 @@ ServerContextConfigImpl::ServerContextConfigImpl(
       full_scan_certs_on_sni_mismatch_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
           config, full_scan_certs_on_sni_mismatch,
           !Runtime::runtimeFeatureEnabled(
-              "envoy.reloadable_features.no_full_scan_certs_on_sni_mismatch"))) {
+              "envoy.reloadable_features.no_full_scan_certs_on_sni_mismatch"))),
+      kernel_tls_offload_(config.enable_kernel_tls_offload()) {
 
   if (session_ticket_keys_provider_ != nullptr) {
     // Validate tls session ticket keys early to reject bad sds updates.
@@ -170,6 +170,7 @@ public:
   }
 
   bool fullScanCertsOnSNIMismatch() const override { return full_scan_certs_on_sni_mismatch_; }
+  bool kernelTlsOffload() const override { return kernel_tls_offload_; }
 
 private:
   static const unsigned DEFAULT_MIN_VERSION;
@@ -195,6 +196,7 @@ private:
   const bool disable_stateless_session_resumption_;
   const bool disable_stateful_session_resumption_;
   bool full_scan_certs_on_sni_mismatch_;
+  const bool kernel_tls_offload_;
 };
 
 } // namespace Tls
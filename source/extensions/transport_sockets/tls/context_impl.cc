@@ -790,6 +790,7 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
   if (config.tlsCertificates().empty() && !config.capabilities().provides_certificates) {
     throwEnvoyExceptionOrPanic("Server TlsCertificates must have a certificate specified");
   }
+  kernel_tls_offload_ = config.kernelTlsOffload();
 
   for (auto& ctx : tls_contexts_) {
     if (ctx.cert_chain_ == nullptr) {
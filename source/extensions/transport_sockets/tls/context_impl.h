@@ -76,6 +76,12 @@ public:
 
   SslStats& stats() { return stats_; }
 
+  /**
+   * @return whether the writes of connections are offloaded to kernel TLS once their handshake
+   * completes.
+   */
+  bool kernelTlsOffload() const { return kernel_tls_offload_; }
+
   /**
    * The global SSL-library index used for storing a pointer to the SslExtendedSocketInfo
    * class in the SSL instance, for retrieval in callbacks.
@@ -154,6 +160,8 @@ protected:
   const Network::Address::IpList tls_keylog_local_;
   const Network::Address::IpList tls_keylog_remote_;
   AccessLog::AccessLogFileSharedPtr tls_keylog_file_;
+  // Only set by server contexts.
+  bool kernel_tls_offload_{};
 };
 
 using ContextImplSharedPtr = std::shared_ptr<ContextImpl>;
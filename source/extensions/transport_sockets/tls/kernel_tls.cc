@@ -0,0 +1,233 @@
+#include "source/extensions/transport_sockets/tls/kernel_tls.h"
+
+#include <cstring>
+#include <string>
+
+#include "envoy/common/platform.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/cleanup.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "openssl/digest.h"
+#include "openssl/hkdf.h"
+#include "openssl/mem.h"
+
+#if defined(__linux__)
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+#if defined(__linux__)
+
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+
+namespace {
+
+// The TLS content type of alerts, and the close_notify alert of RFC 8446 section 6.1.
+constexpr uint8_t AlertContentType = 21;
+constexpr uint8_t CloseNotifyAlert[] = {1 /* warning */, 0 /* close_notify */};
+
+// HKDF-Expand-Label of RFC 8446 section 7.1, with an empty context.
+bool hkdfExpandLabel(const EVP_MD* digest, absl::Span<const uint8_t> secret,
+                     absl::string_view label, absl::Span<uint8_t> out) {
+  const std::string full_label = absl::StrCat("tls13 ", label);
+  std::vector<uint8_t> hkdf_label;
+  hkdf_label.push_back(out.size() >> 8);
+  hkdf_label.push_back(out.size() & 0xff);
+  hkdf_label.push_back(full_label.size());
+  hkdf_label.insert(hkdf_label.end(), full_label.begin(), full_label.end());
+  hkdf_label.push_back(0);
+  return HKDF_expand(out.data(), out.size(), digest, secret.data(), secret.size(),
+                     hkdf_label.data(), hkdf_label.size()) == 1;
+}
+
+// Fills the crypto info of a cipher from the key and the implicit IV of one direction. The
+// implicit IV is either the whole nonce which the sequence number is XORed into, or only the salt
+// of TLS 1.2 AES-GCM, whose explicit nonce BoringSSL sets to the sequence number.
+template <class Info>
+absl::optional<KernelTls::CryptoInfo> makeCryptoInfo(uint16_t version, uint16_t cipher_type,
+                                                     absl::Span<const uint8_t> key,
+                                                     absl::Span<const uint8_t> fixed_iv,
+                                                     uint64_t sequence) {
+  Info info;
+  memset(&info, 0, sizeof(info));
+  info.info.version = version;
+  info.info.cipher_type = cipher_type;
+  for (size_t i = 0; i < sizeof(info.rec_seq); i++) {
+    info.rec_seq[i] = sequence >> (8 * (sizeof(info.rec_seq) - 1 - i));
+  }
+  if (key.size() != sizeof(info.key)) {
+    return absl::nullopt;
+  }
+  memcpy(info.key, key.data(), sizeof(info.key));
+  if (fixed_iv.size() == sizeof(info.salt) + sizeof(info.iv)) {
+    memcpy(info.salt, fixed_iv.data(), sizeof(info.salt));
+    memcpy(info.iv, fixed_iv.data() + sizeof(info.salt), sizeof(info.iv));
+  } else if (fixed_iv.size() == sizeof(info.salt) && sizeof(info.iv) == sizeof(info.rec_seq)) {
+    memcpy(info.salt, fixed_iv.data(), sizeof(info.salt));
+    memcpy(info.iv, info.rec_seq, sizeof(info.iv));
+  } else {
+    return absl::nullopt;
+  }
+
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&info);
+  KernelTls::CryptoInfo crypto_info(bytes, bytes + sizeof(info));
+  OPENSSL_cleanse(&info, sizeof(info));
+  return crypto_info;
+}
+
+} // namespace
+
+absl::optional<KernelTls::CryptoInfo> KernelTls::cryptoInfo(const SSL& ssl, bool transmit) {
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(&ssl);
+  if (cipher == nullptr) {
+    return absl::nullopt;
+  }
+  size_t key_len;
+  switch (SSL_CIPHER_get_cipher_nid(cipher)) {
+  case NID_aes_128_gcm:
+    key_len = 16;
+    break;
+  case NID_aes_256_gcm:
+  case NID_chacha20_poly1305:
+    key_len = 32;
+    break;
+  default:
+    return absl::nullopt;
+  }
+  const bool chacha = SSL_CIPHER_get_cipher_nid(cipher) == NID_chacha20_poly1305;
+
+  uint16_t version;
+  std::vector<uint8_t> keys;
+  absl::Span<const uint8_t> key;
+  absl::Span<const uint8_t> fixed_iv;
+  Cleanup cleanse_keys([&keys]() { OPENSSL_cleanse(keys.data(), keys.size()); });
+  switch (SSL_version(&ssl)) {
+  case TLS1_2_VERSION: {
+    version = TLS_1_2_VERSION;
+    // The key block of AEAD ciphers is the client and server write keys followed by the client
+    // and server implicit IVs, per RFC 5246 section 6.3.
+    const size_t iv_len = chacha ? 12 : 4;
+    keys.resize(SSL_get_key_block_len(&ssl));
+    if (keys.size() != 2 * (key_len + iv_len) ||
+        !SSL_generate_key_block(&ssl, keys.data(), keys.size())) {
+      return absl::nullopt;
+    }
+    const bool client_keys = SSL_is_server(&ssl) != transmit;
+    key = absl::MakeConstSpan(keys).subspan(client_keys ? 0 : key_len, key_len);
+    fixed_iv =
+        absl::MakeConstSpan(keys).subspan(2 * key_len + (client_keys ? 0 : iv_len), iv_len);
+    break;
+  }
+#ifdef TLS_1_3_VERSION
+  case TLS1_3_VERSION: {
+    version = TLS_1_3_VERSION;
+    bssl::Span<const uint8_t> read_secret;
+    bssl::Span<const uint8_t> write_secret;
+    if (!bssl::SSL_get_traffic_secrets(&ssl, &read_secret, &write_secret)) {
+      return absl::nullopt;
+    }
+    const bssl::Span<const uint8_t> secret = transmit ? write_secret : read_secret;
+    const EVP_MD* digest = SSL_CIPHER_get_handshake_digest(cipher);
+    keys.resize(key_len + 12);
+    if (!hkdfExpandLabel(digest, {secret.data(), secret.size()}, "key",
+                         absl::MakeSpan(keys).subspan(0, key_len)) ||
+        !hkdfExpandLabel(digest, {secret.data(), secret.size()}, "iv",
+                         absl::MakeSpan(keys).subspan(key_len))) {
+      return absl::nullopt;
+    }
+    key = absl::MakeConstSpan(keys).subspan(0, key_len);
+    fixed_iv = absl::MakeConstSpan(keys).subspan(key_len);
+    break;
+  }
+#endif
+  default:
+    return absl::nullopt;
+  }
+
+  const uint64_t sequence = transmit ? SSL_get_write_sequence(&ssl) : SSL_get_read_sequence(&ssl);
+  if (chacha) {
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+    return makeCryptoInfo<tls12_crypto_info_chacha20_poly1305>(
+        version, TLS_CIPHER_CHACHA20_POLY1305, key, fixed_iv, sequence);
+#else
+    return absl::nullopt;
+#endif
+  }
+  if (key_len == 16) {
+    return makeCryptoInfo<tls12_crypto_info_aes_gcm_128>(version, TLS_CIPHER_AES_GCM_128, key,
+                                                         fixed_iv, sequence);
+  }
+  return makeCryptoInfo<tls12_crypto_info_aes_gcm_256>(version, TLS_CIPHER_AES_GCM_256, key,
+                                                       fixed_iv, sequence);
+}
+
+bool KernelTls::enableTransmitOffload(const SSL& ssl, Network::IoHandle& io_handle) {
+  absl::optional<CryptoInfo> crypto_info = cryptoInfo(ssl, true);
+  if (!crypto_info.has_value()) {
+    return false;
+  }
+  Cleanup cleanse_crypto_info(
+      [&crypto_info]() { OPENSSL_cleanse(crypto_info->data(), crypto_info->size()); });
+
+  // Without keys, the ULP passes everything through, so that a socket it was attached to but whose
+  // keys were rejected is still usable by BoringSSL.
+  static constexpr char Ulp[] = "tls";
+  if (io_handle.setOption(IPPROTO_TCP, TCP_ULP, Ulp, sizeof(Ulp)).return_value_ != 0) {
+    return false;
+  }
+  return io_handle.setOption(SOL_TLS, TLS_TX, crypto_info->data(), crypto_info->size())
+             .return_value_ == 0;
+}
+
+void KernelTls::sendCloseNotify(Network::IoHandle& io_handle) {
+  // Records of other content types than application data are written with a control message.
+  iovec iov;
+  iov.iov_base = const_cast<uint8_t*>(CloseNotifyAlert);
+  iov.iov_len = sizeof(CloseNotifyAlert);
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(AlertContentType))];
+  memset(control, 0, sizeof(control));
+  msghdr message;
+  memset(&message, 0, sizeof(message));
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(AlertContentType));
+  *CMSG_DATA(cmsg) = AlertContentType;
+  // Like SSL_shutdown(), this is best effort and not retried if the socket is full.
+  Api::OsSysCallsSingleton::get().sendmsg(io_handle.fdDoNotUse(), &message, 0);
+}
+
+#else
+
+absl::optional<KernelTls::CryptoInfo> KernelTls::cryptoInfo(const SSL&, bool) {
+  return absl::nullopt;
+}
+
+bool KernelTls::enableTransmitOffload(const SSL&, Network::IoHandle&) { return false; }
+
+void KernelTls::sendCloseNotify(Network::IoHandle&) { PANIC("not implemented"); }
+
+#endif
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "envoy/network/io_handle.h"
+
+#include "absl/types/optional.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Offloads the record protection of established TLS connections to the Linux kernel TLS (kTLS)
+ * upper layer protocol, so that data is written to the socket in the clear and framed and
+ * encrypted into TLS records by the kernel.
+ */
+class KernelTls {
+public:
+  /**
+   * The crypto info of one direction of a connection, as passed to setsockopt(SOL_TLS).
+   */
+  using CryptoInfo = std::vector<uint8_t>;
+
+  /**
+   * @param ssl supplies the connection, whose handshake must be complete.
+   * @param transmit whether to return the crypto info with which the connection writes its
+   *        records, or else reads them.
+   * @return the crypto info, or nullopt if the kernel doesn't support the protocol version or the
+   *         cipher of the connection.
+   */
+  static absl::optional<CryptoInfo> cryptoInfo(const SSL& ssl, bool transmit);
+
+  /**
+   * Installs the keys with which the connection writes its records into the kernel. If this
+   * succeeds, everything written to the socket afterwards is sent as application data records.
+   * @param ssl supplies the connection, whose handshake must be complete and which must have no
+   *        records left to write.
+   * @param io_handle supplies the TCP socket of the connection.
+   * @return whether the keys were installed. If not, the connection is left as it was.
+   */
+  static bool enableTransmitOffload(const SSL& ssl, Network::IoHandle& io_handle);
+
+  /**
+   * Sends a close_notify alert on a connection whose writes have been offloaded.
+   * @param io_handle supplies the TCP socket of the connection.
+   */
+  static void sendCloseNotify(Network::IoHandle& io_handle);
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
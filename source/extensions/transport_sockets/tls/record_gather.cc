@@ -0,0 +1,24 @@
+#include "source/extensions/transport_sockets/tls/record_gather.h"
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+const void* RecordGather::gather(const Buffer::Instance& buffer, uint64_t length) {
+  ASSERT(length <= MaxRecordSize && length <= buffer.length());
+  const Buffer::RawSlice front = buffer.frontSlice();
+  if (front.len_ >= length) {
+    return front.mem_;
+  }
+  static thread_local uint8_t scratch[MaxRecordSize];
+  buffer.copyOut(0, length, scratch);
+  return scratch;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/buffer/buffer.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Gathers the plaintext of TLS records written with SSL_write() from the slices of a buffer,
+ * without linearizing the buffer, which would allocate a new slice for each record that spans
+ * several slices and move its data into it.
+ */
+class RecordGather {
+public:
+  // The largest plaintext of a TLS record.
+  static constexpr uint64_t MaxRecordSize = 16384;
+
+  /**
+   * @param buffer supplies the buffer to write.
+   * @param length supplies the length of the record, of at most MaxRecordSize and the length of
+   *        the buffer.
+   * @return the first length bytes of the buffer. These are its first slice if it is long enough,
+   *         and else a copy in a scratch slab of the calling thread, which is valid until the next
+   *         call on the thread. SSL_write() consumes the plaintext before it returns, so that the
+   *         slab is shared by all connections of the thread.
+   */
+  static const void* gather(const Buffer::Instance& buffer, uint64_t length);
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
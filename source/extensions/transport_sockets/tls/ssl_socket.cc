@@ -8,6 +8,8 @@
 #include "source/common/http/headers.h"
 #include "source/common/runtime/runtime_features.h"
 #include "source/extensions/transport_sockets/tls/io_handle_bio.h"
+#include "source/extensions/transport_sockets/tls/kernel_tls.h"
+#include "source/extensions/transport_sockets/tls/record_gather.h"
 #include "source/extensions/transport_sockets/tls/ssl_handshaker.h"
 #include "source/extensions/transport_sockets/tls/utility.h"
 
@@ -60,6 +62,8 @@ SslSocket::SslSocket(Envoy::Ssl::ContextSharedPtr ctx, InitialState state,
     ASSERT(state == InitialState::Server);
     SSL_set_accept_state(rawSsl());
   }
+  // The plaintext of a retried SSL_write() may have been gathered elsewhere than the first time.
+  SSL_set_mode(rawSsl(), SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
 }
 
 void SslSocket::setTransportSocketCallbacks(Network::TransportSocketCallbacks& callbacks) {
@@ -160,6 +164,14 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
     bytes_read += bytes_read_this_iteration;
   }
 
+  if (kernel_tls_offload_ && BIO_pending(SSL_get_wbio(rawSsl())) > 0) {
+    // BoringSSL replied to a post-handshake message, e.g. a TLS 1.3 KeyUpdate requesting an update
+    // of the keys which the kernel now writes with.
+    ENVOY_CONN_LOG(debug, "TLS record written after kernel TLS offload", callbacks_->connection());
+    failure_reason_ = "TLS error: record written after kernel TLS offload";
+    action = PostIoAction::Close;
+  }
+
   ENVOY_CONN_LOG(trace, "ssl read {} bytes", callbacks_->connection(), bytes_read);
 
   return {action, bytes_read, end_stream};
@@ -184,6 +196,9 @@ Network::Connection& SslSocket::connection() const { return callbacks_->connecti
 
 void SslSocket::onSuccess(SSL* ssl) {
   ctx_->logHandshake(ssl);
+  if (ctx_->kernelTlsOffload()) {
+    enableKernelTlsOffload(ssl);
+  }
   if (callbacks_->connection().streamInfo().upstreamInfo()) {
     callbacks_->connection()
         .streamInfo()
@@ -199,6 +214,20 @@ void SslSocket::onSuccess(SSL* ssl) {
 
 void SslSocket::onFailure() { drainErrorQueue(); }
 
+void SslSocket::enableKernelTlsOffload(SSL* ssl) {
+  if (!KernelTls::enableTransmitOffload(*ssl, callbacks_->ioHandle())) {
+    ENVOY_CONN_LOG(debug, "kernel TLS offload not supported", callbacks_->connection());
+    ctx_->stats().kernel_tls_offload_failed_.inc();
+    return;
+  }
+  ENVOY_CONN_LOG(debug, "kernel TLS offload enabled", callbacks_->connection());
+  ctx_->stats().kernel_tls_offload_.inc();
+  kernel_tls_offload_ = true;
+  // Anything written to the socket is now encrypted by the kernel, so BoringSSL must no longer
+  // write to it. What it still writes is captured instead, and closes the connection.
+  SSL_set0_wbio(ssl, BIO_new(BIO_s_mem()));
+}
+
 PostIoAction SslSocket::doHandshake() { return info_->doHandshake(); }
 
 void SslSocket::drainErrorQueue() {
@@ -256,12 +285,16 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     }
   }
 
+  if (kernel_tls_offload_) {
+    return doKernelTlsWrite(write_buffer, end_stream);
+  }
+
   uint64_t bytes_to_write;
   if (bytes_to_retry_) {
     bytes_to_write = bytes_to_retry_;
     bytes_to_retry_ = 0;
   } else {
-    bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+    bytes_to_write = std::min(write_buffer.length(), RecordGather::MaxRecordSize);
   }
 
   uint64_t total_bytes_written = 0;
@@ -271,15 +304,16 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
 
     // SSL_write() requires that if a previous call returns SSL_ERROR_WANT_WRITE, we need to call
     // it again with the same parameters. This is done by tracking last write size, but not write
-    // data, since linearize() will return the same undrained data anyway.
+    // data, since gather() will return the same undrained data anyway.
     ASSERT(bytes_to_write <= write_buffer.length());
-    int rc = SSL_write(rawSsl(), write_buffer.linearize(bytes_to_write), bytes_to_write);
+    const void* record = RecordGather::gather(write_buffer, bytes_to_write);
+    int rc = SSL_write(rawSsl(), record, bytes_to_write);
     ENVOY_CONN_LOG(trace, "ssl write returns: {}", callbacks_->connection(), rc);
     if (rc > 0) {
       ASSERT(rc == static_cast<int>(bytes_to_write));
       total_bytes_written += rc;
       write_buffer.drain(rc);
-      bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+      bytes_to_write = std::min(write_buffer.length(), RecordGather::MaxRecordSize);
     } else {
       int err = SSL_get_error(rawSsl(), rc);
       ENVOY_CONN_LOG(trace, "ssl error occurred while write: {}", callbacks_->connection(),
@@ -306,6 +340,31 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
   return {PostIoAction::KeepOpen, total_bytes_written, false};
 }
 
+Network::IoResult SslSocket::doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream) {
+  // The kernel frames and encrypts the buffer as is, without it being linearized.
+  uint64_t total_bytes_written = 0;
+  while (write_buffer.length() > 0) {
+    Api::IoCallUint64Result result = callbacks_->ioHandle().write(write_buffer);
+    if (!result.ok()) {
+      ENVOY_CONN_LOG(trace, "kernel TLS write error: {}", callbacks_->connection(),
+                     result.err_->getErrorDetails());
+      if (result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+        return {PostIoAction::KeepOpen, total_bytes_written, false};
+      }
+      return {PostIoAction::Close, total_bytes_written, false, result.err_->getErrorCode()};
+    }
+    ENVOY_CONN_LOG(trace, "kernel TLS write returns: {}", callbacks_->connection(),
+                   result.return_value_);
+    total_bytes_written += result.return_value_;
+  }
+
+  if (end_stream) {
+    shutdownSsl();
+  }
+
+  return {PostIoAction::KeepOpen, total_bytes_written, false};
+}
+
 void SslSocket::onConnected() { ASSERT(info_->state() == Ssl::SocketState::PreHandshake); }
 
 Ssl::ConnectionInfoConstSharedPtr SslSocket::ssl() const { return info_; }
@@ -314,6 +373,11 @@ void SslSocket::shutdownSsl() {
   ASSERT(info_->state() != Ssl::SocketState::PreHandshake);
   if (info_->state() != Ssl::SocketState::ShutdownSent &&
       callbacks_->connection().state() != Network::Connection::State::Closed) {
+    if (kernel_tls_offload_) {
+      KernelTls::sendCloseNotify(callbacks_->ioHandle());
+      info_->setState(Ssl::SocketState::ShutdownSent);
+      return;
+    }
     int rc = SSL_shutdown(rawSsl());
     if constexpr (Event::PlatformDefaultTriggerType == Event::FileTriggerType::EmulatedEdge) {
       // Windows operate under `EmulatedEdge`. These are level events that are artificially
@@ -86,6 +86,8 @@ private:
   ReadResult sslReadIntoSlice(Buffer::RawSlice& slice);
 
   Network::PostIoAction doHandshake();
+  void enableKernelTlsOffload(SSL* ssl);
+  Network::IoResult doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream);
   void drainErrorQueue();
   void shutdownSsl();
   void shutdownBasic();
@@ -96,6 +98,8 @@ private:
   ContextImplSharedPtr ctx_;
   uint64_t bytes_to_retry_{};
   std::string failure_reason_;
+  // Whether the writes of the connection are encrypted by the kernel, and no longer by BoringSSL.
+  bool kernel_tls_offload_{};
 
   SslHandshakerImplSharedPtr info_;
 };
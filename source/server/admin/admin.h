@@ -359,6 +359,7 @@ private:
       socket_create_ = true;
       return socket_;
     }
+    OptRef<Network::ListenSocketLoad> socketLoad(uint32_t) override { return {}; }
     Network::ListenSocketFactoryPtr clone() const override { return nullptr; }
     void closeAllSockets() override {}
     void doFinalPreWorkerInit() override {}
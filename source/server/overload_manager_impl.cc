@@ -1,6 +1,7 @@
 #include "source/server/overload_manager_impl.h"
 
 #include <chrono>
+#include <cmath>
 
 #include "envoy/common/exception.h"
 #include "envoy/config/overload/v3/overload.pb.h"
@@ -16,6 +17,7 @@
 
 #include "absl/container/node_hash_map.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Server {
@@ -79,7 +81,77 @@ private:
   OverloadActionState state_;
 };
 
-TriggerPtr createTriggerFromConfig(const envoy::config::overload::v3::Trigger& trigger_config) {
+class PredictiveTriggerImpl final : public Trigger {
+public:
+  PredictiveTriggerImpl(const envoy::config::overload::v3::PredictiveTrigger& config,
+                        TimeSource& time_source)
+      : saturation_threshold_(config.saturation_threshold()),
+        scaling_horizon_(
+            std::chrono::milliseconds(PROTOBUF_GET_MS_REQUIRED(config, scaling_horizon))),
+        saturation_horizon_(
+            std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, saturation_horizon, 0))),
+        rate_window_(
+            std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, rate_window, 5000))),
+        time_source_(time_source), state_(OverloadActionState::inactive()) {
+    if (saturation_horizon_ >= scaling_horizon_) {
+      throw EnvoyException("saturation_horizon must be less than scaling_horizon");
+    }
+  }
+
+  bool updateValue(double value) override {
+    const OverloadActionState old_state = actionState();
+    updateRate(value);
+    if (value >= saturation_threshold_) {
+      state_ = OverloadActionState::saturated();
+    } else if (rate_ <= 0) {
+      state_ = OverloadActionState::inactive();
+    } else {
+      const std::chrono::duration<double> time_to_saturation((saturation_threshold_ - value) /
+                                                             rate_);
+      if (time_to_saturation <= saturation_horizon_) {
+        state_ = OverloadActionState::saturated();
+      } else if (time_to_saturation >= scaling_horizon_) {
+        state_ = OverloadActionState::inactive();
+      } else {
+        state_ = OverloadActionState(UnitFloat((scaling_horizon_ - time_to_saturation) /
+                                               (scaling_horizon_ - saturation_horizon_)));
+      }
+    }
+    // As with ScaledTriggerImpl, a signal for a tiny change is harmless.
+    return state_.value() != old_state.value();
+  }
+
+  OverloadActionState actionState() const override { return state_; }
+
+private:
+  // Folds the rate of change since the previous value into the moving average, weighted by how
+  // much of the window has passed since, so that the average doesn't depend on how often the
+  // value is updated.
+  void updateRate(double value) {
+    const MonotonicTime now = time_source_.monotonicTime();
+    if (last_update_.has_value() && now > *last_update_) {
+      const std::chrono::duration<double> elapsed = now - *last_update_;
+      const double weight = 1 - std::exp(-elapsed / rate_window_);
+      rate_ += weight * ((value - last_value_) / elapsed.count() - rate_);
+    }
+    last_update_ = now;
+    last_value_ = value;
+  }
+
+  const double saturation_threshold_;
+  const std::chrono::duration<double> scaling_horizon_;
+  const std::chrono::duration<double> saturation_horizon_;
+  const std::chrono::duration<double> rate_window_;
+  TimeSource& time_source_;
+  absl::optional<MonotonicTime> last_update_;
+  double last_value_{};
+  // The moving average of the rate of change of the value, per second.
+  double rate_{};
+  OverloadActionState state_;
+};
+
+TriggerPtr createTriggerFromConfig(const envoy::config::overload::v3::Trigger& trigger_config,
+                                   TimeSource& time_source) {
   TriggerPtr trigger;
 
   switch (trigger_config.trigger_oneof_case()) {
@@ -89,6 +161,9 @@ TriggerPtr createTriggerFromConfig(const envoy::config::overload::v3::Trigger& t
   case envoy::config::overload::v3::Trigger::TriggerOneofCase::kScaled:
     trigger = std::make_unique<ScaledTriggerImpl>(trigger_config.scaled());
     break;
+  case envoy::config::overload::v3::Trigger::TriggerOneofCase::kPredictive:
+    trigger = std::make_unique<PredictiveTriggerImpl>(trigger_config.predictive(), time_source);
+    break;
   case envoy::config::overload::v3::Trigger::TriggerOneofCase::TRIGGER_ONEOF_NOT_SET:
     throw EnvoyException(absl::StrCat("action not set for trigger ", trigger_config.name()));
   }
@@ -265,14 +340,16 @@ const absl::string_view NamedOverloadActionSymbolTable::name(Symbol symbol) cons
 }
 
 OverloadAction::OverloadAction(const envoy::config::overload::v3::OverloadAction& config,
-                               Stats::Scope& stats_scope)
+                               Stats::Scope& stats_scope, TimeSource& time_source)
     : state_(OverloadActionState::inactive()),
       active_gauge_(
           makeGauge(stats_scope, config.name(), "active", Stats::Gauge::ImportMode::NeverImport)),
       scale_percent_gauge_(makeGauge(stats_scope, config.name(), "scale_percent",
                                      Stats::Gauge::ImportMode::NeverImport)) {
   for (const auto& trigger_config : config.triggers()) {
-    if (!triggers_.try_emplace(trigger_config.name(), createTriggerFromConfig(trigger_config))
+    if (!triggers_
+             .try_emplace(trigger_config.name(),
+                          createTriggerFromConfig(trigger_config, time_source))
              .second) {
       throw EnvoyException(
           absl::StrCat("Duplicate trigger resource for overload action ", config.name()));
@@ -314,12 +391,15 @@ OverloadActionState OverloadAction::getState() const { return state_; }
 
 LoadShedPointImpl::LoadShedPointImpl(const envoy::config::overload::v3::LoadShedPoint& config,
                                      Stats::Scope& stats_scope,
-                                     Random::RandomGenerator& random_generator)
+                                     Random::RandomGenerator& random_generator,
+                                     TimeSource& time_source)
     : scale_percent_(makeGauge(stats_scope, config.name(), "scale_percent",
                                Stats::Gauge::ImportMode::NeverImport)),
       random_generator_(random_generator) {
   for (const auto& trigger_config : config.triggers()) {
-    if (!triggers_.try_emplace(trigger_config.name(), createTriggerFromConfig(trigger_config))
+    if (!triggers_
+             .try_emplace(trigger_config.name(),
+                          createTriggerFromConfig(trigger_config, time_source))
              .second) {
       throw EnvoyException(
           absl::StrCat("Duplicate trigger resource for LoadShedPoint ", config.name()));
@@ -374,7 +454,7 @@ OverloadManagerImpl::OverloadManagerImpl(Event::Dispatcher& dispatcher, Stats::S
           std::make_unique<
               absl::node_hash_map<OverloadProactiveResourceName, ProactiveResource>>()) {
   Configuration::ResourceMonitorFactoryContextImpl context(dispatcher, options, api,
-                                                           validation_visitor);
+                                                           slot_allocator, validation_visitor);
   // We should hide impl details from users, for them there should be no distinction between
   // proactive and regular resource monitors in configuration API. But internally we will maintain
   // two distinct collections of proactive and regular resources. Proactive resources are not
@@ -431,7 +511,7 @@ OverloadManagerImpl::OverloadManagerImpl(Event::Dispatcher& dispatcher, Stats::S
     // We cannot currently use in place construction as the OverloadAction constructor may throw,
     // causing an inconsistent internal state of the actions_ map, which on destruction results in
     // an invalid free.
-    auto result = actions_.try_emplace(symbol, OverloadAction(action, stats_scope));
+    auto result = actions_.try_emplace(symbol, OverloadAction(action, stats_scope, time_source_));
     if (!result.second) {
       throw EnvoyException(absl::StrCat("Duplicate overload action ", name));
     }
@@ -476,7 +556,8 @@ OverloadManagerImpl::OverloadManagerImpl(Event::Dispatcher& dispatcher, Stats::S
 
     const auto result = loadshed_points_.try_emplace(
         point.name(),
-        std::make_unique<LoadShedPointImpl>(point, api.rootScope(), api.randomGenerator()));
+        std::make_unique<LoadShedPointImpl>(point, api.rootScope(), api.randomGenerator(),
+                                            time_source_));
 
     if (!result.second) {
       throw EnvoyException(absl::StrCat("Duplicate loadshed point ", point.name()));
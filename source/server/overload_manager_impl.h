@@ -42,7 +42,7 @@ public:
 class OverloadAction {
 public:
   OverloadAction(const envoy::config::overload::v3::OverloadAction& config,
-                 Stats::Scope& stats_scope);
+                 Stats::Scope& stats_scope, TimeSource& time_source);
 
   // Updates the current pressure for the given resource and returns whether the action
   // has changed state.
@@ -66,7 +66,8 @@ private:
 class LoadShedPointImpl : public LoadShedPoint {
 public:
   LoadShedPointImpl(const envoy::config::overload::v3::LoadShedPoint& config,
-                    Stats::Scope& stats_scope, Random::RandomGenerator& random_generator);
+                    Stats::Scope& stats_scope, Random::RandomGenerator& random_generator,
+                    TimeSource& time_source);
   LoadShedPointImpl(const LoadShedPointImpl&) = delete;
   LoadShedPointImpl& operator=(const LoadShedPointImpl&) = delete;
 
@@ -9,9 +9,9 @@ namespace Configuration {
 class ResourceMonitorFactoryContextImpl : public ResourceMonitorFactoryContext {
 public:
   ResourceMonitorFactoryContextImpl(Event::Dispatcher& dispatcher, const Server::Options& options,
-                                    Api::Api& api,
+                                    Api::Api& api, ThreadLocal::SlotAllocator& thread_local,
                                     ProtobufMessage::ValidationVisitor& validation_visitor)
-      : dispatcher_(dispatcher), options_(options), api_(api),
+      : dispatcher_(dispatcher), options_(options), api_(api), thread_local_(thread_local),
         validation_visitor_(validation_visitor) {}
 
   Event::Dispatcher& mainThreadDispatcher() override { return dispatcher_; }
@@ -20,6 +20,8 @@ public:
 
   Api::Api& api() override { return api_; }
 
+  ThreadLocal::SlotAllocator& threadLocal() override { return thread_local_; }
+
   ProtobufMessage::ValidationVisitor& messageValidationVisitor() override {
     return validation_visitor_;
   }
@@ -28,6 +30,7 @@ private:
   Event::Dispatcher& dispatcher_;
   const Server::Options& options_;
   Api::Api& api_;
+  ThreadLocal::SlotAllocator& thread_local_;
   ProtobufMessage::ValidationVisitor& validation_visitor_;
 };
 
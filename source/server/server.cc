@@ -96,8 +96,10 @@ InstanceBase::InstanceBase(Init::Manager& init_manager, const Options& options,
           process_context ? ProcessContextOptRef(std::ref(*process_context)) : absl::nullopt,
           watermark_factory)),
       dispatcher_(api_->allocateDispatcher("main_thread")),
+      // With worker buffers, the main thread writing the admin access logs gets one as well.
       access_log_manager_(options.fileFlushIntervalMsec(), *api_, *dispatcher_, access_log_lock,
-                          store),
+                          store,
+                          options.fileFlushWorkerBuffers() ? options.concurrency() + 1 : 0),
       singleton_manager_(new Singleton::ManagerImpl(api_->threadFactory())),
       handler_(getHandler(*dispatcher_)), worker_factory_(thread_local_, *api_, hooks),
       mutex_tracer_(options.mutexTracingEnabled() ? &Envoy::MutexTracerImpl::getOrCreateTracer()
@@ -505,6 +507,10 @@ void InstanceBase::initializeOrThrow(Network::Address::InstanceConstSharedPtr lo
       bootstrap_.stats_config(), stats_store_.symbolTable()));
   stats_store_.setHistogramSettings(
       std::make_unique<Stats::HistogramSettingsImpl>(bootstrap_.stats_config()));
+  if (bootstrap_.stats_config().shard_counters()) {
+    // The main thread increments counters too, so it has a shard of its own.
+    stats_store_.setCounterShards(options_.concurrency() + 1);
+  }
 
   const std::string server_stats_prefix = "server.";
   const std::string server_compilation_settings_stats_prefix = "server.compilation_settings";
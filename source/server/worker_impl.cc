@@ -9,6 +9,7 @@
 #include "envoy/server/configuration.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "source/common/common/thread.h"
 #include "source/common/config/utility.h"
 #include "source/server/listener_manager_factory.h"
 
@@ -35,16 +36,16 @@ WorkerPtr ProdWorkerFactory::createWorker(uint32_t index, OverloadManager& overl
   Event::DispatcherPtr dispatcher(
       api_.allocateDispatcher(worker_name, overload_manager.scaledTimerFactory()));
   auto conn_handler = getHandler(*dispatcher, index, overload_manager);
-  return std::make_unique<WorkerImpl>(tls_, hooks_, std::move(dispatcher), std::move(conn_handler),
-                                      overload_manager, api_, stat_names_);
+  return std::make_unique<WorkerImpl>(index, tls_, hooks_, std::move(dispatcher),
+                                      std::move(conn_handler), overload_manager, api_, stat_names_);
 }
 
-WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks,
+WorkerImpl::WorkerImpl(uint32_t index, ThreadLocal::Instance& tls, ListenerHooks& hooks,
                        Event::DispatcherPtr&& dispatcher, Network::ConnectionHandlerPtr handler,
                        OverloadManager& overload_manager, Api::Api& api,
                        WorkerStatNames& stat_names)
-    : tls_(tls), hooks_(hooks), dispatcher_(std::move(dispatcher)), handler_(std::move(handler)),
-      api_(api), reset_streams_counter_(
+    : index_(index), tls_(tls), hooks_(hooks), dispatcher_(std::move(dispatcher)),
+      handler_(std::move(handler)), api_(api), reset_streams_counter_(
                      api_.rootScope().counterFromStatName(stat_names.reset_high_memory_stream_)) {
   tls_.registerThread(*dispatcher_, false);
   overload_manager.registerForAction(
@@ -141,6 +142,7 @@ void WorkerImpl::stopListener(Network::ListenerConfig& listener,
 
 void WorkerImpl::threadRoutine(OptRef<GuardDog> guard_dog, const std::function<void()>& cb) {
   ENVOY_LOG(debug, "worker entering dispatch loop");
+  Thread::WorkerIndex::set(index_);
   // The watch dog must be created after the dispatcher starts running and has post events flushed,
   // as this is when TLS stat scopes start working.
   dispatcher_->post([this, &guard_dog, cb]() {
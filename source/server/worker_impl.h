@@ -47,9 +47,9 @@ private:
  */
 class WorkerImpl : public Worker, Logger::Loggable<Logger::Id::main> {
 public:
-  WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks, Event::DispatcherPtr&& dispatcher,
-             Network::ConnectionHandlerPtr handler, OverloadManager& overload_manager,
-             Api::Api& api, WorkerStatNames& stat_names);
+  WorkerImpl(uint32_t index, ThreadLocal::Instance& tls, ListenerHooks& hooks,
+             Event::DispatcherPtr&& dispatcher, Network::ConnectionHandlerPtr handler,
+             OverloadManager& overload_manager, Api::Api& api, WorkerStatNames& stat_names);
 
   // Server::Worker
   void addListener(absl::optional<uint64_t> overridden_listener, Network::ListenerConfig& listener,
@@ -74,6 +74,7 @@ private:
   void rejectIncomingConnectionsCb(OverloadActionState state);
   void resetStreamsUsingExcessiveMemory(OverloadActionState state);
 
+  const uint32_t index_;
   ThreadLocal::Instance& tls_;
   ListenerHooks& hooks_;
   Event::DispatcherPtr dispatcher_;
@@ -11,6 +11,10 @@
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -501,6 +505,114 @@ TEST_F(AccessLogManagerImplTest, ReopenAllFiles) {
       .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
 }
 
+class AccessLogManagerImplWorkerBuffersTest : public AccessLogManagerImplTest {
+protected:
+  AccessLogManagerImplWorkerBuffersTest()
+      : worker_buffers_manager_(timeout_40ms_, api_, dispatcher_, lock_, store_, 2) {}
+
+  AccessLogManagerImpl worker_buffers_manager_;
+};
+
+// Files with worker buffers are flushed by a shared thread instead of a timer of their own.
+TEST_F(AccessLogManagerImplWorkerBuffersTest, FlushWorkerBuffers) {
+  EXPECT_CALL(dispatcher_, createTimer_(_)).Times(0);
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = worker_buffers_manager_.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"});
+
+  absl::Mutex written_lock;
+  std::string written;
+  EXPECT_CALL(*file_, write_(_))
+      .WillRepeatedly(Invoke([&](absl::string_view data) -> Api::IoCallSizeResult {
+        absl::MutexLock lock(&written_lock);
+        absl::StrAppend(&written, data);
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  log_file->write("hello\n");
+  Thread::ThreadPtr thread =
+      thread_factory_.createThread([&]() -> void { log_file->write("world\n"); });
+  thread->join();
+
+  waitForCounterEq("filesystem.write_buffered", 2);
+  waitForGaugeEq("filesystem.write_total_buffered", 0);
+  EXPECT_GT(store_.counter("filesystem.flushed_by_timer").value(), 0UL);
+  {
+    absl::MutexLock lock(&written_lock);
+    EXPECT_EQ(12UL, written.size());
+    EXPECT_TRUE(absl::StrContains(written, "hello\n"));
+    EXPECT_TRUE(absl::StrContains(written, "world\n"));
+  }
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+// Writes are counted as backpressured once a worker buffer is over the flush size, and are dropped
+// once it would go over its maximum size.
+TEST_F(AccessLogManagerImplWorkerBuffersTest, WorkerBufferFull) {
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = worker_buffers_manager_.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"});
+
+  absl::Notification writing;
+  absl::Notification release;
+  EXPECT_CALL(*file_, write_(_))
+      .WillRepeatedly(Invoke([&](absl::string_view data) -> Api::IoCallSizeResult {
+        if (!writing.HasBeenNotified()) {
+          writing.Notify();
+          release.WaitForNotification();
+        }
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  // A write over the flush size is flushed right away, and the flush thread is then held up.
+  log_file->write(std::string(65537, 'a'));
+  writing.WaitForNotification();
+
+  const std::string chunk(65536, 'b');
+  for (int i = 0; i < 17; i++) {
+    log_file->write(chunk);
+  }
+  EXPECT_EQ(14UL, store_.counter("filesystem.write_backpressured").value());
+  EXPECT_EQ(1UL, store_.counter("filesystem.write_dropped").value());
+
+  release.Notify();
+  waitForCounterEq("filesystem.write_buffered", 17);
+  waitForGaugeEq("filesystem.write_total_buffered", 0);
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(AccessLogManagerImplWorkerBuffersTest, ReopenFile) {
+  Sequence sq;
+  EXPECT_CALL(*file_, open_(_))
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = worker_buffers_manager_.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"});
+
+  EXPECT_CALL(*file_, close_())
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  EXPECT_CALL(*file_, open_(_))
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  EXPECT_CALL(*file_, write_(_))
+      .InSequence(sq)
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("reopened"));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  EXPECT_CALL(*file_, close_())
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+
+  log_file->reopen();
+  EXPECT_TRUE(file_->waitForEventCount(file_->num_opens_, 2));
+  log_file->write("reopened");
+  EXPECT_TRUE(file_->waitForEventCount(file_->num_writes_, 1));
+}
+
 } // namespace
 } // namespace AccessLog
 } // namespace Envoy
@@ -1,3 +1,7 @@
+#include <regex>
+#include <string>
+#include <vector>
+
 #include "envoy/common/exception.h"
 #include "envoy/type/matcher/v3/regex.pb.h"
 
@@ -138,6 +142,52 @@ TEST(Utility, ParseRegex) {
   }
 }
 
+class StdRegexMatcher : public CompiledMatcher {
+public:
+  explicit StdRegexMatcher(const std::string& regex) : regex_(regex) {}
+
+  bool match(absl::string_view value) const override {
+    return std::regex_match(value.begin(), value.end(), regex_);
+  }
+  std::string replaceAll(absl::string_view, absl::string_view) const override { return ""; }
+
+private:
+  const std::regex regex_;
+};
+
+TEST(CompiledGoogleReSet, FindMatches) {
+  CompiledGoogleReSet regex_set;
+  EXPECT_TRUE(regex_set.add(CompiledGoogleReMatcher("/foo/.*", false)));
+  EXPECT_TRUE(regex_set.add(CompiledGoogleReMatcher("/bar", false)));
+  EXPECT_TRUE(regex_set.add(CompiledGoogleReMatcher("/foo/[a-z]+", false)));
+  EXPECT_TRUE(regex_set.add(CompiledGoogleReMatcher("/.*", false)));
+  EXPECT_EQ(4, regex_set.size());
+  ASSERT_TRUE(regex_set.compile());
+
+  std::vector<int> matches;
+  EXPECT_TRUE(regex_set.findMatches("/foo/bar", matches));
+  EXPECT_EQ(std::vector<int>({0, 2, 3}), matches);
+  EXPECT_TRUE(regex_set.findMatches("/foo/1", matches));
+  EXPECT_EQ(std::vector<int>({0, 3}), matches);
+  // Regexes must match the whole value.
+  EXPECT_TRUE(regex_set.findMatches("/barbaz", matches));
+  EXPECT_EQ(std::vector<int>({3}), matches);
+  EXPECT_TRUE(regex_set.findMatches("foo", matches));
+  EXPECT_EQ(std::vector<int>(), matches);
+
+  EXPECT_EQ(true, regex_set.matchesAny("/bar"));
+  EXPECT_EQ(false, regex_set.matchesAny("bar"));
+}
+
+TEST(CompiledGoogleReSet, OnlyGoogleReMatchers) {
+  CompiledGoogleReSet regex_set;
+  EXPECT_FALSE(regex_set.add(StdRegexMatcher("/foo")));
+  EXPECT_TRUE(regex_set.add(CompiledGoogleReMatcher("/foo", false)));
+  EXPECT_EQ(1, regex_set.size());
+  ASSERT_TRUE(regex_set.compile());
+  EXPECT_EQ(true, regex_set.matchesAny("/foo"));
+}
+
 } // namespace
 } // namespace Regex
 } // namespace Envoy
@@ -246,6 +246,20 @@ TEST_F(ThreadAsyncPtrTest, NameNotSpecifiedWait) {
   thread->join();
 }
 
+// Workers get a slot of their own whichever thread first uses the slots, and all other threads
+// share slot 0.
+TEST(WorkerIndexTest, Slot) {
+  EXPECT_EQ(0, WorkerIndex::slot(4));
+  auto thread = threadFactoryForTest().createThread([]() {
+    EXPECT_EQ(0, WorkerIndex::slot(4));
+    WorkerIndex::set(1);
+    EXPECT_EQ(2, WorkerIndex::slot(4));
+    EXPECT_EQ(0, WorkerIndex::slot(2));
+  });
+  thread->join();
+  EXPECT_EQ(0, WorkerIndex::slot(4));
+}
+
 } // namespace
 } // namespace Thread
 } // namespace Envoy
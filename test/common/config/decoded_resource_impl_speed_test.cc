@@ -0,0 +1,87 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "envoy/config/route/v3/route.pb.h"
+#include "envoy/config/route/v3/route.pb.validate.h"
+
+#include "source/common/config/decoded_resource_impl.h"
+#include "source/common/config/opaque_resource_decoder_impl.h"
+#include "source/common/memory/stats.h"
+#include "source/common/protobuf/message_validator_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/test_common/test_runtime.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Config {
+namespace {
+
+constexpr int RouteConfigurations = 10;
+constexpr int RoutesPerVirtualHost = 100;
+
+// The resources of an RDS response with the given number of routes in total.
+Protobuf::RepeatedPtrField<ProtobufWkt::Any> routeConfigurations(int num_routes) {
+  Protobuf::RepeatedPtrField<ProtobufWkt::Any> resources;
+  for (int i = 0; i < RouteConfigurations; i++) {
+    envoy::config::route::v3::RouteConfiguration route_config;
+    route_config.set_name(absl::StrCat("route_config_", i));
+    for (int j = 0; j < num_routes / RouteConfigurations; j++) {
+      if (j % RoutesPerVirtualHost == 0) {
+        auto* virtual_host = route_config.add_virtual_hosts();
+        virtual_host->set_name(absl::StrCat("virtual_host_", j));
+        virtual_host->add_domains(absl::StrCat("www", j, ".example.com"));
+      }
+      auto* route = route_config.mutable_virtual_hosts()->rbegin()->add_routes();
+      route->mutable_match()->set_prefix(absl::StrCat("/service_", j, "/"));
+      auto* header = route->mutable_match()->add_headers();
+      header->set_name("x-tenant");
+      header->mutable_string_match()->set_exact(absl::StrCat("tenant_", j));
+      route->mutable_route()->set_cluster(absl::StrCat("cluster_", j));
+      route->mutable_route()->mutable_timeout()->set_seconds(15);
+      route->mutable_route()->mutable_retry_policy()->set_retry_on("5xx");
+      auto* header_to_add = route->add_request_headers_to_add()->mutable_header();
+      header_to_add->set_key("x-route");
+      header_to_add->set_value(absl::StrCat("route_", j));
+    }
+    resources.Add()->PackFrom(route_config);
+  }
+  return resources;
+}
+
+// Decodes the resources of an RDS response onto the heap, or into an arena. The memory counter
+// is what the decoded resources take up, which is only measured when built with tcmalloc.
+void bmDecodeRouteConfigurations(benchmark::State& state) {
+  const int num_routes = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && num_routes > 10000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.xds_arena_decoding", state.range(1) ? "true" : "false"}});
+  const Protobuf::RepeatedPtrField<ProtobufWkt::Any> resources = routeConfigurations(num_routes);
+  ProtobufMessage::StrictValidationVisitorImpl validation_visitor;
+  OpaqueResourceDecoderImpl<envoy::config::route::v3::RouteConfiguration> resource_decoder(
+      validation_visitor, "name");
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+    DecodedResourcesWrapper decoded_resources(resource_decoder, resources, "1");
+    state.PauseTiming();
+    state.counters["memory"] = Memory::Stats::totalCurrentlyAllocated() - start_mem;
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(bmDecodeRouteConfigurations)
+    ->Args({1000, 0})
+    ->Args({1000, 1})
+    ->Args({100000, 0})
+    ->Args({100000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace Config
+} // namespace Envoy
@@ -1,10 +1,13 @@
 #include "source/common/config/decoded_resource_impl.h"
 
 #include "test/mocks/config/mocks.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
 
+using ::testing::_;
+using ::testing::Invoke;
 using ::testing::InvokeWithoutArgs;
 using ::testing::Return;
 
@@ -150,6 +153,38 @@ TEST(DecodedResourceImplTest, All) {
   }
 }
 
+TEST(DecodedResourceImplTest, Arena) {
+  TestScopedRuntime scoped_runtime;
+  EXPECT_EQ(nullptr, DecodedResourceImpl::createArena());
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.xds_arena_decoding", "true"}});
+  ArenaSharedPtr arena = DecodedResourceImpl::createArena();
+  ASSERT_NE(nullptr, arena);
+
+  MockOpaqueResourceDecoder resource_decoder;
+  ProtobufWkt::StringValue value;
+  value.set_value("some_value");
+  envoy::service::discovery::v3::Resource resource_wrapper;
+  resource_wrapper.set_name("real_name");
+  resource_wrapper.mutable_resource()->PackFrom(value);
+  ProtobufWkt::Any resource_any;
+  resource_any.PackFrom(resource_wrapper);
+  EXPECT_CALL(resource_decoder, decodeResource(ProtoEq(resource_wrapper.resource()), _))
+      .WillOnce(Invoke([](const ProtobufWkt::Any& resource, Protobuf::Arena& arena) {
+        auto* message = Protobuf::Arena::Create<ProtobufWkt::StringValue>(&arena);
+        MessageUtil::unpackTo(resource, *message);
+        return message;
+      }));
+  DecodedResourceImplPtr decoded_resource =
+      DecodedResourceImpl::fromResource(resource_decoder, resource_any, "1", arena);
+  EXPECT_EQ(arena.get(), decoded_resource->resource().GetArena());
+
+  // The resource keeps its arena alive.
+  arena.reset();
+  EXPECT_EQ("real_name", decoded_resource->name());
+  EXPECT_EQ("1", decoded_resource->version());
+  EXPECT_THAT(decoded_resource->resource(), ProtoEq(value));
+}
+
 } // namespace
 } // namespace Config
 } // namespace Envoy
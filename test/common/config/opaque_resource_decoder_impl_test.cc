@@ -77,6 +77,25 @@ TEST_F(OpaqueResourceDecoderImplTest, Success) {
   EXPECT_EQ("foo", result.second);
 }
 
+// Decoding into an arena.
+TEST_F(OpaqueResourceDecoderImplTest, Arena) {
+  envoy::config::endpoint::v3::ClusterLoadAssignment cluster_resource;
+  cluster_resource.set_cluster_name("foo");
+  cluster_resource.add_endpoints()->set_priority(1);
+  ProtobufWkt::Any opaque_resource;
+  opaque_resource.PackFrom(cluster_resource);
+  Protobuf::Arena arena;
+  const Protobuf::Message* decoded_resource =
+      resource_decoder_.decodeResource(opaque_resource, arena);
+  EXPECT_EQ(&arena, decoded_resource->GetArena());
+  EXPECT_THAT(*decoded_resource, ProtoEq(cluster_resource));
+  EXPECT_EQ("foo", resource_decoder_.resourceName(*decoded_resource));
+
+  envoy::config::endpoint::v3::ClusterLoadAssignment invalid_resource;
+  opaque_resource.PackFrom(invalid_resource);
+  EXPECT_THROW(resource_decoder_.decodeResource(opaque_resource, arena), ProtoValidationException);
+}
+
 } // namespace
 } // namespace Config
 } // namespace Envoy
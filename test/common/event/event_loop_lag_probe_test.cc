@@ -0,0 +1,87 @@
+#include <chrono>
+
+#include "source/common/event/event_loop_lag_probe.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+using testing::_;
+using testing::NiceMock;
+
+class EventLoopLagProbeTest : public testing::Test {
+protected:
+  SimulatedTimeSystem time_system_;
+  NiceMock<MockDispatcher> dispatcher_;
+};
+
+TEST_F(EventLoopLagProbeTest, MeasuresLateProbes) {
+  auto* timer = new MockTimer(&dispatcher_);
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(100), _)).Times(3);
+  EventLoopLagProbeSharedPtr probe =
+      EventLoopLagProbe::acquire(dispatcher_, std::chrono::milliseconds(100));
+  EXPECT_EQ(std::chrono::nanoseconds(0), probe->lag(time_system_.monotonicTime()));
+
+  // The probe runs 50ms late.
+  time_system_.advanceTimeWait(std::chrono::milliseconds(150));
+  timer->invokeCallback();
+  EXPECT_EQ(std::chrono::milliseconds(50), probe->lag(time_system_.monotonicTime()));
+
+  // The lag of the late probe holds until the next one, which runs on time.
+  time_system_.advanceTimeWait(std::chrono::milliseconds(100));
+  EXPECT_EQ(std::chrono::milliseconds(50), probe->lag(time_system_.monotonicTime()));
+  timer->invokeCallback();
+  EXPECT_EQ(std::chrono::nanoseconds(0), probe->lag(time_system_.monotonicTime()));
+}
+
+// A stalled event loop lags by at least as long as its probe is overdue.
+TEST_F(EventLoopLagProbeTest, MeasuresOverdueProbes) {
+  auto* timer = new NiceMock<MockTimer>(&dispatcher_);
+  EventLoopLagProbeSharedPtr probe =
+      EventLoopLagProbe::acquire(dispatcher_, std::chrono::milliseconds(100));
+
+  time_system_.advanceTimeWait(std::chrono::milliseconds(400));
+  EXPECT_EQ(std::chrono::milliseconds(300), probe->lag(time_system_.monotonicTime()));
+  timer->invokeCallback();
+  EXPECT_EQ(std::chrono::milliseconds(300), probe->lag(time_system_.monotonicTime()));
+}
+
+// A dispatcher is probed by one timer, at the shortest interval that its probe was acquired with.
+TEST_F(EventLoopLagProbeTest, SharedPerDispatcher) {
+  auto* timer = new MockTimer(&dispatcher_);
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(100), _));
+  EventLoopLagProbeSharedPtr probe1 =
+      EventLoopLagProbe::acquire(dispatcher_, std::chrono::milliseconds(100));
+  EventLoopLagProbeSharedPtr probe2 =
+      EventLoopLagProbe::acquire(dispatcher_, std::chrono::milliseconds(50));
+  EXPECT_EQ(probe1, probe2);
+
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(50), _));
+  time_system_.advanceTimeWait(std::chrono::milliseconds(100));
+  timer->invokeCallback();
+
+  // Once released, the dispatcher gets a new probe.
+  bool timer_destroyed = false;
+  timer->timer_destroyed_ = &timer_destroyed;
+  probe1.reset();
+  EXPECT_FALSE(timer_destroyed);
+  probe2.reset();
+  EXPECT_TRUE(timer_destroyed);
+
+  auto* new_timer = new NiceMock<MockTimer>(&dispatcher_);
+  EventLoopLagProbeSharedPtr probe3 =
+      EventLoopLagProbe::acquire(dispatcher_, std::chrono::milliseconds(100));
+  EXPECT_CALL(*new_timer, enableTimer(std::chrono::milliseconds(100), _));
+  time_system_.advanceTimeWait(std::chrono::milliseconds(100));
+  new_timer->invokeCallback();
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
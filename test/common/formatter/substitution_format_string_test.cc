@@ -7,6 +7,7 @@
 #include "test/mocks/server/factory_context.h"
 #include "test/mocks/stream_info/mocks.h"
 #include "test/test_common/registry.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -77,6 +78,33 @@ TEST_F(SubstitutionFormatStringUtilsTest, TestFromProtoConfigJson) {
   EXPECT_TRUE(TestUtility::jsonStringEqual(out_json, expected));
 }
 
+TEST_F(SubstitutionFormatStringUtilsTest, TestFromProtoConfigCompiledJson) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.compiled_json_access_log_formatter", "true"}});
+
+  const std::string yaml = R"EOF(
+  json_format:
+    text: "plain text"
+    path: "%REQ(:path)%"
+    code: "%RESPONSE_CODE%"
+    headers:
+      content-type: "%REQ(CONTENT-TYPE)%"
+)EOF";
+  TestUtility::loadFromYaml(yaml, config_);
+
+  auto formatter = SubstitutionFormatStringUtils::fromProtoConfig(config_, context_);
+  EXPECT_NE(nullptr, dynamic_cast<CompiledJsonFormatterImpl*>(formatter.get()));
+  EXPECT_EQ("{\"code\":200,\"headers\":{\"content-type\":\"application/json\"},"
+            "\"path\":\"/bar/foo\",\"text\":\"plain text\"}\n",
+            formatter->formatWithContext(formatter_context_, stream_info_));
+
+  // Empty values can only be omitted by the formatter building a Struct.
+  config_.set_omit_empty_values(true);
+  formatter = SubstitutionFormatStringUtils::fromProtoConfig(config_, context_);
+  EXPECT_EQ(nullptr, dynamic_cast<CompiledJsonFormatterImpl*>(formatter.get()));
+}
+
 TEST_F(SubstitutionFormatStringUtilsTest, TestInvalidConfigs) {
   const std::vector<std::string> invalid_configs = {
       R"(
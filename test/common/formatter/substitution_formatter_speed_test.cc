@@ -28,6 +28,24 @@ std::unique_ptr<Envoy::Formatter::JsonFormatterImpl> makeJsonFormatter(bool type
   return std::make_unique<Envoy::Formatter::JsonFormatterImpl>(JsonLogFormat, typed, false, false);
 }
 
+std::unique_ptr<Envoy::Formatter::CompiledJsonFormatterImpl> makeCompiledJsonFormatter(bool typed) {
+  ProtobufWkt::Struct JsonLogFormat;
+  const std::string format_yaml = R"EOF(
+    remote_address: '%DOWNSTREAM_REMOTE_ADDRESS_WITHOUT_PORT%'
+    start_time: '%START_TIME(%Y/%m/%dT%H:%M:%S%z %s)%'
+    method: '%REQ(:METHOD)%'
+    url: '%REQ(X-FORWARDED-PROTO)%://%REQ(:AUTHORITY)%%REQ(X-ENVOY-ORIGINAL-PATH?:PATH)%'
+    protocol: '%PROTOCOL%'
+    response_code: '%RESPONSE_CODE%'
+    bytes_sent: '%BYTES_SENT%'
+    duration: '%DURATION%'
+    referer: '%REQ(REFERER)%'
+    user-agent: '%REQ(USER-AGENT)%'
+  )EOF";
+  TestUtility::loadFromYaml(format_yaml, JsonLogFormat);
+  return std::make_unique<Envoy::Formatter::CompiledJsonFormatterImpl>(JsonLogFormat, typed);
+}
+
 std::unique_ptr<Envoy::Formatter::StructFormatter> makeStructFormatter(bool typed) {
   ProtobufWkt::Struct StructLogFormat;
   const std::string format_yaml = R"EOF(
@@ -93,6 +111,31 @@ static void BM_AccessLogFormatter(benchmark::State& state) {
 }
 BENCHMARK(BM_AccessLogFormatter);
 
+// Measures formatting a line whose fields are separated by long literals, which are all merged
+// with the literal preceding them.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_AccessLogFormatterLiterals(benchmark::State& state) {
+  MockTimeSystem time_system;
+  std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo(time_system);
+  static const char* LogFormat =
+      "remote_address=\"%DOWNSTREAM_REMOTE_ADDRESS_WITHOUT_PORT%\" "
+      "start_time=\"%START_TIME(%Y/%m/%dT%H:%M:%S%z %s)%\" method=\"%REQ(:METHOD)%\" "
+      "url=\"%REQ(X-FORWARDED-PROTO)%://%REQ(:AUTHORITY)%%REQ(X-ENVOY-ORIGINAL-PATH?:PATH)%\" "
+      "protocol=\"%PROTOCOL%\" response_code=\"%RESPONSE_CODE%\" bytes_sent=\"%BYTES_SENT%\" "
+      "duration=\"%DURATION%\" referer=\"%REQ(REFERER)%\" user_agent=\"%REQ(USER-AGENT)%\" "
+      "100%% done\n";
+
+  std::unique_ptr<Envoy::Formatter::FormatterImpl> formatter =
+      std::make_unique<Envoy::Formatter::FormatterImpl>(LogFormat, false);
+
+  size_t output_bytes = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    output_bytes += formatter->formatWithContext({}, *stream_info).length();
+  }
+  benchmark::DoNotOptimize(output_bytes);
+}
+BENCHMARK(BM_AccessLogFormatterLiterals);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void BM_StructAccessLogFormatter(benchmark::State& state) {
   MockTimeSystem time_system;
@@ -151,6 +194,36 @@ static void BM_TypedJsonAccessLogFormatter(benchmark::State& state) {
 }
 BENCHMARK(BM_TypedJsonAccessLogFormatter);
 
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_CompiledJsonAccessLogFormatter(benchmark::State& state) {
+  MockTimeSystem time_system;
+  std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo(time_system);
+  std::unique_ptr<Envoy::Formatter::CompiledJsonFormatterImpl> json_formatter =
+      makeCompiledJsonFormatter(false);
+
+  size_t output_bytes = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    output_bytes += json_formatter->formatWithContext({}, *stream_info).length();
+  }
+  benchmark::DoNotOptimize(output_bytes);
+}
+BENCHMARK(BM_CompiledJsonAccessLogFormatter);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_TypedCompiledJsonAccessLogFormatter(benchmark::State& state) {
+  MockTimeSystem time_system;
+  std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo(time_system);
+  std::unique_ptr<Envoy::Formatter::CompiledJsonFormatterImpl> typed_json_formatter =
+      makeCompiledJsonFormatter(true);
+
+  size_t output_bytes = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    output_bytes += typed_json_formatter->formatWithContext({}, *stream_info).length();
+  }
+  benchmark::DoNotOptimize(output_bytes);
+}
+BENCHMARK(BM_TypedCompiledJsonAccessLogFormatter);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void BM_FormatterCommandParsing(benchmark::State& state) {
   const std::string token = "Listener:namespace:key";
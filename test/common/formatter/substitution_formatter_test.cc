@@ -3784,6 +3784,84 @@ TEST(SubstitutionFormatterTest, JsonFormatterWithOrderedPropertiesTest) {
   EXPECT_EQ(out_json, expected);
 }
 
+TEST(SubstitutionFormatterTest, CompiledJsonFormatterTest) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{"quoted", "\"val\tue\""}};
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body;
+
+  HttpFormatterContext formatter_context(&request_header, &response_header, &response_trailer,
+                                         body);
+
+  absl::optional<Http::Protocol> protocol = Http::Protocol::Http11;
+  EXPECT_CALL(stream_info, protocol()).WillRepeatedly(Return(protocol));
+  MockTimeSystem time_system;
+  EXPECT_CALL(time_system, monotonicTime)
+      .WillOnce(Return(MonotonicTime(std::chrono::nanoseconds(5000000))));
+  stream_info.downstream_timing_.onLastDownstreamRxByteReceived(time_system);
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    request_duration: '%REQUEST_DURATION%'
+    number: 3.5
+    missing: '%REQ(missing)%'
+    multi_token: 'protocol="%PROTOCOL%" quoted=%REQ(quoted)% missing=%REQ(missing)%'
+    nested_level:
+      plain_string: plain_string_value
+      escaped: "tab\tquote\"%%"
+      list: ['%PROTOCOL%', 1, '']
+  )EOF",
+                            key_mapping);
+  CompiledJsonFormatterImpl formatter(key_mapping, false);
+
+  const std::string expected =
+      "{\"missing\":\"-\",\"multi_token\":\"protocol=\\\"HTTP/1.1\\\" quoted=\\\"val\\tue\\\" "
+      "missing=-\",\"nested_level\":{\"escaped\":\"tab\\tquote\\\"%\",\"list\":[\"HTTP/1.1\","
+      "\"1\",\"\"],\"plain_string\":\"plain_string_value\"},\"number\":\"3.5\","
+      "\"request_duration\":\"5\"}\n";
+
+  // Check string equality to verify the order and the escaping.
+  EXPECT_EQ(expected, formatter.formatWithContext(formatter_context, stream_info));
+}
+
+TEST(SubstitutionFormatterTest, CompiledJsonFormatterTypedTest) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestRequestHeaderMapImpl request_header;
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body;
+
+  HttpFormatterContext formatter_context(&request_header, &response_header, &response_trailer,
+                                         body);
+
+  envoy::config::core::v3::Metadata metadata;
+  populateMetadataTestData(metadata);
+  EXPECT_CALL(stream_info, dynamicMetadata()).WillRepeatedly(ReturnRef(metadata));
+  EXPECT_CALL(Const(stream_info), dynamicMetadata()).WillRepeatedly(ReturnRef(metadata));
+  MockTimeSystem time_system;
+  EXPECT_CALL(time_system, monotonicTime)
+      .WillOnce(Return(MonotonicTime(std::chrono::nanoseconds(5000000))));
+  stream_info.downstream_timing_.onLastDownstreamRxByteReceived(time_system);
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    request_duration: '%REQUEST_DURATION%'
+    number: 3.5
+    missing: '%REQ(missing)%'
+    multi_token: 'duration=%REQUEST_DURATION%'
+    metadata: '%DYNAMIC_METADATA(com.test)%'
+  )EOF",
+                            key_mapping);
+  CompiledJsonFormatterImpl formatter(key_mapping, true);
+
+  const std::string expected =
+      "{\"metadata\":{\"test_key\":\"test_value\",\"test_obj\":{\"inner_key\":\"inner_value\"}},"
+      "\"missing\":null,\"multi_token\":\"duration=5\",\"number\":3.5,\"request_duration\":5}\n";
+
+  EXPECT_EQ(expected, formatter.formatWithContext(formatter_context, stream_info));
+}
+
 TEST(SubstitutionFormatterTest, CompositeFormatterSuccess) {
   Http::TestRequestHeaderMapImpl request_header{{"first", "GET"}, {":path", "/"}};
   Http::TestResponseHeaderMapImpl response_header{{"second", "PUT"}, {"test", "test"}};
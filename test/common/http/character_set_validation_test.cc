@@ -1,3 +1,6 @@
+#include <string>
+#include <vector>
+
 #include "source/common/http/character_set_validation.h"
 
 #include "gtest/gtest.h"
@@ -33,5 +36,58 @@ TEST(CharacterSetValidationTest, Test) {
   }
 }
 
+TEST(CharacterSetValidationTest, CharTableScanner) {
+  // Tables with none, all and some of the extended ASCII characters, the last of which aren't
+  // tested with vector instructions.
+  constexpr std::array<uint32_t, 8> kAllExtendedCharTable = {
+      0b00000000010000000000000000000000, 0b11111111111111111111111111111111,
+      0b11111111111111111111111111111111, 0b11111111111111111111111111111110,
+      0b11111111111111111111111111111111, 0b11111111111111111111111111111111,
+      0b11111111111111111111111111111111, 0b11111111111111111111111111111111,
+  };
+  constexpr std::array<uint32_t, 8> kSomeExtendedCharTable = {
+      0b00000000000000000000000000000000, 0b01011111001101101111111111000000,
+      0b01111111111111111111111111100011, 0b11111111111111111111111111101010,
+      0b11110000000000000000000000000000, 0b00000000000000000000000000000000,
+      0b00000000000000000000000000000000, 0b00000000000000000000000000000001,
+  };
+  const std::vector<std::array<uint32_t, 8>> tables = {
+      kGenericHeaderNameCharTable, kUriQueryAndFragmentCharTable, kAllExtendedCharTable,
+      kSomeExtendedCharTable};
+
+  for (const auto& table : tables) {
+    const CharTableScanner scanner(table);
+    std::string valid_chars;
+    std::string invalid_chars;
+    for (unsigned c = 0; c < 256; ++c) {
+      (testCharInTable(table, c) ? valid_chars : invalid_chars).push_back(c);
+    }
+
+    // Place each invalid character at every position of strings of lengths that exercise both the
+    // vectorized and scalar scans.
+    for (size_t length = 0; length <= 80; ++length) {
+      std::string value;
+      for (size_t i = 0; i < length; ++i) {
+        value.push_back(valid_chars[(i * 7) % valid_chars.size()]);
+      }
+      EXPECT_EQ(length, scanner.findFirstNotInTable(value));
+      EXPECT_TRUE(scanner.allInTable(value));
+
+      for (size_t position = 0; position < length; ++position) {
+        for (const char invalid_char : invalid_chars) {
+          std::string invalid_value = value;
+          invalid_value[position] = invalid_char;
+          // A second invalid character must not change the result.
+          if (position + 1 < length) {
+            invalid_value[length - 1] = invalid_chars[0];
+          }
+          ASSERT_EQ(position, scanner.findFirstNotInTable(invalid_value));
+          ASSERT_FALSE(scanner.allInTable(invalid_value));
+        }
+      }
+    }
+  }
+}
+
 } // namespace Http
 } // namespace Envoy
@@ -330,6 +330,39 @@ TEST(HeaderMapImplTest, RemovePrefix) {
   EXPECT_EQ(nullptr, headers.ContentLength());
 }
 
+// Headers are allocated from a pool owned by the map, which reuses the memory of removed headers.
+TEST(HeaderMapImplTest, ReuseRemovedHeaders) {
+  TestRequestHeaderMapImpl headers;
+  for (int round = 0; round < 3; round++) {
+    for (int i = 0; i < 100; i++) {
+      headers.addCopy(LowerCaseString(absl::StrCat("x-header-", i)), absl::StrCat("value-", i));
+    }
+    headers.setPath("/");
+    headers.setContentLength(round);
+    EXPECT_EQ(102UL, headers.size());
+
+    // Remove every other header, then add them back in a different order.
+    EXPECT_EQ(50UL, headers.removeIf([](const HeaderEntry& entry) -> bool {
+      const absl::string_view value = entry.value().getStringView();
+      return absl::StartsWith(entry.key().getStringView(), "x-header-") &&
+             (value.back() - '0') % 2 == 0;
+    }));
+    for (int i = 98; i >= 0; i -= 2) {
+      headers.addCopy(LowerCaseString(absl::StrCat("x-header-", i)), absl::StrCat("value-", i));
+    }
+    EXPECT_EQ(102UL, headers.size());
+    for (int i = 0; i < 100; i++) {
+      EXPECT_EQ(absl::StrCat("value-", i),
+                headers.get_(LowerCaseString(absl::StrCat("x-header-", i))));
+    }
+    EXPECT_EQ("/", headers.getPathValue());
+    EXPECT_EQ(absl::StrCat(round), headers.getContentLengthValue());
+
+    headers.clear();
+    EXPECT_TRUE(headers.empty());
+  }
+}
+
 class HeaderAndValueCb
     : public testing::MockFunction<void(const std::string&, const std::string&)> {
 public:
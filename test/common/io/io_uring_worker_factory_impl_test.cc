@@ -0,0 +1,55 @@
+#include "source/common/io/io_uring_impl.h"
+#include "source/common/io/io_uring_worker_factory_impl.h"
+
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Io {
+namespace {
+
+class IoUringWorkerFactoryImplTest : public ::testing::Test {
+public:
+  IoUringWorkerFactoryImplTest()
+      : api_(Api::createApiForTest()), should_skip_(!isIoUringSupported()) {
+    if (!should_skip_) {
+      dispatcher_ = api_->allocateDispatcher("test_thread");
+      tls_.setDispatcher(dispatcher_.get());
+    }
+  }
+
+  void SetUp() override {
+    if (should_skip_) {
+      GTEST_SKIP();
+    }
+  }
+
+  Api::ApiPtr api_;
+  testing::NiceMock<ThreadLocal::MockInstance> tls_;
+  Event::DispatcherPtr dispatcher_;
+  const bool should_skip_{};
+};
+
+TEST_F(IoUringWorkerFactoryImplTest, Basic) {
+  IoUringWorkerFactoryImpl factory(2, false, 8192, 1000, tls_);
+  EXPECT_TRUE(factory.currentThreadRegistered());
+
+  factory.onServerInitialized();
+  OptRef<IoUringWorker> worker = factory.getIoUringWorker();
+  ASSERT_TRUE(worker.has_value());
+  EXPECT_EQ(dispatcher_.get(), &worker->dispatcher());
+  EXPECT_EQ(0, worker->getNumOfSockets());
+}
+
+TEST_F(IoUringWorkerFactoryImplTest, CurrentThreadNotRegistered) {
+  IoUringWorkerFactoryImpl factory(2, false, 8192, 1000, tls_);
+  tls_.registered_ = false;
+  EXPECT_FALSE(factory.currentThreadRegistered());
+}
+
+} // namespace
+} // namespace Io
+} // namespace Envoy
@@ -3,8 +3,10 @@
 #include "source/common/io/io_uring_worker_impl.h"
 #include "source/common/network/address_impl.h"
 
+#include "test/mocks/api/mocks.h"
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/io/mocks.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
@@ -114,6 +116,16 @@ TEST(IoUringWorkerImplTest, SubmitRequestsFailed) {
   EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
   delete worker.submitShutdownRequest(io_uring_socket, SHUT_WR);
 
+  EXPECT_CALL(mock_io_uring, prepareAccept(fd, _, _, _))
+      .WillOnce(Return<IoUringResult>(IoUringResult::Ok))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, prepareAccept(fd, _, _, _))
+      .WillOnce(Return<IoUringResult>(IoUringResult::Failed))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  delete worker.submitAcceptRequest(io_uring_socket);
+
   EXPECT_EQ(fd, io_uring_socket.fd());
   EXPECT_EQ(1, worker.getSockets().size());
   EXPECT_CALL(mock_io_uring, removeInjectedCompletion(fd));
@@ -684,6 +696,142 @@ TEST(IoUringWorkerImplTest, NoEnableReadOnConnectError) {
   delete static_cast<Request*>(connect_req);
 }
 
+TEST(IoUringWorkerImplTest, AcceptSocketDeliverAcceptedSocket) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(dispatcher, createFileEvent_(_, _, Event::PlatformDefaultTriggerType,
+                                           Event::FileReadyType::Read));
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher);
+
+  IoUringSocket* socket_ptr = nullptr;
+  uint32_t accepted = 0;
+  IoUringAcceptSocket socket(
+      0, worker,
+      [&socket_ptr, &accepted](uint32_t events) {
+        EXPECT_EQ(events, Event::FileReadyType::Read);
+        const OptRef<AcceptedSocketParam>& param = socket_ptr->getAcceptedSocketParam();
+        ASSERT_TRUE(param.has_value());
+        EXPECT_EQ(10, param->fd_);
+        // Take over the accepted socket.
+        SET_SOCKET_INVALID(param->fd_);
+        accepted++;
+      },
+      false);
+  socket_ptr = &socket;
+
+  Request* accept_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareAccept(0, _, _, _))
+      .WillOnce(DoAll(SaveArg<3>(&accept_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit());
+  socket.enableRead();
+
+  // The next accept request is submitted after the socket is delivered.
+  Request* accept_req2 = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareAccept(0, _, _, _))
+      .WillOnce(DoAll(SaveArg<3>(&accept_req2), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit());
+  socket.onAccept(accept_req, 10, false);
+  EXPECT_EQ(1, accepted);
+  EXPECT_FALSE(socket.getAcceptedSocketParam().has_value());
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  delete accept_req;
+  delete accept_req2;
+}
+
+TEST(IoUringWorkerImplTest, AcceptSocketKeepAcceptedSocketWhenReadDisabled) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(ReturnNew<NiceMock<Event::MockFileEvent>>());
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher);
+
+  IoUringSocket* socket_ptr = nullptr;
+  uint32_t accepted = 0;
+  IoUringAcceptSocket socket(
+      0, worker,
+      [&socket_ptr, &accepted](uint32_t) {
+        SET_SOCKET_INVALID(socket_ptr->getAcceptedSocketParam()->fd_);
+        accepted++;
+      },
+      false);
+  socket_ptr = &socket;
+
+  Request* accept_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareAccept(0, _, _, _))
+      .WillOnce(DoAll(SaveArg<3>(&accept_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit());
+  socket.enableRead();
+  socket.disableRead();
+
+  // The accepted socket is kept and no more accept request is submitted.
+  socket.onAccept(accept_req, 10, false);
+  EXPECT_EQ(0, accepted);
+
+  // The kept socket is delivered through an injected completion once the socket is read enabled.
+  Request* injected_req = nullptr;
+  EXPECT_CALL(mock_io_uring, injectCompletion(0, _, -EAGAIN)).WillOnce(SaveArg<1>(&injected_req));
+  Request* accept_req2 = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareAccept(0, _, _, _))
+      .WillOnce(DoAll(SaveArg<3>(&accept_req2), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit());
+  socket.enableRead();
+  socket.onAccept(injected_req, -EAGAIN, true);
+  EXPECT_EQ(1, accepted);
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  delete accept_req;
+  delete accept_req2;
+  delete injected_req;
+}
+
+TEST(IoUringWorkerImplTest, AcceptSocketCloseWithAcceptRequest) {
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(dispatcher, createFileEvent_(_, _, Event::PlatformDefaultTriggerType,
+                                           Event::FileReadyType::Read));
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher);
+  IoUringAcceptSocket socket(
+      0, worker, [](uint32_t) { FAIL(); }, false);
+
+  Request* accept_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareAccept(0, _, _, _))
+      .WillOnce(DoAll(SaveArg<3>(&accept_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit());
+  socket.enableRead();
+
+  // The in flight accept request is cancelled on closing.
+  Request* cancel_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareCancel(accept_req, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit());
+  socket.close(false);
+  socket.onCancel(cancel_req, 0, false);
+
+  // The socket accepted before the cancellation is closed since nobody takes it over, then the
+  // close request is submitted.
+  EXPECT_CALL(os_sys_calls, close(10));
+  Request* close_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareClose(0, _))
+      .WillOnce(DoAll(SaveArg<1>(&close_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit());
+  socket.onAccept(accept_req, 10, false);
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  delete accept_req;
+  delete cancel_req;
+  delete close_req;
+}
+
 } // namespace
 } // namespace Io
 } // namespace Envoy
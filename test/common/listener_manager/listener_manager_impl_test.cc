@@ -1,5 +1,6 @@
 #include "test/common/listener_manager/listener_manager_impl_test.h"
 
+#include <array>
 #include <chrono>
 #include <memory>
 #include <string>
@@ -20,6 +21,7 @@
 #include "source/common/init/manager_impl.h"
 #include "source/common/network/address_impl.h"
 #include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/network/reuse_port_steering.h"
 #include "source/common/network/socket_interface_impl.h"
 #include "source/common/network/utility.h"
 #include "source/common/protobuf/protobuf.h"
@@ -31,6 +33,7 @@
 
 #include "test/common/listener_manager/config.pb.h"
 #include "test/common/listener_manager/config.pb.validate.h"
+#include "test/mocks/api/mocks.h"
 #include "test/mocks/init/mocks.h"
 #include "test/mocks/matcher/mocks.h"
 #include "test/server/utility.h"
@@ -41,6 +44,12 @@
 #include "absl/strings/escaping.h"
 #include "absl/strings/match.h"
 
+#if defined(__linux__)
+#include <linux/bpf.h>
+
+#include "source/common/api/os_sys_calls_impl_linux.h"
+#endif
+
 namespace Envoy {
 namespace Server {
 namespace {
@@ -998,6 +1007,9 @@ TEST_P(ListenerManagerImplTest, RejectTcpOptionsWithInternalListenerConfig) {
       [](envoy::config::listener::v3::Listener& l) {
         l.mutable_connection_balance_config()->mutable_exact_balance();
       },
+      [](envoy::config::listener::v3::Listener& l) {
+        l.mutable_connection_balance_config()->mutable_least_connections_balance();
+      },
       [](envoy::config::listener::v3::Listener& l) { l.mutable_enable_reuse_port(); },
       [](envoy::config::listener::v3::Listener& l) { l.mutable_freebind()->set_value(true); },
       [](envoy::config::listener::v3::Listener& l) { l.mutable_tcp_backlog_size(); },
@@ -6481,6 +6493,24 @@ TEST_P(ListenerManagerImplWithRealFiltersTest, MptcpOnUnixDomainSocket) {
                             "listener mptcp-udp: enable_mptcp can only be used with IP addresses");
 }
 
+TEST_P(ListenerManagerImplWithRealFiltersTest, ReusePortLoadBalancingOnUdp) {
+  envoy::config::listener::v3::Listener listener = parseListenerFromV3Yaml(R"EOF(
+      name: steered-udp
+      enable_reuse_port_load_balancing: true
+      address:
+        socket_address:
+          address: 127.0.0.1
+          port_value: 1111
+          protocol: UDP
+      filter_chains:
+      - filters: []
+        name: foo
+    )EOF");
+  EXPECT_THROW_WITH_MESSAGE(
+      addOrUpdateListener(listener), EnvoyException,
+      "listener steered-udp: enable_reuse_port_load_balancing can only be used with TCP listeners");
+}
+
 TEST_P(ListenerManagerImplWithRealFiltersTest, MptcpNotSupported) {
   envoy::config::listener::v3::Listener listener = parseListenerFromV3Yaml(R"EOF(
       name: mptcp-udp
@@ -8059,6 +8089,108 @@ TEST_P(ListenerManagerImplWithRealFiltersTest, EmptyConnectionBalanceConfig) {
 #endif
 }
 
+#ifdef __linux__
+class ListenerManagerImplReusePortSteeringTest : public ListenerManagerImplTest {
+public:
+  // Creates a factory of two reuse_port sockets with load balancing, whose steering is created
+  // with the given result of creating its first map.
+  std::unique_ptr<ListenSocketFactoryImpl> createFactory(Api::SysCallIntResult map_result) {
+    EXPECT_CALL(listener_factory_, createListenSocket(_, Network::Socket::Type::Stream, _,
+                                                      ListenerComponentFactory::BindType::ReusePort,
+                                                      _, _))
+        .WillOnce(Return(sockets_[0]))
+        .WillOnce(Return(sockets_[1]));
+    if (map_result.return_value_ < 0) {
+      EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_CREATE, _, _)).WillOnce(Return(map_result));
+    } else {
+      EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_CREATE, _, _))
+          .WillOnce(Return(map_result))
+          .WillOnce(Return(Api::SysCallIntResult{map_result.return_value_ + 1, 0}));
+      EXPECT_CALL(os_sys_calls_, mmap(_, _, _, _, map_result.return_value_, _))
+          .WillOnce(Return(Api::SysCallPtrResult{counts_.data(), 0}));
+      EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_PROG_LOAD, _, _))
+          .WillOnce(Return(Api::SysCallIntResult{map_result.return_value_ + 2, 0}));
+    }
+    return std::make_unique<ListenSocketFactoryImpl>(
+        listener_factory_, local_address_, Network::Socket::Type::Stream, nullptr, "foo", 128,
+        ListenerComponentFactory::BindType::ReusePort, Network::SocketCreationOptions{}, 2, true);
+  }
+
+  NiceMock<Api::MockLinuxOsSysCalls> linux_os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls_{&linux_os_sys_calls_};
+  std::vector<std::shared_ptr<NiceMock<Network::MockListenSocket>>> sockets_{
+      std::make_shared<NiceMock<Network::MockListenSocket>>(),
+      std::make_shared<NiceMock<Network::MockListenSocket>>()};
+  alignas(64) std::array<uint8_t, 2 * Network::ReusePortSteering::CountStride> counts_{};
+};
+
+TEST_P(ListenerManagerImplReusePortSteeringTest, AttachesSteeringAfterListening) {
+  auto factory = createFactory({10, 0});
+  EXPECT_TRUE(factory->socketLoad(0).has_value());
+  EXPECT_TRUE(factory->socketLoad(1).has_value());
+
+  // Each socket is added at the index of its worker before the program is attached to the group.
+  InSequence s;
+  for (uint32_t i = 0; i < sockets_.size(); i++) {
+    EXPECT_CALL(*sockets_[i]->io_handle_, listen(128));
+  }
+  for (uint32_t i = 0; i < sockets_.size(); i++) {
+    EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_UPDATE_ELEM, _, _))
+        .WillOnce(Invoke([i](int, void* attr, unsigned int) -> Api::SysCallIntResult {
+          const bpf_attr& update = *static_cast<bpf_attr*>(attr);
+          EXPECT_EQ(11, update.map_fd);
+          EXPECT_EQ(i, *reinterpret_cast<const uint32_t*>(update.key));
+          return {0, 0};
+        }));
+  }
+  EXPECT_CALL(*sockets_[0], setSocketOption(SOL_SOCKET, _, _, sizeof(int)))
+      .WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  factory->doFinalPreWorkerInit();
+  EXPECT_TRUE(factory->socketLoad(1).has_value());
+}
+
+TEST_P(ListenerManagerImplReusePortSteeringTest, FallsBackToHashingIfAttachFails) {
+  auto factory = createFactory({10, 0});
+  EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_UPDATE_ELEM, _, _))
+      .Times(2)
+      .WillRepeatedly(Return(Api::SysCallIntResult{0, 0}));
+  EXPECT_CALL(*sockets_[0], setSocketOption(SOL_SOCKET, _, _, sizeof(int)))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EPERM}));
+  factory->doFinalPreWorkerInit();
+  EXPECT_FALSE(factory->socketLoad(0).has_value());
+  EXPECT_FALSE(factory->socketLoad(1).has_value());
+}
+
+TEST_P(ListenerManagerImplReusePortSteeringTest, FallsBackToHashingIfAddingSocketFails) {
+  auto factory = createFactory({10, 0});
+  EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_UPDATE_ELEM, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EINVAL}));
+  EXPECT_CALL(*sockets_[0], setSocketOption(SOL_SOCKET, _, _, sizeof(int))).Times(0);
+  factory->doFinalPreWorkerInit();
+  EXPECT_FALSE(factory->socketLoad(0).has_value());
+}
+
+TEST_P(ListenerManagerImplReusePortSteeringTest, FallsBackToHashingIfBpfFails) {
+  auto factory = createFactory({-1, EPERM});
+  EXPECT_FALSE(factory->socketLoad(0).has_value());
+  EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_UPDATE_ELEM, _, _)).Times(0);
+  EXPECT_CALL(*sockets_[0], setSocketOption(SOL_SOCKET, _, _, sizeof(int))).Times(0);
+  factory->doFinalPreWorkerInit();
+  EXPECT_FALSE(factory->socketLoad(1).has_value());
+}
+
+// A clone shares the steering, and adds its duplicates of the sockets at the same indexes.
+TEST_P(ListenerManagerImplReusePortSteeringTest, CloneSharesSteering) {
+  auto factory = createFactory({10, 0});
+  auto clone = factory->clone();
+  EXPECT_TRUE(clone->socketLoad(1).has_value());
+  EXPECT_EQ(&factory->socketLoad(1).ref(), &clone->socketLoad(1).ref());
+}
+
+INSTANTIATE_TEST_SUITE_P(Matcher, ListenerManagerImplReusePortSteeringTest,
+                         ::testing::Values(false));
+#endif
+
 INSTANTIATE_TEST_SUITE_P(Matcher, ListenerManagerImplTest, ::testing::Values(false));
 INSTANTIATE_TEST_SUITE_P(Matcher, ListenerManagerImplWithRealFiltersTest,
                          ::testing::Values(false, true));
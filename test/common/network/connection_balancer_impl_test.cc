@@ -0,0 +1,207 @@
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "source/common/network/connection_balancer_impl.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+using testing::_;
+using testing::NiceMock;
+
+class FakeHandler : public BalancedConnectionHandler {
+public:
+  explicit FakeHandler(uint64_t connections = 0) : connections_(connections) {}
+
+  // Network::BalancedConnectionHandler
+  uint64_t numConnections() const override { return connections_; }
+  void incNumConnections() override { ++connections_; }
+  void post(ConnectionSocketPtr&&) override {}
+  Event::Dispatcher& dispatcher() override { return dispatcher_; }
+  void onAcceptWorker(ConnectionSocketPtr&&, bool, bool) override {}
+
+  std::atomic<uint64_t> connections_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+};
+
+class LeastConnectionsConnectionBalancerTest : public testing::Test {
+protected:
+  // Registers a handler whose lag probe timer is returned.
+  Event::MockTimer* registerProbedHandler(FakeHandler& handler) {
+    auto* timer = new Event::MockTimer(&handler.dispatcher_);
+    EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(100), _)).Times(testing::AnyNumber());
+    balancer_.registerHandler(handler);
+    return timer;
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  LeastConnectionsConnectionBalancerImpl balancer_{std::chrono::milliseconds(100),
+                                                   std::chrono::milliseconds(50), 0};
+};
+
+TEST(LeastConnectionsConnectionBalancerImplTest, PicksLeastConnections) {
+  LeastConnectionsConnectionBalancerImpl balancer(std::chrono::milliseconds(0),
+                                                  std::chrono::milliseconds(50), 0);
+  FakeHandler handler1(3);
+  FakeHandler handler2(1);
+  FakeHandler handler3(2);
+  balancer.registerHandler(handler1);
+  balancer.registerHandler(handler2);
+  balancer.registerHandler(handler3);
+
+  EXPECT_EQ(&handler2, &balancer.pickTargetHandler(handler1));
+  EXPECT_EQ(2, handler2.numConnections());
+  // Ties are kept by the accepting handler.
+  EXPECT_EQ(&handler3, &balancer.pickTargetHandler(handler3));
+  EXPECT_EQ(3, handler3.numConnections());
+  EXPECT_EQ(&handler2, &balancer.pickTargetHandler(handler3));
+  EXPECT_EQ(3, handler1.numConnections());
+  EXPECT_EQ(3, handler2.numConnections());
+
+  balancer.unregisterHandler(handler2);
+  balancer.unregisterHandler(handler3);
+  EXPECT_EQ(&handler1, &balancer.pickTargetHandler(handler1));
+  EXPECT_EQ(4, handler1.numConnections());
+  balancer.unregisterHandler(handler1);
+}
+
+TEST(LeastConnectionsConnectionBalancerImplTest, ImbalanceTolerance) {
+  LeastConnectionsConnectionBalancerImpl balancer(std::chrono::milliseconds(0),
+                                                  std::chrono::milliseconds(50), 2);
+  FakeHandler handler1(2);
+  FakeHandler handler2(0);
+  balancer.registerHandler(handler1);
+  balancer.registerHandler(handler2);
+
+  EXPECT_EQ(&handler1, &balancer.pickTargetHandler(handler1));
+  EXPECT_EQ(3, handler1.numConnections());
+  EXPECT_EQ(&handler2, &balancer.pickTargetHandler(handler1));
+  EXPECT_EQ(1, handler2.numConnections());
+
+  balancer.unregisterHandler(handler1);
+  balancer.unregisterHandler(handler2);
+}
+
+// Handlers which the balancer doesn't know of keep their connections.
+TEST(LeastConnectionsConnectionBalancerImplTest, UnregisteredHandler) {
+  LeastConnectionsConnectionBalancerImpl balancer(std::chrono::milliseconds(0),
+                                                  std::chrono::milliseconds(50), 0);
+  FakeHandler handler1(1);
+  FakeHandler handler2(0);
+  balancer.registerHandler(handler2);
+
+  EXPECT_EQ(&handler1, &balancer.pickTargetHandler(handler1));
+  EXPECT_EQ(2, handler1.numConnections());
+  balancer.unregisterHandler(handler2);
+}
+
+TEST_F(LeastConnectionsConnectionBalancerTest, PassesOverLaggingWorker) {
+  FakeHandler handler1(5);
+  FakeHandler handler2(0);
+  Event::MockTimer* timer1 = registerProbedHandler(handler1);
+  Event::MockTimer* timer2 = registerProbedHandler(handler2);
+
+  time_system_.advanceTimeWait(std::chrono::milliseconds(100));
+  timer1->invokeCallback();
+  timer2->invokeCallback();
+  EXPECT_EQ(&handler2, &balancer_.pickTargetHandler(handler1));
+
+  // The second worker's probe is overdue, but not by enough to pass it over.
+  time_system_.advanceTimeWait(std::chrono::milliseconds(120));
+  timer1->invokeCallback();
+  EXPECT_EQ(&handler2, &balancer_.pickTargetHandler(handler1));
+
+  // Until it is.
+  time_system_.advanceTimeWait(std::chrono::milliseconds(40));
+  EXPECT_EQ(&handler1, &balancer_.pickTargetHandler(handler1));
+  EXPECT_EQ(6, handler1.numConnections());
+
+  // The lag of its late probe holds until the next one.
+  timer2->invokeCallback();
+  EXPECT_EQ(&handler1, &balancer_.pickTargetHandler(handler1));
+  EXPECT_EQ(7, handler1.numConnections());
+
+  time_system_.advanceTimeWait(std::chrono::milliseconds(100));
+  timer1->invokeCallback();
+  timer2->invokeCallback();
+  EXPECT_EQ(&handler2, &balancer_.pickTargetHandler(handler1));
+  EXPECT_EQ(3, handler2.numConnections());
+
+  bool timer1_destroyed = false;
+  timer1->timer_destroyed_ = &timer1_destroyed;
+  balancer_.unregisterHandler(handler1);
+  EXPECT_TRUE(timer1_destroyed);
+  balancer_.unregisterHandler(handler2);
+}
+
+// When all workers lag, the lag is disregarded.
+TEST_F(LeastConnectionsConnectionBalancerTest, AllWorkersLagging) {
+  FakeHandler handler1(5);
+  FakeHandler handler2(0);
+  registerProbedHandler(handler1);
+  registerProbedHandler(handler2);
+
+  time_system_.advanceTimeWait(std::chrono::milliseconds(200));
+  EXPECT_EQ(&handler2, &balancer_.pickTargetHandler(handler1));
+  EXPECT_EQ(1, handler2.numConnections());
+
+  balancer_.unregisterHandler(handler1);
+  balancer_.unregisterHandler(handler2);
+}
+
+// Handlers come and go while other workers pick.
+TEST(LeastConnectionsConnectionBalancerImplTest, ConcurrentPicks) {
+  constexpr int Workers = 4;
+  constexpr int Picks = 10000;
+  LeastConnectionsConnectionBalancerImpl balancer(std::chrono::milliseconds(0),
+                                                  std::chrono::milliseconds(50), 0);
+  std::vector<std::unique_ptr<FakeHandler>> handlers;
+  for (int i = 0; i < Workers; i++) {
+    handlers.push_back(std::make_unique<FakeHandler>());
+    balancer.registerHandler(*handlers.back());
+  }
+
+  std::atomic<bool> picking{true};
+  Thread::ThreadPtr churn = Thread::threadFactoryForTest().createThread([&balancer, &picking]() {
+    while (picking) {
+      // The handler has too many connections to be picked, so that all picks are counted below.
+      FakeHandler handler(Workers * Picks);
+      balancer.registerHandler(handler);
+      balancer.unregisterHandler(handler);
+    }
+  });
+  std::vector<Thread::ThreadPtr> threads;
+  for (int i = 0; i < Workers; i++) {
+    threads.push_back(
+        Thread::threadFactoryForTest().createThread([&balancer, &handler = *handlers[i]]() {
+          for (int j = 0; j < Picks; j++) {
+            balancer.pickTargetHandler(handler);
+          }
+        }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  picking = false;
+  churn->join();
+
+  uint64_t total = 0;
+  for (const auto& handler : handlers) {
+    total += handler->numConnections();
+    balancer.unregisterHandler(*handler);
+  }
+  EXPECT_EQ(Workers * Picks, total);
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
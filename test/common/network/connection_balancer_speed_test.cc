@@ -0,0 +1,131 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "source/common/common/assert.h"
+#include "source/common/network/connection_balancer_impl.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+constexpr int Workers = 8;
+
+class FakeHandler : public BalancedConnectionHandler {
+public:
+  void decNumConnections() { --connections_; }
+
+  // Network::BalancedConnectionHandler
+  uint64_t numConnections() const override { return connections_; }
+  void incNumConnections() override { ++connections_; }
+  void post(ConnectionSocketPtr&&) override {}
+  Event::Dispatcher& dispatcher() override { PANIC("not reached"); }
+  void onAcceptWorker(ConnectionSocketPtr&&, bool, bool) override {}
+
+private:
+  std::atomic<uint64_t> connections_{};
+};
+
+enum class BalancerType { Nop, Exact, LeastConnections };
+
+std::unique_ptr<ConnectionBalancer> createBalancer(int64_t type) {
+  switch (static_cast<BalancerType>(type)) {
+  case BalancerType::Nop:
+    return std::make_unique<NopConnectionBalancerImpl>();
+  case BalancerType::Exact:
+    return std::make_unique<ExactConnectionBalancerImpl>();
+  case BalancerType::LeastConnections:
+    // The lag probe is left out, as there are no event loops to probe.
+    return std::make_unique<LeastConnectionsConnectionBalancerImpl>(
+        std::chrono::milliseconds(0), std::chrono::milliseconds(50), 0);
+  }
+  PANIC("not reached");
+}
+
+std::unique_ptr<ConnectionBalancer> shared_balancer;
+std::vector<std::unique_ptr<FakeHandler>> shared_handlers;
+
+// Balances short-lived connections accepted by several workers at once, as many as there are
+// threads, which all share a balancer.
+void bmAcceptThroughput(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    shared_balancer = createBalancer(state.range(0));
+    for (int i = 0; i < state.threads(); i++) {
+      shared_handlers.push_back(std::make_unique<FakeHandler>());
+      shared_balancer->registerHandler(*shared_handlers.back());
+    }
+  }
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    FakeHandler& handler = *shared_handlers[state.thread_index()];
+    FakeHandler& target = static_cast<FakeHandler&>(shared_balancer->pickTargetHandler(handler));
+    target.decNumConnections();
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  if (state.thread_index() == 0) {
+    for (const auto& handler : shared_handlers) {
+      shared_balancer->unregisterHandler(*handler);
+    }
+    shared_handlers.clear();
+    shared_balancer.reset();
+  }
+}
+BENCHMARK(bmAcceptThroughput)
+    ->Arg(static_cast<int64_t>(BalancerType::Nop))
+    ->Arg(static_cast<int64_t>(BalancerType::Exact))
+    ->Arg(static_cast<int64_t>(BalancerType::LeastConnections))
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(Workers)
+    ->UseRealTime();
+
+// Balances long-lived connections of which half are accepted by one worker, as when the kernel
+// wakes up the same worker for most of the connections. The skew counter is the number of
+// connections of the most loaded worker over the mean number of connections per worker.
+void bmWorkerSkew(benchmark::State& state) {
+  const int connections = state.range(1);
+  double skew = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    std::unique_ptr<ConnectionBalancer> balancer = createBalancer(state.range(0));
+    std::vector<std::unique_ptr<FakeHandler>> handlers;
+    for (int i = 0; i < Workers; i++) {
+      handlers.push_back(std::make_unique<FakeHandler>());
+      balancer->registerHandler(*handlers.back());
+    }
+    state.ResumeTiming();
+
+    for (int i = 0; i < connections; i++) {
+      const int worker = i % 2 == 0 ? 0 : 1 + (i / 2) % (Workers - 1);
+      balancer->pickTargetHandler(*handlers[worker]);
+    }
+
+    state.PauseTiming();
+    uint64_t most_connections = 0;
+    for (const auto& handler : handlers) {
+      most_connections = std::max(most_connections, handler->numConnections());
+      balancer->unregisterHandler(*handler);
+    }
+    skew = static_cast<double>(most_connections) * Workers / connections;
+    state.ResumeTiming();
+  }
+  state.counters["skew"] = skew;
+  state.SetItemsProcessed(state.iterations() * connections);
+}
+BENCHMARK(bmWorkerSkew)
+    ->ArgsProduct({{static_cast<int64_t>(BalancerType::Nop),
+                    static_cast<int64_t>(BalancerType::Exact),
+                    static_cast<int64_t>(BalancerType::LeastConnections)},
+                   {1000, 100000}});
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,260 @@
+#include "source/common/network/address_impl.h"
+#include "source/common/network/io_socket_error_impl.h"
+#include "source/common/network/io_uring_socket_handle_impl.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/io/mocks.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+using testing::SaveArg;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class IoUringSocketHandleImplTest : public testing::Test {
+public:
+  IoUringSocketHandleImplTest() {
+    ON_CALL(factory_, getIoUringWorker())
+        .WillByDefault(Return(OptRef<Io::IoUringWorker>(worker_)));
+    ON_CALL(factory_, currentThreadRegistered()).WillByDefault(Return(true));
+    ON_CALL(worker_, dispatcher()).WillByDefault(ReturnRef(dispatcher_));
+    ON_CALL(socket_, getIoUringWorker()).WillByDefault(ReturnRef(worker_));
+    ON_CALL(socket_, getReadParam()).WillByDefault(ReturnRef(read_param_));
+    ON_CALL(socket_, getWriteParam()).WillByDefault(ReturnRef(write_param_));
+    ON_CALL(socket_, getAcceptedSocketParam()).WillByDefault(ReturnRef(accepted_socket_param_));
+  }
+
+  void closeHandle(IoUringSocketHandleImpl& handle) {
+    EXPECT_CALL(socket_, close(false, _));
+    handle.close();
+    EXPECT_FALSE(handle.isOpen());
+  }
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Io::MockIoUringWorkerFactory> factory_;
+  NiceMock<Io::MockIoUringWorker> worker_;
+  NiceMock<Io::MockIoUringSocket> socket_;
+  OptRef<Io::ReadParam> read_param_;
+  OptRef<Io::WriteParam> write_param_;
+  OptRef<Io::AcceptedSocketParam> accepted_socket_param_;
+};
+
+TEST_F(IoUringSocketHandleImplTest, CloseBeforeInitializeFileEvent) {
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+
+  IoUringSocketHandleImpl handle(factory_, 10);
+  EXPECT_EQ(IoUringSocketType::Unknown, handle.ioUringSocketType());
+  EXPECT_CALL(os_sys_calls, close(10)).WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  handle.close();
+  EXPECT_FALSE(handle.isOpen());
+}
+
+TEST_F(IoUringSocketHandleImplTest, ServerSocketRead) {
+  IoUringSocketHandleImpl handle(factory_, 10, false, absl::nullopt, true);
+  EXPECT_EQ(IoUringSocketType::Server, handle.ioUringSocketType());
+
+  EXPECT_CALL(worker_, addServerSocket(10, _, true)).WillOnce(ReturnRef(socket_));
+  handle.initializeFileEvent(
+      dispatcher_, [](uint32_t) {}, Event::PlatformDefaultTriggerType,
+      Event::FileReadyType::Read | Event::FileReadyType::Closed);
+
+  // Nothing to read out of the read event callback.
+  Buffer::OwnedImpl buffer;
+  auto result = handle.read(buffer, absl::nullopt);
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+
+  Buffer::OwnedImpl read_buf("hello world");
+  Io::ReadParam read_param{read_buf, static_cast<int32_t>(read_buf.length())};
+  read_param_ = read_param;
+
+  // Peeking keeps the data in the io_uring socket.
+  char peek_buf[5];
+  result = handle.recv(peek_buf, 5, MSG_PEEK);
+  EXPECT_EQ(5, result.return_value_);
+  EXPECT_EQ("hello", absl::string_view(peek_buf, 5));
+  EXPECT_EQ(11, read_buf.length());
+
+  result = handle.read(buffer, 6);
+  EXPECT_EQ(6, result.return_value_);
+  EXPECT_EQ("hello ", buffer.toString());
+
+  char readv_buf[10];
+  Buffer::RawSlice slice{readv_buf, 10};
+  result = handle.readv(10, &slice, 1);
+  EXPECT_EQ(5, result.return_value_);
+  EXPECT_EQ("world", absl::string_view(readv_buf, 5));
+
+  // All the data is consumed.
+  result = handle.read(buffer, absl::nullopt);
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+
+  closeHandle(handle);
+}
+
+TEST_F(IoUringSocketHandleImplTest, ServerSocketReadError) {
+  IoUringSocketHandleImpl handle(factory_, 10, false, absl::nullopt, true);
+  EXPECT_CALL(worker_, addServerSocket(10, _, false)).WillOnce(ReturnRef(socket_));
+  handle.initializeFileEvent(
+      dispatcher_, [](uint32_t) {}, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
+
+  Buffer::OwnedImpl read_buf;
+  Io::ReadParam read_param{read_buf, -ECONNRESET};
+  read_param_ = read_param;
+  Buffer::OwnedImpl buffer;
+  auto result = handle.read(buffer, absl::nullopt);
+  EXPECT_EQ(Api::IoError::IoErrorCode::ConnectionReset, result.err_->getErrorCode());
+
+  // Remote close.
+  Io::ReadParam remote_close_param{read_buf, 0};
+  read_param_ = remote_close_param;
+  result = handle.read(buffer, absl::nullopt);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(0, result.return_value_);
+
+  closeHandle(handle);
+}
+
+TEST_F(IoUringSocketHandleImplTest, ServerSocketWrite) {
+  IoUringSocketHandleImpl handle(factory_, 10, false, absl::nullopt, true);
+  EXPECT_CALL(worker_, addServerSocket(10, _, false)).WillOnce(ReturnRef(socket_));
+  handle.initializeFileEvent(
+      dispatcher_, [](uint32_t) {}, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
+
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_CALL(socket_, write(testing::A<Buffer::Instance&>()))
+      .WillOnce(testing::Invoke([](Buffer::Instance& data) { data.drain(data.length()); }));
+  auto result = handle.write(buffer);
+  EXPECT_EQ(5, result.return_value_);
+  EXPECT_EQ(0, buffer.length());
+
+  // The error of the previous write request is returned.
+  Io::WriteParam write_param{-EPIPE};
+  write_param_ = write_param;
+  Buffer::OwnedImpl buffer2("world");
+  result = handle.write(buffer2);
+  EXPECT_FALSE(result.ok());
+  EXPECT_EQ(5, buffer2.length());
+
+  EXPECT_CALL(socket_, shutdown(SHUT_WR));
+  handle.shutdown(SHUT_WR);
+
+  closeHandle(handle);
+}
+
+TEST_F(IoUringSocketHandleImplTest, FileEvents) {
+  IoUringSocketHandleImpl handle(factory_, 10, false, absl::nullopt, true);
+  EXPECT_CALL(worker_, addServerSocket(10, _, false)).WillOnce(ReturnRef(socket_));
+  handle.initializeFileEvent(
+      dispatcher_, [](uint32_t) {}, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
+
+  EXPECT_CALL(socket_, disableRead());
+  EXPECT_CALL(socket_, enableCloseEvent(true));
+  handle.enableFileEvents(Event::FileReadyType::Closed);
+
+  EXPECT_CALL(socket_, injectCompletion(Io::Request::RequestType::Read));
+  EXPECT_CALL(socket_, injectCompletion(Io::Request::RequestType::Write));
+  handle.activateFileEvents(Event::FileReadyType::Read | Event::FileReadyType::Write);
+
+  // The io_uring socket is reused when the file event is initialized again.
+  EXPECT_CALL(socket_, disableRead());
+  EXPECT_CALL(socket_, enableCloseEvent(false));
+  handle.resetFileEvents();
+  EXPECT_CALL(worker_, addServerSocket(_, _, _)).Times(0);
+  EXPECT_CALL(socket_, setFileReadyCb(_));
+  EXPECT_CALL(socket_, enableRead());
+  EXPECT_CALL(socket_, enableCloseEvent(false));
+  handle.initializeFileEvent(
+      dispatcher_, [](uint32_t) {}, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
+
+  closeHandle(handle);
+}
+
+TEST_F(IoUringSocketHandleImplTest, Accept) {
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+
+  IoUringSocketHandleImpl handle(factory_, 10);
+  EXPECT_CALL(os_sys_calls, listen(10, 128)).WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  handle.listen(128);
+  EXPECT_EQ(IoUringSocketType::Accept, handle.ioUringSocketType());
+
+  EXPECT_CALL(worker_, addAcceptSocket(10, _, false)).WillOnce(ReturnRef(socket_));
+  handle.initializeFileEvent(
+      dispatcher_, [](uint32_t) {}, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
+
+  // Nothing is accepted.
+  sockaddr_storage addr;
+  socklen_t addr_len = sizeof(addr);
+  EXPECT_EQ(nullptr, handle.accept(reinterpret_cast<sockaddr*>(&addr), &addr_len));
+
+  Address::Ipv4Instance remote_address("1.2.3.4", 5678);
+  sockaddr_storage remote_addr{};
+  memcpy(&remote_addr, remote_address.sockAddr(), remote_address.sockAddrLen());
+  Io::AcceptedSocketParam accepted_socket_param{11, &remote_addr, remote_address.sockAddrLen()};
+  accepted_socket_param_ = accepted_socket_param;
+
+  IoHandlePtr accepted = handle.accept(reinterpret_cast<sockaddr*>(&addr), &addr_len);
+  ASSERT_NE(nullptr, accepted);
+  EXPECT_EQ(11, accepted->fdDoNotUse());
+  EXPECT_EQ(remote_address.sockAddrLen(), addr_len);
+  EXPECT_EQ(0, memcmp(&addr, &remote_addr, addr_len));
+  EXPECT_EQ(IoUringSocketType::Server,
+            dynamic_cast<IoUringSocketHandleImpl*>(accepted.get())->ioUringSocketType());
+  // The accepted socket is taken over.
+  EXPECT_FALSE(SOCKET_VALID(accepted_socket_param.fd_));
+  EXPECT_EQ(nullptr, handle.accept(reinterpret_cast<sockaddr*>(&addr), &addr_len));
+
+  EXPECT_CALL(os_sys_calls, close(11)).WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  accepted->close();
+  closeHandle(handle);
+}
+
+TEST_F(IoUringSocketHandleImplTest, Connect) {
+  IoUringSocketHandleImpl handle(factory_, 10);
+  EXPECT_CALL(worker_, addClientSocket(10, _, false)).WillOnce(ReturnRef(socket_));
+  handle.initializeFileEvent(
+      dispatcher_, [](uint32_t) {}, Event::PlatformDefaultTriggerType, Event::FileReadyType::Write);
+  EXPECT_EQ(IoUringSocketType::Client, handle.ioUringSocketType());
+
+  auto address = std::make_shared<Address::Ipv4Instance>("1.2.3.4", 5678);
+  EXPECT_CALL(socket_, connect(_));
+  auto result = handle.connect(address);
+  EXPECT_EQ(-1, result.return_value_);
+  EXPECT_EQ(SOCKET_ERROR_IN_PROGRESS, result.errno_);
+
+  closeHandle(handle);
+}
+
+TEST_F(IoUringSocketHandleImplTest, Duplicate) {
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+
+  IoUringSocketHandleImpl handle(factory_, 10);
+  EXPECT_CALL(os_sys_calls, listen(10, 128)).WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  handle.listen(128);
+
+  EXPECT_CALL(os_sys_calls, duplicate(10)).WillOnce(Return(Api::SysCallSocketResult{11, 0}));
+  IoHandlePtr duplicated = handle.duplicate();
+  EXPECT_EQ(IoUringSocketType::Accept,
+            dynamic_cast<IoUringSocketHandleImpl*>(duplicated.get())->ioUringSocketType());
+
+  EXPECT_CALL(os_sys_calls, close(11)).WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  duplicated->close();
+  EXPECT_CALL(os_sys_calls, close(10)).WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  handle.close();
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,192 @@
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/network/address_impl.h"
+#include "source/common/network/listen_socket_impl.h"
+#include "source/common/network/reuse_port_steering.h"
+#include "source/common/network/socket_option_factory.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "gtest/gtest.h"
+
+#if defined(__linux__)
+#include <linux/bpf.h>
+#include <sys/mman.h>
+
+#include "source/common/api/os_sys_calls_impl_linux.h"
+#endif
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+#if defined(__linux__)
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+// Fakes the system calls of the steering, so that it can be tested without privileges.
+class ReusePortSteeringSysCallsTest : public testing::Test {
+protected:
+  // Expects a steering of two sockets to be created with the given maps and program.
+  void expectCreate(int counts_fd, int sockets_fd, int program_fd) {
+    EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_CREATE, _, _))
+        .WillOnce(Invoke([counts_fd](int, void* attr, unsigned int) -> Api::SysCallIntResult {
+          EXPECT_EQ(BPF_MAP_TYPE_ARRAY, static_cast<bpf_attr*>(attr)->map_type);
+          return {counts_fd, 0};
+        }))
+        .WillOnce(Invoke([sockets_fd](int, void* attr, unsigned int) -> Api::SysCallIntResult {
+          EXPECT_EQ(BPF_MAP_TYPE_REUSEPORT_SOCKARRAY, static_cast<bpf_attr*>(attr)->map_type);
+          EXPECT_EQ(2, static_cast<bpf_attr*>(attr)->max_entries);
+          return {sockets_fd, 0};
+        }));
+    EXPECT_CALL(os_sys_calls_, mmap(nullptr, _, PROT_READ | PROT_WRITE, MAP_SHARED, counts_fd, 0))
+        .WillOnce(Return(Api::SysCallPtrResult{counts_.data(), 0}));
+    EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_PROG_LOAD, _, _))
+        .WillOnce(Invoke([program_fd](int, void* attr, unsigned int) -> Api::SysCallIntResult {
+          EXPECT_EQ(BPF_PROG_TYPE_SK_REUSEPORT, static_cast<bpf_attr*>(attr)->prog_type);
+          return {program_fd, 0};
+        }));
+  }
+
+  NiceMock<Api::MockOsSysCalls> os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_{&os_sys_calls_};
+  NiceMock<Api::MockLinuxOsSysCalls> linux_os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls_{&linux_os_sys_calls_};
+  alignas(64) std::array<uint8_t, 2 * ReusePortSteering::CountStride> counts_{};
+};
+
+TEST_F(ReusePortSteeringSysCallsTest, MapCreationFails) {
+  EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_CREATE, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EPERM}));
+  auto steering = ReusePortSteering::create(2);
+  EXPECT_EQ(absl::StatusCode::kUnavailable, steering.status().code());
+}
+
+TEST_F(ReusePortSteeringSysCallsTest, ProgramLoadFailureReleasesMaps) {
+  EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_CREATE, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{10, 0}))
+      .WillOnce(Return(Api::SysCallIntResult{11, 0}));
+  EXPECT_CALL(os_sys_calls_, mmap(_, _, _, _, 10, _))
+      .WillOnce(Return(Api::SysCallPtrResult{counts_.data(), 0}));
+  EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_PROG_LOAD, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EINVAL}));
+  EXPECT_CALL(os_sys_calls_, munmap(counts_.data(), _));
+  EXPECT_CALL(os_sys_calls_, close(11));
+  EXPECT_CALL(os_sys_calls_, close(10));
+  auto steering = ReusePortSteering::create(2);
+  EXPECT_EQ(absl::StatusCode::kUnavailable, steering.status().code());
+}
+
+// The sockets are added to the socket array by the index of their worker, whatever order they
+// joined the group in.
+TEST_F(ReusePortSteeringSysCallsTest, AddsSocketsByWorkerIndex) {
+  expectCreate(10, 11, 12);
+  auto steering = ReusePortSteering::create(2);
+  ASSERT_TRUE(steering.ok());
+
+  NiceMock<MockListenSocket> socket;
+  EXPECT_CALL(*socket.io_handle_, fdDoNotUse()).WillRepeatedly(Return(42));
+  EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_UPDATE_ELEM, _, _))
+      .WillOnce(Invoke([](int, void* attr, unsigned int) -> Api::SysCallIntResult {
+        const bpf_attr& update = *static_cast<bpf_attr*>(attr);
+        EXPECT_EQ(11, update.map_fd);
+        EXPECT_EQ(1, *reinterpret_cast<const uint32_t*>(update.key));
+        EXPECT_EQ(42, *reinterpret_cast<const uint64_t*>(update.value));
+        return {0, 0};
+      }));
+  EXPECT_EQ(0, steering.value()->addSocket(1, socket).return_value_);
+
+  EXPECT_CALL(socket, setSocketOption(SOL_SOCKET, _, _, sizeof(int)))
+      .WillOnce(Invoke([](int, int, const void* value, socklen_t) -> Api::SysCallIntResult {
+        EXPECT_EQ(12, *static_cast<const int*>(value));
+        return {0, 0};
+      }));
+  EXPECT_EQ(0, steering.value()->attach(socket).return_value_);
+
+  // The workers count their connections in the mapped counts.
+  steering.value()->load(1).add(3);
+  EXPECT_EQ(3, steering.value()->connections(1));
+  EXPECT_EQ(0, steering.value()->connections(0));
+  EXPECT_EQ(3, *reinterpret_cast<uint32_t*>(counts_.data() + ReusePortSteering::CountStride));
+
+  EXPECT_CALL(os_sys_calls_, munmap(counts_.data(), _));
+  EXPECT_CALL(os_sys_calls_, close(12));
+  EXPECT_CALL(os_sys_calls_, close(11));
+  EXPECT_CALL(os_sys_calls_, close(10));
+}
+
+class ReusePortSteeringTest : public testing::Test {
+protected:
+  void SetUp() override {
+    auto steering = ReusePortSteering::create(2);
+    if (!steering.ok()) {
+      // Loading BPF programs takes privileges which the test may not have.
+      GTEST_SKIP() << steering.status();
+    }
+    steering_ = std::move(steering.value());
+  }
+
+  ReusePortSteeringSharedPtr steering_;
+};
+
+TEST_F(ReusePortSteeringTest, Loads) {
+  steering_->load(0).add(2);
+  steering_->load(1).add(1);
+  steering_->load(0).add(-1);
+  EXPECT_EQ(1, steering_->connections(0));
+  EXPECT_EQ(1, steering_->connections(1));
+}
+
+// Connections mostly go to the socket whose worker has fewer connections. The other socket still
+// gets those for which the program picks it twice, a quarter of them.
+TEST_F(ReusePortSteeringTest, SteersToLessLoadedSocket) {
+  Socket::OptionsSharedPtr options = SocketOptionFactory::buildReusePortOptions();
+  std::vector<std::unique_ptr<TcpListenSocket>> sockets;
+  sockets.push_back(std::make_unique<TcpListenSocket>(
+      std::make_shared<Address::Ipv4Instance>("127.0.0.1", 0), options, true));
+  const Address::InstanceConstSharedPtr address =
+      sockets[0]->connectionInfoProvider().localAddress();
+  sockets.push_back(std::make_unique<TcpListenSocket>(address, options, true));
+  for (uint32_t i = 0; i < sockets.size(); i++) {
+    ASSERT_EQ(0, sockets[i]->ioHandle().listen(256).return_value_);
+    ASSERT_EQ(0, steering_->addSocket(i, *sockets[i]).return_value_);
+  }
+  ASSERT_EQ(0, steering_->attach(*sockets[0]).return_value_);
+  steering_->load(0).add(1000);
+
+  constexpr int Connections = 200;
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  std::vector<int> accepted(sockets.size());
+  for (int i = 0; i < Connections; i++) {
+    const os_fd_t fd = os_sys_calls.socket(AF_INET, SOCK_STREAM, 0).return_value_;
+    ASSERT_NE(INVALID_SOCKET, fd);
+    ASSERT_EQ(0, os_sys_calls.connect(fd, address->sockAddr(), address->sockAddrLen())
+                     .return_value_);
+    for (size_t j = 0; j < sockets.size(); j++) {
+      IoHandlePtr connection = sockets[j]->ioHandle().accept(nullptr, nullptr);
+      if (connection != nullptr) {
+        accepted[j]++;
+        connection->close();
+      }
+    }
+    os_sys_calls.close(fd);
+  }
+  EXPECT_EQ(Connections, accepted[0] + accepted[1]);
+  // The expected split is 50 and 150, which the bounds are five standard deviations from.
+  EXPECT_GT(accepted[1], 120);
+  EXPECT_LT(accepted[0], 80);
+}
+
+#endif
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -39,7 +39,8 @@ static Http::TestRequestHeaderMapImpl genRequestHeaders(int route_num) {
  * Generates the route config for the type of matcher being tested.
  */
 static RouteConfiguration genRouteConfig(benchmark::State& state,
-                                         RouteMatch::PathSpecifierCase match_type) {
+                                         RouteMatch::PathSpecifierCase match_type,
+                                         int header_match_interval = 0) {
   // Create the base route config.
   RouteConfiguration route_config;
   VirtualHost* v_host = route_config.add_virtual_hosts();
@@ -52,6 +53,13 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
     DirectResponseAction* direct_response = route->mutable_direct_response();
     direct_response->set_status(200);
     RouteMatch* match = route->mutable_match();
+    // One route in the middle of every `header_match_interval` routes also matches a header. The
+    // last route, which the request must match, is at the end of an interval and so never does.
+    if (header_match_interval > 0 && i % header_match_interval == header_match_interval / 2) {
+      auto* header = match->add_headers();
+      header->set_name("x-debug");
+      header->mutable_string_match()->set_exact("1");
+    }
 
     switch (match_type) {
     case RouteMatch::PathSpecifierCase::kPrefix: {
@@ -59,7 +67,7 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
       break;
     }
     case RouteMatch::PathSpecifierCase::kPath: {
-      match->set_prefix(absl::StrCat("/shelves/shelf_", i, "/route_", i));
+      match->set_path(absl::StrCat("/shelves/shelf_", i, "/route_", i));
       break;
     }
     case RouteMatch::PathSpecifierCase::kSafeRegex: {
@@ -78,14 +86,16 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
 
 /**
  * Measure the speed of doing a route match against a route table of varying sizes.
- * Why? Currently, route matching is linear in first-to-win ordering.
+ * Why? Route matching is linear in first-to-win ordering, except for runs of prefix and path
+ * routes without other match criteria, which are looked up in tries.
  *
  * We construct the first `n - 1` items in the route table so they are not
  * matched by the incoming request. Only the last route will be matched.
  * We then time how long it takes for the request to be matched against the
  * last route.
  */
-static void bmRouteTableSize(benchmark::State& state, RouteMatch::PathSpecifierCase match_type) {
+static void bmRouteTableSize(benchmark::State& state, RouteMatch::PathSpecifierCase match_type,
+                             int header_match_interval = 0) {
   // Setup router for benchmarking.
   Api::ApiPtr api = Api::createApiForTest();
   NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
@@ -93,7 +103,7 @@ static void bmRouteTableSize(benchmark::State& state, RouteMatch::PathSpecifierC
   ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
 
   // Create router config.
-  ConfigImpl config(genRouteConfig(state, match_type), factory_context,
+  ConfigImpl config(genRouteConfig(state, match_type, header_match_interval), factory_context,
                     ProtobufMessage::getNullValidationVisitor(), true);
 
   for (auto _ : state) { // NOLINT
@@ -124,6 +134,14 @@ static void bmRouteTableSizeWithExactPathMatch(benchmark::State& state) {
   bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kPath);
 }
 
+/**
+ * Benchmark a route table with path prefix matchers, every 100th of which also matches a header,
+ * splitting the table into runs of routes matched by their path alone.
+ */
+static void bmRouteTableSizeWithPathPrefixAndHeaderMatch(benchmark::State& state) {
+  bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kPrefix, 100);
+}
+
 /**
  * Benchmark a route table with regex path matchers in the form of:
  * - /shelves/{shelf_id}/route_1
@@ -136,9 +154,79 @@ static void bmRouteTableSizeWithRegexMatch(benchmark::State& state) {
   bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kSafeRegex);
 }
 
+/**
+ * Generates a route config with `n` virtual hosts, each with a suffix wildcard domain of one of
+ * many lengths, in the form of:
+ * - *.tenant_0.example.com
+ * - *.tenant_1a.example.com
+ * - *.tenant_2aa.example.com
+ * - etc.
+ */
+static RouteConfiguration genWildcardVirtualHostsConfig(int num_virtual_hosts) {
+  RouteConfiguration route_config;
+  for (int i = 0; i < num_virtual_hosts; ++i) {
+    VirtualHost* v_host = route_config.add_virtual_hosts();
+    v_host->set_name(absl::StrCat("tenant_", i));
+    v_host->add_domains(
+        absl::StrCat("*.tenant_", i, std::string(i % 64, 'a'), ".example.com"));
+    Route* route = v_host->add_routes();
+    route->mutable_match()->set_prefix("/");
+    route->mutable_direct_response()->set_status(200);
+  }
+  return route_config;
+}
+
+/**
+ * Measure the time it takes to build a route config with `n` wildcard virtual hosts.
+ */
+static void bmWildcardVirtualHostsBuild(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  const RouteConfiguration route_config = genWildcardVirtualHostsConfig(state.range(0));
+
+  for (auto _ : state) { // NOLINT
+    ConfigImpl config(route_config, factory_context, ProtobufMessage::getNullValidationVisitor(),
+                      true);
+    benchmark::DoNotOptimize(config);
+  }
+}
+
+/**
+ * Measure the speed of finding the virtual host of a request among `n` wildcard virtual hosts,
+ * whose domains have many different lengths. The request matches the last one.
+ */
+static void bmWildcardVirtualHostsLookup(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  ConfigImpl config(genWildcardVirtualHostsConfig(state.range(0)), factory_context,
+                    ProtobufMessage::getNullValidationVisitor(), true);
+
+  const int last_virtual_host = state.range(0) - 1;
+  const Http::TestRequestHeaderMapImpl headers{
+      {":authority", absl::StrCat("www.tenant_", last_virtual_host,
+                                  std::string(last_virtual_host % 64, 'a'), ".example.com")},
+      {":method", "GET"},
+      {":path", "/"},
+      {"x-forwarded-proto", "http"}};
+  for (auto _ : state) { // NOLINT
+    config.route(headers, stream_info, 0);
+  }
+}
+
 BENCHMARK(bmRouteTableSizeWithPathPrefixMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithExactPathMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
+BENCHMARK(bmRouteTableSizeWithPathPrefixAndHeaderMatch)
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithRegexMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
+BENCHMARK(bmWildcardVirtualHostsBuild)
+    ->RangeMultiplier(8)
+    ->Ranges({{1, 2 << 16}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(bmWildcardVirtualHostsLookup)->RangeMultiplier(8)->Ranges({{1, 2 << 16}});
 
 } // namespace
 } // namespace Router
@@ -8926,6 +8926,155 @@ virtual_hosts:
   }
 }
 
+// Runs of routes matching requests on their path alone are compiled into tries, which must keep
+// the routes' first match semantics with the routes evaluated one at a time around them.
+TEST_F(RouteMatcherTest, CompiledPathRoutes) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: compiled
+    domains: ["*"]
+    routes:
+      - match: { prefix: "/foo/bar/baz" }
+        route: { cluster: foo_bar_baz }
+      - match: { path: "/foo/bar" }
+        route: { cluster: foo_bar_exact }
+      - match: { path_separated_prefix: "/foo" }
+        route: { cluster: foo_separated }
+      - match: { prefix: "/foo" }
+        route: { cluster: foo_prefix }
+      - match: { path: "/bar" }
+        route: { cluster: bar_exact }
+      - match: { prefix: "/bar/" }
+        route: { cluster: bar_prefix }
+      - match: { prefix: "/123", case_sensitive: false }
+        route: { cluster: digits }
+      - match: { path: "/qux" }
+        route: { cluster: qux }
+      - match:
+          prefix: "/"
+          headers:
+          - name: x-debug
+            string_match: { exact: "1" }
+        route: { cluster: debug }
+      - match: { prefix: "/case", case_sensitive: false }
+        route: { cluster: case_insensitive }
+      - match: { prefix: "/r0" }
+        route: { cluster: r }
+      - match: { prefix: "/r1" }
+        route: { cluster: r }
+      - match: { prefix: "/r2" }
+        route: { cluster: r }
+      - match: { prefix: "/r3" }
+        route: { cluster: r }
+      - match: { prefix: "/r4" }
+        route: { cluster: r }
+      - match: { prefix: "/r5" }
+        route: { cluster: r }
+      - match: { prefix: "/r6" }
+        route: { cluster: r }
+      - match: { prefix: "/" }
+        route: { cluster: default }
+  )EOF";
+
+  factory_context_.cluster_manager_.initializeClusters(
+      {"foo_bar_baz", "foo_bar_exact", "foo_separated", "foo_prefix", "bar_exact", "bar_prefix",
+       "digits", "qux", "debug", "case_insensitive", "r", "default"},
+      {});
+  auto route_configuration = parseRouteConfigurationFromYaml(yaml);
+  TestConfigImpl config(route_configuration, factory_context_, true);
+
+  const auto cluster = [&config](const std::string& path) {
+    return config.route(genHeaders("www.lyft.com", path, "GET"), 0)->routeEntry()->clusterName();
+  };
+  EXPECT_EQ("foo_bar_baz", cluster("/foo/bar/baz/1"));
+  EXPECT_EQ("foo_bar_exact", cluster("/foo/bar"));
+  EXPECT_EQ("foo_bar_exact", cluster("/foo/bar?param=true"));
+  EXPECT_EQ("foo_bar_exact", cluster("/foo/bar#fragment"));
+  EXPECT_EQ("foo_separated", cluster("/foo/ba"));
+  EXPECT_EQ("foo_separated", cluster("/foo"));
+  EXPECT_EQ("foo_prefix", cluster("/foobar"));
+  EXPECT_EQ("bar_exact", cluster("/bar"));
+  EXPECT_EQ("bar_prefix", cluster("/bar/baz"));
+  EXPECT_EQ("digits", cluster("/123abc"));
+  EXPECT_EQ("qux", cluster("/qux"));
+  EXPECT_EQ("case_insensitive", cluster("/CASE/1"));
+  EXPECT_EQ("r", cluster("/r3/1"));
+  EXPECT_EQ("default", cluster("/qux/1"));
+  EXPECT_EQ("foo_separated", cluster("/foo/bar;param"));
+
+  // Routes evaluated one at a time between the tries still match in order.
+  Http::TestRequestHeaderMapImpl headers = genHeaders("www.lyft.com", "/qux", "GET");
+  headers.addCopy("x-debug", "1");
+  EXPECT_EQ("qux", config.route(headers, 0)->routeEntry()->clusterName());
+  headers.setPath("/r3");
+  EXPECT_EQ("debug", config.route(headers, 0)->routeEntry()->clusterName());
+
+  // The tries match the paths of requests as the routes do, without their path parameters.
+  route_configuration.set_ignore_path_parameters_in_path_matching(true);
+  TestConfigImpl config_ignoring_parameters(route_configuration, factory_context_, true);
+  EXPECT_EQ("foo_bar_exact",
+            config_ignoring_parameters.route(genHeaders("www.lyft.com", "/foo/bar;param", "GET"), 0)
+                ->routeEntry()
+                ->clusterName());
+}
+
+// Runs of regex routes are compiled into regex sets, which must keep the routes' first match
+// semantics, including for routes with other match criteria.
+TEST_F(RouteMatcherTest, CompiledRegexRoutes) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: compiled
+    domains: ["*"]
+    routes:
+      - match: { safe_regex: { regex: "/users/[0-9]+" } }
+        route: { cluster: user }
+      - match:
+          safe_regex: { regex: "/users/.*" }
+          headers:
+          - name: x-debug
+            string_match: { exact: "1" }
+        route: { cluster: users_debug }
+      - match: { safe_regex: { regex: "/users/[a-z]+" } }
+        route: { cluster: user_name }
+      - match: { safe_regex: { regex: "/users/.*" } }
+        route: { cluster: users }
+      - match: { safe_regex: { regex: "/[a-z]+" } }
+        route: { cluster: word }
+      - match: { prefix: "/" }
+        route: { cluster: default }
+  )EOF";
+
+  factory_context_.cluster_manager_.initializeClusters(
+      {"user", "users_debug", "user_name", "users", "word", "default"}, {});
+  auto route_configuration = parseRouteConfigurationFromYaml(yaml);
+  TestConfigImpl config(route_configuration, factory_context_, true);
+
+  const auto cluster = [&config](const std::string& path) {
+    return config.route(genHeaders("www.lyft.com", path, "GET"), 0)->routeEntry()->clusterName();
+  };
+  EXPECT_EQ("user", cluster("/users/123"));
+  EXPECT_EQ("user", cluster("/users/123?param=true"));
+  EXPECT_EQ("user_name", cluster("/users/abc"));
+  EXPECT_EQ("users", cluster("/users/abc/1"));
+  EXPECT_EQ("word", cluster("/users"));
+  EXPECT_EQ("default", cluster("/users1"));
+  EXPECT_EQ("users", cluster("/users/123;param"));
+
+  Http::TestRequestHeaderMapImpl headers = genHeaders("www.lyft.com", "/users/123", "GET");
+  headers.addCopy("x-debug", "1");
+  EXPECT_EQ("user", config.route(headers, 0)->routeEntry()->clusterName());
+  headers.setPath("/users/abc");
+  EXPECT_EQ("users_debug", config.route(headers, 0)->routeEntry()->clusterName());
+
+  // The regex sets match the paths of requests as the routes do, without their path parameters.
+  route_configuration.set_ignore_path_parameters_in_path_matching(true);
+  TestConfigImpl config_ignoring_parameters(route_configuration, factory_context_, true);
+  EXPECT_EQ("user", config_ignoring_parameters
+                        .route(genHeaders("www.lyft.com", "/users/123;param", "GET"), 0)
+                        ->routeEntry()
+                        ->clusterName());
+}
+
 TEST_F(RouteConfigurationV2, RegexPrefixWithNoRewriteWorksWhenPathChanged) {
 
   // Setup regex route entry. the regex is trivial, that's ok as we only want to test that
@@ -11191,6 +11340,106 @@ virtual_hosts:
   EXPECT_EQ(accepted_route, nullptr);
 }
 
+TEST_F(RouteMatchOverrideTest, VerifyAllMatchableCompiledRoutes) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: bar
+    domains: ["*"]
+    routes:
+      - match: { prefix: "/foo/bar/baz" }
+        route:
+          cluster: foo_bar_baz
+      - match: { prefix: "/other" }
+        route:
+          cluster: other
+      - match: { prefix: "/foo/bar" }
+        route:
+          cluster: foo_bar
+      - match: { path: "/foo/bar/baz" }
+        route:
+          cluster: foo_bar_baz_exact
+      - match: { prefix: "/foo" }
+        route:
+          cluster: foo
+      - match: { path_separated_prefix: "/foo/bar" }
+        route:
+          cluster: foo_bar_separated
+      - match: { prefix: "/fo" }
+        route:
+          cluster: fo
+      - match: { prefix: "/" }
+        route:
+          cluster: default
+)EOF";
+
+  factory_context_.cluster_manager_.initializeClusters(
+      {"foo_bar_baz", "other", "foo_bar", "foo_bar_baz_exact", "foo", "foo_bar_separated", "fo",
+       "default"},
+      {});
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true);
+  // Every matching route is passed to the callback in order, whether or not it is in a trie.
+  std::vector<std::string> clusters{"default",           "fo",      "foo_bar_separated", "foo",
+                                    "foo_bar_baz_exact", "foo_bar", "foo_bar_baz"};
+
+  RouteConstSharedPtr accepted_route = config.route(
+      [&clusters](RouteConstSharedPtr route,
+                  RouteEvalStatus route_eval_status) -> RouteMatchStatus {
+        EXPECT_FALSE(clusters.empty());
+        EXPECT_EQ(clusters[clusters.size() - 1], route->routeEntry()->clusterName());
+        clusters.pop_back();
+        EXPECT_EQ(route_eval_status, clusters.empty() ? RouteEvalStatus::NoMoreRoutes
+                                                      : RouteEvalStatus::HasMoreRoutes);
+        return RouteMatchStatus::Continue;
+      },
+      genHeaders("bat.com", "/foo/bar/baz", "GET"));
+  EXPECT_TRUE(clusters.empty());
+  EXPECT_EQ(nullptr, accepted_route);
+}
+
+TEST_F(RouteMatchOverrideTest, VerifyAllMatchableCompiledRegexRoutes) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: bar
+    domains: ["*"]
+    routes:
+      - match: { safe_regex: { regex: "/foo/[a-z]+" } }
+        route:
+          cluster: foo_name
+      - match: { safe_regex: { regex: "/bar/.*" } }
+        route:
+          cluster: bar
+      - match: { safe_regex: { regex: "/foo/.*" } }
+        route:
+          cluster: foo
+      - match: { safe_regex: { regex: "/[a-z]+/[a-z]+" } }
+        route:
+          cluster: words
+      - match: { prefix: "/" }
+        route:
+          cluster: default
+)EOF";
+
+  factory_context_.cluster_manager_.initializeClusters(
+      {"foo_name", "bar", "foo", "words", "default"}, {});
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true);
+  // Every matching route is passed to the callback in order, whether or not it is in a regex set.
+  std::vector<std::string> clusters{"default", "words", "foo", "foo_name"};
+
+  RouteConstSharedPtr accepted_route = config.route(
+      [&clusters](RouteConstSharedPtr route,
+                  RouteEvalStatus route_eval_status) -> RouteMatchStatus {
+        EXPECT_FALSE(clusters.empty());
+        EXPECT_EQ(clusters[clusters.size() - 1], route->routeEntry()->clusterName());
+        clusters.pop_back();
+        EXPECT_EQ(route_eval_status, clusters.empty() ? RouteEvalStatus::NoMoreRoutes
+                                                      : RouteEvalStatus::HasMoreRoutes);
+        return RouteMatchStatus::Continue;
+      },
+      genHeaders("bat.com", "/foo/bar", "GET"));
+  EXPECT_TRUE(clusters.empty());
+  EXPECT_EQ(nullptr, accepted_route);
+}
+
 TEST_F(RouteMatchOverrideTest, NullRouteOnRequireTlsAll) {
   const std::string yaml = R"EOF(
 virtual_hosts:
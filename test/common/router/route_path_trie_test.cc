@@ -0,0 +1,104 @@
+#include <string>
+#include <vector>
+
+#include "source/common/router/route_path_trie.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+using MatchType = RoutePathTrie::MatchType;
+
+std::vector<uint32_t> findMatches(const RoutePathTrie& trie, absl::string_view path) {
+  RoutePathTrie::Matches matches;
+  trie.findMatches(path, matches);
+  return {matches.begin(), matches.end()};
+}
+
+TEST(RoutePathTrieTest, Empty) {
+  RoutePathTrie trie;
+  EXPECT_EQ(std::vector<uint32_t>(), findMatches(trie, ""));
+  EXPECT_EQ(std::vector<uint32_t>(), findMatches(trie, "/foo"));
+}
+
+TEST(RoutePathTrieTest, Prefix) {
+  RoutePathTrie trie;
+  trie.add("/foo/bar", MatchType::Prefix, 0);
+  trie.add("/foo", MatchType::Prefix, 1);
+  trie.add("/", MatchType::Prefix, 2);
+  trie.add("/fob", MatchType::Prefix, 3);
+  trie.add("", MatchType::Prefix, 4);
+
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 2, 4}), findMatches(trie, "/foo/bar/baz"));
+  EXPECT_EQ(std::vector<uint32_t>({1, 2, 4}), findMatches(trie, "/foo/ba"));
+  EXPECT_EQ(std::vector<uint32_t>({1, 2, 4}), findMatches(trie, "/foo"));
+  EXPECT_EQ(std::vector<uint32_t>({2, 3, 4}), findMatches(trie, "/fob"));
+  EXPECT_EQ(std::vector<uint32_t>({2, 4}), findMatches(trie, "/fo"));
+  EXPECT_EQ(std::vector<uint32_t>({4}), findMatches(trie, "foo"));
+  EXPECT_EQ(std::vector<uint32_t>({4}), findMatches(trie, ""));
+}
+
+TEST(RoutePathTrieTest, Exact) {
+  RoutePathTrie trie;
+  trie.add("/foo", MatchType::Exact, 0);
+  trie.add("/foo/bar", MatchType::Exact, 1);
+  trie.add("/", MatchType::Exact, 2);
+
+  EXPECT_EQ(std::vector<uint32_t>({0}), findMatches(trie, "/foo"));
+  EXPECT_EQ(std::vector<uint32_t>({1}), findMatches(trie, "/foo/bar"));
+  EXPECT_EQ(std::vector<uint32_t>({2}), findMatches(trie, "/"));
+  EXPECT_EQ(std::vector<uint32_t>(), findMatches(trie, "/foo/"));
+  EXPECT_EQ(std::vector<uint32_t>(), findMatches(trie, "/fo"));
+  EXPECT_EQ(std::vector<uint32_t>(), findMatches(trie, ""));
+}
+
+TEST(RoutePathTrieTest, PathSeparatedPrefix) {
+  RoutePathTrie trie;
+  trie.add("/foo", MatchType::PathSeparatedPrefix, 0);
+  trie.add("/foo/bar", MatchType::PathSeparatedPrefix, 1);
+
+  EXPECT_EQ(std::vector<uint32_t>({0}), findMatches(trie, "/foo"));
+  EXPECT_EQ(std::vector<uint32_t>({0}), findMatches(trie, "/foo/"));
+  EXPECT_EQ(std::vector<uint32_t>({0}), findMatches(trie, "/foo/barbaz"));
+  EXPECT_EQ(std::vector<uint32_t>({0, 1}), findMatches(trie, "/foo/bar/baz"));
+  EXPECT_EQ(std::vector<uint32_t>(), findMatches(trie, "/foobar"));
+}
+
+// Routes are found in the order they were added in, whichever matches the path more closely.
+TEST(RoutePathTrieTest, MixedAndDuplicateRoutes) {
+  RoutePathTrie trie;
+  trie.add("/", MatchType::Prefix, 0);
+  trie.add("/api/v1", MatchType::Exact, 1);
+  trie.add("/api", MatchType::PathSeparatedPrefix, 2);
+  trie.add("/api/v1", MatchType::Prefix, 3);
+  trie.add("/api/v1", MatchType::Exact, 4);
+  trie.add("/api/v2", MatchType::Prefix, 5);
+
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 2, 3, 4}), findMatches(trie, "/api/v1"));
+  EXPECT_EQ(std::vector<uint32_t>({0, 2, 3}), findMatches(trie, "/api/v1/users"));
+  EXPECT_EQ(std::vector<uint32_t>({0, 2, 5}), findMatches(trie, "/api/v2"));
+  EXPECT_EQ(std::vector<uint32_t>({0}), findMatches(trie, "/apis"));
+}
+
+// Adding a path that diverges from a compressed one in the middle splits it.
+TEST(RoutePathTrieTest, SplitPaths) {
+  RoutePathTrie trie;
+  trie.add("/shelves/shelf_1/route_1", MatchType::Exact, 0);
+  trie.add("/shelves/shelf_2/route_2", MatchType::Exact, 1);
+  trie.add("/shelves/shelf_10/route_10", MatchType::Exact, 2);
+  trie.add("/shelves/", MatchType::Prefix, 3);
+  trie.add("/shel", MatchType::Prefix, 4);
+
+  EXPECT_EQ(std::vector<uint32_t>({0, 3, 4}), findMatches(trie, "/shelves/shelf_1/route_1"));
+  EXPECT_EQ(std::vector<uint32_t>({1, 3, 4}), findMatches(trie, "/shelves/shelf_2/route_2"));
+  EXPECT_EQ(std::vector<uint32_t>({2, 3, 4}), findMatches(trie, "/shelves/shelf_10/route_10"));
+  EXPECT_EQ(std::vector<uint32_t>({3, 4}), findMatches(trie, "/shelves/shelf_1/route_10"));
+  EXPECT_EQ(std::vector<uint32_t>({4}), findMatches(trie, "/shelf"));
+  EXPECT_EQ(std::vector<uint32_t>(), findMatches(trie, "/she"));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,69 @@
+#include "source/common/router/wildcard_domain_trie.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+using MatchType = WildcardDomainTrie::MatchType;
+
+TEST(WildcardDomainTrieTest, Empty) {
+  WildcardDomainTrie trie(MatchType::Suffix);
+  EXPECT_TRUE(trie.empty());
+  EXPECT_EQ(absl::nullopt, trie.findLongestMatch(""));
+  EXPECT_EQ(absl::nullopt, trie.findLongestMatch("foo.com"));
+}
+
+TEST(WildcardDomainTrieTest, Suffix) {
+  WildcardDomainTrie trie(MatchType::Suffix);
+  EXPECT_TRUE(trie.add(".baz.com", 0));
+  EXPECT_TRUE(trie.add("-bar.baz.com", 1));
+  EXPECT_TRUE(trie.add(".foo.com", 2));
+  EXPECT_TRUE(trie.add("com", 3));
+  EXPECT_FALSE(trie.empty());
+
+  EXPECT_EQ(1, trie.findLongestMatch("foo-bar.baz.com"));
+  EXPECT_EQ(0, trie.findLongestMatch("-bar.baz.com"));
+  EXPECT_EQ(0, trie.findLongestMatch("bar.baz.com"));
+  EXPECT_EQ(2, trie.findLongestMatch("www.foo.com"));
+  EXPECT_EQ(3, trie.findLongestMatch("foo.com"));
+  EXPECT_EQ(3, trie.findLongestMatch(".foo.com"));
+  EXPECT_EQ(3, trie.findLongestMatch("lyft.com"));
+  // The wildcard must match at least one character.
+  EXPECT_EQ(absl::nullopt, trie.findLongestMatch("com"));
+  EXPECT_EQ(absl::nullopt, trie.findLongestMatch("foo.net"));
+}
+
+TEST(WildcardDomainTrieTest, Prefix) {
+  WildcardDomainTrie trie(MatchType::Prefix);
+  EXPECT_TRUE(trie.add("foo.", 0));
+  EXPECT_TRUE(trie.add("foo.bar.", 1));
+  EXPECT_TRUE(trie.add("fo", 2));
+
+  EXPECT_EQ(1, trie.findLongestMatch("foo.bar.com"));
+  EXPECT_EQ(0, trie.findLongestMatch("foo.bar."));
+  EXPECT_EQ(0, trie.findLongestMatch("foo.baz"));
+  EXPECT_EQ(2, trie.findLongestMatch("foo."));
+  EXPECT_EQ(2, trie.findLongestMatch("fob"));
+  EXPECT_EQ(absl::nullopt, trie.findLongestMatch("fo"));
+  EXPECT_EQ(absl::nullopt, trie.findLongestMatch("bar.foo."));
+}
+
+TEST(WildcardDomainTrieTest, Duplicates) {
+  WildcardDomainTrie trie(MatchType::Suffix);
+  EXPECT_TRUE(trie.add(".foo.com", 0));
+  EXPECT_TRUE(trie.add(".bar.foo.com", 1));
+  EXPECT_FALSE(trie.add(".foo.com", 2));
+  // A domain ending where another one was split is still new.
+  EXPECT_TRUE(trie.add("o.com", 3));
+  EXPECT_FALSE(trie.add("o.com", 4));
+
+  EXPECT_EQ(0, trie.findLongestMatch("www.foo.com"));
+  EXPECT_EQ(1, trie.findLongestMatch("www.bar.foo.com"));
+  EXPECT_EQ(3, trie.findLongestMatch("foo.com"));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -64,6 +64,48 @@ TEST_F(AllocatorImplTest, CountersWithSameName) {
   EXPECT_EQ(2, c2->value());
 }
 
+// Sharded counters fold the increments of all threads when read or latched.
+TEST_F(AllocatorImplTest, ShardedCounters) {
+  alloc_.setCounterShards(4);
+  StatName counter_name = makeStat("counter.name");
+  CounterSharedPtr counter = alloc_.makeCounter(counter_name, StatName(), {});
+  EXPECT_FALSE(counter->used());
+  counter->add(5);
+  EXPECT_TRUE(counter->used());
+  EXPECT_EQ(5, counter->value());
+
+  Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+  const uint32_t num_threads = 6;
+  const uint32_t iters = 1000;
+  std::vector<Thread::ThreadPtr> threads;
+  absl::Notification go;
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads.push_back(thread_factory.createThread([&]() {
+      go.WaitForNotification();
+      for (uint32_t i = 0; i < iters; ++i) {
+        counter->inc();
+      }
+    }));
+  }
+  go.Notify();
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads[i]->join();
+  }
+
+  EXPECT_EQ(5 + num_threads * iters, counter->value());
+  EXPECT_EQ(5 + num_threads * iters, counter->latch());
+  EXPECT_EQ(0, counter->latch());
+  counter->reset();
+  EXPECT_EQ(0, counter->value());
+
+  // Counters made before sharding is disabled stay sharded.
+  alloc_.setCounterShards(0);
+  CounterSharedPtr unsharded = alloc_.makeCounter(makeStat("counter.unsharded"), StatName(), {});
+  unsharded->inc();
+  EXPECT_EQ(1, unsharded->value());
+  EXPECT_EQ(counter.get(), alloc_.makeCounter(counter_name, StatName(), {}).get());
+}
+
 TEST_F(AllocatorImplTest, GaugesWithSameName) {
   StatName gauge_name = makeStat("gauges.name");
   GaugeSharedPtr g1 = alloc_.makeGauge(gauge_name, StatName(), {}, Gauge::ImportMode::Accumulate);
@@ -18,6 +18,7 @@
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/synchronization/notification.h"
 #include "benchmark/benchmark.h"
 
 namespace Envoy {
@@ -64,6 +65,27 @@ public:
     store_.initializeThreading(*dispatcher_, *tls_);
   }
 
+  void setCounterShards(uint32_t num_shards) { heap_alloc_.setCounterShards(num_shards); }
+
+  // Increments one counter from num_threads threads at once, as workers do with global counters.
+  void incrementCounterConcurrently(uint32_t num_threads, uint64_t increments_per_thread) {
+    Stats::Counter& counter = store_.rootScope()->counterFromString("downstream_rq_total");
+    std::vector<Thread::ThreadPtr> threads;
+    absl::Notification go;
+    for (uint32_t i = 0; i < num_threads; ++i) {
+      threads.push_back(api_->threadFactory().createThread([&]() {
+        go.WaitForNotification();
+        for (uint64_t j = 0; j < increments_per_thread; ++j) {
+          counter.inc();
+        }
+      }));
+    }
+    go.Notify();
+    for (auto& thread : threads) {
+      thread->join();
+    }
+  }
+
   void initPrefixRejections(const std::string& prefix) {
     stats_config_.mutable_stats_matcher()->mutable_exclusion_list()->add_patterns()->set_prefix(
         prefix);
@@ -134,5 +156,28 @@ static void BM_StatsWithTlsAndRejectionsWithoutDot(benchmark::State& state) {
 }
 BENCHMARK(BM_StatsWithTlsAndRejectionsWithoutDot);
 
+// Tests the throughput of increments of a counter shared by several threads. The second argument
+// is the number of counter shards; without shards, all threads contend on one cache line.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_CounterIncrementMultiThread(benchmark::State& state) {
+  const uint32_t num_threads = state.range(0);
+  const uint64_t increments_per_thread = 100000;
+  Envoy::ThreadLocalStorePerf context;
+  context.setCounterShards(state.range(1));
+
+  for (auto _ : state) { // NOLINT
+    context.incrementCounterConcurrently(num_threads, increments_per_thread);
+  }
+  state.SetItemsProcessed(state.iterations() * num_threads * increments_per_thread);
+}
+BENCHMARK(BM_CounterIncrementMultiThread)
+    ->Args({1, 0})
+    ->Args({4, 0})
+    ->Args({4, 4})
+    ->Args({16, 0})
+    ->Args({16, 16})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
 // TODO(jmarantz): add multi-threaded variant of this test, that aggressively
 // looks up stats in multiple threads to try to trigger contention issues.
@@ -16,6 +16,7 @@
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/mocks/upstream/cluster_priority_set.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -35,9 +36,10 @@ MATCHER_P(WithName, expectedName, "") { return arg.name() == expectedName; }
 
 class CdsApiImplTest : public testing::Test {
 protected:
-  void setup() {
+  void setup(uint32_t preparation_threads = 0) {
     envoy::config::core::v3::ConfigSource cds_config;
-    cds_ = CdsApiImpl::create(cds_config, nullptr, cm_, *store_.rootScope(), validation_visitor_);
+    cds_ = CdsApiImpl::create(cds_config, nullptr, cm_, *store_.rootScope(), validation_visitor_,
+                              Thread::threadFactoryForTest(), preparation_threads);
     cds_->setInitializedCb([this]() -> void { initialized_.ready(); });
 
     EXPECT_CALL(*cm_.subscription_factory_.subscription_, start(_));
@@ -173,6 +175,101 @@ TEST_F(CdsApiImplTest, ConfigUpdateWith2ValidClusters) {
   EXPECT_TRUE(cds_callbacks_->onConfigUpdate(decoded_resources.refvec_, "").ok());
 }
 
+// The clusters of large updates are checked and hashed on the preparation threads, which are
+// kept for the following updates.
+TEST_F(CdsApiImplTest, ConfigUpdateWithPreparationThreads) {
+  {
+    InSequence s;
+    setup(4);
+  }
+
+  EXPECT_CALL(cm_, clusters()).Times(2).WillRepeatedly(Return(makeClusterInfoMaps({})));
+  EXPECT_CALL(initialized_, ready());
+
+  // Enough clusters for two threads.
+  std::vector<envoy::config::cluster::v3::Cluster> clusters(
+      2 * CdsApiHelper::MinClustersPerPreparationThread + 1);
+  for (size_t i = 0; i < clusters.size(); i++) {
+    clusters[i].set_name(absl::StrCat("cluster_", i));
+    EXPECT_CALL(cm_, addOrUpdateCluster(WithName(clusters[i].name()), "",
+                                        MessageUtil::hash(clusters[i])))
+        .Times(2)
+        .WillRepeatedly(Return(true));
+  }
+  EXPECT_CALL(cm_, addOrUpdateCluster(_, _)).Times(0);
+
+  const auto decoded_resources = TestUtility::decodeResources(clusters);
+  EXPECT_TRUE(cds_callbacks_->onConfigUpdate(decoded_resources.refvec_, "").ok());
+  EXPECT_TRUE(cds_callbacks_->onConfigUpdate(decoded_resources.refvec_, "").ok());
+}
+
+// The clusters of small updates are checked and hashed on the main thread.
+TEST_F(CdsApiImplTest, ConfigUpdateTooSmallForPreparationThreads) {
+  {
+    InSequence s;
+    setup(4);
+  }
+
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({})));
+  EXPECT_CALL(initialized_, ready());
+
+  envoy::config::cluster::v3::Cluster cluster_1;
+  cluster_1.set_name("cluster_1");
+  EXPECT_CALL(cm_, addOrUpdateCluster(WithName("cluster_1"), "", MessageUtil::hash(cluster_1)))
+      .WillOnce(Return(true));
+  EXPECT_CALL(cm_, addOrUpdateCluster(_, _)).Times(0);
+
+  const auto decoded_resources = TestUtility::decodeResources({cluster_1});
+  EXPECT_TRUE(cds_callbacks_->onConfigUpdate(decoded_resources.refvec_, "").ok());
+}
+
+// With preparation threads, the proto constraints of the clusters are checked as they are
+// prepared rather than as they are decoded, and an invalid cluster rejects the whole update.
+TEST_F(CdsApiImplTest, ConfigUpdateWithPreparationThreadsRejectsInvalidCluster) {
+  {
+    InSequence s;
+    setup(4);
+  }
+
+  std::vector<envoy::config::cluster::v3::Cluster> clusters(
+      2 * CdsApiHelper::MinClustersPerPreparationThread + 1);
+  for (size_t i = 0; i < clusters.size(); i++) {
+    clusters[i].set_name(absl::StrCat("cluster_", i));
+  }
+  clusters[150].mutable_connect_timeout()->set_seconds(-1);
+  ProtobufWkt::Any invalid_cluster;
+  invalid_cluster.PackFrom(clusters[150]);
+  EXPECT_NO_THROW(cm_.subscription_factory_.resource_decoder_->decodeResource(invalid_cluster));
+
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({})));
+  EXPECT_CALL(initialized_, ready());
+  EXPECT_CALL(cm_, addOrUpdateCluster(_, _, _)).Times(0);
+  EXPECT_CALL(cm_, removeCluster(_)).Times(0);
+
+  const auto decoded_resources = TestUtility::decodeResources(clusters);
+  const absl::Status status = cds_callbacks_->onConfigUpdate(decoded_resources.refvec_, "1");
+  EXPECT_THAT(status.message(),
+              testing::HasSubstr("cluster_150: Proto constraint validation failed"));
+  EXPECT_EQ("", cds_->versionInfo());
+}
+
+// Without preparation threads, the proto constraints of the clusters are checked as they are
+// decoded.
+TEST_F(CdsApiImplTest, DecodingChecksConstraintsWithoutPreparationThreads) {
+  {
+    InSequence s;
+    setup();
+  }
+
+  envoy::config::cluster::v3::Cluster cluster;
+  cluster.set_name("cluster_1");
+  cluster.mutable_connect_timeout()->set_seconds(-1);
+  ProtobufWkt::Any resource;
+  resource.PackFrom(cluster);
+  EXPECT_THROW_WITH_REGEX(cm_.subscription_factory_.resource_decoder_->decodeResource(resource),
+                          EnvoyException, "Proto constraint validation failed");
+}
+
 TEST_F(CdsApiImplTest, DeltaConfigUpdate) {
   {
     InSequence s;
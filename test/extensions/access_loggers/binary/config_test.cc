@@ -0,0 +1,109 @@
+#include "envoy/config/accesslog/v3/accesslog.pb.h"
+#include "envoy/extensions/access_loggers/binary/v3/binary.pb.h"
+
+#include "source/common/access_log/access_log_impl.h"
+#include "source/extensions/access_loggers/binary/config.h"
+#include "source/extensions/access_loggers/binary/segment_format.h"
+
+#include "test/mocks/server/factory_context.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Binary {
+namespace {
+
+TEST(BinaryAccessLogConfigTest, ValidateFail) {
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+
+  EXPECT_THROW(BinaryAccessLogFactory().createAccessLogInstance(
+                   envoy::extensions::access_loggers::binary::v3::BinaryAccessLog(), nullptr,
+                   context),
+               ProtoValidationException);
+}
+
+class BinaryAccessLogTest : public testing::Test {
+protected:
+  BinaryAccessLogTest() : directory_(TestEnvironment::temporaryPath("binary_access_log")) {
+    TestEnvironment::removePath(directory_);
+    TestEnvironment::createPath(directory_);
+  }
+
+  ~BinaryAccessLogTest() override { TestEnvironment::removePath(directory_); }
+
+  AccessLog::InstanceSharedPtr createLogger(const std::string& fields) {
+    envoy::extensions::access_loggers::binary::v3::BinaryAccessLog binary_config;
+    TestUtility::loadFromYaml(fmt::format(R"EOF(
+path_prefix: "{}/log"
+fields: [{}]
+)EOF",
+                                          directory_, fields),
+                              binary_config);
+    envoy::config::accesslog::v3::AccessLog config;
+    config.set_name("envoy.access_loggers.binary");
+    config.mutable_typed_config()->PackFrom(binary_config);
+    return AccessLog::AccessLogFactory::fromProto(config, context_);
+  }
+
+  const std::string directory_;
+  Http::TestRequestHeaderMapImpl request_headers_{{":method", "GET"}, {":path", "/bar/foo"}};
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+  NiceMock<Server::Configuration::MockFactoryContext> context_;
+};
+
+TEST_F(BinaryAccessLogTest, LogFields) {
+  AccessLog::InstanceSharedPtr logger =
+      createLogger("START_TIME, DURATION, RESPONSE_CODE, BYTES_RECEIVED, PROTOCOL, REQUEST_METHOD, "
+                   "REQUEST_PATH, USER_AGENT, DOWNSTREAM_REMOTE_ADDRESS, UPSTREAM_HOST, "
+                   "UPSTREAM_CLUSTER, ROUTE_NAME");
+
+  stream_info_.start_time_ = SystemTime(std::chrono::microseconds(1700000000000000));
+  stream_info_.end_time_ = std::chrono::microseconds(1500);
+  stream_info_.response_code_ = 200;
+  stream_info_.bytes_received_ = 10;
+  stream_info_.protocol_ = Http::Protocol::Http11;
+  stream_info_.route_name_ = "route";
+  logger->log({&request_headers_}, stream_info_);
+  // Closes the segment.
+  logger.reset();
+
+  const std::string segment =
+      TestEnvironment::readFileToStringForTest(directory_ + "/log.test_thread.0.bal");
+  absl::StatusOr<SegmentReader> reader = SegmentReader::create(segment);
+  ASSERT_TRUE(reader.ok());
+  std::vector<SegmentReader::Value> values;
+  ASSERT_TRUE(reader->next(values).value());
+  ASSERT_EQ(12, values.size());
+  EXPECT_EQ(1700000000000000, absl::get<uint64_t>(values[0]));
+  EXPECT_EQ(1500, absl::get<uint64_t>(values[1]));
+  EXPECT_EQ(200, absl::get<uint64_t>(values[2]));
+  EXPECT_EQ(10, absl::get<uint64_t>(values[3]));
+  EXPECT_EQ("HTTP/1.1", absl::get<absl::string_view>(values[4]));
+  EXPECT_EQ("GET", absl::get<absl::string_view>(values[5]));
+  EXPECT_EQ("/bar/foo", absl::get<absl::string_view>(values[6]));
+  EXPECT_TRUE(absl::holds_alternative<absl::monostate>(values[7]));
+  EXPECT_EQ("127.0.0.1:0", absl::get<absl::string_view>(values[8]));
+  EXPECT_TRUE(absl::holds_alternative<absl::monostate>(values[9]));
+  EXPECT_TRUE(absl::holds_alternative<absl::monostate>(values[10]));
+  EXPECT_EQ("route", absl::get<absl::string_view>(values[11]));
+  EXPECT_FALSE(reader->next(values).value());
+
+  EXPECT_EQ(1, TestUtility::findCounter(context_.store_,
+                                        "access_logs.binary_access_log.logs_written")
+                   ->value());
+  EXPECT_EQ(1, TestUtility::findCounter(context_.store_,
+                                        "access_logs.binary_access_log.segments_created")
+                   ->value());
+}
+
+} // namespace
+} // namespace Binary
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
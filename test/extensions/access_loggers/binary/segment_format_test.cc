@@ -0,0 +1,114 @@
+#include "source/extensions/access_loggers/binary/segment_format.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Binary {
+namespace {
+
+using BinaryAccessLogConfig = envoy::extensions::access_loggers::binary::v3::BinaryAccessLog;
+
+TEST(SegmentFormatTest, Varint) {
+  uint8_t varint[SegmentFormat::MaxVarintSize];
+  EXPECT_EQ(1, SegmentFormat::writeVarint(0, varint));
+  EXPECT_EQ(0, varint[0]);
+  EXPECT_EQ(1, SegmentFormat::writeVarint(127, varint));
+  EXPECT_EQ(127, varint[0]);
+  EXPECT_EQ(2, SegmentFormat::writeVarint(300, varint));
+  EXPECT_EQ(0xac, varint[0]);
+  EXPECT_EQ(0x02, varint[1]);
+  EXPECT_EQ(SegmentFormat::MaxVarintSize, SegmentFormat::writeVarint(UINT64_MAX, varint));
+}
+
+TEST(SegmentFormatTest, Header) {
+  const std::string header = SegmentFormat::header(
+      {BinaryAccessLogConfig::RESPONSE_CODE, BinaryAccessLogConfig::REQUEST_PATH});
+  EXPECT_EQ(std::string("ENVOYBAL\x01\x02\x02\x08", 12), header);
+}
+
+TEST(SegmentFormatTest, RoundTrip) {
+  const std::vector<Field> fields{BinaryAccessLogConfig::START_TIME,
+                                  BinaryAccessLogConfig::RESPONSE_CODE,
+                                  BinaryAccessLogConfig::REQUEST_PATH,
+                                  BinaryAccessLogConfig::ROUTE_NAME};
+  std::string segment = SegmentFormat::header(fields);
+  const auto append_record = [&segment](absl::string_view record) {
+    uint8_t length[SegmentFormat::MaxVarintSize];
+    segment.append(reinterpret_cast<const char*>(length),
+                   SegmentFormat::writeVarint(record.size(), length));
+    segment.append(record.data(), record.size());
+  };
+
+  std::string record;
+  SegmentFormat::appendInteger(1700000000000000, record);
+  SegmentFormat::appendInteger(0, record);
+  SegmentFormat::appendString("/foo", record);
+  SegmentFormat::appendString("", record);
+  append_record(record);
+  record.clear();
+  SegmentFormat::appendInteger(UINT64_MAX, record);
+  SegmentFormat::appendInteger(absl::nullopt, record);
+  SegmentFormat::appendString(absl::nullopt, record);
+  SegmentFormat::appendString(std::string(200, 'a'), record);
+  append_record(record);
+  // The zeroed end of a segment still being written.
+  segment.append(16, '\0');
+
+  absl::StatusOr<SegmentReader> reader = SegmentReader::create(segment);
+  ASSERT_TRUE(reader.ok());
+  EXPECT_EQ(fields, reader->fields());
+
+  std::vector<SegmentReader::Value> values;
+  ASSERT_TRUE(reader->next(values).value());
+  ASSERT_EQ(4, values.size());
+  EXPECT_EQ(1700000000000000, absl::get<uint64_t>(values[0]));
+  EXPECT_EQ(0, absl::get<uint64_t>(values[1]));
+  EXPECT_EQ("/foo", absl::get<absl::string_view>(values[2]));
+  EXPECT_EQ("", absl::get<absl::string_view>(values[3]));
+
+  ASSERT_TRUE(reader->next(values).value());
+  ASSERT_EQ(4, values.size());
+  EXPECT_EQ(UINT64_MAX, absl::get<uint64_t>(values[0]));
+  EXPECT_TRUE(absl::holds_alternative<absl::monostate>(values[1]));
+  EXPECT_TRUE(absl::holds_alternative<absl::monostate>(values[2]));
+  EXPECT_EQ(std::string(200, 'a'), absl::get<absl::string_view>(values[3]));
+
+  EXPECT_FALSE(reader->next(values).value());
+  EXPECT_FALSE(reader->next(values).value());
+}
+
+TEST(SegmentFormatTest, InvalidHeader) {
+  EXPECT_EQ("not a binary access log segment",
+            SegmentReader::create("ENVOYLOG\x01\x01\x02").status().message());
+  EXPECT_EQ("unsupported segment version 2",
+            SegmentReader::create("ENVOYBAL\x02\x01\x02").status().message());
+  EXPECT_EQ("truncated segment header",
+            SegmentReader::create("ENVOYBAL\x01\x02\x02").status().message());
+  EXPECT_EQ("unknown field 100",
+            SegmentReader::create("ENVOYBAL\x01\x01\x64").status().message());
+}
+
+TEST(SegmentFormatTest, InvalidRecord) {
+  const std::string header = SegmentFormat::header({BinaryAccessLogConfig::REQUEST_PATH});
+
+  absl::StatusOr<SegmentReader> reader = SegmentReader::create(header + "\x05\x04/fo");
+  ASSERT_TRUE(reader.ok());
+  std::vector<SegmentReader::Value> values;
+  EXPECT_EQ("truncated record", reader->next(values).status().message());
+
+  reader = SegmentReader::create(header + "\x03\x05/fo");
+  ASSERT_TRUE(reader.ok());
+  EXPECT_EQ("truncated string field", reader->next(values).status().message());
+
+  reader = SegmentReader::create(header + "\x04\x03/fo");
+  ASSERT_TRUE(reader.ok());
+  EXPECT_EQ("record longer than its fields", reader->next(values).status().message());
+}
+
+} // namespace
+} // namespace Binary
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
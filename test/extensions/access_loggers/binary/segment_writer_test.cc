@@ -0,0 +1,154 @@
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/access_loggers/binary/segment_format.h"
+#include "source/extensions/access_loggers/binary/segment_writer.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Binary {
+namespace {
+
+using BinaryAccessLogConfig = envoy::extensions::access_loggers::binary::v3::BinaryAccessLog;
+
+class SegmentWriterTest : public testing::Test {
+protected:
+  SegmentWriterTest()
+      : directory_(TestEnvironment::temporaryPath("binary_access_log_segments")),
+        prefix_(directory_ + "/log"), api_(Api::createApiForTest()),
+        stats_{ALL_BINARY_ACCESS_LOG_STATS(
+            POOL_COUNTER_PREFIX(*store_.rootScope(), "access_logs.binary_access_log."))} {
+    TestEnvironment::removePath(directory_);
+    TestEnvironment::createPath(directory_);
+  }
+
+  ~SegmentWriterTest() override { TestEnvironment::removePath(directory_); }
+
+  // Each segment of 64 bytes holds the 11 bytes of its header and two records of 23 bytes.
+  std::unique_ptr<SegmentWriter> createWriter(uint32_t max_segments = 0) {
+    return std::make_unique<SegmentWriter>(Api::OsSysCallsSingleton::get(), time_system_, stats_,
+                                           prefix_, header_, 64, max_segments);
+  }
+
+  static std::string record(char c) {
+    std::string record;
+    SegmentFormat::appendString(std::string(21, c), record);
+    return record;
+  }
+
+  std::string segmentPath(uint64_t sequence) {
+    return absl::StrCat(prefix_, ".", sequence, ".bal");
+  }
+
+  // Returns the first character of the path of each record in a segment.
+  std::string segmentRecords(uint64_t sequence) {
+    const std::string segment = TestEnvironment::readFileToStringForTest(segmentPath(sequence));
+    absl::StatusOr<SegmentReader> reader = SegmentReader::create(segment);
+    EXPECT_TRUE(reader.ok());
+    std::string records;
+    std::vector<SegmentReader::Value> values;
+    while (reader->next(values).value()) {
+      records.push_back(absl::get<absl::string_view>(values[0])[0]);
+    }
+    return records;
+  }
+
+  uint64_t counter(absl::string_view name) {
+    return TestUtility::findCounter(store_, absl::StrCat("access_logs.binary_access_log.", name))
+        ->value();
+  }
+
+  const std::string directory_;
+  const std::string prefix_;
+  const std::string header_{SegmentFormat::header({BinaryAccessLogConfig::REQUEST_PATH})};
+  Api::ApiPtr api_;
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl store_;
+  BinaryAccessLogStats stats_;
+};
+
+TEST_F(SegmentWriterTest, WriteAndRotate) {
+  auto writer = createWriter();
+  writer->write(record('a'));
+  writer->write(record('b'));
+  writer->write(record('c'));
+
+  // The closed segment is truncated to its records, and the open one isn't yet.
+  EXPECT_EQ("ab", segmentRecords(0));
+  EXPECT_EQ(57, TestEnvironment::readFileToStringForTest(segmentPath(0)).size());
+  EXPECT_EQ(64, TestEnvironment::readFileToStringForTest(segmentPath(1)).size());
+  EXPECT_EQ("c", segmentRecords(1));
+
+  writer.reset();
+  EXPECT_EQ(34, TestEnvironment::readFileToStringForTest(segmentPath(1)).size());
+  EXPECT_EQ("c", segmentRecords(1));
+  EXPECT_EQ(3, counter("logs_written"));
+  EXPECT_EQ(2, counter("segments_created"));
+  EXPECT_EQ(0, counter("logs_dropped"));
+}
+
+TEST_F(SegmentWriterTest, MaxSegments) {
+  auto writer = createWriter(2);
+  for (char c = 'a'; c < 'f'; c++) {
+    writer->write(record(c));
+  }
+  writer.reset();
+
+  EXPECT_FALSE(api_->fileSystem().fileExists(segmentPath(0)));
+  EXPECT_EQ("cd", segmentRecords(1));
+  EXPECT_EQ("e", segmentRecords(2));
+  EXPECT_EQ(3, counter("segments_created"));
+}
+
+TEST_F(SegmentWriterTest, RecordLargerThanSegment) {
+  auto writer = createWriter();
+  std::string record;
+  SegmentFormat::appendString(std::string(60, 'a'), record);
+  writer->write(record);
+
+  EXPECT_EQ(1, counter("logs_dropped"));
+  EXPECT_EQ(0, counter("segments_created"));
+  EXPECT_FALSE(api_->fileSystem().fileExists(segmentPath(0)));
+}
+
+TEST_F(SegmentWriterTest, SkipsExistingSegments) {
+  TestEnvironment::writeStringToFileForTest(segmentPath(0), "existing", true);
+  auto writer = createWriter();
+  writer->write(record('a'));
+  writer.reset();
+
+  EXPECT_EQ("existing", TestEnvironment::readFileToStringForTest(segmentPath(0)));
+  EXPECT_EQ("a", segmentRecords(1));
+}
+
+TEST_F(SegmentWriterTest, OpenFailureRetriedAfterASecond) {
+  TestEnvironment::removePath(directory_);
+  auto writer = createWriter();
+  writer->write(record('a'));
+  writer->write(record('b'));
+  EXPECT_EQ(2, counter("logs_dropped"));
+  EXPECT_EQ(1, counter("segment_errors"));
+
+  TestEnvironment::createPath(directory_);
+  writer->write(record('c'));
+  EXPECT_EQ(3, counter("logs_dropped"));
+
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  writer->write(record('d'));
+  writer.reset();
+  EXPECT_EQ(1, counter("segment_errors"));
+  EXPECT_EQ(1, counter("logs_written"));
+  EXPECT_EQ("d", segmentRecords(1));
+}
+
+} // namespace
+} // namespace Binary
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
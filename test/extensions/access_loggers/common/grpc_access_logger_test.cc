@@ -5,10 +5,12 @@
 #include "envoy/extensions/access_loggers/grpc/v3/als.pb.h"
 #include "envoy/service/accesslog/v3/als.pb.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/buffer/zero_copy_input_stream_impl.h"
 #include "source/common/grpc/typed_async_client.h"
 #include "source/common/network/address_impl.h"
 #include "source/common/protobuf/protobuf.h"
+#include "source/common/tracing/null_span_impl.h"
 #include "source/extensions/access_loggers/common/grpc_access_logger.h"
 
 #include "test/mocks/access_log/mocks.h"
@@ -85,6 +87,11 @@ private:
     mockAddEntry(MOCK_TCP_LOG_FIELD_NAME);
   }
 
+  void removeOldestEntries(size_t count) override {
+    auto& value = message_.mutable_fields()->at(MOCK_HTTP_LOG_FIELD_NAME);
+    value.set_number_value(value.number_value() - count);
+  }
+
   bool isEmpty() override { return message_.fields().empty(); }
 
   void initMessage() override { ++num_inits_; }
@@ -332,6 +339,67 @@ TEST_F(StreamingGrpcAccessLogTest, Flushing) {
   timer_->invokeCallback();
 }
 
+// Test that the oldest entries are evicted while the stream is backed up with adaptive batching.
+TEST_F(StreamingGrpcAccessLogTest, AdaptiveBatchingEvictsOldest) {
+  InSequence s;
+  const int entry_size = mockHttpEntry().ByteSizeLong();
+  config_.mutable_adaptive_batching()->mutable_max_pending_bytes()->set_value(2 * entry_size);
+  initLogger(FlushInterval, 1);
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+
+  // The first entry fills the buffer, but the stream is backed up, so the buffer grows instead, up
+  // to the pending limit, which the second entry fills.
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).Times(3).WillRepeatedly(Return(true));
+  logger_->log(mockHttpEntry());
+  logger_->log(mockHttpEntry());
+  EXPECT_EQ(0,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_evicted")->value());
+
+  // The third entry takes the buffered entries over the pending limit, so the oldest one goes.
+  logger_->log(mockHttpEntry());
+  EXPECT_EQ(1,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_evicted")->value());
+  EXPECT_EQ(1,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_dropped")->value());
+  EXPECT_EQ(3,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_written")->value());
+
+  // The remaining entries are flushed together once the stream drains.
+  expectFlushedLogEntriesCount(stream, MOCK_HTTP_LOG_FIELD_NAME, 2);
+  EXPECT_CALL(*timer_, enableTimer(FlushInterval, _));
+  timer_->invokeCallback();
+  EXPECT_EQ(1, logger_->numClears());
+
+  // TCP logging doesn't change the logs_written counter.
+  logger_->log(ProtobufWkt::Empty());
+  EXPECT_EQ(3,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_written")->value());
+}
+
+// Test that a pending limit below the buffer size doesn't evict entries from a healthy stream.
+TEST_F(StreamingGrpcAccessLogTest, AdaptiveBatchingPendingLimitBelowBufferSize) {
+  const int entry_size = mockHttpEntry().ByteSizeLong();
+  config_.mutable_adaptive_batching()->mutable_max_pending_bytes()->set_value(entry_size);
+  initLogger(FlushInterval, 3 * entry_size);
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+
+  expectFlushedLogEntriesCount(stream, MOCK_HTTP_LOG_FIELD_NAME, 3);
+  logger_->log(mockHttpEntry());
+  logger_->log(mockHttpEntry());
+  logger_->log(mockHttpEntry());
+  EXPECT_EQ(1, logger_->numClears());
+  EXPECT_EQ(0,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_evicted")->value());
+  EXPECT_EQ(3,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_written")->value());
+}
+
 class UnaryGrpcAccessLogTest : public testing::Test {
 public:
   using MockAccessLogStream = Grpc::MockAsyncStream;
@@ -469,6 +537,54 @@ TEST_F(UnaryGrpcAccessLogTest, Flushing) {
   timer_->invokeCallback();
 }
 
+// Test that batches grow while requests are outstanding and shrink back once they complete.
+TEST_F(UnaryGrpcAccessLogTest, AdaptiveBatching) {
+  InSequence s;
+  const int entry_size = mockHttpEntry().ByteSizeLong();
+  config_.mutable_adaptive_batching()->mutable_max_buffer_size_bytes()->set_value(4 * entry_size);
+  initLogger(std::chrono::milliseconds(1000), entry_size);
+
+  std::vector<Grpc::RawAsyncRequestCallbacks*> outstanding;
+  const auto expect_request = [this, &outstanding](int count) {
+    EXPECT_CALL(*async_client_, sendRaw(_, _, _, _, _, _))
+        .WillOnce(Invoke([&outstanding, count](absl::string_view, absl::string_view,
+                                               Buffer::InstancePtr&& request,
+                                               Grpc::RawAsyncRequestCallbacks& callbacks,
+                                               Tracing::Span&,
+                                               const Http::AsyncClient::RequestOptions&) {
+          ProtobufWkt::Struct message;
+          Buffer::ZeroCopyInputStreamImpl request_stream(std::move(request));
+          EXPECT_TRUE(message.ParseFromZeroCopyStream(&request_stream));
+          EXPECT_EQ(count, message.fields().at(MOCK_HTTP_LOG_FIELD_NAME).number_value());
+          outstanding.push_back(&callbacks);
+          return nullptr;
+        }));
+  };
+
+  // The second request is sent while the first one is outstanding, so the buffer grows.
+  expect_request(1);
+  logger_->log(mockHttpEntry());
+  expect_request(1);
+  logger_->log(mockHttpEntry());
+
+  expect_request(4);
+  for (int i = 0; i < 4; i++) {
+    logger_->log(mockHttpEntry());
+  }
+
+  // Once the requests complete, the buffer shrinks back with each flush.
+  for (Grpc::RawAsyncRequestCallbacks* callbacks : outstanding) {
+    callbacks->onSuccessRaw(std::make_unique<Buffer::OwnedImpl>(), Tracing::NullSpan::instance());
+  }
+  expect_request(4);
+  for (int i = 0; i < 4; i++) {
+    logger_->log(mockHttpEntry());
+  }
+  expect_request(2);
+  logger_->log(mockHttpEntry());
+  logger_->log(mockHttpEntry());
+}
+
 class MockGrpcAccessLoggerCache
     : public Common::GrpcAccessLoggerCache<
           MockGrpcAccessLoggerImpl,
@@ -110,9 +110,10 @@ public:
   }
 
   // Set up an EDS config with multiple priorities, localities, weights and make sure
-  // they are loaded as expected.
+  // they are loaded as expected. If set, unhealthy_host is the index of the only unhealthy host.
   void priorityAndLocalityWeightedHelper(bool ignore_unknown_dynamic_fields, size_t num_hosts,
-                                         bool healthy) {
+                                         bool healthy,
+                                         absl::optional<size_t> unhealthy_host = absl::nullopt) {
     state_.PauseTiming();
 
     envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
@@ -130,7 +131,7 @@ public:
     uint32_t port = 1000;
     for (size_t i = 0; i < num_hosts; ++i) {
       auto* lb_endpoint = endpoints->add_lb_endpoints();
-      if (healthy) {
+      if (healthy && unhealthy_host != i) {
         lb_endpoint->set_health_status(envoy::config::core::v3::HEALTHY);
       } else {
         lb_endpoint->set_health_status(envoy::config::core::v3::UNHEALTHY);
@@ -241,3 +242,20 @@ static void healthOnlyUpdate(State& state) {
 }
 
 BENCHMARK(healthOnlyUpdate)->Ranges({{1, 100000}, {false, true}})->Unit(benchmark::kMillisecond);
+
+static void singleHostHealthUpdate(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    Envoy::Upstream::EdsSpeedTest speed_test(state, state.range(1));
+    uint32_t endpoints = skipExpensiveBenchmarks() ? 1 : state.range(0);
+
+    speed_test.priorityAndLocalityWeightedHelper(true, endpoints, true);
+    speed_test.priorityAndLocalityWeightedHelper(true, endpoints, true, 0);
+  }
+}
+
+BENCHMARK(singleHostHealthUpdate)
+    ->Ranges({{1, 100000}, {false, true}})
+    ->Unit(benchmark::kMillisecond);
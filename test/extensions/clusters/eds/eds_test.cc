@@ -2229,6 +2229,105 @@ TEST_F(EdsTest, EndpointHostsPerLocality) {
   }
 }
 
+// Validate that health changes of existing endpoints keep the hosts and their localities, and only
+// update the health partitions of the affected localities.
+TEST_F(EdsTest, EndpointHealthUpdatedInPlace) {
+  envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
+  cluster_load_assignment.set_cluster_name("fare");
+  uint32_t port = 1000;
+  auto add_hosts_to_locality = [&cluster_load_assignment, &port](const std::string& sub_zone,
+                                                                 uint32_t n) {
+    auto* endpoints = cluster_load_assignment.add_endpoints();
+    endpoints->mutable_locality()->set_region("oceania");
+    endpoints->mutable_locality()->set_zone("koala");
+    endpoints->mutable_locality()->set_sub_zone(sub_zone);
+
+    for (uint32_t i = 0; i < n; ++i) {
+      auto* socket_address = endpoints->add_lb_endpoints()
+                                 ->mutable_endpoint()
+                                 ->mutable_address()
+                                 ->mutable_socket_address();
+      socket_address->set_address("1.2.3.4");
+      socket_address->set_port_value(port++);
+    }
+  };
+
+  add_hosts_to_locality("ingsoc", 2);
+  add_hosts_to_locality("eucalyptus", 2);
+
+  initialize();
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_TRUE(initialized_);
+
+  const auto& host_set = *cluster_->prioritySet().hostSetsPerPriority()[0];
+  const HostVectorConstSharedPtr hosts = host_set.hostsPtr();
+  const HostsPerLocalityConstSharedPtr hosts_per_locality = host_set.hostsPerLocalityPtr();
+  EXPECT_EQ(4, host_set.healthyHosts().size());
+
+  uint32_t membership_updates = 0;
+  auto member_update_cb = cluster_->prioritySet().addMemberUpdateCb(
+      [&](const HostVector& hosts_added, const HostVector& hosts_removed) {
+        EXPECT_TRUE(hosts_added.empty());
+        EXPECT_TRUE(hosts_removed.empty());
+        ++membership_updates;
+      });
+
+  // The first locality of the host set is "eucalyptus", the second one "ingsoc".
+  const HostVectorConstSharedPtr healthy_eucalyptus_hosts =
+      host_set.healthyHostsPerLocality().get().shared(0);
+  const DegradedHostVectorConstSharedPtr degraded_hosts = host_set.degradedHostsPtr();
+  const HostsPerLocalityConstSharedPtr degraded_hosts_per_locality =
+      host_set.degradedHostsPerLocalityPtr();
+  cluster_load_assignment.mutable_endpoints(0)->mutable_lb_endpoints(1)->set_health_status(
+      envoy::config::core::v3::UNHEALTHY);
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(1, membership_updates);
+  EXPECT_EQ(hosts, host_set.hostsPtr());
+  EXPECT_EQ(hosts_per_locality, host_set.hostsPerLocalityPtr());
+  EXPECT_EQ(3, host_set.healthyHosts().size());
+  EXPECT_EQ(2, host_set.healthyHostsPerLocality().get()[0].size());
+  EXPECT_EQ(1, host_set.healthyHostsPerLocality().get()[1].size());
+  EXPECT_EQ(hosts_per_locality->get()[1][0], host_set.healthyHostsPerLocality().get()[1][0]);
+  // The unaffected locality and the partitions no host left or joined are shared.
+  EXPECT_EQ(healthy_eucalyptus_hosts, host_set.healthyHostsPerLocality().get().shared(0));
+  EXPECT_EQ(degraded_hosts, host_set.degradedHostsPtr());
+  EXPECT_EQ(degraded_hosts_per_locality, host_set.degradedHostsPerLocalityPtr());
+
+  cluster_load_assignment.mutable_endpoints(1)->mutable_lb_endpoints(0)->set_health_status(
+      envoy::config::core::v3::DEGRADED);
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(2, membership_updates);
+  EXPECT_EQ(hosts, host_set.hostsPtr());
+  EXPECT_EQ(2, host_set.healthyHosts().size());
+  EXPECT_EQ(1, host_set.healthyHostsPerLocality().get()[0].size());
+  EXPECT_EQ(1, host_set.healthyHostsPerLocality().get()[1].size());
+  EXPECT_EQ(1, host_set.degradedHosts().size());
+  EXPECT_EQ(1, host_set.degradedHostsPerLocality().get()[0].size());
+  EXPECT_EQ(0, host_set.degradedHostsPerLocality().get()[1].size());
+
+  // Weight changes keep the partitions.
+  const HostsPerLocalityConstSharedPtr healthy_hosts_per_locality =
+      host_set.healthyHostsPerLocalityPtr();
+  cluster_load_assignment.mutable_endpoints(0)
+      ->mutable_lb_endpoints(0)
+      ->mutable_load_balancing_weight()
+      ->set_value(10);
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(3, membership_updates);
+  EXPECT_EQ(hosts, host_set.hostsPtr());
+  EXPECT_EQ(healthy_hosts_per_locality, host_set.healthyHostsPerLocalityPtr());
+  EXPECT_EQ(10, hosts_per_locality->get()[1][0]->weight());
+
+  // Adding an endpoint rebuilds the host set.
+  member_update_cb.reset();
+  add_hosts_to_locality("wattle", 1);
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_NE(hosts, host_set.hostsPtr());
+  EXPECT_EQ(5, host_set.hosts().size());
+  EXPECT_EQ(3, host_set.healthyHosts().size());
+  EXPECT_EQ(3, host_set.hostsPerLocality().get().size());
+}
+
 // Validate that onConfigUpdate() updates all priorities in the prioritySet
 TEST_F(EdsTest, EndpointHostPerPriority) {
   envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
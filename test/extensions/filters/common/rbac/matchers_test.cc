@@ -144,6 +144,48 @@ TEST(OrMatcher, Principal_Set) {
   checkMatcher(RBAC::OrMatcher(set), true, conn, headers, info);
 }
 
+// The regexes of several url_path rules are matched at once.
+TEST(OrMatcher, Permission_UrlPathRegexes) {
+  envoy::config::rbac::v3::Permission::Set set;
+  for (const char* regex : {"/users/[0-9]+", "/groups/.*", "/admin"}) {
+    auto* safe_regex = set.add_rules()->mutable_url_path()->mutable_path()->mutable_safe_regex();
+    safe_regex->mutable_google_re2();
+    safe_regex->set_regex(regex);
+  }
+  set.add_rules()->mutable_url_path()->mutable_path()->set_prefix("/public/");
+  RBAC::OrMatcher matcher(set, ProtobufMessage::getStrictValidationVisitor());
+
+  Envoy::Http::TestRequestHeaderMapImpl headers;
+  checkMatcher(matcher, false, Envoy::Network::MockConnection(), headers);
+  headers.setPath("/users/123");
+  checkMatcher(matcher, true, Envoy::Network::MockConnection(), headers);
+  headers.setPath("/users/123?param=val");
+  checkMatcher(matcher, true, Envoy::Network::MockConnection(), headers);
+  headers.setPath("/users/abc");
+  checkMatcher(matcher, false, Envoy::Network::MockConnection(), headers);
+  headers.setPath("/groups/abc#fragment");
+  checkMatcher(matcher, true, Envoy::Network::MockConnection(), headers);
+  headers.setPath("/admin/1");
+  checkMatcher(matcher, false, Envoy::Network::MockConnection(), headers);
+  headers.setPath("/public/1");
+  checkMatcher(matcher, true, Envoy::Network::MockConnection(), headers);
+}
+
+TEST(OrMatcher, Principal_UrlPathRegexes) {
+  envoy::config::rbac::v3::Principal::Set set;
+  for (const char* regex : {"/users/[0-9]+", "/groups/.*"}) {
+    auto* safe_regex = set.add_ids()->mutable_url_path()->mutable_path()->mutable_safe_regex();
+    safe_regex->mutable_google_re2();
+    safe_regex->set_regex(regex);
+  }
+  RBAC::OrMatcher matcher(set);
+
+  Envoy::Http::TestRequestHeaderMapImpl headers{{":path", "/groups/abc"}};
+  checkMatcher(matcher, true, Envoy::Network::MockConnection(), headers);
+  headers.setPath("/users/abc");
+  checkMatcher(matcher, false, Envoy::Network::MockConnection(), headers);
+}
+
 TEST(NotMatcher, Permission) {
   envoy::config::rbac::v3::Permission perm;
   perm.set_any(true);
@@ -0,0 +1,134 @@
+#include "source/extensions/filters/http/cache/cache_fill.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+class CacheFillTest : public ::testing::Test {
+protected:
+  Key makeKey(absl::string_view path) {
+    Key key;
+    key.set_host("example.com");
+    key.set_path(std::string(path));
+    return key;
+  }
+
+  CacheFillManagerSharedPtr manager_ = std::make_shared<CacheFillManager>(/*max_buffer_bytes=*/6);
+  Api::ApiPtr api_ = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher_ = api_->allocateDispatcher("test_thread");
+  Http::TestResponseHeaderMapImpl response_headers_{{":status", "200"}};
+};
+
+TEST_F(CacheFillTest, FirstAcquireLeads) {
+  auto [fill1, leader1] = manager_->acquire(makeKey("/a"));
+  auto [fill2, leader2] = manager_->acquire(makeKey("/a"));
+  auto [fill3, leader3] = manager_->acquire(makeKey("/b"));
+  EXPECT_TRUE(leader1);
+  EXPECT_FALSE(leader2);
+  EXPECT_TRUE(leader3);
+  EXPECT_EQ(fill1, fill2);
+  EXPECT_NE(fill1, fill3);
+  EXPECT_EQ(manager_->size(), 2);
+}
+
+TEST_F(CacheFillTest, InsertCompleteUnregisters) {
+  CacheFillSharedPtr fill = manager_->acquire(makeKey("/a")).first;
+  fill->onHeaders(response_headers_, true);
+  fill->onInsertComplete();
+  EXPECT_EQ(manager_->size(), 0);
+  // A later miss starts a new fill.
+  EXPECT_TRUE(manager_->acquire(makeKey("/a")).second);
+}
+
+TEST_F(CacheFillTest, ReadReturnsOnlyUnreadParts) {
+  CacheFillSharedPtr fill = manager_->acquire(makeKey("/a")).first;
+  EXPECT_EQ(fill->read(false, 0).headers_, nullptr);
+
+  fill->onHeaders(response_headers_, false);
+  fill->onBody(Buffer::OwnedImpl("abc"), false);
+  CacheFillUpdate update = fill->read(false, 0);
+  ASSERT_NE(update.headers_, nullptr);
+  EXPECT_THAT(*update.headers_, HeaderMapEqualRef(&response_headers_));
+  EXPECT_EQ(update.body_.toString(), "abc");
+  EXPECT_FALSE(update.end_stream_);
+
+  fill->onBody(Buffer::OwnedImpl("def"), false);
+  fill->onTrailers(Http::TestResponseTrailerMapImpl{{"grpc-status", "0"}});
+  update = fill->read(true, 3);
+  EXPECT_EQ(update.headers_, nullptr);
+  EXPECT_EQ(update.body_.toString(), "def");
+  ASSERT_NE(update.trailers_, nullptr);
+  EXPECT_EQ(update.trailers_->get(Http::LowerCaseString("grpc-status"))[0]->value(), "0");
+  EXPECT_TRUE(update.end_stream_);
+  EXPECT_FALSE(update.failed_);
+}
+
+TEST_F(CacheFillTest, AbortFailsIncompleteFill) {
+  CacheFillSharedPtr fill = manager_->acquire(makeKey("/a")).first;
+  fill->onHeaders(response_headers_, false);
+  fill->abort();
+  EXPECT_TRUE(fill->read(true, 0).failed_);
+  EXPECT_EQ(manager_->size(), 0);
+}
+
+TEST_F(CacheFillTest, AbortDoesNotFailCompleteFill) {
+  CacheFillSharedPtr fill = manager_->acquire(makeKey("/a")).first;
+  fill->onHeaders(response_headers_, false);
+  fill->onBody(Buffer::OwnedImpl("abc"), true);
+  fill->abort();
+  CacheFillUpdate update = fill->read(false, 0);
+  EXPECT_FALSE(update.failed_);
+  EXPECT_TRUE(update.end_stream_);
+  EXPECT_EQ(update.body_.toString(), "abc");
+  EXPECT_EQ(manager_->size(), 0);
+}
+
+TEST_F(CacheFillTest, BodyLargerThanMaxBufferFailsFill) {
+  CacheFillSharedPtr fill = manager_->acquire(makeKey("/a")).first;
+  fill->onHeaders(response_headers_, false);
+  fill->onBody(Buffer::OwnedImpl("abcdef"), false);
+  EXPECT_EQ(fill->read(false, 0).body_.toString(), "abcdef");
+  fill->onBody(Buffer::OwnedImpl("g"), false);
+  EXPECT_TRUE(fill->read(true, 6).failed_);
+  EXPECT_EQ(manager_->size(), 0);
+  // The leader keeps writing the rest of the response, which is ignored.
+  fill->onBody(Buffer::OwnedImpl("h"), true);
+  EXPECT_TRUE(fill->read(false, 0).failed_);
+}
+
+TEST_F(CacheFillTest, ContentLengthLargerThanMaxBufferFailsFill) {
+  CacheFillSharedPtr fill = manager_->acquire(makeKey("/a")).first;
+  response_headers_.setContentLength(7);
+  fill->onHeaders(response_headers_, false);
+  CacheFillUpdate update = fill->read(false, 0);
+  EXPECT_TRUE(update.failed_);
+  EXPECT_EQ(update.headers_, nullptr);
+  EXPECT_EQ(manager_->size(), 0);
+}
+
+TEST_F(CacheFillTest, SubscribersAreNotifiedOnTheirDispatcher) {
+  CacheFillSharedPtr fill = manager_->acquire(makeKey("/a")).first;
+  int updates = 0;
+  fill->subscribe(*dispatcher_, [&updates]() { updates++; });
+  // Subscribing posts an initial update so that late subscribers catch up.
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(updates, 1);
+
+  fill->onHeaders(response_headers_, false);
+  fill->onBody(Buffer::OwnedImpl("abc"), true);
+  EXPECT_EQ(updates, 1);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(updates, 3);
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
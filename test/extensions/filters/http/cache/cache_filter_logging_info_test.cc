@@ -18,6 +18,9 @@ TEST(Coverage, LookupStatusToString) {
             "StaleHitWithSuccessfulValidation");
   EXPECT_EQ(lookupStatusToString(LookupStatus::StaleHitWithFailedValidation),
             "StaleHitWithFailedValidation");
+  EXPECT_EQ(lookupStatusToString(LookupStatus::StaleHitWhileRevalidating),
+            "StaleHitWhileRevalidating");
+  EXPECT_EQ(lookupStatusToString(LookupStatus::StaleHitOnError), "StaleHitOnError");
   EXPECT_EQ(lookupStatusToString(LookupStatus::NotModifiedHit), "NotModifiedHit");
   EXPECT_EQ(lookupStatusToString(LookupStatus::RequestNotCacheable), "RequestNotCacheable");
   EXPECT_EQ(lookupStatusToString(LookupStatus::RequestIncomplete), "RequestIncomplete");
@@ -1,11 +1,14 @@
 #include "envoy/event/dispatcher.h"
 
 #include "source/common/http/headers.h"
+#include "source/common/http/message_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
 #include "source/extensions/filters/http/cache/cache_filter.h"
 #include "source/extensions/filters/http/cache/cache_filter_logging_info.h"
 #include "source/extensions/http/cache/simple_http_cache/simple_http_cache.h"
 
 #include "test/extensions/filters/http/cache/mocks.h"
+#include "test/mocks/http/mocks.h"
 #include "test/mocks/server/factory_context.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/status_utility.h"
@@ -22,6 +25,8 @@ namespace Cache {
 namespace {
 
 using ::Envoy::StatusHelpers::IsOkAndHolds;
+using ::testing::_;
+using ::testing::Invoke;
 using ::testing::IsNull;
 using ::testing::NotNull;
 
@@ -31,8 +36,8 @@ protected:
   // cache callbacks.
   CacheFilterSharedPtr makeFilter(std::shared_ptr<HttpCache> cache, bool auto_destroy = true) {
     std::shared_ptr<CacheFilter> filter(
-        new CacheFilter(config_, /*stats_prefix=*/"", context_.scope(),
-                        context_.server_factory_context_.timeSource(), cache),
+        new CacheFilter(config_, sharedState(), context_.server_factory_context_.timeSource(),
+                        cache),
         [auto_destroy](CacheFilter* f) {
           if (auto_destroy) {
             f->onDestroy();
@@ -46,6 +51,21 @@ protected:
     return filter;
   }
 
+  // Created on first use, so that tests can set fill_manager_ first.
+  CacheFilterSharedStateSharedPtr sharedState() {
+    if (shared_state_ == nullptr) {
+      shared_state_ = std::make_shared<CacheFilterSharedState>(
+          config_, /*stats_prefix=*/"", *stats_store_.rootScope(),
+          context_.server_factory_context_.cluster_manager_, fill_manager_);
+    }
+    return shared_state_;
+  }
+
+  uint64_t counterValue(const std::string& name) {
+    Stats::CounterSharedPtr counter = TestUtility::findCounter(stats_store_, name);
+    return counter == nullptr ? 0 : counter->value();
+  }
+
   void SetUp() override {
     ON_CALL(encoder_callbacks_, dispatcher()).WillByDefault(::testing::ReturnRef(*dispatcher_));
     ON_CALL(decoder_callbacks_, dispatcher()).WillByDefault(::testing::ReturnRef(*dispatcher_));
@@ -161,8 +181,12 @@ protected:
 
   void waitBeforeSecondRequest() { time_source_.advanceTimeWait(delay_); }
 
-  std::shared_ptr<SimpleHttpCache> simple_cache_ = std::make_shared<SimpleHttpCache>();
+  Stats::IsolatedStoreImpl stats_store_;
+  std::shared_ptr<SimpleHttpCache> simple_cache_ =
+      std::make_shared<SimpleHttpCache>(SimpleHttpCacheConfig(), *stats_store_.rootScope());
   envoy::extensions::filters::http::cache::v3::CacheConfig config_;
+  CacheFillManagerSharedPtr fill_manager_;
+  CacheFilterSharedStateSharedPtr shared_state_;
   std::shared_ptr<StreamInfo::FilterState> filter_state_ =
       std::make_shared<StreamInfo::FilterStateImpl>(StreamInfo::FilterState::LifeSpan::FilterChain);
   NiceMock<Server::Configuration::MockFactoryContext> context_;
@@ -257,6 +281,155 @@ TEST_F(CacheFilterTest, CacheMiss) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+TEST_F(CacheFilterTest, CoalescedRequestStreamsLeaderResponse) {
+  request_headers_.setHost("CoalescedRequestStreamsLeaderResponse");
+  fill_manager_ = std::make_shared<CacheFillManager>(/*max_buffer_bytes=*/1024);
+  const std::string body = "abc";
+  Buffer::OwnedImpl body_buffer(body);
+
+  CacheFilterSharedPtr leader = makeFilter(simple_cache_);
+  testDecodeRequestMiss(leader);
+
+  CacheFilterSharedPtr waiter = makeFilter(simple_cache_);
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> waiter_callbacks;
+  ON_CALL(waiter_callbacks, dispatcher()).WillByDefault(::testing::ReturnRef(*dispatcher_));
+  waiter->setDecoderFilterCallbacks(waiter_callbacks);
+
+  // The second request neither goes upstream nor serves anything until the first request's
+  // response arrives.
+  EXPECT_CALL(waiter_callbacks, continueDecoding).Times(0);
+  EXPECT_CALL(waiter_callbacks, encodeHeaders_).Times(0);
+  EXPECT_EQ(waiter->decodeHeaders(request_headers_, true),
+            Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&waiter_callbacks);
+
+  EXPECT_CALL(waiter_callbacks, encodeHeaders_(IsSupersetOfHeaders(response_headers_), false));
+  EXPECT_CALL(waiter_callbacks,
+              encodeData(testing::Property(&Buffer::Instance::toString, testing::Eq(body)), true));
+  EXPECT_EQ(leader->encodeHeaders(response_headers_, false), Http::FilterHeadersStatus::Continue);
+  EXPECT_EQ(leader->encodeData(body_buffer, true), Http::FilterDataStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&waiter_callbacks);
+
+  // The insert is complete, so later requests are served by the cache rather than the fill.
+  EXPECT_EQ(fill_manager_->size(), 0);
+}
+
+TEST_F(CacheFilterTest, CoalescedRequestGoesUpstreamIfResponseNotCacheable) {
+  request_headers_.setHost("CoalescedRequestGoesUpstreamIfResponseNotCacheable");
+  response_headers_.setReferenceKey(Http::CustomHeaders::get().CacheControl, "no-store");
+  fill_manager_ = std::make_shared<CacheFillManager>(/*max_buffer_bytes=*/1024);
+
+  CacheFilterSharedPtr leader = makeFilter(simple_cache_);
+  testDecodeRequestMiss(leader);
+
+  CacheFilterSharedPtr waiter = makeFilter(simple_cache_);
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> waiter_callbacks;
+  ON_CALL(waiter_callbacks, dispatcher()).WillByDefault(::testing::ReturnRef(*dispatcher_));
+  waiter->setDecoderFilterCallbacks(waiter_callbacks);
+  EXPECT_EQ(waiter->decodeHeaders(request_headers_, true),
+            Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  EXPECT_CALL(waiter_callbacks, encodeHeaders_).Times(0);
+  EXPECT_CALL(waiter_callbacks, continueDecoding);
+  EXPECT_EQ(leader->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&waiter_callbacks);
+  EXPECT_EQ(fill_manager_->size(), 0);
+}
+
+TEST_F(CacheFilterTest, CoalescedRequestGoesUpstreamIfResponseTooLarge) {
+  request_headers_.setHost("CoalescedRequestGoesUpstreamIfResponseTooLarge");
+  fill_manager_ = std::make_shared<CacheFillManager>(/*max_buffer_bytes=*/2);
+
+  CacheFilterSharedPtr leader = makeFilter(simple_cache_);
+  testDecodeRequestMiss(leader);
+
+  CacheFilterSharedPtr waiter = makeFilter(simple_cache_);
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> waiter_callbacks;
+  ON_CALL(waiter_callbacks, dispatcher()).WillByDefault(::testing::ReturnRef(*dispatcher_));
+  waiter->setDecoderFilterCallbacks(waiter_callbacks);
+  EXPECT_EQ(waiter->decodeHeaders(request_headers_, true),
+            Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  // The response is too large to buffer for the waiting request, which goes upstream, while the
+  // first request still inserts it.
+  EXPECT_CALL(waiter_callbacks, encodeHeaders_).Times(0);
+  EXPECT_CALL(waiter_callbacks, continueDecoding);
+  EXPECT_CALL(waiter_callbacks, removeDownstreamWatermarkCallbacks(_));
+  response_headers_.setContentLength(3);
+  Buffer::OwnedImpl body("abc");
+  EXPECT_EQ(leader->encodeHeaders(response_headers_, false), Http::FilterHeadersStatus::Continue);
+  EXPECT_EQ(leader->encodeData(body, true), Http::FilterDataStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&waiter_callbacks);
+  EXPECT_EQ(fill_manager_->size(), 0);
+}
+
+TEST_F(CacheFilterTest, CoalescedRequestWaitsForDownstreamToDrain) {
+  request_headers_.setHost("CoalescedRequestWaitsForDownstreamToDrain");
+  fill_manager_ = std::make_shared<CacheFillManager>(/*max_buffer_bytes=*/1024);
+  const std::string body = "abc";
+  Buffer::OwnedImpl body_buffer(body);
+
+  CacheFilterSharedPtr leader = makeFilter(simple_cache_);
+  testDecodeRequestMiss(leader);
+
+  CacheFilterSharedPtr waiter = makeFilter(simple_cache_);
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> waiter_callbacks;
+  ON_CALL(waiter_callbacks, dispatcher()).WillByDefault(::testing::ReturnRef(*dispatcher_));
+  waiter->setDecoderFilterCallbacks(waiter_callbacks);
+  EXPECT_CALL(waiter_callbacks, addDownstreamWatermarkCallbacks(_));
+  EXPECT_EQ(waiter->decodeHeaders(request_headers_, true),
+            Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&waiter_callbacks);
+
+  // The headers are served, but the body waits while the downstream is backed up.
+  EXPECT_CALL(waiter_callbacks, encodeHeaders_(IsSupersetOfHeaders(response_headers_), false));
+  EXPECT_CALL(waiter_callbacks, encodeData).Times(0);
+  EXPECT_EQ(leader->encodeHeaders(response_headers_, false), Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  waiter->onAboveWriteBufferHighWatermark();
+  EXPECT_EQ(leader->encodeData(body_buffer, true), Http::FilterDataStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&waiter_callbacks);
+
+  EXPECT_CALL(waiter_callbacks,
+              encodeData(testing::Property(&Buffer::Instance::toString, testing::Eq(body)), true));
+  EXPECT_CALL(waiter_callbacks, removeDownstreamWatermarkCallbacks(_));
+  waiter->onBelowWriteBufferLowWatermark();
+  ::testing::Mock::VerifyAndClearExpectations(&waiter_callbacks);
+}
+
+TEST_F(CacheFilterTest, CoalescedRequestGoesUpstreamAfterMaxWait) {
+  request_headers_.setHost("CoalescedRequestGoesUpstreamAfterMaxWait");
+  config_.mutable_request_coalescing()->mutable_max_wait()->set_seconds(1);
+  fill_manager_ = std::make_shared<CacheFillManager>(/*max_buffer_bytes=*/1024);
+
+  CacheFilterSharedPtr leader = makeFilter(simple_cache_);
+  testDecodeRequestMiss(leader);
+
+  CacheFilterSharedPtr waiter = makeFilter(simple_cache_);
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> waiter_callbacks;
+  ON_CALL(waiter_callbacks, dispatcher()).WillByDefault(::testing::ReturnRef(*dispatcher_));
+  waiter->setDecoderFilterCallbacks(waiter_callbacks);
+  EXPECT_EQ(waiter->decodeHeaders(request_headers_, true),
+            Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  EXPECT_CALL(waiter_callbacks, continueDecoding);
+  time_source_.advanceTimeAndRun(std::chrono::seconds(1), *dispatcher_,
+                                 Event::Dispatcher::RunType::NonBlock);
+  ::testing::Mock::VerifyAndClearExpectations(&waiter_callbacks);
+
+  // The first request is still filling the cache.
+  EXPECT_EQ(fill_manager_->size(), 1);
+}
+
 TEST_F(CacheFilterTest, Disabled) {
   request_headers_.setHost("CacheDisabled");
   CacheFilterSharedPtr filter = makeFilter(std::shared_ptr<HttpCache>{});
@@ -809,6 +982,205 @@ TEST_F(CacheFilterTest, UnsuccessfulValidation) {
   }
 }
 
+TEST_F(CacheFilterTest, StaleWhileRevalidateServesStaleAndFreshensInBackground) {
+  request_headers_.setHost("StaleWhileRevalidate");
+  config_.set_serve_stale_while_revalidate(true);
+  const std::string body = "abc";
+  const std::string etag = "abc123";
+  context_.server_factory_context_.cluster_manager_.initializeThreadLocalClusters(
+      {"fake_cluster"});
+  Http::MockAsyncClient& async_client =
+      context_.server_factory_context_.cluster_manager_.thread_local_cluster_.async_client_;
+  {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+    testDecodeRequestMiss(filter);
+    response_headers_.setReferenceKey(Http::CustomHeaders::get().CacheControl,
+                                      "public, max-age=5, stale-while-revalidate=60");
+    response_headers_.setReferenceKey(Http::CustomHeaders::get().Etag, etag);
+    response_headers_.setContentLength(body.size());
+    Buffer::OwnedImpl buffer(body);
+    EXPECT_EQ(filter->encodeHeaders(response_headers_, false), Http::FilterHeadersStatus::Continue);
+    EXPECT_EQ(filter->encodeData(buffer, true), Http::FilterDataStatus::Continue);
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+  }
+  waitBeforeSecondRequest();
+  Http::AsyncClient::Callbacks* revalidation_callbacks = nullptr;
+  Http::MockAsyncClientRequest revalidation_request(&async_client);
+  {
+    // The stale response is served straight away, and revalidated with a conditional request.
+    EXPECT_CALL(async_client, send_(_, _, _))
+        .WillOnce(Invoke([&](Http::RequestMessagePtr& message, Http::AsyncClient::Callbacks& cb,
+                             const Http::AsyncClient::RequestOptions&) {
+          EXPECT_THAT(message->headers(), HeaderHasValueRef("if-none-match", etag));
+          revalidation_callbacks = &cb;
+          return &revalidation_request;
+        }));
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+    testDecodeRequestHitWithBody(filter, body);
+    filter->onStreamComplete();
+    EXPECT_THAT(lookupStatus(), IsOkAndHolds(LookupStatus::StaleHitWhileRevalidating));
+  }
+  ASSERT_NE(revalidation_callbacks, nullptr);
+  EXPECT_EQ(counterValue("cache.stale_while_revalidate_served"), 1);
+  EXPECT_EQ(counterValue("cache.background_revalidation_started"), 1);
+  {
+    // Stale hits while the revalidation is in flight don't start another one.
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+    testDecodeRequestHitWithBody(filter, body);
+    EXPECT_EQ(counterValue("cache.stale_while_revalidate_served"), 2);
+    EXPECT_EQ(counterValue("cache.background_revalidation_started"), 1);
+  }
+
+  revalidation_callbacks->onSuccess(
+      revalidation_request,
+      std::make_unique<Http::ResponseMessageImpl>(Http::ResponseHeaderMapPtr{
+          new Http::TestResponseHeaderMapImpl{{":status", "304"},
+                                              {"date", formatter_.now(time_source_)}}}));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(counterValue("cache.background_revalidation_not_modified"), 1);
+  {
+    // The freshened response is a plain cache hit.
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+    EXPECT_CALL(decoder_callbacks_,
+                encodeHeaders_(HeaderHasValueRef(Http::CustomHeaders::get().Age, "0"), false));
+    EXPECT_EQ(filter->decodeHeaders(request_headers_, true),
+              Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+    filter->onStreamComplete();
+    EXPECT_THAT(lookupStatus(), IsOkAndHolds(LookupStatus::CacheHit));
+  }
+}
+
+TEST_F(CacheFilterTest, StaleWhileRevalidateReplacesChangedResponse) {
+  request_headers_.setHost("StaleWhileRevalidateReplaces");
+  config_.set_serve_stale_while_revalidate(true);
+  context_.server_factory_context_.cluster_manager_.initializeThreadLocalClusters(
+      {"fake_cluster"});
+  Http::MockAsyncClient& async_client =
+      context_.server_factory_context_.cluster_manager_.thread_local_cluster_.async_client_;
+  response_headers_.setReferenceKey(Http::CustomHeaders::get().CacheControl,
+                                    "public, max-age=5, stale-while-revalidate=60");
+  {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+    testDecodeRequestMiss(filter);
+    response_headers_.setContentLength(3);
+    Buffer::OwnedImpl buffer("abc");
+    EXPECT_EQ(filter->encodeHeaders(response_headers_, false), Http::FilterHeadersStatus::Continue);
+    EXPECT_EQ(filter->encodeData(buffer, true), Http::FilterDataStatus::Continue);
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+  }
+  waitBeforeSecondRequest();
+  Http::AsyncClient::Callbacks* revalidation_callbacks = nullptr;
+  Http::MockAsyncClientRequest revalidation_request(&async_client);
+  EXPECT_CALL(async_client, send_(_, _, _))
+      .WillOnce(Invoke([&](Http::RequestMessagePtr&, Http::AsyncClient::Callbacks& cb,
+                           const Http::AsyncClient::RequestOptions&) {
+        revalidation_callbacks = &cb;
+        return &revalidation_request;
+      }));
+  {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+    testDecodeRequestHitWithBody(filter, "abc");
+  }
+  ASSERT_NE(revalidation_callbacks, nullptr);
+
+  auto new_response = std::make_unique<Http::ResponseMessageImpl>(
+      Http::ResponseHeaderMapPtr{new Http::TestResponseHeaderMapImpl{
+          {":status", "200"},
+          {"cache-control", "public, max-age=3600"},
+          {"date", formatter_.now(time_source_)}}});
+  new_response->body().add("new body");
+  revalidation_callbacks->onSuccess(revalidation_request, std::move(new_response));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(counterValue("cache.background_revalidation_replaced"), 1);
+  {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+    EXPECT_CALL(decoder_callbacks_,
+                encodeData(testing::Property(&Buffer::Instance::toString, "new body"), true));
+    EXPECT_EQ(filter->decodeHeaders(request_headers_, true),
+              Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+    filter->onStreamComplete();
+    EXPECT_THAT(lookupStatus(), IsOkAndHolds(LookupStatus::CacheHit));
+  }
+}
+
+TEST_F(CacheFilterTest, StaleWhileRevalidateValidatesUnlessEnabled) {
+  request_headers_.setHost("StaleWhileRevalidateDisabled");
+  const std::string etag = "abc123";
+  context_.server_factory_context_.cluster_manager_.initializeThreadLocalClusters(
+      {"fake_cluster"});
+  Http::MockAsyncClient& async_client =
+      context_.server_factory_context_.cluster_manager_.thread_local_cluster_.async_client_;
+  {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+    testDecodeRequestMiss(filter);
+    response_headers_.setReferenceKey(Http::CustomHeaders::get().CacheControl,
+                                      "public, max-age=5, stale-while-revalidate=60");
+    response_headers_.setReferenceKey(Http::CustomHeaders::get().Etag, etag);
+    response_headers_.setContentLength(3);
+    Buffer::OwnedImpl buffer("abc");
+    EXPECT_EQ(filter->encodeHeaders(response_headers_, false), Http::FilterHeadersStatus::Continue);
+    EXPECT_EQ(filter->encodeData(buffer, true), Http::FilterDataStatus::Continue);
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+  }
+  waitBeforeSecondRequest();
+  {
+    // Without serve_stale_while_revalidate, the stale response is validated before it is served.
+    EXPECT_CALL(async_client, send_(_, _, _)).Times(0);
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+    testDecodeRequestMiss(filter);
+    EXPECT_THAT(request_headers_, HeaderHasValueRef("if-none-match", etag));
+    filter->onStreamComplete();
+    EXPECT_THAT(lookupStatus(), IsOkAndHolds(LookupStatus::RequestIncomplete));
+  }
+  EXPECT_EQ(counterValue("cache.stale_while_revalidate_served"), 0);
+  EXPECT_EQ(counterValue("cache.background_revalidation_started"), 0);
+}
+
+TEST_F(CacheFilterTest, StaleIfErrorServesStaleOnServerError) {
+  request_headers_.setHost("StaleIfError");
+  const std::string body = "abc";
+  {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+    testDecodeRequestMiss(filter);
+    response_headers_.setReferenceKey(Http::CustomHeaders::get().CacheControl,
+                                      "public, max-age=5, stale-if-error=60");
+    response_headers_.setContentLength(body.size());
+    Buffer::OwnedImpl buffer(body);
+    EXPECT_EQ(filter->encodeHeaders(response_headers_, false), Http::FilterHeadersStatus::Continue);
+    EXPECT_EQ(filter->encodeData(buffer, true), Http::FilterDataStatus::Continue);
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+  }
+  waitBeforeSecondRequest();
+  {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+    // The stale response requires validation.
+    testDecodeRequestMiss(filter);
+
+    // The upstream fails; the stale response is served in place of the error.
+    Http::TestResponseHeaderMapImpl error_headers{{":status", "503"}};
+    EXPECT_EQ(filter->encodeHeaders(error_headers, false), Http::FilterHeadersStatus::StopIteration);
+    EXPECT_THAT(error_headers, IsSupersetOfHeaders(response_headers_));
+    EXPECT_THAT(error_headers, HeaderHasValueRef(Http::CustomHeaders::get().Age, age));
+
+    Buffer::OwnedImpl error_body("upstream unavailable");
+    EXPECT_EQ(filter->encodeData(error_body, true),
+              Http::FilterDataStatus::StopIterationAndBuffer);
+    EXPECT_EQ(error_body.length(), 0);
+    EXPECT_CALL(
+        encoder_callbacks_,
+        addEncodedData(testing::Property(&Buffer::Instance::toString, testing::Eq(body)), true));
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+    ::testing::Mock::VerifyAndClearExpectations(&encoder_callbacks_);
+
+    filter->onStreamComplete();
+    EXPECT_THAT(lookupStatus(), IsOkAndHolds(LookupStatus::StaleHitOnError));
+    EXPECT_THAT(insertStatus(), IsOkAndHolds(InsertStatus::NoInsertCacheHit));
+  }
+  EXPECT_EQ(counterValue("cache.stale_if_error_served"), 1);
+}
+
 TEST_F(CacheFilterTest, SingleSatisfiableRange) {
   request_headers_.setHost("SingleSatisfiableRange");
   const std::string body = "abc";
@@ -1167,6 +1539,9 @@ TEST(LookupStatusDeathTest, ResolveLookupStatusRequireValidationAndDestroyedIsBu
 }
 
 TEST(LookupStatusTest, ResolveLookupStatusReturnsCorrectStatuses) {
+  EXPECT_EQ(CacheFilter::resolveLookupStatus(CacheEntryStatus::StaleWhileRevalidate,
+                                             FilterState::ResponseServedFromCache),
+            LookupStatus::StaleHitWhileRevalidating);
   EXPECT_EQ(CacheFilter::resolveLookupStatus(absl::nullopt, FilterState::Initial),
             LookupStatus::RequestIncomplete);
   EXPECT_EQ(CacheFilter::resolveLookupStatus(absl::nullopt, FilterState::NotServingFromCache),
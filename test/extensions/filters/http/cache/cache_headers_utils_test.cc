@@ -175,6 +175,28 @@ TEST(ResponseCacheControl, StreamingTest) {
   EXPECT_EQ(os.str(), "{must_validate, no_store, no_transform, no_stale, max-age=0}");
 }
 
+TEST(ResponseCacheControl, StreamingStaleDirectivesTest) {
+  std::ostringstream os;
+  ResponseCacheControl response_cache_control(
+      "max-age=10, stale-while-revalidate=20, stale-if-error=30");
+  os << response_cache_control;
+  EXPECT_EQ(os.str(), "{max-age=10, stale-while-revalidate=20, stale-if-error=30}");
+}
+
+TEST(ResponseCacheControl, StaleDirectives) {
+  ResponseCacheControl response_cache_control(
+      "max-age=10, stale-while-revalidate=\"20\", stale-if-error=30");
+  EXPECT_EQ(response_cache_control.stale_while_revalidate_, Seconds(20));
+  EXPECT_EQ(response_cache_control.stale_if_error_, Seconds(30));
+
+  // Invalid durations are ignored.
+  ResponseCacheControl invalid("max-age=10, stale-while-revalidate=soon, stale-if-error");
+  EXPECT_EQ(invalid.stale_while_revalidate_, absl::nullopt);
+  EXPECT_EQ(invalid.stale_if_error_, absl::nullopt);
+  EXPECT_EQ(invalid, ResponseCacheControl("max-age=10"));
+  EXPECT_FALSE(response_cache_control == ResponseCacheControl("max-age=10"));
+}
+
 struct TestResponseCacheControl : public ResponseCacheControl {
   TestResponseCacheControl(bool must_validate, bool no_store, bool no_transform, bool no_stale,
                            bool is_public, OptionalDuration max_age) {
@@ -165,6 +165,35 @@ public:
                             /*response_date=*/currentTime(),
                             /*expected_result=*/CacheEntryStatus::Ok,
                             /*expected_age=*/"999"},
+                           {"expired_within_stale_while_revalidate",
+                            /*request_cache_control=*/"",
+                            /*response_cache_control=*/"max-age=1000, stale-while-revalidate=500",
+                            /*request_time=*/currentTime() + Seconds(1500),
+                            /*response_date=*/currentTime(),
+                            /*expected_result=*/CacheEntryStatus::StaleWhileRevalidate,
+                            /*expected_age=*/"1500"},
+                           {"expired_beyond_stale_while_revalidate",
+                            /*request_cache_control=*/"",
+                            /*response_cache_control=*/"max-age=1000, stale-while-revalidate=500",
+                            /*request_time=*/currentTime() + Seconds(1501),
+                            /*response_date=*/currentTime(),
+                            /*expected_result=*/CacheEntryStatus::RequiresValidation,
+                            /*expected_age=*/"1501"},
+                           {"stale_while_revalidate_but_response_must_revalidate",
+                            /*request_cache_control=*/"",
+                            /*response_cache_control=*/
+                            "max-age=1000, must-revalidate, stale-while-revalidate=500",
+                            /*request_time=*/currentTime() + Seconds(1001),
+                            /*response_date=*/currentTime(),
+                            /*expected_result=*/CacheEntryStatus::RequiresValidation,
+                            /*expected_age=*/"1001"},
+                           {"stale_while_revalidate_but_request_requires_revalidation",
+                            /*request_cache_control=*/"no-cache",
+                            /*response_cache_control=*/"max-age=1000, stale-while-revalidate=500",
+                            /*request_time=*/currentTime() + Seconds(1001),
+                            /*response_date=*/currentTime(),
+                            /*expected_result=*/CacheEntryStatus::RequiresValidation,
+                            /*expected_age=*/"1001"},
 
     );
   }
@@ -234,6 +263,27 @@ TEST_F(LookupRequestTest, ExpiredViaFallbackheader) {
   EXPECT_EQ(CacheEntryStatus::RequiresValidation, lookup_response.cache_entry_status_);
 }
 
+TEST_F(LookupRequestTest, StaleIfError) {
+  const LookupRequest lookup_request(request_headers_, currentTime() + Seconds(1500),
+                                     vary_allow_list_);
+  const Http::TestResponseHeaderMapImpl within_window(
+      {{"cache-control", "max-age=1000, stale-if-error=500"},
+       {"date", formatter_.fromTime(currentTime())}});
+  const LookupResult within_window_result = makeLookupResult(lookup_request, within_window);
+  EXPECT_EQ(CacheEntryStatus::RequiresValidation, within_window_result.cache_entry_status_);
+  EXPECT_TRUE(within_window_result.serve_stale_if_error_);
+
+  const Http::TestResponseHeaderMapImpl beyond_window(
+      {{"cache-control", "max-age=1000, stale-if-error=499"},
+       {"date", formatter_.fromTime(currentTime())}});
+  EXPECT_FALSE(makeLookupResult(lookup_request, beyond_window).serve_stale_if_error_);
+
+  const Http::TestResponseHeaderMapImpl must_revalidate(
+      {{"cache-control", "max-age=1000, must-revalidate, stale-if-error=500"},
+       {"date", formatter_.fromTime(currentTime())}});
+  EXPECT_FALSE(makeLookupResult(lookup_request, must_revalidate).serve_stale_if_error_);
+}
+
 TEST_F(LookupRequestTest, NotExpiredViaFallbackheader) {
   const LookupRequest lookup_request(request_headers_, currentTime(), vary_allow_list_);
   const Http::TestResponseHeaderMapImpl response_headers(
@@ -2,6 +2,8 @@
 #include "envoy/registry/registry.h"
 
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
 #include "source/extensions/filters/http/cache/cache_entry_utils.h"
 #include "source/extensions/filters/http/cache/cache_headers_utils.h"
 #include "source/extensions/http/cache/simple_http_cache/simple_http_cache.h"
@@ -25,7 +27,9 @@ public:
   bool validationEnabled() const override { return true; }
 
 private:
-  std::shared_ptr<SimpleHttpCache> cache_ = std::make_shared<SimpleHttpCache>();
+  Stats::IsolatedStoreImpl stats_store_;
+  std::shared_ptr<SimpleHttpCache> cache_ =
+      std::make_shared<SimpleHttpCache>(SimpleHttpCacheConfig(), *stats_store_.rootScope());
 };
 
 INSTANTIATE_TEST_SUITE_P(SimpleHttpCacheTest, HttpCacheImplementationTest,
@@ -45,6 +49,141 @@ TEST(Registration, GetFactory) {
             "envoy.extensions.http.cache.simple");
 }
 
+TEST(Registration, SameConfigSharesCache) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.extensions.http.cache.simple_http_cache.v3.SimpleHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  testing::NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  envoy::extensions::filters::http::cache::v3::CacheConfig config;
+  SimpleHttpCacheConfig simple_config;
+  config.mutable_typed_config()->PackFrom(simple_config);
+  std::shared_ptr<HttpCache> cache1 = factory->getCache(config, factory_context);
+  std::shared_ptr<HttpCache> cache2 = factory->getCache(config, factory_context);
+  EXPECT_EQ(cache1, cache2);
+
+  simple_config.mutable_max_cache_size_bytes()->set_value(1024);
+  config.mutable_typed_config()->PackFrom(simple_config);
+  std::shared_ptr<HttpCache> cache3 = factory->getCache(config, factory_context);
+  EXPECT_NE(cache1, cache3);
+}
+
+class SimpleHttpCacheLruTest : public testing::Test {
+protected:
+  SimpleHttpCacheLruTest()
+      : vary_allow_list_(
+            Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher>()) {}
+
+  void createCache(uint64_t max_cache_size_bytes, uint32_t shard_count) {
+    SimpleHttpCacheConfig config;
+    config.mutable_max_cache_size_bytes()->set_value(max_cache_size_bytes);
+    config.mutable_shard_count()->set_value(shard_count);
+    cache_ = std::make_unique<SimpleHttpCache>(config, *stats_store_.rootScope());
+  }
+
+  LookupRequest makeLookupRequest(absl::string_view path) {
+    Http::TestRequestHeaderMapImpl request_headers{
+        {":method", "GET"}, {":scheme", "https"}, {":authority", "example.com"}, {":path", path}};
+    return {request_headers, time_system_.systemTime(), vary_allow_list_};
+  }
+
+  bool insert(absl::string_view path, std::string body) {
+    return cache_->insert(
+        makeLookupRequest(path).key(),
+        Http::createHeaderMap<Http::ResponseHeaderMapImpl>(
+            {{Http::Headers::get().Status, "200"}}),
+        ResponseMetadata{time_system_.systemTime()}, std::move(body), nullptr);
+  }
+
+  bool cached(absl::string_view path) {
+    return cache_->lookup(makeLookupRequest(path)).response_headers_ != nullptr;
+  }
+
+  uint64_t counter(absl::string_view name) {
+    return TestUtility::findCounter(stats_store_, absl::StrCat("simple_http_cache.", name))
+        ->value();
+  }
+
+  uint64_t gauge(absl::string_view name) {
+    return TestUtility::findGauge(stats_store_, absl::StrCat("simple_http_cache.", name))->value();
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl stats_store_;
+  VaryAllowList vary_allow_list_;
+  std::unique_ptr<SimpleHttpCache> cache_;
+};
+
+TEST_F(SimpleHttpCacheLruTest, UnboundedCacheNeverEvicts) {
+  createCache(0, 4);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_TRUE(insert(absl::StrCat("/", i), std::string(1000, 'a')));
+  }
+  for (int i = 0; i < 100; i++) {
+    EXPECT_TRUE(cached(absl::StrCat("/", i)));
+  }
+  EXPECT_EQ(0, counter("eviction"));
+  EXPECT_EQ(100, gauge("size_count"));
+  EXPECT_GT(gauge("size_bytes"), 100 * 1000);
+  EXPECT_EQ(100, counter("cache_hit"));
+}
+
+TEST_F(SimpleHttpCacheLruTest, EvictsLeastRecentlyUsed) {
+  // A single shard with room for two of these entries but not three.
+  createCache(2500, 1);
+  EXPECT_TRUE(insert("/a", std::string(1000, 'a')));
+  EXPECT_TRUE(insert("/b", std::string(1000, 'b')));
+  // Touch /a so that /b becomes the least recently used entry.
+  EXPECT_TRUE(cached("/a"));
+  EXPECT_TRUE(insert("/c", std::string(1000, 'c')));
+
+  EXPECT_TRUE(cached("/a"));
+  EXPECT_FALSE(cached("/b"));
+  EXPECT_TRUE(cached("/c"));
+  EXPECT_EQ(1, counter("eviction"));
+  EXPECT_EQ(2, gauge("size_count"));
+  EXPECT_LE(gauge("size_bytes"), 2500);
+  EXPECT_EQ(3, counter("cache_hit"));
+  EXPECT_EQ(1, counter("cache_miss"));
+}
+
+TEST_F(SimpleHttpCacheLruTest, ReplacingEntryUpdatesSize) {
+  createCache(0, 1);
+  EXPECT_TRUE(insert("/a", std::string(1000, 'a')));
+  const uint64_t size = gauge("size_bytes");
+  EXPECT_TRUE(insert("/a", std::string(10, 'a')));
+  EXPECT_EQ(1, gauge("size_count"));
+  EXPECT_EQ(size - 990, gauge("size_bytes"));
+}
+
+TEST_F(SimpleHttpCacheLruTest, RejectsEntryLargerThanShard) {
+  createCache(4000, 4);
+  EXPECT_TRUE(insert("/small", std::string(100, 'a')));
+  EXPECT_FALSE(insert("/large", std::string(2000, 'a')));
+  EXPECT_TRUE(cached("/small"));
+  EXPECT_FALSE(cached("/large"));
+  EXPECT_EQ(1, counter("insert_rejected"));
+  EXPECT_EQ(0, counter("eviction"));
+}
+
+TEST_F(SimpleHttpCacheLruTest, ShardsStayWithinBudget) {
+  createCache(16 * 1024, 8);
+  for (int i = 0; i < 200; i++) {
+    EXPECT_TRUE(insert(absl::StrCat("/", i), std::string(500, 'a')));
+  }
+  EXPECT_GT(counter("eviction"), 0);
+  EXPECT_LE(gauge("size_bytes"), 16 * 1024);
+  EXPECT_EQ(200 - counter("eviction"), gauge("size_count"));
+}
+
+TEST_F(SimpleHttpCacheLruTest, DestructionReleasesGauges) {
+  createCache(0, 2);
+  EXPECT_TRUE(insert("/a", std::string(1000, 'a')));
+  EXPECT_GT(gauge("size_bytes"), 0);
+  cache_.reset();
+  EXPECT_EQ(0, gauge("size_bytes"));
+  EXPECT_EQ(0, gauge("size_count"));
+}
+
 } // namespace
 } // namespace Cache
 } // namespace HttpFilters
@@ -0,0 +1,128 @@
+// Usage: bazel run //test/extensions/load_balancing_policies/maglev:maglev_lb_benchmark
+
+#include <memory>
+
+#include "envoy/config/cluster/v3/cluster.pb.h"
+
+#include "source/common/common/random_generator.h"
+#include "source/common/upstream/upstream_impl.h"
+#include "source/extensions/load_balancing_policies/maglev/maglev_lb.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class MaglevTester : public Event::TestUsingSimulatedTime {
+public:
+  MaglevTester(uint64_t num_hosts) {
+    for (uint64_t i = 0; i < num_hosts; i++) {
+      hosts_.push_back(makeHost());
+    }
+    updateHosts(hosts_, {});
+    maglev_lb_ = std::make_unique<MaglevLoadBalancer>(priority_set_, stats_, stats_scope_, runtime_,
+                                                      random_, absl::nullopt, common_config_);
+  }
+
+  HostSharedPtr makeHost() {
+    const uint64_t i = next_host_++;
+    const std::string url =
+        fmt::format("tcp://10.{}.{}.{}:6379", i / 65536, (i / 256) % 256, i % 256);
+    return makeTestHost(info_, url, simTime());
+  }
+
+  // Replaces the first num_replaced hosts with new ones, rebuilding the table.
+  void replaceHosts(uint64_t num_replaced) {
+    HostVector removed(hosts_.begin(), hosts_.begin() + num_replaced);
+    HostVector added;
+    for (uint64_t i = 0; i < num_replaced; i++) {
+      added.push_back(makeHost());
+    }
+    hosts_.erase(hosts_.begin(), hosts_.begin() + num_replaced);
+    hosts_.insert(hosts_.end(), added.begin(), added.end());
+    updateHosts(added, removed);
+  }
+
+  void updateHosts(const HostVector& added, const HostVector& removed) {
+    HostVectorConstSharedPtr updated_hosts = std::make_shared<HostVector>(hosts_);
+    HostsPerLocalityConstSharedPtr hosts_per_locality = makeHostsPerLocality({hosts_});
+    priority_set_.updateHosts(0, HostSetImpl::partitionHosts(updated_hosts, hosts_per_locality), {},
+                              added, removed, absl::nullopt);
+  }
+
+  Envoy::Thread::MutexBasicLockable lock_;
+  // Reduce default log level to warn while running this benchmark to avoid problems due to
+  // excessive debug logging in upstream_impl.cc
+  Envoy::Logger::Context logging_context_{spdlog::level::warn,
+                                          Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock_, false};
+
+  PrioritySetImpl priority_set_;
+  HostVector hosts_;
+  uint64_t next_host_{};
+
+  Stats::IsolatedStoreImpl stats_store_;
+  Stats::Scope& stats_scope_{*stats_store_.rootScope()};
+  ClusterLbStatNames stat_names_{stats_store_.symbolTable()};
+  ClusterLbStats stats_{stat_names_, stats_scope_};
+  NiceMock<Runtime::MockLoader> runtime_;
+  Random::RandomGeneratorImpl random_;
+  envoy::config::cluster::v3::Cluster::CommonLbConfig common_config_;
+  std::shared_ptr<MockClusterInfo> info_{new NiceMock<MockClusterInfo>()};
+  std::unique_ptr<MaglevLoadBalancer> maglev_lb_;
+};
+
+// Builds the table of a new load balancer, hashing every host.
+void benchmarkMaglevTableBuild(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    MaglevTester tester(num_hosts);
+    state.ResumeTiming();
+
+    tester.maglev_lb_->initialize();
+  }
+}
+BENCHMARK(benchmarkMaglevTableBuild)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(5000)
+    ->Unit(::benchmark::kMillisecond);
+
+// Rebuilds the table after some of the hosts were replaced, as EDS updates of a large cluster do.
+// Only the new hosts are hashed. This includes the cost of updating the host set.
+void benchmarkMaglevTableRebuild(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t num_replaced = state.range(1);
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  MaglevTester tester(num_hosts);
+  tester.maglev_lb_->initialize();
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    tester.replaceHosts(num_replaced);
+  }
+}
+BENCHMARK(benchmarkMaglevTableRebuild)
+    ->Args({100, 1})
+    ->Args({1000, 10})
+    ->Args({5000, 1})
+    ->Args({5000, 50})
+    ->Args({5000, 500})
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
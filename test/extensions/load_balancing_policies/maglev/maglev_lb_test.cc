@@ -323,6 +323,62 @@ TEST_F(MaglevLoadBalancerTest, BasicStability) {
   }
 }
 
+// Rebuilding the table after host changes reuses the permutations of the remaining hosts, and
+// results in the same table as building it from scratch.
+TEST_F(MaglevLoadBalancerTest, PermutationCacheFollowsHostChanges) {
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:91", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:92", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:93", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:94", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:95", simTime())};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  init(MaglevTable::DefaultTableSize);
+  EXPECT_EQ(6, lb_->permutationCache().size());
+
+  host_set_.hosts_.erase(host_set_.hosts_.begin(), host_set_.hosts_.begin() + 2);
+  host_set_.hosts_.push_back(makeTestHost(info_, "tcp://127.0.0.1:96", simTime()));
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(5, lb_->permutationCache().size());
+  LoadBalancerPtr rebuilt_lb = lb_->factory()->create(lb_params_);
+
+  auto rebuilt_maglev_lb = std::move(lb_);
+  createLb();
+  lb_->initialize();
+  LoadBalancerPtr fresh_lb = lb_->factory()->create(lb_params_);
+  for (uint32_t i = 0; i < MaglevTable::DefaultTableSize; ++i) {
+    TestLoadBalancerContext context(i);
+    EXPECT_EQ(fresh_lb->chooseHost(&context), rebuilt_lb->chooseHost(&context));
+  }
+}
+
+// Permutations stay cached as long as one of the retained builds uses them.
+TEST(MaglevPermutationCacheTest, RetainedBuilds) {
+  MaglevPermutationCache cache(MaglevTable::DefaultTableSize);
+  const MaglevPermutationCache::Permutation expected =
+      MaglevPermutationCache::computePermutation("a", MaglevTable::DefaultTableSize);
+  const MaglevPermutationCache::Permutation permutation = cache.get("a");
+  EXPECT_EQ(expected.offset_, permutation.offset_);
+  EXPECT_EQ(expected.skip_, permutation.skip_);
+  EXPECT_LT(permutation.offset_, MaglevTable::DefaultTableSize);
+  EXPECT_GT(permutation.skip_, 0);
+  EXPECT_LT(permutation.skip_, MaglevTable::DefaultTableSize);
+  cache.endBuild(2);
+
+  cache.get("b");
+  cache.endBuild(2);
+  EXPECT_EQ(2, cache.size());
+
+  cache.get("b");
+  cache.endBuild(2);
+  EXPECT_EQ(1, cache.size());
+
+  cache.endBuild(1);
+  EXPECT_EQ(0, cache.size());
+}
+
 // Weighted sanity test.
 TEST_F(MaglevLoadBalancerTest, Weighted) {
   host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", simTime(), 1),
@@ -0,0 +1,105 @@
+// Usage: bazel run //test/extensions/load_balancing_policies/ring_hash:ring_hash_lb_benchmark
+
+#include <memory>
+
+#include "envoy/config/cluster/v3/cluster.pb.h"
+
+#include "source/common/common/random_generator.h"
+#include "source/common/memory/stats.h"
+#include "source/common/upstream/upstream_impl.h"
+#include "source/extensions/load_balancing_policies/ring_hash/ring_hash_lb.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class RingHashTester : public Event::TestUsingSimulatedTime {
+public:
+  RingHashTester(uint64_t num_hosts, uint64_t ring_size) {
+    HostVector hosts;
+    for (uint64_t i = 0; i < num_hosts; i++) {
+      const std::string url = fmt::format("tcp://10.0.{}.{}:6379", i / 256, i % 256);
+      hosts.push_back(makeTestHost(info_, url, simTime()));
+    }
+    HostVectorConstSharedPtr updated_hosts = std::make_shared<HostVector>(hosts);
+    HostsPerLocalityConstSharedPtr hosts_per_locality = makeHostsPerLocality({hosts});
+    priority_set_.updateHosts(0, HostSetImpl::partitionHosts(updated_hosts, hosts_per_locality), {},
+                              hosts, {}, absl::nullopt);
+
+    config_.mutable_minimum_ring_size()->set_value(ring_size);
+    config_.mutable_maximum_ring_size()->set_value(ring_size);
+    ring_hash_lb_ = std::make_unique<RingHashLoadBalancer>(
+        priority_set_, stats_, stats_scope_, runtime_, random_,
+        makeOptRef<const envoy::config::cluster::v3::Cluster::RingHashLbConfig>(config_),
+        common_config_);
+  }
+
+  Envoy::Thread::MutexBasicLockable lock_;
+  // Reduce default log level to warn while running this benchmark to avoid problems due to
+  // excessive debug logging in upstream_impl.cc
+  Envoy::Logger::Context logging_context_{spdlog::level::warn,
+                                          Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock_, false};
+
+  PrioritySetImpl priority_set_;
+  LoadBalancerParams lb_params_{priority_set_, nullptr};
+
+  Stats::IsolatedStoreImpl stats_store_;
+  Stats::Scope& stats_scope_{*stats_store_.rootScope()};
+  ClusterLbStatNames stat_names_{stats_store_.symbolTable()};
+  ClusterLbStats stats_{stat_names_, stats_scope_};
+  NiceMock<Runtime::MockLoader> runtime_;
+  Random::RandomGeneratorImpl random_;
+  envoy::config::cluster::v3::Cluster::RingHashLbConfig config_;
+  envoy::config::cluster::v3::Cluster::CommonLbConfig common_config_;
+  std::shared_ptr<MockClusterInfo> info_{new NiceMock<MockClusterInfo>()};
+  std::unique_ptr<RingHashLoadBalancer> ring_hash_lb_;
+};
+
+class TestLoadBalancerContext : public LoadBalancerContextBase {
+public:
+  // Upstream::LoadBalancerContext
+  absl::optional<uint64_t> computeHashKey() override { return hash_key_; }
+
+  absl::optional<uint64_t> hash_key_;
+};
+
+// Measures the latency of picking a host for random hashes, and the memory used by the ring.
+void benchmarkRingHashChooseHost(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t ring_size = state.range(1);
+  if (benchmark::skipExpensiveBenchmarks() && ring_size > 65536) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  RingHashTester tester(num_hosts, ring_size);
+  const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+  tester.ring_hash_lb_->initialize();
+  const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+  state.counters["memory_per_ring_entry"] =
+      static_cast<double>(end_mem - start_mem) / tester.ring_hash_lb_->stats().size_.value();
+
+  LoadBalancerPtr lb = tester.ring_hash_lb_->factory()->create(tester.lb_params_);
+  TestLoadBalancerContext context;
+  Random::RandomGeneratorImpl random;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    context.hash_key_ = random.random();
+    benchmark::DoNotOptimize(lb->chooseHost(&context));
+  }
+}
+BENCHMARK(benchmarkRingHashChooseHost)
+    ->Args({100, 1024})
+    ->Args({100, 65536})
+    ->Args({1000, 1024 * 1024})
+    ->Args({1000, 8 * 1024 * 1024});
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -21,6 +21,7 @@
 #include "test/test_common/simulated_time_system.h"
 
 #include "absl/container/node_hash_map.h"
+#include "absl/strings/str_cat.h"
 #include "absl/types/optional.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -637,6 +638,50 @@ TEST_P(RingHashLoadBalancerTest, HostWeightedLargeRing) {
   EXPECT_EQ(3081, counts[2]); // :92 | ~3000 expected hits
 }
 
+// Rings large enough to be searched through their bucket index map each hash to the ring entry
+// with the next equal or larger hash, like smaller rings do.
+TEST_P(RingHashLoadBalancerTest, LargeRingBucketIndex) {
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:91", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:92", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:93", simTime())};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  config_ = envoy::config::cluster::v3::Cluster::RingHashLbConfig();
+  config_.value().mutable_minimum_ring_size()->set_value(4096);
+  init();
+  EXPECT_EQ(4096, lb_->stats().size_.value());
+  LoadBalancerPtr lb = lb_->factory()->create(lb_params_);
+
+  // Each host has 1024 hashes on the ring, those of "<address>_<i>".
+  std::vector<std::pair<uint64_t, HostConstSharedPtr>> ring;
+  for (const auto& host : hostSet().hosts_) {
+    for (uint32_t i = 0; i < 1024; ++i) {
+      ring.emplace_back(HashUtil::xxHash64(absl::StrCat(host->address()->asString(), "_", i)),
+                        host);
+    }
+  }
+  std::sort(ring.begin(), ring.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+  const auto expected_host = [&ring](uint64_t hash) {
+    auto it = std::lower_bound(ring.begin(), ring.end(), hash,
+                               [](const auto& entry, uint64_t value) { return entry.first < value; });
+    return it == ring.end() ? ring.front().second : it->second;
+  };
+
+  std::vector<uint64_t> hashes = {0, std::numeric_limits<uint64_t>::max()};
+  for (const auto& entry : ring) {
+    hashes.push_back(entry.first - 1);
+    hashes.push_back(entry.first);
+    hashes.push_back(entry.first + 1);
+  }
+  for (const uint64_t hash : hashes) {
+    TestLoadBalancerContext context(hash);
+    EXPECT_EQ(expected_host(hash), lb->chooseHost(&context)) << hash;
+  }
+}
+
 // Given locality weights all 0, expect the same behavior as if no hosts were provided at all.
 TEST_P(RingHashLoadBalancerTest, ZeroLocalityWeights) {
   envoy::config::core::v3::Locality zone_a;
@@ -7,6 +7,7 @@
 
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/server/options.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
@@ -30,8 +31,9 @@ TEST(ActiveDownstreamConnectionsMonitorFactoryTest, CreateMonitorInvalidConfig)
   Event::MockDispatcher dispatcher;
   Api::ApiPtr api = Api::createApiForTest();
   Server::MockOptions options;
+  ThreadLocal::MockInstance tls;
   Server::Configuration::ResourceMonitorFactoryContextImpl context(
-      dispatcher, options, *api, ProtobufMessage::getStrictValidationVisitor());
+      dispatcher, options, *api, tls, ProtobufMessage::getStrictValidationVisitor());
   EXPECT_THROW_WITH_REGEX(factory->createProactiveResourceMonitor(config, context),
                           ProtoValidationException,
                           "Proto constraint validation failed "
@@ -52,8 +54,9 @@ TEST(ActiveDownstreamConnectionsMonitorFactoryTest, CreateCustomMonitor) {
   Event::MockDispatcher dispatcher;
   Api::ApiPtr api = Api::createApiForTest();
   Server::MockOptions options;
+  ThreadLocal::MockInstance tls;
   Server::Configuration::ResourceMonitorFactoryContextImpl context(
-      dispatcher, options, *api, ProtobufMessage::getStrictValidationVisitor());
+      dispatcher, options, *api, tls, ProtobufMessage::getStrictValidationVisitor());
   auto monitor = factory->createProactiveResourceMonitor(config, context);
   EXPECT_NE(monitor, nullptr);
 }
@@ -67,8 +70,9 @@ TEST(ActiveDownstreamConnectionsMonitorFactoryTest, CreateDefaultMonitor) {
   Event::MockDispatcher dispatcher;
   Api::ApiPtr api = Api::createApiForTest();
   Server::MockOptions options;
+  ThreadLocal::MockInstance tls;
   Server::Configuration::ResourceMonitorFactoryContextImpl context(
-      dispatcher, options, *api, ProtobufMessage::getStrictValidationVisitor());
+      dispatcher, options, *api, tls, ProtobufMessage::getStrictValidationVisitor());
   auto config = factory->createEmptyConfigProto();
 
   EXPECT_THROW_WITH_REGEX(factory->createProactiveResourceMonitor(*config, context),
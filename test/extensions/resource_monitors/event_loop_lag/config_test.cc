@@ -0,0 +1,58 @@
+#include "envoy/extensions/resource_monitors/event_loop_lag/v3/event_loop_lag.pb.h"
+#include "envoy/extensions/resource_monitors/event_loop_lag/v3/event_loop_lag.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/extensions/resource_monitors/event_loop_lag/config.h"
+#include "source/server/resource_monitor_config_impl.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/server/options.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopLagMonitor {
+namespace {
+
+TEST(EventLoopLagMonitorFactoryTest, CreateMonitor) {
+  auto factory =
+      Registry::FactoryRegistry<Server::Configuration::ResourceMonitorFactory>::getFactory(
+          "envoy.resource_monitors.event_loop_lag");
+  EXPECT_NE(factory, nullptr);
+
+  envoy::extensions::resource_monitors::event_loop_lag::v3::EventLoopLagConfig config;
+  config.mutable_max_event_loop_lag()->set_seconds(1);
+  Event::MockDispatcher dispatcher;
+  Api::ApiPtr api = Api::createApiForTest();
+  Server::MockOptions options;
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
+  Server::Configuration::ResourceMonitorFactoryContextImpl context(
+      dispatcher, options, *api, tls, ProtobufMessage::getStrictValidationVisitor());
+  auto monitor = factory->createResourceMonitor(config, context);
+  EXPECT_NE(monitor, nullptr);
+}
+
+TEST(EventLoopLagMonitorFactoryTest, RequiresMaxEventLoopLag) {
+  auto factory =
+      Registry::FactoryRegistry<Server::Configuration::ResourceMonitorFactory>::getFactory(
+          "envoy.resource_monitors.event_loop_lag");
+  envoy::extensions::resource_monitors::event_loop_lag::v3::EventLoopLagConfig config;
+  Event::MockDispatcher dispatcher;
+  Api::ApiPtr api = Api::createApiForTest();
+  Server::MockOptions options;
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
+  Server::Configuration::ResourceMonitorFactoryContextImpl context(
+      dispatcher, options, *api, tls, ProtobufMessage::getStrictValidationVisitor());
+  EXPECT_THROW_WITH_REGEX(factory->createResourceMonitor(config, context),
+                          ProtoValidationException, "MaxEventLoopLag: value is required");
+}
+
+} // namespace
+} // namespace EventLoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,94 @@
+#include <chrono>
+
+#include "envoy/extensions/resource_monitors/event_loop_lag/v3/event_loop_lag.pb.h"
+
+#include "source/extensions/resource_monitors/event_loop_lag/event_loop_lag_monitor.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "absl/types/optional.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopLagMonitor {
+namespace {
+
+using testing::_;
+using testing::DoubleNear;
+using testing::NiceMock;
+
+class ResourcePressure : public Server::ResourceUpdateCallbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+  }
+
+  void onFailure(const EnvoyException& error) override { error_ = error; }
+
+  double pressure() const { return *pressure_; }
+
+private:
+  absl::optional<double> pressure_;
+  absl::optional<EnvoyException> error_;
+};
+
+class EventLoopLagMonitorTest : public testing::Test {
+protected:
+  EventLoopLagMonitorTest() {
+    envoy::extensions::resource_monitors::event_loop_lag::v3::EventLoopLagConfig config;
+    config.mutable_max_event_loop_lag()->set_nanos(200 * 1000 * 1000);
+    config.mutable_probe_interval()->set_nanos(100 * 1000 * 1000);
+    monitor_ = std::make_unique<EventLoopLagMonitor>(config, tls_, time_system_);
+  }
+
+  double updatePressure() {
+    ResourcePressure resource;
+    monitor_->updateResourceUsage(resource);
+    return resource.pressure();
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  std::unique_ptr<EventLoopLagMonitor> monitor_;
+};
+
+TEST_F(EventLoopLagMonitorTest, ReportsLateProbes) {
+  // The probe of the thread is started by the first update.
+  auto* timer = new NiceMock<Event::MockTimer>(&tls_.dispatcher_);
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(100), _)).Times(3);
+  EXPECT_EQ(0, updatePressure());
+
+  // The probe runs 50ms late.
+  time_system_.advanceTimeWait(std::chrono::milliseconds(150));
+  timer->invokeCallback();
+  EXPECT_THAT(updatePressure(), DoubleNear(0.25, 0.001));
+
+  // The lag of the late probe holds until the next one, which runs on time.
+  time_system_.advanceTimeWait(std::chrono::milliseconds(100));
+  EXPECT_THAT(updatePressure(), DoubleNear(0.25, 0.001));
+  timer->invokeCallback();
+  EXPECT_EQ(0, updatePressure());
+}
+
+// A stalled event loop is reported before its probe runs.
+TEST_F(EventLoopLagMonitorTest, ReportsOverdueProbes) {
+  auto* timer = new NiceMock<Event::MockTimer>(&tls_.dispatcher_);
+  EXPECT_EQ(0, updatePressure());
+
+  time_system_.advanceTimeWait(std::chrono::milliseconds(400));
+  EXPECT_THAT(updatePressure(), DoubleNear(1.5, 0.001));
+
+  timer->invokeCallback();
+  EXPECT_THAT(updatePressure(), DoubleNear(1.5, 0.001));
+}
+
+} // namespace
+} // namespace EventLoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
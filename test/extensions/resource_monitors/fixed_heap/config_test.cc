@@ -7,6 +7,7 @@
 
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/server/options.h"
+#include "test/mocks/thread_local/mocks.h"
 
 #include "gtest/gtest.h"
 
@@ -27,8 +28,9 @@ TEST(FixedHeapMonitorFactoryTest, CreateMonitor) {
   Event::MockDispatcher dispatcher;
   Api::ApiPtr api = Api::createApiForTest();
   Server::MockOptions options;
+  ThreadLocal::MockInstance tls;
   Server::Configuration::ResourceMonitorFactoryContextImpl context(
-      dispatcher, options, *api, ProtobufMessage::getStrictValidationVisitor());
+      dispatcher, options, *api, tls, ProtobufMessage::getStrictValidationVisitor());
   auto monitor = factory->createResourceMonitor(config, context);
   EXPECT_NE(monitor, nullptr);
 }
@@ -7,6 +7,7 @@
 #include "source/server/resource_monitor_config_impl.h"
 
 #include "test/mocks/server/options.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/utility.h"
 
@@ -29,8 +30,9 @@ TEST(InjectedResourceMonitorFactoryTest, CreateMonitor) {
   Api::ApiPtr api = Api::createApiForTest();
   Event::DispatcherPtr dispatcher(api->allocateDispatcher("test_thread"));
   Server::MockOptions options;
+  ThreadLocal::MockInstance tls;
   Server::Configuration::ResourceMonitorFactoryContextImpl context(
-      *dispatcher, options, *api, ProtobufMessage::getStrictValidationVisitor());
+      *dispatcher, options, *api, tls, ProtobufMessage::getStrictValidationVisitor());
   Server::ResourceMonitorPtr monitor = factory->createResourceMonitor(config, context);
   EXPECT_NE(monitor, nullptr);
 }
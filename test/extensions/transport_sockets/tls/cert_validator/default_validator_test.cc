@@ -352,6 +352,28 @@ TEST(DefaultCertValidatorTest, TestInitializeSslContextFailure) {
                           "Failed to load trusted CA certificates from.*");
 }
 
+TEST(DefaultCertValidatorTest, CountsTrustedCaCacheHitsAndMisses) {
+  Stats::TestUtil::TestStore test_store;
+  SslStats stats = generateSslStats(*test_store.rootScope());
+  envoy::config::core::v3::TypedExtensionConfig typed_conf;
+  const std::string ca_cert = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.pem"));
+  TestCertificateValidationContextConfig config(typed_conf, false, {}, ca_cert);
+
+  // The first validator parses the bundle, and the second one shares it while it is held.
+  SSLContextPtr first_ctx = SSL_CTX_new(TLS_method());
+  DefaultCertValidator first(&config, stats, Event::GlobalTimeSystem().timeSystem());
+  EXPECT_EQ(SSL_VERIFY_PEER, first.initializeSslContexts({first_ctx.get()}, false));
+  EXPECT_EQ(0, stats.trusted_ca_cache_hit_.value());
+  EXPECT_EQ(1, stats.trusted_ca_cache_miss_.value());
+
+  SSLContextPtr second_ctx = SSL_CTX_new(TLS_method());
+  DefaultCertValidator second(&config, stats, Event::GlobalTimeSystem().timeSystem());
+  EXPECT_EQ(SSL_VERIFY_PEER, second.initializeSslContexts({second_ctx.get()}, false));
+  EXPECT_EQ(1, stats.trusted_ca_cache_hit_.value());
+  EXPECT_EQ(1, stats.trusted_ca_cache_miss_.value());
+}
+
 } // namespace Tls
 } // namespace TransportSockets
 } // namespace Extensions
@@ -0,0 +1,73 @@
+#include <string>
+
+#include "source/extensions/transport_sockets/tls/cert_validator/trusted_ca_cache.h"
+
+#include "test/test_common/environment.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+std::string readTestData(absl::string_view name) {
+  return TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+      absl::StrCat("{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/", name)));
+}
+
+TEST(TrustedCaCacheTest, SharesBundlesOfTheSameContents) {
+  TrustedCaCache& cache = TrustedCaCache::get();
+  const size_t initial_size = cache.size();
+  const std::string ca_cert = readTestData("ca_cert.pem");
+  const std::string ca_cert_with_crl = readTestData("ca_cert_with_crl.pem");
+
+  bool shared;
+  X509InfoListConstSharedPtr first = cache.getOrParse(ca_cert, shared);
+  ASSERT_NE(nullptr, first);
+  EXPECT_FALSE(shared);
+  EXPECT_EQ(1, sk_X509_INFO_num(first.get()));
+
+  X509InfoListConstSharedPtr second = cache.getOrParse(ca_cert, shared);
+  EXPECT_TRUE(shared);
+  EXPECT_EQ(first, second);
+
+  X509InfoListConstSharedPtr other = cache.getOrParse(ca_cert_with_crl, shared);
+  ASSERT_NE(nullptr, other);
+  EXPECT_FALSE(shared);
+  EXPECT_NE(first, other);
+  EXPECT_EQ(2, sk_X509_INFO_num(other.get()));
+  EXPECT_EQ(initial_size + 2, cache.size());
+
+  // A bundle is released with its last holder.
+  first.reset();
+  EXPECT_EQ(initial_size + 2, cache.size());
+  second.reset();
+  EXPECT_EQ(initial_size + 1, cache.size());
+  other.reset();
+  EXPECT_EQ(initial_size, cache.size());
+
+  // And parsed again when next needed.
+  first = cache.getOrParse(ca_cert, shared);
+  ASSERT_NE(nullptr, first);
+  EXPECT_FALSE(shared);
+  EXPECT_EQ(initial_size + 1, cache.size());
+}
+
+TEST(TrustedCaCacheTest, InvalidBundle) {
+  TrustedCaCache& cache = TrustedCaCache::get();
+  const size_t initial_size = cache.size();
+  bool shared;
+  EXPECT_EQ(nullptr, cache.getOrParse("-----BEGIN CERTIFICATE-----\nnot base64\n"
+                                      "-----END CERTIFICATE-----\n",
+                                      shared));
+  EXPECT_EQ(initial_size, cache.size());
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
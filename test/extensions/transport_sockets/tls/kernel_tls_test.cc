@@ -0,0 +1,173 @@
+#include <string>
+
+#include "source/extensions/transport_sockets/tls/kernel_tls.h"
+
+#include "test/mocks/network/io_handle.h"
+#include "test/test_common/environment.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+#if defined(__linux__)
+#include <linux/tls.h>
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+#if defined(__linux__)
+
+using testing::_;
+using testing::Invoke;
+using testing::Return;
+using testing::StrictMock;
+
+struct KernelTlsTestParam {
+  uint16_t version;
+  std::string cipher;
+};
+
+// Handshakes a client and a server over a pair of in-memory BIOs.
+class KernelTlsTest : public testing::Test {
+protected:
+  void handshake(uint16_t version, const std::string& cipher) {
+    bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
+    bssl::UniquePtr<SSL_CTX> server_ctx(SSL_CTX_new(TLS_method()));
+    for (SSL_CTX* ctx : {client_ctx.get(), server_ctx.get()}) {
+      ASSERT_EQ(1, SSL_CTX_set_min_proto_version(ctx, version));
+      ASSERT_EQ(1, SSL_CTX_set_max_proto_version(ctx, version));
+      if (!cipher.empty()) {
+        ASSERT_EQ(1, SSL_CTX_set_strict_cipher_list(ctx, cipher.c_str()));
+      }
+    }
+    const std::string cert_path = TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_cert.pem");
+    const std::string key_path = TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_key.pem");
+    ASSERT_EQ(1, SSL_CTX_use_certificate_chain_file(server_ctx.get(), cert_path.c_str()));
+    ASSERT_EQ(1, SSL_CTX_use_PrivateKey_file(server_ctx.get(), key_path.c_str(), SSL_FILETYPE_PEM));
+
+    client_ssl_.reset(SSL_new(client_ctx.get()));
+    server_ssl_.reset(SSL_new(server_ctx.get()));
+    SSL_set_connect_state(client_ssl_.get());
+    SSL_set_accept_state(server_ssl_.get());
+    BIO* client_bio;
+    BIO* server_bio;
+    ASSERT_EQ(1, BIO_new_bio_pair(&client_bio, 0, &server_bio, 0));
+    SSL_set_bio(client_ssl_.get(), client_bio, client_bio);
+    SSL_set_bio(server_ssl_.get(), server_bio, server_bio);
+
+    bool client_done = false;
+    bool server_done = false;
+    for (int i = 0; i < 10 && !(client_done && server_done); i++) {
+      client_done = client_done || SSL_do_handshake(client_ssl_.get()) == 1;
+      server_done = server_done || SSL_do_handshake(server_ssl_.get()) == 1;
+    }
+    ASSERT_TRUE(client_done && server_done);
+  }
+
+  // Sends application data from one end to the other, advancing their sequence numbers.
+  void transfer(SSL* from, SSL* to) {
+    const std::string data = "hello";
+    ASSERT_EQ(static_cast<int>(data.size()), SSL_write(from, data.data(), data.size()));
+    char buffer[16];
+    ASSERT_EQ(static_cast<int>(data.size()), SSL_read(to, buffer, sizeof(buffer)));
+  }
+
+  bssl::UniquePtr<SSL> client_ssl_;
+  bssl::UniquePtr<SSL> server_ssl_;
+};
+
+class KernelTlsCipherTest : public KernelTlsTest,
+                            public testing::WithParamInterface<KernelTlsTestParam> {};
+
+INSTANTIATE_TEST_SUITE_P(
+    Ciphers, KernelTlsCipherTest,
+    testing::Values(KernelTlsTestParam{TLS1_2_VERSION, "ECDHE-RSA-AES128-GCM-SHA256"},
+                    KernelTlsTestParam{TLS1_2_VERSION, "ECDHE-RSA-AES256-GCM-SHA384"},
+                    KernelTlsTestParam{TLS1_2_VERSION, "ECDHE-RSA-CHACHA20-POLY1305"},
+                    KernelTlsTestParam{TLS1_3_VERSION, ""}));
+
+// The keys with which one end writes are the ones with which the other end reads.
+TEST_P(KernelTlsCipherTest, CryptoInfoMatchesPeer) {
+  handshake(GetParam().version, GetParam().cipher);
+  for (int i = 0; i < 3; i++) {
+    absl::optional<KernelTls::CryptoInfo> server_transmit =
+        KernelTls::cryptoInfo(*server_ssl_, true);
+    absl::optional<KernelTls::CryptoInfo> client_transmit =
+        KernelTls::cryptoInfo(*client_ssl_, true);
+    ASSERT_TRUE(server_transmit.has_value());
+    ASSERT_TRUE(client_transmit.has_value());
+    EXPECT_EQ(server_transmit, KernelTls::cryptoInfo(*client_ssl_, false));
+    EXPECT_EQ(client_transmit, KernelTls::cryptoInfo(*server_ssl_, false));
+    EXPECT_NE(server_transmit, client_transmit);
+
+    const tls_crypto_info* info = reinterpret_cast<const tls_crypto_info*>(server_transmit->data());
+    EXPECT_EQ(GetParam().version == TLS1_2_VERSION ? TLS_1_2_VERSION : TLS_1_3_VERSION,
+              info->version);
+
+    transfer(server_ssl_.get(), client_ssl_.get());
+  }
+}
+
+TEST_P(KernelTlsCipherTest, EnableTransmitOffload) {
+  handshake(GetParam().version, GetParam().cipher);
+  const absl::optional<KernelTls::CryptoInfo> expected = KernelTls::cryptoInfo(*server_ssl_, true);
+  ASSERT_TRUE(expected.has_value());
+
+  StrictMock<Network::MockIoHandle> io_handle;
+  EXPECT_CALL(io_handle, setOption(IPPROTO_TCP, _, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  EXPECT_CALL(io_handle, setOption(SOL_TLS, TLS_TX, _, expected->size()))
+      .WillOnce(Invoke([&expected](int, int, const void* value, socklen_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(value);
+        EXPECT_EQ(*expected, KernelTls::CryptoInfo(bytes, bytes + size));
+        return Api::SysCallIntResult{0, 0};
+      }));
+  EXPECT_TRUE(KernelTls::enableTransmitOffload(*server_ssl_, io_handle));
+}
+
+TEST_P(KernelTlsCipherTest, UlpNotSupported) {
+  handshake(GetParam().version, GetParam().cipher);
+  StrictMock<Network::MockIoHandle> io_handle;
+  EXPECT_CALL(io_handle, setOption(IPPROTO_TCP, _, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, ENOENT}));
+  EXPECT_FALSE(KernelTls::enableTransmitOffload(*server_ssl_, io_handle));
+}
+
+TEST_P(KernelTlsCipherTest, KeysRejected) {
+  handshake(GetParam().version, GetParam().cipher);
+  StrictMock<Network::MockIoHandle> io_handle;
+  EXPECT_CALL(io_handle, setOption(IPPROTO_TCP, _, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  EXPECT_CALL(io_handle, setOption(SOL_TLS, TLS_TX, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EINVAL}));
+  EXPECT_FALSE(KernelTls::enableTransmitOffload(*server_ssl_, io_handle));
+}
+
+// Ciphers which the kernel doesn't support aren't offloaded.
+TEST_F(KernelTlsTest, UnsupportedCipher) {
+  handshake(TLS1_2_VERSION, "ECDHE-RSA-AES128-SHA");
+  EXPECT_FALSE(KernelTls::cryptoInfo(*server_ssl_, true).has_value());
+  StrictMock<Network::MockIoHandle> io_handle;
+  EXPECT_FALSE(KernelTls::enableTransmitOffload(*server_ssl_, io_handle));
+}
+
+// Nor are connections whose handshake isn't complete.
+TEST_F(KernelTlsTest, NoHandshake) {
+  bssl::UniquePtr<SSL_CTX> ctx(SSL_CTX_new(TLS_method()));
+  bssl::UniquePtr<SSL> ssl(SSL_new(ctx.get()));
+  EXPECT_FALSE(KernelTls::cryptoInfo(*ssl, true).has_value());
+}
+
+#endif
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,53 @@
+#include <string>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/transport_sockets/tls/record_gather.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+// Appends a slice of its own to the buffer.
+void appendSlice(Buffer::Instance& buffer, const std::string& data) {
+  Buffer::OwnedImpl slice(data);
+  buffer.move(slice);
+}
+
+TEST(RecordGatherTest, FirstSlice) {
+  Buffer::OwnedImpl buffer;
+  appendSlice(buffer, std::string(RecordGather::MaxRecordSize, 'a'));
+  appendSlice(buffer, "b");
+  EXPECT_EQ(buffer.frontSlice().mem_, RecordGather::gather(buffer, RecordGather::MaxRecordSize));
+  EXPECT_EQ(buffer.frontSlice().mem_, RecordGather::gather(buffer, 100));
+}
+
+TEST(RecordGatherTest, SeveralSlices) {
+  Buffer::OwnedImpl buffer;
+  appendSlice(buffer, std::string(100, 'a'));
+  appendSlice(buffer, std::string(5000, 'b'));
+  appendSlice(buffer, std::string(20000, 'c'));
+  const std::string expected = buffer.toString().substr(0, RecordGather::MaxRecordSize);
+  const uint64_t num_slices = buffer.getRawSlices().size();
+
+  const void* record = RecordGather::gather(buffer, RecordGather::MaxRecordSize);
+  EXPECT_NE(buffer.frontSlice().mem_, record);
+  EXPECT_EQ(expected,
+            absl::string_view(static_cast<const char*>(record), RecordGather::MaxRecordSize));
+  // The buffer is left as it was.
+  EXPECT_EQ(num_slices, buffer.getRawSlices().size());
+  EXPECT_EQ(25100, buffer.length());
+
+  // The scratch slab is reused.
+  EXPECT_EQ(record, RecordGather::gather(buffer, 200));
+  EXPECT_EQ(expected.substr(0, 200), absl::string_view(static_cast<const char*>(record), 200));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -12,6 +12,7 @@
 #include "source/common/event/dispatcher_impl.h"
 #include "source/common/json/json_loader.h"
 #include "source/common/network/address_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
 #include "source/common/network/listen_socket_impl.h"
 #include "source/common/network/tcp_listener_impl.h"
 #include "source/common/network/transport_socket_options_impl.h"
@@ -40,6 +41,7 @@
 #include "test/extensions/transport_sockets/tls/test_data/san_uri_cert_info.h"
 #include "test/extensions/transport_sockets/tls/test_data/selfsigned_ecdsa_p256_cert_info.h"
 #include "test/extensions/transport_sockets/tls/test_private_key_method_provider.h"
+#include "test/mocks/api/mocks.h"
 #include "test/mocks/buffer/mocks.h"
 #include "test/mocks/init/mocks.h"
 #include "test/mocks/local_info/mocks.h"
@@ -54,6 +56,7 @@
 #include "test/test_common/network_utility.h"
 #include "test/test_common/registry.h"
 #include "test/test_common/test_runtime.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
 #include "absl/strings/str_replace.h"
@@ -62,6 +65,10 @@
 #include "gtest/gtest.h"
 #include "openssl/ssl.h"
 
+#if defined(__linux__)
+#include <linux/tls.h>
+#endif
+
 using testing::_;
 using testing::ContainsRegex;
 using testing::DoAll;
@@ -7327,6 +7334,235 @@ TEST_P(SslSocketTest, RsaKeyUsageVerificationEnforcementOn) {
   testUtilV2(test_options);
 }
 
+
+#if defined(__linux__)
+
+// Drives a server SslSocket which offloads its writes to kernel TLS over a UNIX socket pair, with a
+// BoringSSL client on the other end. The kernel TLS ULP can't be attached to a UNIX socket, so the
+// system calls of the socket are mocked: installing the ULP and the keys succeeds without effect,
+// and everything else passes through to the socket pair. What the SslSocket writes once offloaded
+// therefore reaches the client in the clear.
+class SslSocketKernelTlsTest : public SslCertsTest {
+protected:
+  SslSocketKernelTlsTest() {
+    ON_CALL(os_sys_calls_, send(_, _, _, _))
+        .WillByDefault(Invoke([](os_fd_t fd, void* buffer, size_t length, int flags) {
+          return sysCallResult(::send(fd, buffer, length, flags));
+        }));
+    ON_CALL(os_sys_calls_, recv(_, _, _, _))
+        .WillByDefault(Invoke([](os_fd_t fd, void* buffer, size_t length, int flags) {
+          return sysCallResult(::recv(fd, buffer, length, flags));
+        }));
+    ON_CALL(os_sys_calls_, writev(_, _, _))
+        .WillByDefault(Invoke([](os_fd_t fd, const iovec* iov, int num_iov) {
+          return sysCallResult(::writev(fd, iov, num_iov));
+        }));
+    ON_CALL(os_sys_calls_, readv(_, _, _))
+        .WillByDefault(Invoke([](os_fd_t fd, const iovec* iov, int num_iov) {
+          return sysCallResult(::readv(fd, iov, num_iov));
+        }));
+
+    int fds[2];
+    RELEASE_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0, "");
+    io_handle_ = std::make_unique<Network::IoSocketHandleImpl>(fds[0]);
+    client_fd_ = fds[1];
+    ON_CALL(callbacks_, ioHandle()).WillByDefault(ReturnRef(*io_handle_));
+
+    const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_key.pem"
+  enable_kernel_tls_offload: true
+)EOF";
+    envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext server_tls_context;
+    TestUtility::loadFromYaml(TestEnvironment::substitute(server_ctx_yaml), server_tls_context);
+    factory_ = std::make_unique<ServerSslSocketFactory>(
+        std::make_unique<ServerContextConfigImpl>(server_tls_context, factory_context_), manager_,
+        *stats_store_.rootScope(), std::vector<std::string>{});
+    socket_ = factory_->createDownstreamTransportSocket();
+    socket_->setTransportSocketCallbacks(callbacks_);
+
+    client_ctx_.reset(SSL_CTX_new(TLS_method()));
+    client_ssl_.reset(SSL_new(client_ctx_.get()));
+    SSL_set_connect_state(client_ssl_.get());
+    SSL_set_fd(client_ssl_.get(), client_fd_);
+  }
+
+  ~SslSocketKernelTlsTest() override { ::close(client_fd_); }
+
+  static Api::SysCallSizeResult sysCallResult(ssize_t rc) {
+    return {rc, rc != -1 ? 0 : errno};
+  }
+
+  void expectOffload() {
+    EXPECT_CALL(os_sys_calls_, setsockopt_(_, IPPROTO_TCP, _, _, _)).WillOnce(Return(0));
+    EXPECT_CALL(os_sys_calls_, setsockopt_(_, SOL_TLS, TLS_TX, _, _)).WillOnce(Return(0));
+  }
+
+  SSL* serverSsl() { return dynamic_cast<const SslHandshakerImpl&>(*socket_->ssl()).ssl(); }
+
+  void handshake() {
+    for (int i = 0; i < 10 && !SSL_is_init_finished(serverSsl()); i++) {
+      SSL_do_handshake(client_ssl_.get());
+      Buffer::OwnedImpl buffer;
+      EXPECT_EQ(Network::PostIoAction::KeepOpen, socket_->doRead(buffer).action_);
+    }
+    ASSERT_TRUE(SSL_is_init_finished(serverSsl()));
+    // The client reads what the server wrote at the end of the handshake, e.g. session tickets, so
+    // that only what the server writes afterwards is left to read.
+    char byte;
+    ASSERT_EQ(-1, SSL_read(client_ssl_.get(), &byte, 1));
+    ASSERT_EQ(SSL_ERROR_WANT_READ, SSL_get_error(client_ssl_.get(), -1));
+  }
+
+  // Reads what the server wrote in the clear.
+  std::string readPlaintext(size_t length) {
+    std::string data(length, '\0');
+    EXPECT_EQ(static_cast<ssize_t>(length), ::read(client_fd_, data.data(), length));
+    return data;
+  }
+
+  NiceMock<Api::MockOsSysCalls> os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_{&os_sys_calls_};
+  Network::IoHandlePtr io_handle_;
+  os_fd_t client_fd_;
+  NiceMock<Network::MockTransportSocketCallbacks> callbacks_;
+  ContextManagerImpl manager_{time_system_};
+  Stats::TestUtil::TestStore stats_store_;
+  std::unique_ptr<ServerSslSocketFactory> factory_;
+  Network::TransportSocketPtr socket_;
+  bssl::UniquePtr<SSL_CTX> client_ctx_;
+  bssl::UniquePtr<SSL> client_ssl_;
+};
+
+TEST_F(SslSocketKernelTlsTest, OffloadsWritesAfterHandshake) {
+  expectOffload();
+  handshake();
+  EXPECT_EQ(1UL, stats_store_.counter("ssl.kernel_tls_offload").value());
+  EXPECT_EQ(0UL, stats_store_.counter("ssl.kernel_tls_offload_failed").value());
+
+  // BoringSSL no longer writes to the socket.
+  BIO* wbio = SSL_get_wbio(serverSsl());
+  EXPECT_NE(SSL_get_rbio(serverSsl()), wbio);
+  EXPECT_EQ(BIO_TYPE_MEM, BIO_method_type(wbio));
+
+  // The slices of the buffer are written as they are, for the kernel to encrypt.
+  Buffer::OwnedImpl buffer;
+  buffer.appendSliceForTest("hello ");
+  buffer.appendSliceForTest("world");
+  EXPECT_CALL(os_sys_calls_, writev(_, _, 2));
+  Network::IoResult result = socket_->doWrite(buffer, false);
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(11UL, result.bytes_processed_);
+  EXPECT_EQ(0UL, buffer.length());
+  EXPECT_EQ("hello world", readPlaintext(11));
+}
+
+TEST_F(SslSocketKernelTlsTest, FallsBackIfUlpNotSupported) {
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, IPPROTO_TCP, _, _, _)).WillOnce(Return(-1));
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, SOL_TLS, _, _, _)).Times(0);
+  handshake();
+  EXPECT_EQ(0UL, stats_store_.counter("ssl.kernel_tls_offload").value());
+  EXPECT_EQ(1UL, stats_store_.counter("ssl.kernel_tls_offload_failed").value());
+  EXPECT_EQ(SSL_get_rbio(serverSsl()), SSL_get_wbio(serverSsl()));
+
+  // BoringSSL keeps writing the records itself.
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_EQ(5UL, socket_->doWrite(buffer, false).bytes_processed_);
+  char data[5];
+  ASSERT_EQ(5, SSL_read(client_ssl_.get(), data, sizeof(data)));
+  EXPECT_EQ("hello", absl::string_view(data, sizeof(data)));
+}
+
+TEST_F(SslSocketKernelTlsTest, KernelTlsWriteRetriesPartialWrites) {
+  expectOffload();
+  handshake();
+  Buffer::OwnedImpl buffer;
+  buffer.appendSliceForTest("hello ");
+  buffer.appendSliceForTest("world");
+
+  // Nothing is written while the socket is full.
+  EXPECT_CALL(os_sys_calls_, writev(_, _, 2))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, SOCKET_ERROR_AGAIN}));
+  Network::IoResult result = socket_->doWrite(buffer, false);
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(0UL, result.bytes_processed_);
+  EXPECT_EQ(11UL, buffer.length());
+
+  // What doesn't fit into the socket is written again.
+  {
+    InSequence s;
+    EXPECT_CALL(os_sys_calls_, writev(_, _, 2))
+        .WillOnce(Invoke([](os_fd_t fd, const iovec* iov, int) {
+          return sysCallResult(::writev(fd, iov, 1));
+        }));
+    EXPECT_CALL(os_sys_calls_, send(_, _, 5, _));
+  }
+  result = socket_->doWrite(buffer, false);
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(11UL, result.bytes_processed_);
+  EXPECT_EQ(0UL, buffer.length());
+  EXPECT_EQ("hello world", readPlaintext(11));
+}
+
+TEST_F(SslSocketKernelTlsTest, KernelTlsWriteError) {
+  expectOffload();
+  handshake();
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_CALL(os_sys_calls_, send(_, _, 5, _))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, SOCKET_ERROR_CONNRESET}));
+  Network::IoResult result = socket_->doWrite(buffer, false);
+  EXPECT_EQ(Network::PostIoAction::Close, result.action_);
+  EXPECT_EQ(0UL, result.bytes_processed_);
+}
+
+TEST_F(SslSocketKernelTlsTest, SendsCloseNotifyAsAlertRecord) {
+  expectOffload();
+  handshake();
+  EXPECT_CALL(os_sys_calls_, sendmsg(_, _, _))
+      .WillOnce(Invoke([](os_fd_t, const msghdr* message, int) {
+        const cmsghdr* cmsg = CMSG_FIRSTHDR(message);
+        EXPECT_EQ(SOL_TLS, cmsg->cmsg_level);
+        EXPECT_EQ(TLS_SET_RECORD_TYPE, cmsg->cmsg_type);
+        // A warning level close_notify in an alert record.
+        EXPECT_EQ(21, *CMSG_DATA(cmsg));
+        EXPECT_EQ(1UL, message->msg_iovlen);
+        EXPECT_EQ(std::string("\x01\x00", 2),
+                  std::string(static_cast<const char*>(message->msg_iov[0].iov_base),
+                              message->msg_iov[0].iov_len));
+        return Api::SysCallSizeResult{2, 0};
+      }));
+
+  Buffer::OwnedImpl buffer("hello");
+  Network::IoResult result = socket_->doWrite(buffer, true);
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(5UL, result.bytes_processed_);
+  EXPECT_EQ("hello", readPlaintext(5));
+
+  // The alert isn't sent again when the socket is closed.
+  socket_->closeSocket(Network::ConnectionEvent::LocalClose);
+}
+
+TEST_F(SslSocketKernelTlsTest, ClosesIfRecordWrittenAfterOffload) {
+  expectOffload();
+  handshake();
+  // As if BoringSSL replied to a post-handshake message of the client, which it can no longer
+  // write to the socket.
+  ASSERT_EQ(1, BIO_write(SSL_get_wbio(serverSsl()), "x", 1));
+
+  ASSERT_EQ(5, SSL_write(client_ssl_.get(), "hello", 5));
+  Buffer::OwnedImpl buffer;
+  Network::IoResult result = socket_->doRead(buffer);
+  EXPECT_EQ(Network::PostIoAction::Close, result.action_);
+  EXPECT_EQ("hello", buffer.toString());
+  EXPECT_EQ("TLS error: record written after kernel TLS offload", socket_->failureReason());
+}
+
+#endif
+
 } // namespace Tls
 } // namespace TransportSockets
 } // namespace Extensions
@@ -1,4 +1,5 @@
 #include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/transport_sockets/tls/record_gather.h"
 
 #include "test/test_common/environment.h"
 
@@ -64,13 +65,14 @@ static void addFullSlices(Buffer::Instance& output_buffer, unsigned num_slices,
   }
 }
 
-static void testThroughput(benchmark::State& state) {
+// Completes the handshake of a client and a server over a pair of sockets.
+static void handshake(int sockets[2], bssl::UniquePtr<SSL>& server_ssl,
+                      bssl::UniquePtr<SSL>& client_ssl) {
   std::string error;
   std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
       bazel::tools::cpp::runfiles::Runfiles::Create("tls_throughput_benchmark", &error));
   Envoy::TestEnvironment::setRunfiles(runfiles.get());
 
-  int sockets[2];
   socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets);
 
   bssl::UniquePtr<SSL_CTX> server_ctx(SSL_CTX_new(TLS_method()));
@@ -85,11 +87,11 @@ static void testThroughput(benchmark::State& state) {
   err = SSL_CTX_use_PrivateKey_file(server_ctx.get(), key_path.c_str(), SSL_FILETYPE_PEM);
   RELEASE_ASSERT(err > 0, "SSL_CTX_use_PrivateKey_file");
 
-  bssl::UniquePtr<SSL> server_ssl(SSL_new(server_ctx.get()));
+  server_ssl.reset(SSL_new(server_ctx.get()));
   SSL_set_fd(server_ssl.get(), sockets[0]);
   SSL_set_accept_state(server_ssl.get());
 
-  bssl::UniquePtr<SSL> client_ssl(SSL_new(client_ctx.get()));
+  client_ssl.reset(SSL_new(client_ctx.get()));
   SSL_set_fd(client_ssl.get(), sockets[1]);
   SSL_set_connect_state(client_ssl.get());
 
@@ -106,8 +108,15 @@ static void testThroughput(benchmark::State& state) {
   }
 
   RELEASE_ASSERT(handshake_success, "handshake completed successfully");
+}
 
-  static uint8_t read_buf[1024 * 1024];
+static uint8_t read_buf[1024 * 1024];
+
+static void testThroughput(benchmark::State& state) {
+  int sockets[2];
+  bssl::UniquePtr<SSL> server_ssl;
+  bssl::UniquePtr<SSL> client_ssl;
+  handshake(sockets, server_ssl, client_ssl);
 
   unsigned short_slice_size = state.range(0);
   unsigned num_short_slices = state.range(1);
@@ -158,7 +167,7 @@ static void testThroughput(benchmark::State& state) {
         ++num_times_linearize_did_something;
       }
 
-      err = SSL_write(client_ssl.get(), mem, len);
+      int err = SSL_write(client_ssl.get(), mem, len);
       RELEASE_ASSERT(err == static_cast<int>(len),
                      absl::StrCat("SSL_write got: ", err, " expected: ", len));
       write_buf.drain(len);
@@ -192,5 +201,58 @@ static void testParams(benchmark::internal::Benchmark* b) {
 
 BENCHMARK(testThroughput)->Unit(::benchmark::kMicrosecond)->Apply(testParams);
 
+// Writes 1MB responses as they are proxied: read from the upstream socket in TCP segment sized
+// chunks, each into a slice of its own, and moved into the downstream connection's buffer. The
+// records are either linearized, or gathered from the slices as SslSocket does.
+static void testProxiedResponseThroughput(benchmark::State& state) {
+  int sockets[2];
+  bssl::UniquePtr<SSL> server_ssl;
+  bssl::UniquePtr<SSL> client_ssl;
+  handshake(sockets, server_ssl, client_ssl);
+  // Records are gathered elsewhere than where a retried write was linearized.
+  SSL_set_mode(client_ssl.get(), SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+
+  const uint32_t read_size = state.range(0);
+  const bool gather = state.range(1);
+  constexpr uint64_t ResponseSize = 1024 * 1024;
+
+  uint64_t bytes_written = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    state.PauseTiming();
+    Buffer::OwnedImpl write_buf;
+    while (write_buf.length() < ResponseSize) {
+      Buffer::OwnedImpl upstream_read;
+      appendSlice(upstream_read, std::min<uint64_t>(read_size, ResponseSize - write_buf.length()));
+      write_buf.move(upstream_read);
+    }
+    bytes_written += write_buf.length();
+    state.ResumeTiming();
+
+    while (write_buf.length() > 0) {
+      const uint64_t len = std::min<uint64_t>(write_buf.length(), RecordGather::MaxRecordSize);
+      const void* mem = gather ? RecordGather::gather(write_buf, len) : write_buf.linearize(len);
+      int err = SSL_write(client_ssl.get(), mem, len);
+      if (err < 0 && SSL_get_error(client_ssl.get(), err) == SSL_ERROR_WANT_WRITE) {
+        // Empty out the read side to make space for the writes.
+        while (SSL_read(server_ssl.get(), read_buf, sizeof(read_buf)) > 0) {
+        }
+        continue;
+      }
+      RELEASE_ASSERT(err == static_cast<int>(len),
+                     absl::StrCat("SSL_write got: ", err, " expected: ", len));
+      write_buf.drain(len);
+    }
+  }
+  state.counters["throughput"] = benchmark::Counter(bytes_written, benchmark::Counter::kIsRate);
+
+  ::close(sockets[0]);
+  ::close(sockets[1]);
+}
+
+BENCHMARK(testProxiedResponseThroughput)
+    ->Unit(::benchmark::kMicrosecond)
+    ->ArgsProduct({{1448, 4096, 16384}, {false, true}});
+
 } // namespace Extensions::TransportSockets::Tls
 } // namespace Envoy
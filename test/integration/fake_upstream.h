@@ -811,6 +811,7 @@ private:
       return socket_->connectionInfoProvider().localAddress();
     }
     Network::SocketSharedPtr getListenSocket(uint32_t) override { return socket_; }
+    OptRef<Network::ListenSocketLoad> socketLoad(uint32_t) override { return {}; }
     Network::ListenSocketFactoryPtr clone() const override { return nullptr; }
     void closeAllSockets() override {}
     void doFinalPreWorkerInit() override;
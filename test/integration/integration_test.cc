@@ -173,6 +173,29 @@ TEST_P(IntegrationTest, PerWorkerStatsAndBalancing) {
   check_listener_stats(0, 1);
 }
 
+// Connections are balanced between workers without a lock.
+TEST_P(IntegrationTest, LeastConnectionsBalancing) {
+  DISABLE_IF_ADMIN_DISABLED; // Uses admin stats
+  concurrency_ = 2;
+  config_helper_.addConfigModifier([&](envoy::config::bootstrap::v3::Bootstrap& bootstrap) -> void {
+    auto* listener = bootstrap.mutable_static_resources()->mutable_listeners(0);
+    listener->mutable_connection_balance_config()->mutable_least_connections_balance();
+  });
+  initialize();
+
+  const std::string prefix =
+      version_ == Network::Address::IpVersion::v4 ? "listener.127.0.0.1_0" : "listener.[__1]_0";
+  codec_client_ = makeHttpConnection(lookupPort("http"));
+  IntegrationCodecClientPtr codec_client2 = makeHttpConnection(lookupPort("http"));
+  test_server_->waitForGaugeEq(prefix + ".worker_0.downstream_cx_active", 1);
+  test_server_->waitForGaugeEq(prefix + ".worker_1.downstream_cx_active", 1);
+
+  codec_client_->close();
+  codec_client2->close();
+  test_server_->waitForGaugeEq(prefix + ".worker_0.downstream_cx_active", 0);
+  test_server_->waitForGaugeEq(prefix + ".worker_1.downstream_cx_active", 0);
+}
+
 class TestConnectionBalanceFactory : public Network::ConnectionBalanceFactory {
 public:
   ProtobufTypes::MessagePtr createEmptyConfigProto() override {
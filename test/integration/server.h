@@ -370,13 +370,16 @@ public:
   void initializeThreading(Event::Dispatcher&, ThreadLocal::Instance&) override {}
   void shutdownThreading() override {}
   void mergeHistograms(PostMergeCb cb) override { merge_cb_ = cb; }
+  void setCounterShards(uint32_t num_shards) override { counter_shards_ = num_shards; }
 
   void runMergeCallback() { merge_cb_(); }
+  uint32_t counterShards() const { return counter_shards_; }
 
 private:
   mutable Thread::MutexBasicLockable lock_;
   IsolatedStoreImpl store_;
   PostMergeCb merge_cb_;
+  uint32_t counter_shards_{};
   ScopeSharedPtr lazy_default_scope_;
 };
 
@@ -15,11 +15,12 @@ MockSubscriptionFactory::MockSubscriptionFactory() {
   ON_CALL(*this, subscriptionFromConfigSource(_, _, _, _, _, _))
       .WillByDefault(Invoke([this](const envoy::config::core::v3::ConfigSource&, absl::string_view,
                                    Stats::Scope&, SubscriptionCallbacks& callbacks,
-                                   OpaqueResourceDecoderSharedPtr,
+                                   OpaqueResourceDecoderSharedPtr resource_decoder,
                                    const SubscriptionOptions&) -> SubscriptionPtr {
         auto ret = std::make_unique<NiceMock<MockSubscription>>();
         subscription_ = ret.get();
         callbacks_ = &callbacks;
+        resource_decoder_ = resource_decoder;
         return ret;
       }));
   ON_CALL(*this, messageValidationVisitor())
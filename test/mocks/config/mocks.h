@@ -41,6 +41,8 @@ public:
   ~MockOpaqueResourceDecoder() override;
 
   MOCK_METHOD(ProtobufTypes::MessagePtr, decodeResource, (const ProtobufWkt::Any& resource));
+  MOCK_METHOD(Protobuf::Message*, decodeResource,
+              (const ProtobufWkt::Any& resource, Protobuf::Arena& arena));
   MOCK_METHOD(std::string, resourceName, (const Protobuf::Message& resource));
 };
 
@@ -93,6 +95,7 @@ public:
 
   MockSubscription* subscription_{};
   SubscriptionCallbacks* callbacks_{};
+  OpaqueResourceDecoderSharedPtr resource_decoder_;
 };
 
 class MockGrpcMuxWatch : public GrpcMuxWatch {
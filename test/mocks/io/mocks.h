@@ -56,6 +56,7 @@ public:
   MOCK_METHOD(IoUringWorker&, getIoUringWorker, (), (const));
   MOCK_METHOD(const OptRef<ReadParam>&, getReadParam, (), (const));
   MOCK_METHOD(const OptRef<WriteParam>&, getWriteParam, (), (const));
+  MOCK_METHOD(const OptRef<AcceptedSocketParam>&, getAcceptedSocketParam, (), (const));
   MOCK_METHOD(void, setFileReadyCb, (Event::FileReadyCb cb));
 };
 
@@ -68,7 +69,10 @@ public:
                bool enable_close_event));
   MOCK_METHOD(IoUringSocket&, addClientSocket,
               (os_fd_t fd, Event::FileReadyCb cb, bool enable_close_event));
+  MOCK_METHOD(IoUringSocket&, addAcceptSocket,
+              (os_fd_t fd, Event::FileReadyCb cb, bool enable_close_event));
   MOCK_METHOD(Event::Dispatcher&, dispatcher, ());
+  MOCK_METHOD(Request*, submitAcceptRequest, (IoUringSocket & socket));
   MOCK_METHOD(Request*, submitConnectRequest,
               (IoUringSocket & socket, const Network::Address::InstanceConstSharedPtr& address));
   MOCK_METHOD(Request*, submitReadRequest, (IoUringSocket & socket));
@@ -80,5 +84,12 @@ public:
   MOCK_METHOD(uint32_t, getNumOfSockets, (), (const));
 };
 
+class MockIoUringWorkerFactory : public IoUringWorkerFactory {
+public:
+  MOCK_METHOD(OptRef<IoUringWorker>, getIoUringWorker, ());
+  MOCK_METHOD(void, onServerInitialized, ());
+  MOCK_METHOD(bool, currentThreadRegistered, ());
+};
+
 } // namespace Io
 } // namespace Envoy
@@ -438,12 +438,20 @@ public:
   MOCK_METHOD(Network::Socket::Type, socketType, (), (const));
   MOCK_METHOD(const Network::Address::InstanceConstSharedPtr&, localAddress, (), (const));
   MOCK_METHOD(Network::SocketSharedPtr, getListenSocket, (uint32_t));
+  MOCK_METHOD(OptRef<Network::ListenSocketLoad>, socketLoad, (uint32_t));
   MOCK_METHOD(bool, reusePort, (), (const));
   MOCK_METHOD(Network::ListenSocketFactoryPtr, clone, (), (const));
   MOCK_METHOD(void, closeAllSockets, ());
   MOCK_METHOD(void, doFinalPreWorkerInit, ());
 };
 
+class MockListenSocketLoad : public ListenSocketLoad {
+public:
+  MockListenSocketLoad() = default;
+
+  MOCK_METHOD(void, add, (int64_t));
+};
+
 class MockUdpPacketWriterFactory : public UdpPacketWriterFactory {
 public:
   MockUdpPacketWriterFactory() = default;
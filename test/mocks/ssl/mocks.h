@@ -148,6 +148,7 @@ public:
   MOCK_METHOD(const std::string&, tlsKeyLogPath, (), (const));
   MOCK_METHOD(AccessLog::AccessLogManager&, accessLogManager, (), (const));
   MOCK_METHOD(bool, fullScanCertsOnSNIMismatch, (), (const));
+  MOCK_METHOD(bool, kernelTlsOffload, (), (const));
 };
 
 class MockTlsCertificateConfig : public TlsCertificateConfig {
@@ -38,6 +38,9 @@ public:
   MOCK_METHOD(bool, addOrUpdateCluster,
               (const envoy::config::cluster::v3::Cluster& cluster,
                const std::string& version_info));
+  MOCK_METHOD(bool, addOrUpdateCluster,
+              (const envoy::config::cluster::v3::Cluster& cluster, const std::string& version_info,
+               uint64_t cluster_hash));
   MOCK_METHOD(void, setPrimaryClustersInitializedCb, (PrimaryClustersReadyCallback));
   MOCK_METHOD(void, setInitializedCb, (InitializationCompleteCallback));
   MOCK_METHOD(absl::Status, initializeSecondaryClusters,
@@ -687,6 +687,33 @@ TEST_F(ActiveTcpListenerTest, Rebalance) {
   active_listener2.reset();
 }
 
+// Verify that the connections of the listener are counted towards the load of its listen socket.
+TEST_F(ActiveTcpListenerTest, CountsConnectionsTowardsSocketLoad) {
+  initialize();
+  NiceMock<Random::MockRandomGenerator> random;
+  Network::MockListenSocketLoad socket_load;
+  auto* listener = new NiceMock<Network::MockListener>();
+  EXPECT_CALL(conn_handler_, createListener(_, _, _, _, _, _))
+      .WillOnce(Return(ByMove(Network::ListenerPtr{listener})));
+  Network::Address::InstanceConstSharedPtr address(
+      new Network::Address::Ipv4Instance("127.0.0.1", 10001));
+  Network::SocketSharedPtr socket = std::make_shared<NiceMock<Network::MockListenSocket>>();
+  auto active_listener = std::make_unique<ActiveTcpListener>(
+      conn_handler_, listener_config_, runtime_, random, std::move(socket), address, balancer_,
+      makeOptRef<Network::ListenSocketLoad>(socket_load), absl::nullopt);
+
+  EXPECT_CALL(socket_load, add(1)).Times(2);
+  active_listener->incNumConnections();
+  active_listener->incNumConnections();
+  EXPECT_CALL(socket_load, add(-1));
+  active_listener->decNumConnections();
+
+  EXPECT_CALL(*listener, onDestroy());
+  EXPECT_CALL(socket_load, add(-1));
+  active_listener->decNumConnections();
+  active_listener.reset();
+}
+
 } // namespace
 } // namespace Server
 } // namespace Envoy
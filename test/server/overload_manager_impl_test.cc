@@ -896,6 +896,126 @@ TEST_F(OverloadManagerSimulatedTimeTest, RefreshLoopDelay) {
   manager->stop();
 }
 
+TEST_F(OverloadManagerSimulatedTimeTest, PredictiveTrigger) {
+  // The rate window is short enough for the rate to be that since the previous update.
+  const std::string config = R"EOF(
+    refresh_interval:
+      seconds: 1
+    resource_monitors:
+      - name: "envoy.resource_monitors.fake_resource1"
+    actions:
+      - name: "envoy.overload_actions.stop_accepting_requests"
+        triggers:
+          - name: "envoy.resource_monitors.fake_resource1"
+            predictive:
+              saturation_threshold: 0.9
+              scaling_horizon: 10s
+              saturation_horizon: 2s
+              rate_window: 0.001s
+  )EOF";
+  setDispatcherExpectation();
+  auto manager(createOverloadManager(config));
+  manager->start();
+  const auto& action_state = manager->getThreadLocalOverloadState().getState(
+      "envoy.overload_actions.stop_accepting_requests");
+
+  // There is no rate to project from until the second update.
+  factory1_.monitor_->setPressure(0.1);
+  timer_cb_();
+  EXPECT_EQ(UnitFloat::min(), action_state.value());
+
+  // Rising by 0.1 a second, the pressure saturates in 7 seconds.
+  simTime().advanceTimeWait(Envoy::Seconds(1));
+  factory1_.monitor_->setPressure(0.2);
+  timer_cb_();
+  EXPECT_FALSE(action_state.isSaturated());
+  EXPECT_THAT(action_state.value().value(), FloatNear(0.375 /* = (10 - 7) / (10 - 2) */, 0.001));
+
+  simTime().advanceTimeWait(Envoy::Seconds(1));
+  timer_cb_();
+  EXPECT_EQ(UnitFloat::min(), action_state.value());
+
+  // Rising by 0.4 a second, the pressure saturates within the saturation horizon.
+  simTime().advanceTimeWait(Envoy::Seconds(1));
+  factory1_.monitor_->setPressure(0.6);
+  timer_cb_();
+  EXPECT_TRUE(action_state.isSaturated());
+
+  // Falling pressure above the threshold still saturates the trigger.
+  simTime().advanceTimeWait(Envoy::Seconds(1));
+  factory1_.monitor_->setPressure(0.95);
+  timer_cb_();
+  simTime().advanceTimeWait(Envoy::Seconds(1));
+  factory1_.monitor_->setPressure(0.92);
+  timer_cb_();
+  EXPECT_TRUE(action_state.isSaturated());
+
+  manager->stop();
+}
+
+// The moving average of the rate follows a change in the rate over the rate window.
+TEST_F(OverloadManagerSimulatedTimeTest, PredictiveTriggerRateWindow) {
+  const std::string config = R"EOF(
+    refresh_interval:
+      seconds: 1
+    resource_monitors:
+      - name: "envoy.resource_monitors.fake_resource1"
+    actions:
+      - name: "envoy.overload_actions.stop_accepting_requests"
+        triggers:
+          - name: "envoy.resource_monitors.fake_resource1"
+            predictive:
+              saturation_threshold: 1.0
+              scaling_horizon: 10s
+              rate_window: 10s
+  )EOF";
+  setDispatcherExpectation();
+  auto manager(createOverloadManager(config));
+  manager->start();
+  const auto& action_state = manager->getThreadLocalOverloadState().getState(
+      "envoy.overload_actions.stop_accepting_requests");
+
+  factory1_.monitor_->setPressure(0.0);
+  timer_cb_();
+
+  // A single jump of 0.5 moves the average rate about a tenth of the way to 0.5 a second, which
+  // projects saturation in about 10.5 seconds.
+  simTime().advanceTimeWait(Envoy::Seconds(1));
+  factory1_.monitor_->setPressure(0.5);
+  timer_cb_();
+  EXPECT_EQ(UnitFloat::min(), action_state.value());
+
+  // As the pressure keeps rising, the projected time shortens and the trigger scales.
+  for (int i = 0; i < 5; i++) {
+    simTime().advanceTimeWait(Envoy::Seconds(1));
+    factory1_.monitor_->setPressure(0.5 + 0.05 * (i + 1));
+    timer_cb_();
+  }
+  EXPECT_GT(action_state.value().value(), 0);
+  EXPECT_FALSE(action_state.isSaturated());
+
+  manager->stop();
+}
+
+// A predictive trigger must saturate before it would start scaling.
+TEST_F(OverloadManagerImplTest, PredictiveTriggerSaturationHorizonNotLessThanScalingHorizon) {
+  const std::string config = R"EOF(
+    resource_monitors:
+      - name: "envoy.resource_monitors.fake_resource1"
+    actions:
+      - name: "envoy.overload_actions.shrink_heap"
+        triggers:
+          - name: "envoy.resource_monitors.fake_resource1"
+            predictive:
+              saturation_threshold: 0.9
+              scaling_horizon: 5s
+              saturation_horizon: 5s
+  )EOF";
+
+  EXPECT_THROW_WITH_REGEX(createOverloadManager(config), EnvoyException,
+                          "saturation_horizon must be less than scaling_horizon.*");
+}
+
 class OverloadManagerLoadShedPointImplTest : public OverloadManagerImplTest {};
 
 TEST_F(OverloadManagerLoadShedPointImplTest, DuplicateLoadShedPoints) {
@@ -816,6 +816,19 @@ TEST_P(ServerInstanceImplTest, Stats) {
 #endif
 }
 
+// Counters are sharded across the workers and the main thread if the bootstrap asks for it.
+TEST_P(ServerInstanceImplTest, ShardCounters) {
+  options_.concurrency_ = 4;
+  EXPECT_NO_THROW(initialize("test/server/test_data/server/shard_counters_bootstrap.yaml"));
+  EXPECT_EQ(5, stats_store_.counterShards());
+}
+
+TEST_P(ServerInstanceImplTest, CountersAreNotShardedByDefault) {
+  options_.concurrency_ = 4;
+  EXPECT_NO_THROW(initialize("test/server/test_data/server/empty_bootstrap.yaml"));
+  EXPECT_EQ(0, stats_store_.counterShards());
+}
+
 class ServerStatsTest
     : public Event::TestUsingSimulatedTime,
       public ServerInstanceImplTestBase,
@@ -34,7 +34,7 @@ public:
       : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("worker_test")),
         no_exit_timer_(dispatcher_->createTimer([]() -> void {})),
         stat_names_(api_->rootScope().symbolTable()),
-        worker_(tls_, hooks_, std::move(dispatcher_), Network::ConnectionHandlerPtr{handler_},
+        worker_(0, tls_, hooks_, std::move(dispatcher_), Network::ConnectionHandlerPtr{handler_},
                 overload_manager_, *api_, stat_names_) {
     // In the real worker the watchdog has timers that prevent exit. Here we need to prevent event
     // loop exit since we use mock timers.
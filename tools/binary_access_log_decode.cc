@@ -0,0 +1,90 @@
+/**
+ * Utility to print the records of binary access log segments as JSON lines, with one object per
+ * record keyed by the lowercase names of its fields. Fields without a value are omitted.
+ *
+ * Usage:
+ *
+ * binary_access_log_decode <segment path>...
+ */
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "source/common/common/json_escape_string.h"
+#include "source/extensions/access_loggers/binary/segment_format.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+
+namespace {
+
+using Envoy::Extensions::AccessLoggers::Binary::SegmentReader;
+
+bool decodeSegment(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    std::cerr << path << ": cannot open" << std::endl;
+    return false;
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+  const std::string segment = contents.str();
+
+  absl::StatusOr<SegmentReader> reader = SegmentReader::create(segment);
+  if (!reader.ok()) {
+    std::cerr << path << ": " << reader.status().message() << std::endl;
+    return false;
+  }
+  std::vector<std::string> names;
+  for (const auto field : reader->fields()) {
+    names.push_back(absl::AsciiStrToLower(
+        envoy::extensions::access_loggers::binary::v3::BinaryAccessLog::Field_Name(field)));
+  }
+
+  std::vector<SegmentReader::Value> values;
+  std::string line;
+  while (true) {
+    const absl::StatusOr<bool> next = reader->next(values);
+    if (!next.ok()) {
+      std::cerr << path << ": " << next.status().message() << std::endl;
+      return false;
+    }
+    if (!*next) {
+      return true;
+    }
+    line = "{";
+    for (size_t i = 0; i < values.size(); i++) {
+      if (absl::holds_alternative<absl::monostate>(values[i])) {
+        continue;
+      }
+      absl::StrAppend(&line, line.size() > 1 ? "," : "", "\"", names[i], "\":");
+      if (const uint64_t* integer = absl::get_if<uint64_t>(&values[i])) {
+        absl::StrAppend(&line, *integer);
+      } else {
+        const absl::string_view str = absl::get<absl::string_view>(values[i]);
+        absl::StrAppend(&line, "\"",
+                        Envoy::JsonEscaper::escapeString(str, Envoy::JsonEscaper::extraSpace(str)),
+                        "\"");
+      }
+    }
+    line.push_back('}');
+    std::cout << line << "\n";
+  }
+}
+
+} // namespace
+
+// NOLINT(namespace-envoy)
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <segment path>..." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  bool ok = true;
+  for (int i = 1; i < argc; i++) {
+    ok = decodeSegment(argv[i]) && ok;
+  }
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}